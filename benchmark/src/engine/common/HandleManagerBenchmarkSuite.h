@@ -0,0 +1,85 @@
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "engine/common/HandleManager.h"
+
+/**
+ * Fill the given handle manager with the given number of live handles.
+ */
+static std::vector<ds::Handle> FillHandleManager(ds::HandleManager *manager,
+                                                 int numHandles,
+                                                 std::vector<int> *data)
+{
+    std::vector<ds::Handle> handles;
+    handles.reserve(numHandles);
+
+    data->resize(numHandles);
+    for (int i = 0; i < numHandles; ++i)
+    {
+        handles.push_back(manager->Add(&(*data)[i], 0));
+    }
+
+    return handles;
+}
+
+// Add the given number of handles to an empty manager.
+static void BM_HandleManagerAdd(benchmark::State &state)
+{
+    ds::HandleManager manager;
+    int data = 0;
+
+    for (auto _ : state)
+    {
+        manager.Reset();
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            benchmark::DoNotOptimize(manager.Add(&data, 0));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HandleManagerAdd)->Arg(1000000);
+
+// Look up every handle of a manager with the given number of live handles.
+static void BM_HandleManagerGet(benchmark::State &state)
+{
+    ds::HandleManager manager;
+    std::vector<int> data;
+    std::vector<ds::Handle> handles =
+        FillHandleManager(&manager, state.range(0), &data);
+
+    for (auto _ : state)
+    {
+        for (const ds::Handle &handle : handles)
+        {
+            benchmark::DoNotOptimize(manager.Get(handle));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HandleManagerGet)->Arg(1000000);
+
+// Remove and re-add every handle of a manager with the given number of live
+// handles.
+static void BM_HandleManagerRemoveAdd(benchmark::State &state)
+{
+    ds::HandleManager manager;
+    std::vector<int> data;
+    std::vector<ds::Handle> handles =
+        FillHandleManager(&manager, state.range(0), &data);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < handles.size(); ++i)
+        {
+            manager.Remove(handles[i]);
+            handles[i] = manager.Add(&data[i], 0);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HandleManagerRemoveAdd)->Arg(1000000);
@@ -0,0 +1,98 @@
+#include "benchmark/benchmark.h"
+
+#include "engine/common/StreamBuffer.h"
+#include "engine/message/MessageHelper.h"
+
+// Number of systems a frame's messages are broadcast to (roughly the number of
+// systems in a typical engine configuration).
+static const int STREAM_BUFFER_BENCHMARK_NUM_SYSTEMS = 6;
+
+/**
+ * Build a message stream containing the given number of keyboard event
+ * messages.
+ */
+static ds_msg::MessageStream BuildKeyboardEventStream(int numMessages)
+{
+    ds_msg::MessageStream stream;
+
+    ds_msg::KeyboardEvent keyEvent;
+    keyEvent.key = ds_platform::Keyboard::Key::Key_a;
+    keyEvent.state = ds_platform::Keyboard::State::Key_Pressed;
+    keyEvent.repeat = false;
+    keyEvent.timeStamp = 0;
+    keyEvent.windowID = 0;
+
+    for (int i = 0; i < numMessages; ++i)
+    {
+        ds_msg::AppendMessage(&stream, ds_msg::MessageType::KeyboardEvent,
+                              sizeof(ds_msg::KeyboardEvent), &keyEvent);
+    }
+
+    return stream;
+}
+
+// Broadcast a frame's messages by copying them into each system's stream.
+static void BM_StreamBufferBroadcastCopy(benchmark::State &state)
+{
+    ds_msg::MessageStream frame = BuildKeyboardEventStream(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < STREAM_BUFFER_BENCHMARK_NUM_SYSTEMS; ++i)
+        {
+            ds_msg::MessageStream received;
+            received.Insert(frame.AvailableBytes(), frame.GetDataPtr());
+            benchmark::DoNotOptimize(received.GetDataPtr());
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * frame.AvailableBytes() *
+                            STREAM_BUFFER_BENCHMARK_NUM_SYSTEMS);
+}
+BENCHMARK(BM_StreamBufferBroadcastCopy)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+// Broadcast a frame's messages by sharing the frame's storage with each
+// system's stream.
+static void BM_StreamBufferBroadcastShared(benchmark::State &state)
+{
+    ds_msg::MessageStream frame = BuildKeyboardEventStream(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < STREAM_BUFFER_BENCHMARK_NUM_SYSTEMS; ++i)
+        {
+            ds_msg::MessageStream received;
+            ds_com::AppendStreamBuffer(received, frame);
+            benchmark::DoNotOptimize(received.GetDataPtr());
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * frame.AvailableBytes() *
+                            STREAM_BUFFER_BENCHMARK_NUM_SYSTEMS);
+}
+BENCHMARK(BM_StreamBufferBroadcastShared)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000);
+
+// Read every message header in a broadcast stream, skipping the payloads.
+static void BM_StreamBufferReadShared(benchmark::State &state)
+{
+    ds_msg::MessageStream frame = BuildKeyboardEventStream(state.range(0));
+
+    for (auto _ : state)
+    {
+        ds_msg::MessageStream received;
+        ds_com::AppendStreamBuffer(received, frame);
+
+        while (received.AvailableBytes() != 0)
+        {
+            ds_msg::MessageHeader header;
+            received >> header;
+            received.Extract(header.size);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StreamBufferReadShared)->Arg(10000)->Arg(100000)->Arg(1000000);
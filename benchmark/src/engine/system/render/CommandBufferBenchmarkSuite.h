@@ -0,0 +1,106 @@
+#include "benchmark/benchmark.h"
+
+#include "engine/system/render/CommandBuffer.h"
+#include "engine/system/render/NullRenderer.h"
+#include "math/Matrix4.h"
+
+// A frame of draws of 10 programs, each object updating it's model matrix
+// before it's draw, made either on the null renderer directly or recorded
+// into a command buffer and executed on it.
+
+/**
+ * Make the calls of a frame of the given number of draws on a renderer or
+ * command buffer, which share method names.
+ */
+template <typename T>
+static void CommandBufferBenchmarkFrame(
+    size_t numDraws,
+    ds_render::ConstantBufferDescription *objectBufferDescription,
+    T *renderer)
+{
+    ds_render::ConstantBufferDescription::Member modelMatrix;
+    modelMatrix.offset = 0;
+
+    for (size_t i = 0; i < numDraws; ++i)
+    {
+        ds_render::ProgramHandle program((uint32_t)(i * 10 / numDraws), 0, 0);
+        if (i % (numDraws / 10) == 0)
+        {
+            renderer->SetProgram(program);
+            renderer->BindTextureToSampler(program, "diffuse",
+                                           ds_render::TextureHandle(1, 0, 0));
+        }
+
+        ds_math::Matrix4 transform = ds_math::Matrix4::CreateTranslationMatrix(
+            (float)i, 0.0f, 0.0f);
+        objectBufferDescription->InsertMemberData(
+            modelMatrix, sizeof(ds_math::Matrix4), &transform);
+        renderer->UpdateConstantBufferSubData(
+            ds_render::ConstantBufferHandle(), *objectBufferDescription, 0,
+            sizeof(ds_math::Matrix4));
+
+        renderer->DrawVerticesIndexed(ds_render::VertexBufferHandle(1, 0, 0),
+                                      ds_render::IndexBufferHandle(1, 0, 0),
+                                      ds_render::PrimitiveType::TriangleStrip,
+                                      0, 36);
+    }
+}
+
+// Calls made straight on the renderer, as IRenderer users do now
+static void BM_NullRendererFrame(benchmark::State &state)
+{
+    ds_render::ConstantBufferDescription objectBufferDescription(
+        sizeof(ds_math::Matrix4));
+    ds_render::NullRenderer nullRenderer;
+    ds_render::IRenderer *renderer = &nullRenderer;
+
+    for (auto _ : state)
+    {
+        CommandBufferBenchmarkFrame(state.range(0), &objectBufferDescription,
+                                    renderer);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_NullRendererFrame)->Arg(10000);
+
+// Recording alone. With more than one thread, each records a frame into a
+// command buffer of it's own, as per thread submission would.
+static void BM_CommandBufferRecord(benchmark::State &state)
+{
+    ds_render::ConstantBufferDescription objectBufferDescription(
+        sizeof(ds_math::Matrix4));
+    ds_render::CommandBuffer commands;
+
+    for (auto _ : state)
+    {
+        commands.Clear();
+        CommandBufferBenchmarkFrame(state.range(0), &objectBufferDescription,
+                                    &commands);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes"] = benchmark::Counter(
+        commands.GetNumBytes(), benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(BM_CommandBufferRecord)->Arg(10000)->Threads(1)->Threads(4);
+
+// Executing a recorded frame on the null renderer, the work left for the
+// render thread.
+static void BM_CommandBufferExecute(benchmark::State &state)
+{
+    ds_render::ConstantBufferDescription objectBufferDescription(
+        sizeof(ds_math::Matrix4));
+    ds_render::CommandBuffer commands;
+    CommandBufferBenchmarkFrame(state.range(0), &objectBufferDescription,
+                                &commands);
+    ds_render::NullRenderer renderer;
+
+    for (auto _ : state)
+    {
+        commands.Execute(&renderer);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CommandBufferExecute)->Arg(10000);
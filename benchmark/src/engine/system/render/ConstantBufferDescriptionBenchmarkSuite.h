@@ -0,0 +1,59 @@
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "engine/system/render/ConstantBufferDescription.h"
+#include "math/Matrix4.h"
+
+// Writes the model matrix of every object into the object constant buffer,
+// looking the member up by name for each object as Render::RenderScene used
+// to.
+static void BM_ConstantBufferInsertByName(benchmark::State &state)
+{
+    ds_render::ConstantBufferDescription description(sizeof(ds_math::Matrix4));
+    description.AddMember("Object.modelMatrix");
+    description.SetMemberOffset("Object.modelMatrix", 0);
+
+    std::vector<ds_math::Matrix4> transforms(state.range(0),
+                                             ds_math::Matrix4(1.0f));
+
+    for (auto _ : state)
+    {
+        for (const ds_math::Matrix4 &transform : transforms)
+        {
+            description.InsertMemberData("Object.modelMatrix",
+                                         sizeof(ds_math::Matrix4), &transform);
+            benchmark::ClobberMemory();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConstantBufferInsertByName)->Arg(10000);
+
+// Same writes through a member found once.
+static void BM_ConstantBufferInsertByMember(benchmark::State &state)
+{
+    ds_render::ConstantBufferDescription description(sizeof(ds_math::Matrix4));
+    description.AddMember("Object.modelMatrix");
+    description.SetMemberOffset("Object.modelMatrix", 0);
+
+    ds_render::ConstantBufferDescription::Member modelMatrix;
+    description.GetMember("Object.modelMatrix", &modelMatrix);
+
+    std::vector<ds_math::Matrix4> transforms(state.range(0),
+                                             ds_math::Matrix4(1.0f));
+
+    for (auto _ : state)
+    {
+        for (const ds_math::Matrix4 &transform : transforms)
+        {
+            description.InsertMemberData(modelMatrix, sizeof(ds_math::Matrix4),
+                                         &transform);
+            benchmark::ClobberMemory();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConstantBufferInsertByMember)->Arg(10000);
@@ -0,0 +1,331 @@
+#include <cstring>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "engine/system/render/GLRenderer.h"
+
+/**
+ * Mock OpenGL backend, replaces the GLEW entry points used to create buffers
+ * and programs and to draw with functions that only hand out object names and
+ * count the calls made. This lets the renderer be driven without a graphics
+ * context, so only the renderer's own bookkeeping is measured.
+ */
+namespace mock_gl
+{
+static GLuint g_nextName = 1;
+static size_t g_numCalls = 0;
+
+static void GLAPIENTRY GenBuffers(GLsizei n, GLuint *buffers)
+{
+    ++g_numCalls;
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        buffers[i] = g_nextName++;
+    }
+}
+
+static void GLAPIENTRY GenVertexArrays(GLsizei n, GLuint *arrays)
+{
+    GenBuffers(n, arrays);
+}
+
+static void GLAPIENTRY BindBuffer(GLenum target, GLuint buffer)
+{
+    ++g_numCalls;
+}
+
+static void GLAPIENTRY BindVertexArray(GLuint array)
+{
+    ++g_numCalls;
+}
+
+static void GLAPIENTRY BufferData(GLenum target,
+                                  GLsizeiptr size,
+                                  const void *data,
+                                  GLenum usage)
+{
+    ++g_numCalls;
+}
+
+static void GLAPIENTRY EnableVertexAttribArray(GLuint index)
+{
+    ++g_numCalls;
+}
+
+static void GLAPIENTRY VertexAttribPointer(GLuint index,
+                                           GLint size,
+                                           GLenum type,
+                                           GLboolean normalized,
+                                           GLsizei stride,
+                                           const void *pointer)
+{
+    ++g_numCalls;
+}
+
+static void GLAPIENTRY BindBufferBase(GLenum target,
+                                      GLuint index,
+                                      GLuint buffer)
+{
+    ++g_numCalls;
+}
+
+static void GLAPIENTRY BindBufferRange(GLenum target,
+                                       GLuint index,
+                                       GLuint buffer,
+                                       GLintptr offset,
+                                       GLsizeiptr size)
+{
+    ++g_numCalls;
+}
+
+static GLuint GLAPIENTRY CreateShader(GLenum type)
+{
+    ++g_numCalls;
+    return g_nextName++;
+}
+
+static void GLAPIENTRY ShaderSource(GLuint shader,
+                                    GLsizei count,
+                                    const GLchar *const *string,
+                                    const GLint *length)
+{
+    ++g_numCalls;
+}
+
+static void GLAPIENTRY CompileShader(GLuint shader)
+{
+    ++g_numCalls;
+}
+
+static void GLAPIENTRY GetShaderiv(GLuint shader, GLenum pname, GLint *param)
+{
+    ++g_numCalls;
+    *param = GL_TRUE;
+}
+
+static GLuint GLAPIENTRY CreateProgram()
+{
+    ++g_numCalls;
+    return g_nextName++;
+}
+
+static void GLAPIENTRY AttachShader(GLuint program, GLuint shader)
+{
+    ++g_numCalls;
+}
+
+static void GLAPIENTRY LinkProgram(GLuint program)
+{
+    ++g_numCalls;
+}
+
+// Programs have one uniform block, "Object", and no other uniforms
+static void GLAPIENTRY GetProgramiv(GLuint program, GLenum pname, GLint *param)
+{
+    ++g_numCalls;
+    switch (pname)
+    {
+    case GL_ACTIVE_UNIFORMS:
+        *param = 0;
+        break;
+    case GL_ACTIVE_UNIFORM_BLOCKS:
+        *param = 1;
+        break;
+    case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+    case GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH:
+        *param = 16;
+        break;
+    default:
+        *param = GL_TRUE;
+        break;
+    }
+}
+
+static void GLAPIENTRY GetActiveUniformBlockName(GLuint program,
+                                                 GLuint uniformBlockIndex,
+                                                 GLsizei bufSize,
+                                                 GLsizei *length,
+                                                 GLchar *uniformBlockName)
+{
+    ++g_numCalls;
+    strcpy(uniformBlockName, "Object");
+    *length = strlen(uniformBlockName);
+}
+
+static GLuint GLAPIENTRY GetUniformBlockIndex(GLuint program,
+                                              const GLchar *uniformBlockName)
+{
+    ++g_numCalls;
+    return 0;
+}
+
+static void GLAPIENTRY UniformBlockBinding(GLuint program,
+                                           GLuint uniformBlockIndex,
+                                           GLuint uniformBlockBinding)
+{
+    ++g_numCalls;
+}
+
+static void GLAPIENTRY UseProgram(GLuint program)
+{
+    ++g_numCalls;
+}
+
+static void GLAPIENTRY DrawElementsInstanced(GLenum mode,
+                                             GLsizei count,
+                                             GLenum type,
+                                             const void *indices,
+                                             GLsizei primcount)
+{
+    ++g_numCalls;
+}
+
+/**
+ * Point the GLEW entry points at the mock backend.
+ */
+static void Install()
+{
+    glGenBuffers = GenBuffers;
+    glGenVertexArrays = GenVertexArrays;
+    glBindBuffer = BindBuffer;
+    glBindVertexArray = BindVertexArray;
+    glBufferData = BufferData;
+    glEnableVertexAttribArray = EnableVertexAttribArray;
+    glVertexAttribPointer = VertexAttribPointer;
+    glBindBufferBase = BindBufferBase;
+    glBindBufferRange = BindBufferRange;
+    glCreateShader = CreateShader;
+    glShaderSource = ShaderSource;
+    glCompileShader = CompileShader;
+    glGetShaderiv = GetShaderiv;
+    glCreateProgram = CreateProgram;
+    glAttachShader = AttachShader;
+    glLinkProgram = LinkProgram;
+    glGetProgramiv = GetProgramiv;
+    glGetActiveUniformBlockName = GetActiveUniformBlockName;
+    glGetUniformBlockIndex = GetUniformBlockIndex;
+    glUniformBlockBinding = UniformBlockBinding;
+    glUseProgram = UseProgram;
+    glDrawElementsInstanced = DrawElementsInstanced;
+}
+}
+
+/**
+ * Description of a vertex buffer of positions.
+ */
+static ds_render::VertexBufferDescription GLRendererBenchmarkDescription()
+{
+    ds_render::VertexBufferDescription::AttributeDescription position;
+    position.attributeType = ds_render::AttributeType::Position;
+    position.attributeDataType = ds_render::RenderDataType::Float;
+    position.numElementsPerAttribute = 3;
+    position.stride = 0;
+    position.offset = 0;
+    position.normalized = false;
+
+    ds_render::VertexBufferDescription description;
+    description.AddAttributeDescription(position);
+
+    return description;
+}
+
+// Create the given number of meshes (a vertex buffer and an index buffer
+// each) through the renderer interface, as a level load would.
+static void BM_GLRendererCreateMeshes(benchmark::State &state)
+{
+    mock_gl::Install();
+
+    ds_render::VertexBufferDescription description =
+        GLRendererBenchmarkDescription();
+
+    std::vector<float> vertices(9, 0.0f);
+    std::vector<unsigned int> indices = {0, 1, 2};
+
+    for (auto _ : state)
+    {
+        // Fresh renderer each iteration so every load starts from empty
+        ds_render::GLRenderer glRenderer;
+        ds_render::IRenderer &renderer = glRenderer;
+
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            benchmark::DoNotOptimize(renderer.CreateVertexBuffer(
+                ds_render::BufferUsageType::Static, description,
+                vertices.size() * sizeof(float), &vertices[0]));
+            benchmark::DoNotOptimize(renderer.CreateIndexBuffer(
+                ds_render::BufferUsageType::Static,
+                indices.size() * sizeof(unsigned int), &indices[0]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GLRendererCreateMeshes)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Draw a frame of the given number of draws of 10 programs and 10 meshes,
+// sorted by program then mesh as the render queue sorts them. Every draw sets
+// all the state it needs, the program, it's range of the object constant
+// buffer and it's mesh, and the OpenGL calls reaching the driver are counted.
+static void BM_GLRendererDrawFrame(benchmark::State &state)
+{
+    mock_gl::Install();
+
+    ds_render::GLRenderer glRenderer;
+    ds_render::IRenderer &renderer = glRenderer;
+
+    const char *source = "void main() {}";
+    std::vector<ds_render::ProgramHandle> programs;
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        std::vector<ds_render::ShaderHandle> shaders;
+        shaders.push_back(renderer.CreateShaderObject(
+            ds_render::ShaderType::VertexShader, strlen(source), source));
+        programs.push_back(renderer.CreateProgram(shaders));
+    }
+
+    ds_render::VertexBufferDescription description =
+        GLRendererBenchmarkDescription();
+    std::vector<float> vertices(9, 0.0f);
+    std::vector<unsigned int> indices = {0, 1, 2};
+    std::vector<ds_render::VertexBufferHandle> vertexBuffers;
+    std::vector<ds_render::IndexBufferHandle> indexBuffers;
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        vertexBuffers.push_back(renderer.CreateVertexBuffer(
+            ds_render::BufferUsageType::Static, description,
+            vertices.size() * sizeof(float), &vertices[0]));
+        indexBuffers.push_back(renderer.CreateIndexBuffer(
+            ds_render::BufferUsageType::Static,
+            indices.size() * sizeof(unsigned int), &indices[0]));
+    }
+
+    ds_render::ConstantBufferHandle objectBuffer =
+        renderer.CreateStreamingConstantBuffer(1024 * 1024);
+
+    const size_t numDraws = state.range(0);
+    const size_t drawsPerProgram = numDraws / programs.size();
+    const size_t drawsPerMesh = drawsPerProgram / vertexBuffers.size();
+
+    mock_gl::g_numCalls = 0;
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < numDraws; ++i)
+        {
+            ds_render::ProgramHandle program = programs[i / drawsPerProgram];
+            size_t mesh = (i / drawsPerMesh) % vertexBuffers.size();
+
+            renderer.SetProgram(program);
+            renderer.BindConstantBuffer(program, "Object", objectBuffer);
+            renderer.BindConstantBufferRange(objectBuffer, i * 256, 64);
+            renderer.DrawVerticesIndexedInstanced(
+                vertexBuffers[mesh], indexBuffers[mesh],
+                ds_render::PrimitiveType::Triangles, 0, indices.size(), 1);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * numDraws);
+    state.counters["glCalls"] = benchmark::Counter(
+        mock_gl::g_numCalls, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_GLRendererDrawFrame)->Arg(1000)->Arg(10000);
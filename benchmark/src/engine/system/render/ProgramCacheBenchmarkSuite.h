@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "engine/system/render/NullRenderer.h"
+#include "engine/system/render/ProgramCache.h"
+
+namespace mock_renderer
+{
+/**
+ * Renderer that draws nothing and counts the programs it compiles and
+ * creates from binaries.
+ */
+class ProgramCountingRenderer : public ds_render::NullRenderer
+{
+public:
+    ProgramCountingRenderer()
+    {
+        numCompiled = 0;
+        numCreatedFromBinary = 0;
+    }
+
+    virtual ds_render::ProgramHandle
+    CreateProgram(const std::vector<ds_render::ShaderHandle> &shaders)
+    {
+        ++numCompiled;
+        return ds_render::ProgramHandle(numCompiled + numCreatedFromBinary, 0,
+                                        0);
+    }
+    virtual bool GetProgramBinary(ds_render::ProgramHandle programHandle,
+                                  std::vector<char> *binary) const
+    {
+        binary->assign(1024, 0);
+        return true;
+    }
+    virtual ds_render::ProgramHandle
+    CreateProgramFromBinary(size_t numBytes, const void *binary)
+    {
+        ++numCreatedFromBinary;
+        return ds_render::ProgramHandle(numCompiled + numCreatedFromBinary, 0,
+                                        0);
+    }
+
+    size_t numCompiled;
+    size_t numCreatedFromBinary;
+};
+}
+
+// Loading the given number of materials, using 10 different shader resources
+// between them, as a level load does. Counters are the programs compiled and
+// created from binaries per load.
+
+/**
+ * Shaders of the given shader resource of a material.
+ */
+static std::vector<ds_render::ProgramCache::ShaderSource>
+ProgramCacheBenchmarkSources(int shaderResource)
+{
+    std::stringstream fragmentSource;
+    fragmentSource << "out vec4 colour; void main() { colour = vec4("
+                   << shaderResource << ".0); }";
+
+    std::vector<ds_render::ProgramCache::ShaderSource> shaderSources(2);
+    shaderSources[0].type = ds_render::ShaderType::VertexShader;
+    shaderSources[0].source = std::string(4096, ' ') + "void main() {}";
+    shaderSources[1].type = ds_render::ShaderType::FragmentShader;
+    shaderSources[1].source = fragmentSource.str();
+
+    return shaderSources;
+}
+
+// Each material compiles it's program, as materials were loaded before
+static void BM_ProgramsUncached(benchmark::State &state)
+{
+    mock_renderer::ProgramCountingRenderer renderer;
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            std::vector<ds_render::ProgramCache::ShaderSource> shaderSources =
+                ProgramCacheBenchmarkSources(i % 10);
+
+            std::vector<ds_render::ShaderHandle> shaders;
+            for (const auto &shaderSource : shaderSources)
+            {
+                shaders.push_back(renderer.CreateShaderObject(
+                    shaderSource.type, shaderSource.source.size(),
+                    shaderSource.source.c_str()));
+            }
+            benchmark::DoNotOptimize(renderer.CreateProgram(shaders));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["compiled"] = benchmark::Counter(
+        renderer.numCompiled, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ProgramsUncached)->Arg(100)->Arg(1000);
+
+// First run, programs are shared between materials but all compiled
+static void BM_ProgramCacheCold(benchmark::State &state)
+{
+    mock_renderer::ProgramCountingRenderer renderer;
+
+    for (auto _ : state)
+    {
+        ds_render::ProgramCache cache;
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            benchmark::DoNotOptimize(cache.GetProgram(
+                &renderer, ProgramCacheBenchmarkSources(i % 10)));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["compiled"] = benchmark::Counter(
+        renderer.numCompiled, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ProgramCacheCold)->Arg(100)->Arg(1000);
+
+// Later runs, the binaries saved by the first are loaded and programs are
+// created from them, loading the file is part of the run
+static void BM_ProgramCacheWarm(benchmark::State &state)
+{
+    const char *filePath = "ProgramCacheBenchmark.bin";
+
+    mock_renderer::ProgramCountingRenderer renderer;
+    ds_render::ProgramCache coldCache;
+    for (int i = 0; i < 10; ++i)
+    {
+        coldCache.GetProgram(&renderer, ProgramCacheBenchmarkSources(i));
+    }
+    coldCache.SaveBinaries(filePath);
+    renderer.numCompiled = 0;
+
+    for (auto _ : state)
+    {
+        ds_render::ProgramCache cache;
+        cache.LoadBinaries(filePath);
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            benchmark::DoNotOptimize(cache.GetProgram(
+                &renderer, ProgramCacheBenchmarkSources(i % 10)));
+        }
+    }
+
+    std::remove(filePath);
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["compiled"] = benchmark::Counter(
+        renderer.numCompiled, benchmark::Counter::kAvgIterations);
+    state.counters["fromBinary"] = benchmark::Counter(
+        renderer.numCreatedFromBinary, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ProgramCacheWarm)->Arg(100)->Arg(1000);
@@ -0,0 +1,423 @@
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "engine/system/render/RenderQueue.h"
+
+/**
+ * Renderer that draws nothing and counts the calls made to it, so the state
+ * changes of a frame can be compared without a graphics context.
+ */
+namespace mock_renderer
+{
+class CountingRenderer : public ds_render::IRenderer
+{
+public:
+    CountingRenderer()
+    {
+        numSetProgram = 0;
+        numBindTexture = 0;
+        numUnbindTexture = 0;
+        numUpdateConstantBuffer = 0;
+        numBytesUploaded = 0;
+        numBindConstantBufferRange = 0;
+        numDraw = 0;
+        numInstances = 0;
+    }
+
+    virtual bool Init(unsigned int viewportWidth, unsigned int viewportHeight)
+    {
+        return true;
+    }
+    virtual void SetClearColour(float r, float g, float b, float a)
+    {
+    }
+    virtual void ClearBuffers(bool colour, bool depth, bool stencil)
+    {
+    }
+    virtual void ResizeViewport(unsigned int newViewportWidth,
+                                unsigned int newViewportHeight)
+    {
+    }
+    virtual ds_render::VertexBufferHandle
+    CreateVertexBuffer(ds_render::BufferUsageType usage,
+                       const ds_render::VertexBufferDescription &description,
+                       size_t numBytes,
+                       const void *data)
+    {
+        return ds_render::VertexBufferHandle();
+    }
+    virtual ds_render::IndexBufferHandle
+    CreateIndexBuffer(ds_render::BufferUsageType usage,
+                      size_t numBytes,
+                      const void *data)
+    {
+        return ds_render::IndexBufferHandle();
+    }
+    virtual ds_render::ShaderHandle
+    CreateShaderObject(ds_render::ShaderType shaderType,
+                       size_t shaderSourceSize,
+                       const char *shaderSource)
+    {
+        return ds_render::ShaderHandle();
+    }
+    virtual ds_render::ProgramHandle
+    CreateProgram(const std::vector<ds_render::ShaderHandle> &shaders)
+    {
+        return ds_render::ProgramHandle();
+    }
+    virtual bool GetProgramBinary(ds_render::ProgramHandle programHandle,
+                                  std::vector<char> *binary) const
+    {
+        return false;
+    }
+    virtual ds_render::ProgramHandle
+    CreateProgramFromBinary(size_t numBytes, const void *binary)
+    {
+        return ds_render::ProgramHandle();
+    }
+    virtual void SetProgram(ds_render::ProgramHandle programHandle)
+    {
+        ++numSetProgram;
+    }
+    virtual ds_render::TextureHandle
+    Create2DTexture(ds_render::ImageFormat format,
+                    ds_render::RenderDataType imageDataType,
+                    ds_render::InternalImageFormat internalFormat,
+                    bool generateMipMaps,
+                    unsigned int width,
+                    unsigned int height,
+                    const void *data)
+    {
+        return ds_render::TextureHandle();
+    }
+    virtual void BindTextureToSampler(ds_render::ProgramHandle programHandle,
+                                      const std::string &samplerName,
+                                      ds_render::TextureHandle textureHandle)
+    {
+        ++numBindTexture;
+    }
+    virtual void
+    UnbindTextureFromSampler(ds_render::TextureHandle textureHandle)
+    {
+        ++numUnbindTexture;
+    }
+    virtual void GetConstantBufferDescription(
+        ds_render::ProgramHandle programHandle,
+        const std::string &constantBufferName,
+        ds_render::ConstantBufferDescription *constantBufferDescription)
+    {
+    }
+    virtual ds_render::ConstantBufferHandle CreateConstantBuffer(
+        const ds_render::ConstantBufferDescription &constantBufferDescription)
+    {
+        return ds_render::ConstantBufferHandle();
+    }
+    virtual void
+    BindConstantBuffer(ds_render::ProgramHandle programHandle,
+                       const std::string &constantBufferName,
+                       ds_render::ConstantBufferHandle constantBufferHandle)
+    {
+    }
+    virtual void UpdateConstantBufferData(
+        ds_render::ConstantBufferHandle constantBufferHandle,
+        const ds_render::ConstantBufferDescription &constantBufferDescription)
+    {
+        ++numUpdateConstantBuffer;
+        numBytesUploaded += constantBufferDescription.GetBufferSize();
+    }
+    virtual void UpdateConstantBufferSubData(
+        ds_render::ConstantBufferHandle constantBufferHandle,
+        const ds_render::ConstantBufferDescription &constantBufferDescription,
+        size_t offset,
+        size_t numBytes)
+    {
+        ++numUpdateConstantBuffer;
+        numBytesUploaded += numBytes;
+    }
+    virtual ds_render::ConstantBufferHandle
+    CreateStreamingConstantBuffer(size_t numBytes)
+    {
+        return ds_render::ConstantBufferHandle();
+    }
+    virtual size_t GetConstantBufferOffsetAlignment() const
+    {
+        return 256;
+    }
+    virtual bool
+    WriteStreamingConstantBuffer(ds_render::ConstantBufferHandle handle,
+                                 size_t numBytes,
+                                 const void *data,
+                                 size_t *offset)
+    {
+        *offset = 0;
+        ++numUpdateConstantBuffer;
+        numBytesUploaded += numBytes;
+
+        return true;
+    }
+    virtual void BindConstantBufferRange(ds_render::ConstantBufferHandle handle,
+                                         size_t offset,
+                                         size_t numBytes)
+    {
+        ++numBindConstantBufferRange;
+    }
+    virtual void DrawVertices(ds_render::VertexBufferHandle buffer,
+                              ds_render::PrimitiveType primitiveType,
+                              size_t startingVertex,
+                              size_t numVertices)
+    {
+        ++numDraw;
+    }
+    virtual void DrawVerticesIndexed(ds_render::VertexBufferHandle buffer,
+                                     ds_render::IndexBufferHandle indexBuffer,
+                                     ds_render::PrimitiveType primitiveType,
+                                     size_t startingIndex,
+                                     size_t numIndices)
+    {
+        ++numDraw;
+        ++numInstances;
+    }
+    virtual void
+    DrawVerticesIndexedInstanced(ds_render::VertexBufferHandle buffer,
+                                 ds_render::IndexBufferHandle indexBuffer,
+                                 ds_render::PrimitiveType primitiveType,
+                                 size_t startingIndex,
+                                 size_t numIndices,
+                                 size_t numInstances)
+    {
+        ++numDraw;
+        this->numInstances += numInstances;
+    }
+
+    unsigned int numSetProgram;
+    unsigned int numBindTexture;
+    unsigned int numUnbindTexture;
+    unsigned int numUpdateConstantBuffer;
+    size_t numBytesUploaded;
+    unsigned int numBindConstantBufferRange;
+    unsigned int numDraw;
+    unsigned int numInstances;
+};
+}
+
+/**
+ * Scene of objects drawn with a few materials and meshes, in component order.
+ * Materials use one of 5 programs and 2 textures each.
+ */
+struct RenderQueueBenchmarkScene
+{
+    RenderQueueBenchmarkScene(size_t numObjects,
+                              unsigned int numMaterials,
+                              unsigned int numMeshes,
+                              bool instanced = false)
+        : objectBufferDescription(sizeof(ds_math::Matrix4)),
+          instanceBufferDescription(
+              ds_render::RenderQueue::MaxInstancesPerDraw *
+              sizeof(ds_math::Matrix4))
+    {
+        for (unsigned int i = 0; i < numMaterials; ++i)
+        {
+            ds_render::Material material;
+            material.SetProgram(ds_render::ProgramHandle(i % 5, 0, 0));
+            material.SetInstanced(instanced);
+            material.AddTexture("diffuse", ds_render::Texture(
+                                               ds_render::TextureHandle(
+                                                   2 * i, 0, 0)));
+            material.AddTexture("normal", ds_render::Texture(
+                                              ds_render::TextureHandle(
+                                                  2 * i + 1, 0, 0)));
+            materials.push_back(material);
+        }
+
+        for (unsigned int i = 0; i < numMeshes; ++i)
+        {
+            meshes.push_back(ds_render::Mesh(
+                ds_render::VertexBufferHandle(i, 0, 0),
+                ds_render::IndexBufferHandle(i, 0, 0), 0, 36,
+                ds_math::AABB()));
+        }
+
+        // Objects spawned in no particular order, as a level would
+        for (size_t i = 0; i < numObjects; ++i)
+        {
+            objectMaterials.push_back((i * 7) % numMaterials);
+            objectMeshes.push_back((i * 3) % numMeshes);
+            worldTransforms.push_back(ds_math::Matrix4::CreateTranslationMatrix(
+                (float)(i % 100), 0.0f, -(float)(i / 100)));
+            depths.push_back((float)((i * 13) % numObjects) / numObjects);
+        }
+
+        objectBufferDescription.AddMember("Object.modelMatrix");
+        objectBufferDescription.SetMemberOffset("Object.modelMatrix", 0);
+        instanceBufferDescription.AddMember("Instances.modelMatrices");
+        instanceBufferDescription.SetMemberOffset("Instances.modelMatrices", 0);
+    }
+
+    std::vector<ds_render::Material> materials;
+    std::vector<ds_render::Mesh> meshes;
+    std::vector<unsigned int> objectMaterials;
+    std::vector<unsigned int> objectMeshes;
+    std::vector<ds_math::Matrix4> worldTransforms;
+    std::vector<float> depths;
+    ds_render::ConstantBufferDescription objectBufferDescription;
+    ds_render::ConstantBufferDescription instanceBufferDescription;
+};
+
+/**
+ * Report the calls made to the renderer in the last iteration.
+ */
+static void
+RenderQueueBenchmarkCounters(benchmark::State &state,
+                             const mock_renderer::CountingRenderer &renderer)
+{
+    state.counters["draws"] = renderer.numDraw;
+    state.counters["programs"] = renderer.numSetProgram;
+    state.counters["textureBinds"] = renderer.numBindTexture;
+    state.counters["textureUnbinds"] = renderer.numUnbindTexture;
+    state.counters["bufferUpdates"] = renderer.numUpdateConstantBuffer;
+    state.counters["bytesUploaded"] = renderer.numBytesUploaded;
+    state.counters["rangeBinds"] = renderer.numBindConstantBufferRange;
+}
+
+// 10000 objects sharing 20 materials and 10 meshes, drawn one at a time in
+// component order, setting every object's program and textures as
+// Render::RenderScene did before the render queue.
+static void BM_RenderComponentOrder(benchmark::State &state)
+{
+    RenderQueueBenchmarkScene scene(state.range(0), 20, 10);
+    mock_renderer::CountingRenderer renderer;
+
+    for (auto _ : state)
+    {
+        renderer = mock_renderer::CountingRenderer();
+
+        for (size_t i = 0; i < scene.objectMaterials.size(); ++i)
+        {
+            const ds_render::Material &material =
+                scene.materials[scene.objectMaterials[i]];
+            const ds_render::Mesh &mesh = scene.meshes[scene.objectMeshes[i]];
+
+            scene.objectBufferDescription.InsertMemberData(
+                "Object.modelMatrix", sizeof(ds_math::Matrix4),
+                &scene.worldTransforms[i]);
+            renderer.UpdateConstantBufferData(ds_render::ConstantBufferHandle(),
+                                              scene.objectBufferDescription);
+
+            renderer.SetProgram(material.GetProgram());
+            for (auto samplerTexture : material.GetTextures())
+            {
+                renderer.BindTextureToSampler(
+                    material.GetProgram(), samplerTexture.first,
+                    samplerTexture.second.GetTextureHandle());
+            }
+
+            renderer.DrawVerticesIndexed(
+                mesh.GetVertexBuffer(), mesh.GetIndexBuffer(),
+                ds_render::PrimitiveType::TriangleStrip,
+                mesh.GetStartingIndex(), mesh.GetNumIndices());
+
+            for (auto samplerTexture : material.GetTextures())
+            {
+                renderer.UnbindTextureFromSampler(
+                    samplerTexture.second.GetTextureHandle());
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    RenderQueueBenchmarkCounters(state, renderer);
+}
+BENCHMARK(BM_RenderComponentOrder)->Arg(10000);
+
+// Same scene through the render queue: keys are built, radix sorted and only
+// state changes are sent to the renderer. Every transform of the frame is
+// streamed with one write, each draw binding it's range.
+static void BM_RenderQueueSorted(benchmark::State &state)
+{
+    RenderQueueBenchmarkScene scene(state.range(0), 20, 10);
+    mock_renderer::CountingRenderer renderer;
+    ds_render::RenderQueue queue;
+    queue.SetObjectBuffer(ds_render::ConstantBufferHandle(),
+                          &scene.objectBufferDescription);
+    ds_render::RenderQueueStatistics statistics;
+
+    for (auto _ : state)
+    {
+        renderer = mock_renderer::CountingRenderer();
+
+        queue.Clear();
+        for (size_t i = 0; i < scene.objectMaterials.size(); ++i)
+        {
+            queue.Push(&scene.materials[scene.objectMaterials[i]],
+                       &scene.meshes[scene.objectMeshes[i]],
+                       &scene.worldTransforms[i], scene.depths[i]);
+        }
+        queue.Sort();
+        statistics = queue.Submit(&renderer);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    RenderQueueBenchmarkCounters(state, renderer);
+    state.counters["meshChanges"] = statistics.numMeshChanges;
+}
+BENCHMARK(BM_RenderQueueSorted)->Arg(10000);
+
+// Same scene with instanced materials: the copies of each mesh sharing a
+// material are drawn together, their transforms streamed with the rest of the
+// frame's.
+static void BM_RenderQueueInstanced(benchmark::State &state)
+{
+    RenderQueueBenchmarkScene scene(state.range(0), 20, 10, true);
+    mock_renderer::CountingRenderer renderer;
+    ds_render::RenderQueue queue;
+    queue.SetObjectBuffer(ds_render::ConstantBufferHandle(),
+                          &scene.objectBufferDescription);
+    queue.SetInstanceBuffer(ds_render::ConstantBufferHandle(),
+                            &scene.instanceBufferDescription);
+
+    for (auto _ : state)
+    {
+        renderer = mock_renderer::CountingRenderer();
+
+        queue.Clear();
+        for (size_t i = 0; i < scene.objectMaterials.size(); ++i)
+        {
+            queue.Push(&scene.materials[scene.objectMaterials[i]],
+                       &scene.meshes[scene.objectMeshes[i]],
+                       &scene.worldTransforms[i], scene.depths[i]);
+        }
+        queue.Sort();
+        queue.Submit(&renderer);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    RenderQueueBenchmarkCounters(state, renderer);
+    state.counters["instances"] = renderer.numInstances;
+}
+BENCHMARK(BM_RenderQueueInstanced)->Arg(10000);
+
+// Sorting alone, for keys already built.
+static void BM_RenderQueueSort(benchmark::State &state)
+{
+    RenderQueueBenchmarkScene scene(state.range(0), 20, 10);
+    ds_render::RenderQueue queue;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        queue.Clear();
+        for (size_t i = 0; i < scene.objectMaterials.size(); ++i)
+        {
+            queue.Push(&scene.materials[scene.objectMaterials[i]],
+                       &scene.meshes[scene.objectMeshes[i]],
+                       &scene.worldTransforms[i], scene.depths[i]);
+        }
+        state.ResumeTiming();
+
+        queue.Sort();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RenderQueueSort)->Arg(10000)->Arg(100000);
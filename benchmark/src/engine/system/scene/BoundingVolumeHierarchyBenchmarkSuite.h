@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "engine/system/scene/BoundingVolumeHierarchy.h"
+#include "math/MathHelper.h"
+
+// Compares the bounding volume hierarchy against testing every entity, for a
+// world of unit sized entities scattered over a 2000 x 100 x 2000 area around
+// the camera, and the cost of keeping the hierarchy up to date as they move.
+
+/**
+ * Create the boxes of the given number of entities.
+ */
+static std::vector<ds_math::AABB> CreateSceneBoxes(size_t count)
+{
+    srand(0);
+
+    std::vector<ds_math::AABB> boxes;
+    boxes.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        boxes.push_back(ds_math::AABB(
+            ds_math::Vector3(rand() % 2000 - 1000.0f, rand() % 100 - 50.0f,
+                             rand() % 2000 - 1000.0f),
+            ds_math::Vector3(0.5f, 0.5f, 0.5f)));
+    }
+
+    return boxes;
+}
+
+/**
+ * Create a hierarchy of the given boxes, the entity index being the position
+ * of the box.
+ */
+static void CreateSceneTree(const std::vector<ds_math::AABB> &boxes,
+                            ds::BoundingVolumeHierarchy *tree)
+{
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        ds::Entity entity;
+        entity.id = (uint32_t)i;
+
+        tree->Insert(entity, boxes[i]);
+    }
+    tree->Rebuild();
+}
+
+/**
+ * Frustum of a camera at the origin looking down -z, seeing 1000 units.
+ */
+static ds_math::Frustum CreateSceneFrustum()
+{
+    return ds_math::Frustum(ds_math::Matrix4::CreatePerspectiveFieldOfView(
+        ds_math::MathHelper::PI / 3.0f, 800.0f / 600.0f, 0.1f, 1000.0f));
+}
+
+// Moves the given percentage of entities each frame, then either refits
+// (arg 1 = 0) or rebuilds (arg 1 = 1) the hierarchy and finds the entities in
+// view. Entities move within a few units of where they started, so the
+// refitted hierarchy stays about as tight as a rebuilt one.
+static void BM_BoundingVolumeHierarchyUpdate(benchmark::State &state)
+{
+    const size_t count = 100000;
+    const size_t percentMoved = state.range(0);
+    const bool rebuild = (state.range(1) != 0);
+
+    const std::vector<ds_math::AABB> boxes = CreateSceneBoxes(count);
+    ds::BoundingVolumeHierarchy tree;
+    CreateSceneTree(boxes, &tree);
+    const ds_math::Frustum frustum = CreateSceneFrustum();
+
+    const size_t step = 100 / percentMoved;
+    std::vector<ds::Entity> visible;
+    float offset = 0.0f;
+    for (auto _ : state)
+    {
+        offset = (offset < 5.0f) ? offset + 1.0f : -5.0f;
+
+        for (size_t i = 0; i < count; i += step)
+        {
+            ds::Entity entity;
+            entity.id = (uint32_t)i;
+
+            tree.Update(entity, ds_math::AABB(boxes[i].center +
+                                                  ds_math::Vector3(offset, 0.0f,
+                                                                   offset),
+                                              boxes[i].extents));
+        }
+
+        if (rebuild)
+        {
+            tree.Rebuild();
+        }
+        else
+        {
+            tree.Refit();
+        }
+
+        visible.clear();
+        tree.QueryFrustum(frustum, &visible);
+        benchmark::DoNotOptimize(visible.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count / step);
+    state.counters["visible"] = visible.size();
+}
+BENCHMARK(BM_BoundingVolumeHierarchyUpdate)
+    ->Args({10, 0})
+    ->Args({10, 1})
+    ->Args({100, 0})
+    ->Args({100, 1});
+
+static void BM_BoundingVolumeHierarchyQueryFrustum(benchmark::State &state)
+{
+    const std::vector<ds_math::AABB> boxes = CreateSceneBoxes(state.range(0));
+    ds::BoundingVolumeHierarchy tree;
+    CreateSceneTree(boxes, &tree);
+    const ds_math::Frustum frustum = CreateSceneFrustum();
+
+    std::vector<ds::Entity> visible;
+    for (auto _ : state)
+    {
+        visible.clear();
+        tree.QueryFrustum(frustum, &visible);
+        benchmark::DoNotOptimize(visible.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * boxes.size());
+    state.counters["visible"] = visible.size();
+}
+BENCHMARK(BM_BoundingVolumeHierarchyQueryFrustum)->Arg(100000);
+
+static void BM_LinearQueryFrustum(benchmark::State &state)
+{
+    const std::vector<ds_math::AABB> boxes = CreateSceneBoxes(state.range(0));
+    const ds_math::Frustum frustum = CreateSceneFrustum();
+
+    std::vector<ds::Entity> visible;
+    for (auto _ : state)
+    {
+        visible.clear();
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            if (frustum.Intersects(boxes[i]))
+            {
+                ds::Entity entity;
+                entity.id = (uint32_t)i;
+                visible.push_back(entity);
+            }
+        }
+        benchmark::DoNotOptimize(visible.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * boxes.size());
+    state.counters["visible"] = visible.size();
+}
+BENCHMARK(BM_LinearQueryFrustum)->Arg(100000);
+
+// Proximity query of the kind gameplay code makes, e.g. finding everything
+// within 20 units of a character
+static void BM_BoundingVolumeHierarchyQueryRadius(benchmark::State &state)
+{
+    const std::vector<ds_math::AABB> boxes = CreateSceneBoxes(state.range(0));
+    ds::BoundingVolumeHierarchy tree;
+    CreateSceneTree(boxes, &tree);
+
+    std::vector<ds::Entity> found;
+    for (auto _ : state)
+    {
+        found.clear();
+        tree.QueryRadius(ds_math::Vector3(), 20.0f, &found);
+        benchmark::DoNotOptimize(found.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * boxes.size());
+    state.counters["found"] = found.size();
+}
+BENCHMARK(BM_BoundingVolumeHierarchyQueryRadius)->Arg(100000);
+
+static void BM_LinearQueryRadius(benchmark::State &state)
+{
+    const std::vector<ds_math::AABB> boxes = CreateSceneBoxes(state.range(0));
+
+    std::vector<ds::Entity> found;
+    for (auto _ : state)
+    {
+        found.clear();
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            // Distance from the origin to the nearest point in the box
+            const ds_math::AABB &box = boxes[i];
+            float dx = std::max(std::fabs(box.center.x) - box.extents.x, 0.0f);
+            float dy = std::max(std::fabs(box.center.y) - box.extents.y, 0.0f);
+            float dz = std::max(std::fabs(box.center.z) - box.extents.z, 0.0f);
+
+            if (dx * dx + dy * dy + dz * dz <= 20.0f * 20.0f)
+            {
+                ds::Entity entity;
+                entity.id = (uint32_t)i;
+                found.push_back(entity);
+            }
+        }
+        benchmark::DoNotOptimize(found.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * boxes.size());
+    state.counters["found"] = found.size();
+}
+BENCHMARK(BM_LinearQueryRadius)->Arg(100000);
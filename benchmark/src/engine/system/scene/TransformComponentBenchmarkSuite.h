@@ -0,0 +1,133 @@
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "engine/system/scene/TransformComponent.h"
+
+// Compares transform components stored as an array of structures against a
+// structure of arrays. Run with
+// --benchmark_perf_counters=CYCLES,CACHE-MISSES (requires Google Benchmark
+// built with libpfm) to also count cache misses.
+
+/**
+ * Fill the given storage with the given number of transform components.
+ */
+template <typename Storage>
+static void FillTransformStorage(Storage *storage, int numComponents)
+{
+    for (int i = 0; i < numComponents; ++i)
+    {
+        storage->PushBack();
+    }
+}
+
+/**
+ * Access the data members of components stored as an array of structures.
+ */
+struct AosTransformAccess
+{
+    typedef ds::AosComponentStorage<ds::TransformComponent> Storage;
+
+    static ds_math::Matrix4 &Local(Storage &s, size_t i)
+    {
+        return s[i].localTransform;
+    }
+    static ds_math::Matrix4 &World(Storage &s, size_t i)
+    {
+        return s[i].worldTransform;
+    }
+    static ds::Instance &Parent(Storage &s, size_t i)
+    {
+        return s[i].parent;
+    }
+};
+
+/**
+ * Access the data members of components stored as a structure of arrays.
+ */
+struct SoaTransformAccess
+{
+    typedef ds::ComponentStorage<ds::TransformComponent> Storage;
+
+    static ds_math::Matrix4 &Local(Storage &s, size_t i)
+    {
+        return s.localTransform[i];
+    }
+    static ds_math::Matrix4 &World(Storage &s, size_t i)
+    {
+        return s.worldTransform[i];
+    }
+    static ds::Instance &Parent(Storage &s, size_t i)
+    {
+        return s.parent[i];
+    }
+};
+
+// Gather the world transform of every component into a contiguous array, as
+// the renderer does each frame.
+template <typename Access>
+static void BM_TransformGatherWorld(benchmark::State &state)
+{
+    typename Access::Storage storage;
+    FillTransformStorage(&storage, state.range(0));
+
+    std::vector<ds_math::Matrix4> gathered(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            gathered[i] = Access::World(storage, i);
+        }
+        benchmark::DoNotOptimize(gathered.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_TransformGatherWorld, AosTransformAccess)
+    ->Arg(10000)
+    ->Arg(100000);
+BENCHMARK_TEMPLATE(BM_TransformGatherWorld, SoaTransformAccess)
+    ->Arg(10000)
+    ->Arg(100000);
+
+// Propagate transforms down a flat hierarchy (each component's parent comes
+// before it), touching only local, world and parent.
+template <typename Access>
+static void BM_TransformPropagate(benchmark::State &state)
+{
+    typename Access::Storage storage;
+    FillTransformStorage(&storage, state.range(0));
+    for (int i = 1; i < state.range(0); i += 2)
+    {
+        Access::Parent(storage, i) = ds::Instance::MakeInstance(i - 1);
+    }
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            const ds::Instance &parent = Access::Parent(storage, i);
+            if (parent.IsValid())
+            {
+                Access::World(storage, i) =
+                    Access::Local(storage, i) *
+                    Access::World(storage, parent.index);
+            }
+            else
+            {
+                Access::World(storage, i) = Access::Local(storage, i);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_TransformPropagate, AosTransformAccess)
+    ->Arg(10000)
+    ->Arg(100000);
+BENCHMARK_TEMPLATE(BM_TransformPropagate, SoaTransformAccess)
+    ->Arg(10000)
+    ->Arg(100000);
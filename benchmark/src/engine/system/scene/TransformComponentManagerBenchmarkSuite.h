@@ -0,0 +1,191 @@
+#include <memory>
+
+#include "benchmark/benchmark.h"
+
+#include "engine/system/scene/TransformComponentManager.h"
+
+// Shapes of hierarchy used by the transform component manager benchmarks
+enum TransformHierarchyShape
+{
+    // Each object is the only child of the one before it
+    TransformHierarchyShape_Deep,
+    // Every object has up to TransformHierarchyWideFanOut children
+    TransformHierarchyShape_Wide
+};
+
+// Number of children of each object in a wide hierarchy. Appending a child
+// walks it's siblings, so a single parent of every object would make building
+// the hierarchy quadratic.
+static const int TransformHierarchyWideFanOut = 100;
+
+/**
+ * Create the given number of transform components, linked into a hierarchy of
+ * the given shape.
+ */
+static void
+CreateTransformHierarchy(ds::TransformComponentManager *manager,
+                         int numComponents,
+                         TransformHierarchyShape shape)
+{
+    for (int i = 0; i < numComponents; ++i)
+    {
+        ds::Entity entity;
+        entity.id = i;
+
+        manager->CreateComponentForEntity(entity);
+    }
+
+    if (shape == TransformHierarchyShape_Deep)
+    {
+        // Link from the bottom up so that the parent is still a root when it
+        // is linked to, otherwise building the chain is quadratic
+        for (int i = numComponents - 1; i > 0; --i)
+        {
+            manager->SetParent(ds::Instance::MakeInstance(i),
+                               ds::Instance::MakeInstance(i - 1));
+        }
+    }
+    else
+    {
+        for (int i = 1; i < numComponents; ++i)
+        {
+            manager->SetParent(
+                ds::Instance::MakeInstance(i),
+                ds::Instance::MakeInstance((i - 1) /
+                                           TransformHierarchyWideFanOut));
+        }
+    }
+
+    manager->UpdateWorldTransforms();
+}
+
+/**
+ * Bytes stored per transform component across all of the storage arrays, the
+ * local transform, world and previous world transforms, links and flags.
+ */
+static size_t TransformComponentBytes()
+{
+    return sizeof(ds::LocalTransform) + 2 * sizeof(ds_math::Matrix4) +
+           4 * sizeof(ds::Instance) + sizeof(uint8_t);
+}
+
+// Set the local transform of every object then update world transforms once,
+// as when every object in the scene moves in a frame.
+static void BM_TransformManagerUpdateAll(benchmark::State &state)
+{
+    const int numComponents = state.range(0);
+    const TransformHierarchyShape shape =
+        (TransformHierarchyShape)state.range(1);
+
+    ds::TransformComponentManager manager;
+    CreateTransformHierarchy(&manager, numComponents, shape);
+
+    const ds_math::Matrix4 local =
+        ds_math::Matrix4::CreateTranslationMatrix(0.0f, 0.001f, 0.0f);
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < numComponents; ++i)
+        {
+            manager.SetLocalTransform(ds::Instance::MakeInstance(i), local);
+        }
+
+        manager.UpdateWorldTransforms();
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(shape == TransformHierarchyShape_Deep ? "deep" : "wide");
+    state.SetItemsProcessed(state.iterations() * numComponents);
+    state.counters["localBytes"] = sizeof(ds::LocalTransform);
+    state.counters["bytesPerNode"] = TransformComponentBytes();
+}
+BENCHMARK(BM_TransformManagerUpdateAll)
+    ->Args({100000, TransformHierarchyShape_Deep})
+    ->Args({100000, TransformHierarchyShape_Wide});
+
+// Move only the root then update world transforms, every descendant must
+// still be updated.
+static void BM_TransformManagerUpdateRoot(benchmark::State &state)
+{
+    const int numComponents = state.range(0);
+    const TransformHierarchyShape shape =
+        (TransformHierarchyShape)state.range(1);
+
+    ds::TransformComponentManager manager;
+    CreateTransformHierarchy(&manager, numComponents, shape);
+
+    const ds_math::Matrix4 local =
+        ds_math::Matrix4::CreateTranslationMatrix(0.0f, 0.001f, 0.0f);
+
+    for (auto _ : state)
+    {
+        manager.SetLocalTransform(ds::Instance::MakeInstance(0), local);
+
+        manager.UpdateWorldTransforms();
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(shape == TransformHierarchyShape_Deep ? "deep" : "wide");
+    state.SetItemsProcessed(state.iterations() * numComponents);
+}
+BENCHMARK(BM_TransformManagerUpdateRoot)
+    ->Args({100000, TransformHierarchyShape_Deep})
+    ->Args({100000, TransformHierarchyShape_Wide});
+
+// Update world transforms when nothing has changed, which should cost
+// nothing.
+static void BM_TransformManagerUpdateClean(benchmark::State &state)
+{
+    ds::TransformComponentManager manager;
+    CreateTransformHierarchy(&manager, state.range(0),
+                             TransformHierarchyShape_Wide);
+
+    for (auto _ : state)
+    {
+        manager.UpdateWorldTransforms();
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_TransformManagerUpdateClean)->Arg(100000);
+
+// Move the root of a wide hierarchy then update every world transform, split
+// across the given number of threads (including the calling thread).
+static void BM_TransformManagerUpdateParallel(benchmark::State &state)
+{
+    const int numComponents = state.range(0);
+    const int numThreads = state.range(1);
+
+    ds::TransformComponentManager manager;
+    CreateTransformHierarchy(&manager, numComponents,
+                             TransformHierarchyShape_Wide);
+
+    // A single thread updates serially, without a thread pool
+    std::unique_ptr<ds_com::ThreadPool> threadPool;
+    if (numThreads > 1)
+    {
+        threadPool = std::unique_ptr<ds_com::ThreadPool>(
+            new ds_com::ThreadPool(numThreads - 1));
+    }
+    manager.SetThreadPool(threadPool.get());
+
+    const ds_math::Matrix4 local =
+        ds_math::Matrix4::CreateTranslationMatrix(0.0f, 0.001f, 0.0f);
+
+    for (auto _ : state)
+    {
+        manager.SetLocalTransform(ds::Instance::MakeInstance(0), local);
+
+        manager.UpdateWorldTransforms();
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numComponents);
+}
+BENCHMARK(BM_TransformManagerUpdateParallel)
+    ->ArgNames({"transforms", "threads"})
+    ->Args({1000000, 1})
+    ->Args({1000000, 2})
+    ->Args({1000000, 4})
+    ->Args({1000000, 8})
+    ->Args({1000000, 16})
+    ->UseRealTime();
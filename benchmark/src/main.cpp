@@ -0,0 +1,18 @@
+#include "benchmark/benchmark.h"
+
+#include "engine/common/HandleManagerBenchmarkSuite.h"
+#include "engine/common/StreamBufferBenchmarkSuite.h"
+#include "engine/system/render/CommandBufferBenchmarkSuite.h"
+#include "engine/system/render/ConstantBufferDescriptionBenchmarkSuite.h"
+#include "engine/system/render/GLRendererBenchmarkSuite.h"
+#include "engine/system/render/ProgramCacheBenchmarkSuite.h"
+#include "engine/system/render/RenderQueueBenchmarkSuite.h"
+#include "engine/system/scene/BoundingVolumeHierarchyBenchmarkSuite.h"
+#include "engine/system/scene/TransformComponentBenchmarkSuite.h"
+#include "engine/system/scene/TransformComponentManagerBenchmarkSuite.h"
+#include "math/BatchBenchmarkSuite.h"
+#include "math/FrustumBenchmarkSuite.h"
+#include "math/Matrix4BenchmarkSuite.h"
+#include "math/QuaternionBenchmarkSuite.h"
+
+BENCHMARK_MAIN();
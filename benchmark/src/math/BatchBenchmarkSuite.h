@@ -0,0 +1,237 @@
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "engine/common/ThreadPool.h"
+#include "math/Batch.h"
+
+// Compares the batched math operations against looping over the single
+// element operations.
+
+/**
+ * Create the given number of points spread along the axes.
+ */
+static std::vector<ds_math::Vector3> CreateBatchBenchmarkPoints(size_t count)
+{
+    std::vector<ds_math::Vector3> points;
+    points.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        points.push_back(ds_math::Vector3(i * 0.5f, i * -0.25f, i * 2.0f));
+    }
+
+    return points;
+}
+
+static void BM_TransformPointsLoop(benchmark::State &state)
+{
+    const size_t count = state.range(0);
+    std::vector<ds_math::Vector3> points = CreateBatchBenchmarkPoints(count);
+    std::vector<ds_math::Vector3> result(count);
+    ds_math::Matrix4 mat =
+        ds_math::Matrix4::CreateTranslationMatrix(1.0f, 2.0f, 3.0f);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            ds_math::Vector4 transformed =
+                mat * ds_math::Vector4(points[i], 1.0f);
+            result[i] =
+                ds_math::Vector3(transformed.x, transformed.y, transformed.z);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TransformPointsLoop)->Arg(1 << 16);
+
+static void BM_TransformPointsBatch(benchmark::State &state)
+{
+    const size_t count = state.range(0);
+    std::vector<ds_math::Vector3> points = CreateBatchBenchmarkPoints(count);
+    std::vector<ds_math::Vector3> result(count);
+    ds_math::Matrix4 mat =
+        ds_math::Matrix4::CreateTranslationMatrix(1.0f, 2.0f, 3.0f);
+
+    for (auto _ : state)
+    {
+        ds_math::Batch::TransformPoints(mat, points.data(), result.data(),
+                                        count);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TransformPointsBatch)->Arg(1 << 16);
+
+// Split a large batch across the given number of threads (including the
+// calling thread).
+static void BM_TransformPointsBatchParallel(benchmark::State &state)
+{
+    const size_t count = state.range(0);
+    const int numThreads = state.range(1);
+    std::vector<ds_math::Vector3> points = CreateBatchBenchmarkPoints(count);
+    std::vector<ds_math::Vector3> result(count);
+    ds_math::Matrix4 mat =
+        ds_math::Matrix4::CreateTranslationMatrix(1.0f, 2.0f, 3.0f);
+
+    ds_com::ThreadPool threadPool(numThreads - 1);
+
+    for (auto _ : state)
+    {
+        threadPool.ParallelFor(0, count, 4096,
+                               [&](size_t begin, size_t end)
+                               {
+                                   ds_math::Batch::TransformPoints(
+                                       mat, points.data() + begin,
+                                       result.data() + begin, end - begin);
+                               });
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TransformPointsBatchParallel)
+    ->ArgNames({"points", "threads"})
+    ->Args({1 << 20, 1})
+    ->Args({1 << 20, 2})
+    ->Args({1 << 20, 4})
+    ->Args({1 << 20, 8})
+    ->UseRealTime();
+
+static void BM_CreateFromQuaternionsLoop(benchmark::State &state)
+{
+    const size_t count = state.range(0);
+    std::vector<ds_math::Quaternion> quaternions(
+        count, ds_math::Quaternion::Normalize(
+                   ds_math::Quaternion(0.2f, 0.5f, -0.3f, 0.8f)));
+    std::vector<ds_math::Matrix4> result(count);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            result[i] = ds_math::Matrix4::CreateFromQuaternion(quaternions[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CreateFromQuaternionsLoop)->Arg(1 << 16);
+
+static void BM_CreateFromQuaternionsBatch(benchmark::State &state)
+{
+    const size_t count = state.range(0);
+    std::vector<ds_math::Quaternion> quaternions(
+        count, ds_math::Quaternion::Normalize(
+                   ds_math::Quaternion(0.2f, 0.5f, -0.3f, 0.8f)));
+    std::vector<ds_math::Matrix4> result(count);
+
+    for (auto _ : state)
+    {
+        ds_math::Batch::CreateFromQuaternions(quaternions.data(),
+                                              result.data(), count);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CreateFromQuaternionsBatch)->Arg(1 << 16);
+
+static void BM_MultiplyLoop(benchmark::State &state)
+{
+    const size_t count = state.range(0);
+    std::vector<ds_math::Matrix4> m1(
+        count, ds_math::Matrix4::CreateTranslationMatrix(1.0f, 2.0f, 3.0f));
+    std::vector<ds_math::Matrix4> m2(
+        count, ds_math::Matrix4::CreateScaleMatrix(1.0f, 2.0f, 3.0f));
+    std::vector<ds_math::Matrix4> result(count);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            result[i] = m1[i] * m2[i];
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_MultiplyLoop)->Arg(1 << 16);
+
+static void BM_MultiplyBatch(benchmark::State &state)
+{
+    const size_t count = state.range(0);
+    std::vector<ds_math::Matrix4> m1(
+        count, ds_math::Matrix4::CreateTranslationMatrix(1.0f, 2.0f, 3.0f));
+    std::vector<ds_math::Matrix4> m2(
+        count, ds_math::Matrix4::CreateScaleMatrix(1.0f, 2.0f, 3.0f));
+    std::vector<ds_math::Matrix4> result(count);
+
+    for (auto _ : state)
+    {
+        ds_math::Batch::Multiply(m1.data(), m2.data(), result.data(), count);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_MultiplyBatch)->Arg(1 << 16);
+
+static void BM_NormalizeQuaternionsBatch(benchmark::State &state)
+{
+    const size_t count = state.range(0);
+    ds_math::NormalizePrecision precision =
+        (state.range(1) == 0) ? ds_math::NormalizePrecision::Exact
+                              : ds_math::NormalizePrecision::Fast;
+    std::vector<ds_math::Quaternion> quaternions(
+        count, ds_math::Quaternion(0.2f, 0.5f, -0.3f, 0.8f));
+    std::vector<ds_math::Quaternion> result(count);
+
+    for (auto _ : state)
+    {
+        ds_math::Batch::Normalize(quaternions.data(), result.data(), count,
+                                  precision);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_NormalizeQuaternionsBatch)
+    ->ArgNames({"quaternions", "fast"})
+    ->Args({1 << 16, 0})
+    ->Args({1 << 16, 1});
+
+static void BM_NlerpBatch(benchmark::State &state)
+{
+    const size_t count = state.range(0);
+    ds_math::NormalizePrecision precision =
+        (state.range(1) == 0) ? ds_math::NormalizePrecision::Exact
+                              : ds_math::NormalizePrecision::Fast;
+    std::vector<ds_math::Quaternion> from(
+        count, ds_math::Quaternion::Normalize(
+                   ds_math::Quaternion(0.2f, 0.5f, -0.3f, 0.8f)));
+    std::vector<ds_math::Quaternion> to(
+        count, ds_math::Quaternion::Normalize(
+                   ds_math::Quaternion(-0.6f, 0.1f, 0.4f, 0.2f)));
+    std::vector<ds_math::Quaternion> result(count);
+
+    for (auto _ : state)
+    {
+        ds_math::Batch::Nlerp(from.data(), to.data(), 0.3f, result.data(),
+                              count, precision);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_NlerpBatch)
+    ->ArgNames({"quaternions", "fast"})
+    ->Args({1 << 16, 0})
+    ->Args({1 << 16, 1});
@@ -0,0 +1,56 @@
+#include <cmath>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "math/Frustum.h"
+#include "math/MathHelper.h"
+
+// Culls a field of objects spread around the camera, as Render::RenderScene
+// does: each object's model space bounds are tested against the frustum after
+// being transformed by its world transform.
+
+static void BM_FrustumCull(benchmark::State &state)
+{
+    const size_t count = state.range(0);
+
+    // Grid of unit cubes on the xz plane centered on the camera, about a
+    // sixth of which are in view
+    ds_math::AABB bounds(ds_math::Vector3(),
+                         ds_math::Vector3(0.5f, 0.5f, 0.5f));
+    std::vector<ds_math::Matrix4> worldTransforms;
+    worldTransforms.reserve(count);
+    const size_t side = (size_t)sqrt((double)count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        worldTransforms.push_back(ds_math::Matrix4::CreateTranslationMatrix(
+            ((float)(i % side) - side / 2.0f) * 2.0f, 0.0f,
+            ((float)(i / side) - side / 2.0f) * 2.0f));
+    }
+
+    ds_math::Matrix4 view = ds_math::Matrix4(1.0f);
+    ds_math::Matrix4 projection =
+        ds_math::Matrix4::CreatePerspectiveFieldOfView(
+            ds_math::MathHelper::PI / 3.0f, 800.0f / 600.0f, 0.1f, 1000.0f);
+
+    size_t numVisible = 0;
+    for (auto _ : state)
+    {
+        ds_math::Frustum frustum(projection * view);
+
+        numVisible = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (frustum.Intersects(bounds, worldTransforms[i]))
+            {
+                ++numVisible;
+            }
+        }
+        benchmark::DoNotOptimize(numVisible);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["visible"] = numVisible;
+    state.counters["culled"] = count - numVisible;
+}
+BENCHMARK(BM_FrustumCull)->Arg(100000);
@@ -0,0 +1,132 @@
+#include "benchmark/benchmark.h"
+
+#include "math/Matrix4.h"
+
+/**
+ * Create an affine transform made of a translation, rotation and scale.
+ */
+static ds_math::Matrix4 CreateBenchmarkTransform(float seed)
+{
+    return ds_math::Matrix4::CreateTranslationMatrix(seed, 2.0f, -seed) *
+           ds_math::Matrix4::CreateFromQuaternion(
+               ds_math::Quaternion::Normalize(
+                   ds_math::Quaternion(0.2f, seed, -0.3f, 0.8f))) *
+           ds_math::Matrix4::CreateScaleMatrix(2.0f, 0.5f, seed);
+}
+
+static void BM_Matrix4Multiply(benchmark::State &state)
+{
+    ds_math::Matrix4 m1 = CreateBenchmarkTransform(1.5f);
+    ds_math::Matrix4 m2 = CreateBenchmarkTransform(0.5f);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(m1);
+        benchmark::DoNotOptimize(m2);
+        ds_math::Matrix4 result = m1 * m2;
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_Matrix4Multiply);
+
+static void BM_Matrix4AffineMultiply(benchmark::State &state)
+{
+    ds_math::Matrix4 m1 = CreateBenchmarkTransform(1.5f);
+    ds_math::Matrix4 m2 = CreateBenchmarkTransform(0.5f);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(m1);
+        benchmark::DoNotOptimize(m2);
+        ds_math::Matrix4 result = ds_math::Matrix4::AffineMultiply(m1, m2);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_Matrix4AffineMultiply);
+
+static void BM_Matrix4Inverse(benchmark::State &state)
+{
+    ds_math::Matrix4 mat = CreateBenchmarkTransform(1.5f);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mat);
+        ds_math::Matrix4 result = ds_math::Matrix4::Inverse(mat);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_Matrix4Inverse);
+
+static void BM_Matrix4AffineInverse(benchmark::State &state)
+{
+    ds_math::Matrix4 mat = CreateBenchmarkTransform(1.5f);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mat);
+        ds_math::Matrix4 result = ds_math::Matrix4::AffineInverse(mat);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_Matrix4AffineInverse);
+
+// Kernels below use SSE unless built with DS_MATH_SIMD=OFF, build both ways to
+// compare.
+
+static void BM_Matrix4Transpose(benchmark::State &state)
+{
+    ds_math::Matrix4 mat = CreateBenchmarkTransform(1.5f);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mat);
+        ds_math::Matrix4 result = ds_math::Matrix4::Transpose(mat);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_Matrix4Transpose);
+
+static void BM_Matrix4MultiplyVector4(benchmark::State &state)
+{
+    ds_math::Matrix4 mat = CreateBenchmarkTransform(1.5f);
+    ds_math::Vector4 vec(1.0f, -2.0f, 3.0f, 1.0f);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mat);
+        benchmark::DoNotOptimize(vec);
+        ds_math::Vector4 result = mat * vec;
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_Matrix4MultiplyVector4);
+
+static void BM_Matrix4CreateFromQuaternion(benchmark::State &state)
+{
+    ds_math::Quaternion quaternion = ds_math::Quaternion::Normalize(
+        ds_math::Quaternion(0.2f, 0.5f, -0.3f, 0.8f));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(quaternion);
+        ds_math::Matrix4 result =
+            ds_math::Matrix4::CreateFromQuaternion(quaternion);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_Matrix4CreateFromQuaternion);
+
+static void BM_Vector4Dot(benchmark::State &state)
+{
+    ds_math::Vector4 v1(1.0f, -2.0f, 3.0f, 1.0f);
+    ds_math::Vector4 v2(0.5f, 4.0f, -1.0f, 2.0f);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(v1);
+        benchmark::DoNotOptimize(v2);
+        ds_math::scalar result = ds_math::Vector4::Dot(v1, v2);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_Vector4Dot);
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "math/Quaternion.h"
+
+// Normalization and interpolation over many orientations, as when animating
+// many entities. Benchmarks with a precision argument use the exact
+// normalization for 0 and the fast one for 1.
+
+/**
+ * Create the given number of unit quaternions, spread over the orientations.
+ */
+static std::vector<ds_math::Quaternion>
+CreateQuaternionBenchmarkOrientations(size_t count, float seed)
+{
+    std::vector<ds_math::Quaternion> orientations;
+    orientations.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        float angle = seed + i * 0.01f;
+        orientations.push_back(ds_math::Quaternion::Normalize(
+            ds_math::Quaternion(sin(angle), cos(angle * 3.0f), 0.5f,
+                                sin(angle * 7.0f))));
+    }
+
+    return orientations;
+}
+
+/**
+ * Get the precision selected by a benchmark argument.
+ */
+static ds_math::NormalizePrecision
+GetQuaternionBenchmarkPrecision(int64_t arg)
+{
+    return (arg == 0) ? ds_math::NormalizePrecision::Exact
+                      : ds_math::NormalizePrecision::Fast;
+}
+
+static void BM_QuaternionNormalize(benchmark::State &state)
+{
+    const size_t count = 1 << 16;
+    ds_math::NormalizePrecision precision =
+        GetQuaternionBenchmarkPrecision(state.range(0));
+    std::vector<ds_math::Quaternion> quaternions =
+        CreateQuaternionBenchmarkOrientations(count, 0.0f);
+    for (auto &q : quaternions)
+    {
+        q *= 3.0f;
+    }
+    std::vector<ds_math::Quaternion> result(count);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            result[i] = ds_math::Quaternion::Normalize(quaternions[i],
+                                                       precision);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_QuaternionNormalize)->ArgName("fast")->Arg(0)->Arg(1);
+
+static void BM_QuaternionNlerp(benchmark::State &state)
+{
+    const size_t count = 1 << 16;
+    ds_math::NormalizePrecision precision =
+        GetQuaternionBenchmarkPrecision(state.range(0));
+    std::vector<ds_math::Quaternion> from =
+        CreateQuaternionBenchmarkOrientations(count, 0.0f);
+    std::vector<ds_math::Quaternion> to =
+        CreateQuaternionBenchmarkOrientations(count, 2.0f);
+    std::vector<ds_math::Quaternion> result(count);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            result[i] =
+                ds_math::Quaternion::Nlerp(from[i], to[i], 0.3f, precision);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_QuaternionNlerp)->ArgName("fast")->Arg(0)->Arg(1);
+
+static void BM_QuaternionSlerp(benchmark::State &state)
+{
+    const size_t count = 1 << 16;
+    std::vector<ds_math::Quaternion> from =
+        CreateQuaternionBenchmarkOrientations(count, 0.0f);
+    std::vector<ds_math::Quaternion> to =
+        CreateQuaternionBenchmarkOrientations(count, 2.0f);
+    std::vector<ds_math::Quaternion> result(count);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            result[i] = ds_math::Quaternion::Slerp(from[i], to[i], 0.3f);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_QuaternionSlerp);
+
+// Reports the largest error in the magnitude of normalized quaternions,
+// compared in double precision.
+static void BM_QuaternionNormalizeAccuracy(benchmark::State &state)
+{
+    const size_t count = 1 << 16;
+    ds_math::NormalizePrecision precision =
+        GetQuaternionBenchmarkPrecision(state.range(0));
+    std::vector<ds_math::Quaternion> quaternions =
+        CreateQuaternionBenchmarkOrientations(count, 0.0f);
+    double maxError = 0.0;
+
+    for (auto _ : state)
+    {
+        maxError = 0.0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Magnitudes from 1e-3 to 1e3
+            ds_math::Quaternion q =
+                quaternions[i] * (float)pow(10.0, (i % 7) - 3.0);
+            ds_math::Quaternion n =
+                ds_math::Quaternion::Normalize(q, precision);
+
+            double magnitude = sqrt((double)n.x * n.x + (double)n.y * n.y +
+                                    (double)n.z * n.z + (double)n.w * n.w);
+            maxError = std::max(maxError, fabs(magnitude - 1.0));
+        }
+    }
+
+    state.counters["maxError"] = maxError;
+}
+BENCHMARK(BM_QuaternionNormalizeAccuracy)->ArgName("fast")->Arg(0)->Arg(1);
+
+// Reports the largest angle in radians between Nlerp and Slerp results over a
+// range of interpolation factors.
+static void BM_QuaternionNlerpAccuracy(benchmark::State &state)
+{
+    const size_t count = 1 << 12;
+    ds_math::NormalizePrecision precision =
+        GetQuaternionBenchmarkPrecision(state.range(0));
+    std::vector<ds_math::Quaternion> from =
+        CreateQuaternionBenchmarkOrientations(count, 0.0f);
+    std::vector<ds_math::Quaternion> to =
+        CreateQuaternionBenchmarkOrientations(count, 2.0f);
+    double maxError = 0.0;
+
+    for (auto _ : state)
+    {
+        maxError = 0.0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (float t = 0.0f; t <= 1.0f; t += 0.125f)
+            {
+                ds_math::Quaternion nlerp =
+                    ds_math::Quaternion::Nlerp(from[i], to[i], t, precision);
+                ds_math::Quaternion slerp =
+                    ds_math::Quaternion::Slerp(from[i], to[i], t);
+
+                double cosHalfAngle =
+                    fabs((double)ds_math::Quaternion::Dot(nlerp, slerp));
+                maxError = std::max(
+                    maxError, 2.0 * acos(std::min(cosHalfAngle, 1.0)));
+            }
+        }
+    }
+
+    state.counters["maxError"] = maxError;
+}
+BENCHMARK(BM_QuaternionNlerpAccuracy)->ArgName("fast")->Arg(0)->Arg(1);
@@ -21,6 +21,16 @@ else (NOT GTEST_FOUND)
 	set(GTEST_ROOT ${GTEST_INCLUDE_DIRS}/..)
 endif (NOT GTEST_FOUND)
 
+# Try to find Google Benchmark package
+set(BENCHMARK_ROOT ${CMAKE_SOURCE_DIR}/../../external/GoogleBenchmark)
+find_package(benchmark QUIET PATHS ${BENCHMARK_ROOT})
+# If not found, download
+if (NOT benchmark_FOUND)
+	message("Will download Google Benchmark...")
+	include(${CMAKE_SOURCE_DIR}/External-GoogleBenchmark.cmake)
+	list(APPEND DRUNKEN_SAILOR_ENGINE_DEPENDENCIES googlebenchmark)
+endif (NOT benchmark_FOUND)
+
 # Try to find Lua package
 set(LUA_DIR ${CMAKE_SOURCE_DIR}/../../external/Lua-5.3.2)
 find_package(LUA)
@@ -128,6 +138,7 @@ ExternalProject_Add(
     # Set variables for various packages to find
 		-DLUA_DIR:PATH=${LUA_DIR}
 		-DGTEST_ROOT:PATH=${GTEST_ROOT}
+		-DCMAKE_PREFIX_PATH:PATH=${BENCHMARK_ROOT}
     -DSDL2DIR=${SDL2DIR}
     -DRAPIDJSON_INCLUDEDIR=${RAPIDJSON_INCLUDEDIR}
     -DGLEW_DIR=${GLEW_DIR}
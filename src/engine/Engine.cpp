@@ -1,16 +1,84 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "engine/Engine.h"
 
 namespace ds
 {
+// Message types the engine handles itself
+static const std::vector<ds_msg::MessageType>
+    EngineMessageTypes(1, ds_msg::MessageType::QuitEvent);
+
 void Engine::Start()
 {
     if (Init())
     {
+        typedef std::chrono::steady_clock Clock;
+
         m_running = true;
 
+        const Clock::duration step =
+            std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(m_simulationStep));
+        const Clock::duration minFrameTime =
+            (m_frameRateLimit > 0)
+                ? std::chrono::duration_cast<Clock::duration>(
+                      std::chrono::duration<double>(1.0 / m_frameRateLimit))
+                : Clock::duration::zero();
+
+        // Time simulated systems are behind real time, start with one update
+        // due so the first frame has something to present.
+        Clock::duration accumulator = step;
+        Clock::time_point frameStart = Clock::now();
+
         while (m_running)
         {
-            Update(0.1f);
+            unsigned int numUpdates = 0;
+            while (accumulator >= step && numUpdates < m_maxUpdatesPerFrame &&
+                   m_running)
+            {
+                Update((float)m_simulationStep);
+
+                accumulator -= step;
+                ++numUpdates;
+            }
+
+            // Too far behind to catch up (i.e. after a stall), drop the
+            // backlog rather than spiralling.
+            if (accumulator >= step)
+            {
+                accumulator = Clock::duration::zero();
+            }
+
+            if (numUpdates > 0 || !m_idleSleep)
+            {
+                float interpolation = (float)((double)accumulator.count() /
+                                              (double)step.count());
+                for (auto &system : m_systems)
+                {
+                    system->Present(interpolation);
+                }
+            }
+
+            // Wait for the frame rate limit, or until the next update is due
+            // when idle.
+            Clock::time_point wakeTime = frameStart + minFrameTime;
+            if (numUpdates == 0 && m_idleSleep)
+            {
+                wakeTime =
+                    std::max(wakeTime, frameStart + (step - accumulator));
+            }
+            std::this_thread::sleep_until(wakeTime);
+
+            Clock::time_point frameEnd = Clock::now();
+            Clock::duration frameTime = frameEnd - frameStart;
+            frameStart = frameEnd;
+
+            accumulator += frameTime;
+            m_frameStatistics.AddFrameTime(
+                std::chrono::duration<double, std::milli>(frameTime).count());
         }
 
         Shutdown();
@@ -38,8 +106,16 @@ bool Engine::AddSystem(std::unique_ptr<ISystem> system)
     {
         m_systems.insert(it, sharedPtr);
 
-        // Also insert into message bus
+        // Also insert into message bus and scheduler
         m_messageBus.AddSystem(std::weak_ptr<ISystem>(sharedPtr));
+        m_scheduler.AddSystem(sharedPtr);
+
+        // Subscribe system to the messages it handles
+        for (auto messageType : sharedPtr->GetMessageSubscriptions())
+        {
+            m_messageBus.Subscribe(std::weak_ptr<ISystem>(sharedPtr),
+                                   messageType);
+        }
 
         result = true;
     }
@@ -47,6 +123,22 @@ bool Engine::AddSystem(std::unique_ptr<ISystem> system)
     return result;
 }
 
+bool Engine::AddSystemDependency(const ISystem *system,
+                                 const ISystem *dependency)
+{
+    return m_scheduler.AddDependency(system, dependency);
+}
+
+const std::vector<double> &Engine::GetSystemUpdateTimes() const
+{
+    return m_scheduler.GetSystemUpdateTimes();
+}
+
+const FrameStatistics &Engine::GetFrameStatistics() const
+{
+    return m_frameStatistics;
+}
+
 bool Engine::Init()
 {
     bool result = true;
@@ -69,6 +161,45 @@ bool Engine::Init()
     stream << header << configLoadMsg;
     PostMessages(stream);
 
+    // Number of threads to update systems on, besides the main thread.
+    // Default to one per hardware thread.
+    unsigned int numWorkerThreads = 0;
+    if (!config.GetUnsignedInt("Engine.workerThreads", &numWorkerThreads))
+    {
+        unsigned int numHardwareThreads = std::thread::hardware_concurrency();
+        numWorkerThreads =
+            (numHardwareThreads > 1) ? (numHardwareThreads - 1) : 0;
+    }
+    m_scheduler.SetNumWorkerThreads(numWorkerThreads);
+
+    // Frame timing
+    unsigned int simulationRate = 0;
+    if (!config.GetUnsignedInt("Engine.simulationRate", &simulationRate) ||
+        simulationRate == 0)
+    {
+        simulationRate = 60;
+    }
+    m_simulationStep = 1.0 / simulationRate;
+
+    if (!config.GetUnsignedInt("Engine.maxUpdatesPerFrame",
+                               &m_maxUpdatesPerFrame) ||
+        m_maxUpdatesPerFrame == 0)
+    {
+        m_maxUpdatesPerFrame = 5;
+    }
+
+    if (!config.GetUnsignedInt("Engine.frameRateLimit", &m_frameRateLimit))
+    {
+        m_frameRateLimit = 0;
+    }
+
+    if (!config.GetBool("Engine.idleSleep", &m_idleSleep))
+    {
+        m_idleSleep = false;
+    }
+
+    m_frameStatistics.Clear();
+
     // Initialize all systems
     for (auto &system : m_systems)
     {
@@ -88,8 +219,8 @@ void Engine::Update(float deltaTime)
     // first tick)
     m_messageBus.CollectAllMessages();
 
-    // Get any generated messages and give to the engine.
-    PostMessages(m_messageBus.CollectMessages());
+    // Get any generated messages the engine handles and give to the engine.
+    PostMessages(m_messageBus.CollectMessages(EngineMessageTypes));
 
     // Broadcast and purge messages
     m_messageBus.BroadcastAllMessages();
@@ -98,14 +229,14 @@ void Engine::Update(float deltaTime)
     ProcessMessages(&m_messagesInternal);
 
     // Update systems
-    for (auto &system : m_systems)
-    {
-        system->Update(deltaTime);
-    }
+    m_scheduler.Update(deltaTime);
 }
 
 void Engine::Shutdown()
 {
+    // Stop worker threads
+    m_scheduler.SetNumWorkerThreads(0);
+
     // Shutdown systems in reverse order
     for (auto it = m_systems.rbegin(); it != m_systems.rend(); ++it)
     {
@@ -2,6 +2,8 @@
 
 #include <memory>
 
+#include "engine/FrameStatistics.h"
+#include "engine/SystemScheduler.h"
 #include "engine/message/Message.h"
 #include "engine/message/MessageBus.h"
 #include "engine/system/ISystem.h"
@@ -22,6 +24,13 @@ public:
      * This method blocks until the engine receives an internal message to quit.
      * This message could, for example, be from the input system which sent the
      * quit message because a certain key was pressed.
+     *
+     * Systems are updated at a fixed timestep ("Engine.simulationRate" in
+     * updates per second), as many times per frame as needed to keep up with
+     * real time, and presented once per frame. Frames may be limited to
+     * "Engine.frameRateLimit" per second and, if "Engine.idleSleep" is set, the
+     * engine sleeps until the next update is due rather than presenting frames
+     * without any updates.
      */
     void Start();
 
@@ -42,6 +51,37 @@ public:
      */
     bool AddSystem(std::unique_ptr<ISystem> system);
 
+    /**
+     * Make a system depend on another system, the system will only be updated
+     * once the other system has finished updating each tick.
+     *
+     * Systems without dependencies between them may be updated concurrently.
+     * Both systems must have already been added to the engine.
+     *
+     * @param   system      const ISystem *, system that depends on the other.
+     * @param   dependency  const ISystem *, system depended on.
+     * @return              bool, TRUE if the dependency was added, FALSE if
+     * either system isn't in the engine or the dependency would create a
+     * cycle.
+     */
+    bool AddSystemDependency(const ISystem *system, const ISystem *dependency);
+
+    /**
+     * Get the time each system took to update during the last tick, in the
+     * order the systems were added.
+     *
+     * @return  const std::vector<double> &, update time of each system in
+     * milliseconds.
+     */
+    const std::vector<double> &GetSystemUpdateTimes() const;
+
+    /**
+     * Get statistics about the time taken by the most recent frames.
+     *
+     * @return  const FrameStatistics &, frame time statistics.
+     */
+    const FrameStatistics &GetFrameStatistics() const;
+
 private:
     /**
      * Initializes the engine and all it's systems.
@@ -107,5 +147,17 @@ private:
     ds_msg::MessageStream m_messagesInternal;
     // Systems managed by the engine
     std::vector<std::shared_ptr<ISystem>> m_systems;
+    // Updates systems, possibly concurrently
+    SystemScheduler m_scheduler;
+    // Times taken by the most recent frames
+    FrameStatistics m_frameStatistics;
+    // Fixed timestep systems are updated over, in seconds
+    double m_simulationStep;
+    // Maximum number of updates per frame before falling behind real time
+    unsigned int m_maxUpdatesPerFrame;
+    // Maximum number of frames per second, zero if unlimited
+    unsigned int m_frameRateLimit;
+    // Sleep until the next update is due rather than presenting idle frames?
+    bool m_idleSleep;
 };
 }
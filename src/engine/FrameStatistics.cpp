@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cmath>
+
+#include "engine/FrameStatistics.h"
+
+namespace ds
+{
+FrameStatistics::FrameStatistics(size_t numFrames)
+{
+    m_maxFrames = (numFrames > 0) ? numFrames : 1;
+    m_nextFrame = 0;
+
+    m_frameTimes.reserve(m_maxFrames);
+}
+
+void FrameStatistics::AddFrameTime(double frameTime)
+{
+    if (m_frameTimes.size() < m_maxFrames)
+    {
+        m_frameTimes.push_back(frameTime);
+    }
+    else
+    {
+        m_frameTimes[m_nextFrame] = frameTime;
+    }
+
+    m_nextFrame = (m_nextFrame + 1) % m_maxFrames;
+}
+
+void FrameStatistics::Clear()
+{
+    m_frameTimes.clear();
+    m_nextFrame = 0;
+}
+
+size_t FrameStatistics::GetNumFrames() const
+{
+    return m_frameTimes.size();
+}
+
+double FrameStatistics::GetLastFrameTime() const
+{
+    double frameTime = 0.0;
+
+    if (!m_frameTimes.empty())
+    {
+        frameTime = m_frameTimes[(m_nextFrame + m_maxFrames - 1) % m_maxFrames];
+    }
+
+    return frameTime;
+}
+
+double FrameStatistics::GetMinFrameTime() const
+{
+    double frameTime = 0.0;
+
+    if (!m_frameTimes.empty())
+    {
+        frameTime = *std::min_element(m_frameTimes.begin(), m_frameTimes.end());
+    }
+
+    return frameTime;
+}
+
+double FrameStatistics::GetMaxFrameTime() const
+{
+    double frameTime = 0.0;
+
+    if (!m_frameTimes.empty())
+    {
+        frameTime = *std::max_element(m_frameTimes.begin(), m_frameTimes.end());
+    }
+
+    return frameTime;
+}
+
+double FrameStatistics::GetAverageFrameTime() const
+{
+    double frameTime = 0.0;
+
+    if (!m_frameTimes.empty())
+    {
+        for (double time : m_frameTimes)
+        {
+            frameTime += time;
+        }
+
+        frameTime /= m_frameTimes.size();
+    }
+
+    return frameTime;
+}
+
+double FrameStatistics::GetPercentileFrameTime(double percentile) const
+{
+    double frameTime = 0.0;
+
+    if (!m_frameTimes.empty())
+    {
+        percentile = std::max(0.0, std::min(100.0, percentile));
+
+        // Nearest-rank percentile
+        size_t rank =
+            (size_t)std::ceil((percentile / 100.0) * m_frameTimes.size());
+        size_t index = (rank > 0) ? (rank - 1) : 0;
+
+        std::vector<double> sorted = m_frameTimes;
+        std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+
+        frameTime = sorted[index];
+    }
+
+    return frameTime;
+}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ds
+{
+/**
+ * Keeps track of the times taken by the most recent frames and calculates
+ * statistics about them.
+ */
+class FrameStatistics
+{
+public:
+    /**
+     * Create a frame statistics object that keeps track of the given number of
+     * most recent frames.
+     *
+     * @param  numFrames  size_t, number of frames to keep track of.
+     */
+    explicit FrameStatistics(size_t numFrames = 256);
+
+    /**
+     * Record the time taken by a frame, replacing the oldest frame recorded if
+     * the maximum number of frames are already being kept track of.
+     *
+     * @param  frameTime  double, time taken by the frame in milliseconds.
+     */
+    void AddFrameTime(double frameTime);
+
+    /**
+     * Forget all frames recorded.
+     */
+    void Clear();
+
+    /**
+     * Get the number of frames currently being kept track of.
+     *
+     * @return  size_t, number of frames.
+     */
+    size_t GetNumFrames() const;
+
+    /**
+     * Get the time taken by the most recent frame.
+     *
+     * @return  double, frame time in milliseconds, 0 if no frames recorded.
+     */
+    double GetLastFrameTime() const;
+
+    /**
+     * Get the minimum frame time of the frames kept track of.
+     *
+     * @return  double, frame time in milliseconds, 0 if no frames recorded.
+     */
+    double GetMinFrameTime() const;
+
+    /**
+     * Get the maximum frame time of the frames kept track of.
+     *
+     * @return  double, frame time in milliseconds, 0 if no frames recorded.
+     */
+    double GetMaxFrameTime() const;
+
+    /**
+     * Get the average frame time of the frames kept track of.
+     *
+     * @return  double, frame time in milliseconds, 0 if no frames recorded.
+     */
+    double GetAverageFrameTime() const;
+
+    /**
+     * Get the frame time that the given percentage of frames kept track of
+     * took no longer than (i.e. 99 for the 99th percentile).
+     *
+     * @param   percentile  double, percentile in the range [0, 100].
+     * @return              double, frame time in milliseconds, 0 if no frames
+     * recorded.
+     */
+    double GetPercentileFrameTime(double percentile) const;
+
+private:
+    // Frame times in milliseconds, used as a ring buffer
+    std::vector<double> m_frameTimes;
+    // Maximum number of frames kept track of
+    size_t m_maxFrames;
+    // Where the next frame time will be stored
+    size_t m_nextFrame;
+};
+}
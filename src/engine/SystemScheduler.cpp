@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include "engine/SystemScheduler.h"
+
+namespace ds
+{
+SystemScheduler::SystemScheduler()
+{
+    m_updateTime = 0.0;
+}
+
+void SystemScheduler::SetNumWorkerThreads(unsigned int numWorkerThreads)
+{
+    // Finish with the current workers first
+    m_threadPool.reset();
+
+    if (numWorkerThreads > 0)
+    {
+        m_threadPool = std::unique_ptr<ds_com::ThreadPool>(
+            new ds_com::ThreadPool(numWorkerThreads));
+    }
+}
+
+bool SystemScheduler::AddSystem(std::shared_ptr<ISystem> system)
+{
+    bool result = false;
+
+    if (system != nullptr && FindSystem(system.get()) == m_systems.size())
+    {
+        m_systems.push_back(system);
+        m_dependencies.push_back(std::vector<size_t>());
+        m_dependents.push_back(std::vector<size_t>());
+        m_systemUpdateTimes.push_back(0.0);
+
+        result = true;
+    }
+
+    return result;
+}
+
+bool SystemScheduler::AddDependency(const ISystem *system,
+                                    const ISystem *dependency)
+{
+    bool result = false;
+
+    size_t systemIndex = FindSystem(system);
+    size_t dependencyIndex = FindSystem(dependency);
+
+    // Both systems must exist and the dependency must not create a cycle
+    if (systemIndex < m_systems.size() && dependencyIndex < m_systems.size() &&
+        systemIndex != dependencyIndex &&
+        !DependsOn(dependencyIndex, systemIndex))
+    {
+        std::vector<size_t> &dependencies = m_dependencies[systemIndex];
+        if (std::find(dependencies.begin(), dependencies.end(),
+                      dependencyIndex) == dependencies.end())
+        {
+            dependencies.push_back(dependencyIndex);
+            m_dependents[dependencyIndex].push_back(systemIndex);
+        }
+
+        result = true;
+    }
+
+    return result;
+}
+
+void SystemScheduler::Update(float deltaTime)
+{
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    if (m_threadPool == nullptr)
+    {
+        // No workers, update systems serially in an order that respects their
+        // dependencies.
+        std::vector<size_t> numRemaining(m_systems.size());
+        std::deque<size_t> ready;
+        for (size_t i = 0; i < m_systems.size(); ++i)
+        {
+            numRemaining[i] = m_dependencies[i].size();
+            if (numRemaining[i] == 0)
+            {
+                ready.push_back(i);
+            }
+        }
+
+        while (!ready.empty())
+        {
+            size_t systemIndex = ready.front();
+            ready.pop_front();
+
+            UpdateSystem(systemIndex, deltaTime);
+
+            for (size_t dependent : m_dependents[systemIndex])
+            {
+                if (--numRemaining[dependent] == 0)
+                {
+                    ready.push_back(dependent);
+                }
+            }
+        }
+    }
+    else
+    {
+        std::mutex mutex;
+        std::condition_variable systemFinished;
+        // Number of dependencies of each system still to be updated
+        std::vector<size_t> numRemaining(m_systems.size());
+        // Systems ready to be updated on the main thread
+        std::deque<size_t> mainThreadReady;
+        size_t numFinished = 0;
+
+        // Schedule a system whose dependencies have all been updated and
+        // mark a system as updated, both must be called with the mutex locked.
+        std::function<void(size_t)> schedule;
+        std::function<void(size_t)> finish;
+
+        schedule = [&](size_t systemIndex)
+        {
+            if (m_systems[systemIndex]->RequiresMainThread())
+            {
+                mainThreadReady.push_back(systemIndex);
+                systemFinished.notify_all();
+            }
+            else
+            {
+                m_threadPool->Submit([&, systemIndex]()
+                                     {
+                                         UpdateSystem(systemIndex, deltaTime);
+
+                                         std::lock_guard<std::mutex> lock(
+                                             mutex);
+                                         finish(systemIndex);
+                                     });
+            }
+        };
+
+        finish = [&](size_t systemIndex)
+        {
+            for (size_t dependent : m_dependents[systemIndex])
+            {
+                if (--numRemaining[dependent] == 0)
+                {
+                    schedule(dependent);
+                }
+            }
+
+            ++numFinished;
+            systemFinished.notify_all();
+        };
+
+        std::unique_lock<std::mutex> lock(mutex);
+
+        for (size_t i = 0; i < m_systems.size(); ++i)
+        {
+            numRemaining[i] = m_dependencies[i].size();
+        }
+        for (size_t i = 0; i < m_systems.size(); ++i)
+        {
+            if (numRemaining[i] == 0)
+            {
+                schedule(i);
+            }
+        }
+
+        // Update main thread systems as they become ready, until all systems
+        // have been updated.
+        while (numFinished < m_systems.size())
+        {
+            if (!mainThreadReady.empty())
+            {
+                size_t systemIndex = mainThreadReady.front();
+                mainThreadReady.pop_front();
+
+                lock.unlock();
+                UpdateSystem(systemIndex, deltaTime);
+                lock.lock();
+
+                finish(systemIndex);
+            }
+            else
+            {
+                systemFinished.wait(lock);
+            }
+        }
+    }
+
+    m_updateTime = std::chrono::duration<double, std::milli>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+}
+
+const std::vector<double> &SystemScheduler::GetSystemUpdateTimes() const
+{
+    return m_systemUpdateTimes;
+}
+
+double SystemScheduler::GetUpdateTime() const
+{
+    return m_updateTime;
+}
+
+size_t SystemScheduler::FindSystem(const ISystem *system) const
+{
+    size_t index = 0;
+
+    while (index < m_systems.size() && m_systems[index].get() != system)
+    {
+        ++index;
+    }
+
+    return index;
+}
+
+bool SystemScheduler::DependsOn(size_t systemIndex,
+                                size_t dependencyIndex) const
+{
+    bool result = false;
+
+    // Depth-first search through the dependencies of the system
+    std::vector<size_t> toVisit(1, systemIndex);
+    std::vector<bool> visited(m_systems.size(), false);
+    while (!toVisit.empty() && !result)
+    {
+        size_t index = toVisit.back();
+        toVisit.pop_back();
+
+        if (index == dependencyIndex)
+        {
+            result = true;
+        }
+        else if (!visited[index])
+        {
+            visited[index] = true;
+            toVisit.insert(toVisit.end(), m_dependencies[index].begin(),
+                           m_dependencies[index].end());
+        }
+    }
+
+    return result;
+}
+
+void SystemScheduler::UpdateSystem(size_t systemIndex, float deltaTime)
+{
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    m_systems[systemIndex]->Update(deltaTime);
+
+    m_systemUpdateTimes[systemIndex] =
+        std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+}
+}
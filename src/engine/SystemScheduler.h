@@ -0,0 +1,130 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "engine/common/ThreadPool.h"
+#include "engine/system/ISystem.h"
+
+namespace ds
+{
+/**
+ * The system scheduler updates the systems managed by the engine.
+ *
+ * Systems are updated in a dependency graph: a system is only updated once all
+ * of the systems it depends on have been updated. Systems that do not depend
+ * on each other are updated concurrently on a pool of worker threads, except
+ * for systems that must be updated on the main thread (see
+ * ISystem::RequiresMainThread), which are updated on the thread calling
+ * Update.
+ *
+ * The time taken to update each system is recorded every update.
+ */
+class SystemScheduler
+{
+public:
+    /**
+     * Default constructor, systems are updated serially until worker threads
+     * are added with SetNumWorkerThreads.
+     */
+    SystemScheduler();
+
+    /**
+     * Set the number of worker threads used to update systems.
+     *
+     * @param  numWorkerThreads  unsigned int, number of worker threads to
+     * use. If zero, all systems are updated serially on the main thread.
+     */
+    void SetNumWorkerThreads(unsigned int numWorkerThreads);
+
+    /**
+     * Add a system to be updated by the scheduler.
+     *
+     * @param   system  std::shared_ptr<ISystem>, system to add.
+     * @return          bool, TRUE if the system was added, FALSE if the system
+     * was already added.
+     */
+    bool AddSystem(std::shared_ptr<ISystem> system);
+
+    /**
+     * Make the given system depend on another system, the system will only be
+     * updated once the other system has finished updating.
+     *
+     * Fails if either system has not been added to the scheduler or the
+     * dependency would create a cycle.
+     *
+     * @param   system      const ISystem *, system that depends on the other.
+     * @param   dependency  const ISystem *, system depended on.
+     * @return              bool, TRUE if the dependency was added, FALSE
+     * otherwise.
+     */
+    bool AddDependency(const ISystem *system, const ISystem *dependency);
+
+    /**
+     * Update all systems over the given timestep, blocks until all systems
+     * have been updated.
+     *
+     * @param  deltaTime  float, timestep to update the systems over.
+     */
+    void Update(float deltaTime);
+
+    /**
+     * Get the time taken to update each system during the last update, in
+     * the order the systems were added.
+     *
+     * @return  const std::vector<double> &, update time of each system in
+     * milliseconds.
+     */
+    const std::vector<double> &GetSystemUpdateTimes() const;
+
+    /**
+     * Get the time taken to update all systems during the last update.
+     *
+     * @return  double, update time in milliseconds.
+     */
+    double GetUpdateTime() const;
+
+private:
+    /**
+     * Find the index of the given system.
+     *
+     * @param   system  const ISystem *, system to find.
+     * @return          size_t, index of the system or the number of systems if
+     * not found.
+     */
+    size_t FindSystem(const ISystem *system) const;
+
+    /**
+     * Does the system at the given index (transitively) depend on the system
+     * at the other index?
+     *
+     * @param   systemIndex      size_t, index of the dependent system.
+     * @param   dependencyIndex  size_t, index of the dependency.
+     * @return                   bool, TRUE if it does, FALSE otherwise.
+     */
+    bool DependsOn(size_t systemIndex, size_t dependencyIndex) const;
+
+    /**
+     * Update the system at the given index and record the time it took.
+     *
+     * @param  systemIndex  size_t, index of the system to update.
+     * @param  deltaTime    float, timestep to update the system over.
+     */
+    void UpdateSystem(size_t systemIndex, float deltaTime);
+
+    // Systems to update
+    std::vector<std::shared_ptr<ISystem>> m_systems;
+    // Indices of the systems each system depends on
+    std::vector<std::vector<size_t>> m_dependencies;
+    // Indices of the systems that depend on each system
+    std::vector<std::vector<size_t>> m_dependents;
+
+    // Update times of each system during the last update
+    std::vector<double> m_systemUpdateTimes;
+    // Time taken by the last update
+    double m_updateTime;
+
+    // Worker threads, null if systems are updated serially
+    std::unique_ptr<ds_com::ThreadPool> m_threadPool;
+};
+}
@@ -39,7 +39,7 @@ namespace ds
  *
  * Exists with a HandleManager.
  *
- * Handles are merely a 32-bit uint split into
+ * Handles are merely a 64-bit uint split into
  * three different sections:
  *     - index: provides a direct (ie. fast) index into
  *              an array in the HandleManager which maps
@@ -50,9 +50,19 @@ namespace ds
  *                 counter.
  *     - type:     Provides a way of determining the type
  *                 of the data being pointed to by the Handle.
+ *
+ * The number of bits used by each section is given by INDEX_BITS,
+ * COUNTER_BITS and TYPE_BITS, which must add up to 64.
  */
 struct Handle
 {
+    enum
+    {
+        INDEX_BITS = 32,
+        COUNTER_BITS = 27,
+        TYPE_BITS = 5
+    };
+
     /**
      * Default constructor.
      *
@@ -77,21 +87,26 @@ struct Handle
     }
 
     /**
-     * Convert Handle to single uint32, because
-     * members are stored as three seperate uint32s.
+     * Convert Handle to single uint64, because
+     * members are stored as three seperate bitfields.
      *
-     * @return     uint32_t, Handle compressed as single uint32.
+     * @return     uint64_t, Handle compressed as single uint64.
      */
-    inline operator uint32_t() const;
+    inline operator uint64_t() const;
 
     // Bitfield (http://en.cppreference.com/w/cpp/language/bit_field)
-    uint32_t index : 12;
-    uint32_t counter : 15;
-    uint32_t type : 5;
+    uint64_t index : INDEX_BITS;
+    uint64_t counter : COUNTER_BITS;
+    uint64_t type : TYPE_BITS;
 };
 
-Handle::operator uint32_t() const
+static_assert(Handle::INDEX_BITS + Handle::COUNTER_BITS + Handle::TYPE_BITS ==
+                  64,
+              "Handle bits must add up to 64.");
+
+Handle::operator uint64_t() const
 {
-    return type << 27 | counter << 12 | index;
+    return ((uint64_t)type << (Handle::INDEX_BITS + Handle::COUNTER_BITS)) |
+           ((uint64_t)counter << Handle::INDEX_BITS) | (uint64_t)index;
 }
 }
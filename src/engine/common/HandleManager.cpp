@@ -34,16 +34,12 @@
 namespace ds
 {
 HandleManager::HandleEntry::HandleEntry()
-    : nextFreeIndex(0), counter(1), active(0), endOfList(0), entry(nullptr)
+    : nextFreeIndex(END_OF_LIST), counter(1), active(0), entry(nullptr)
 {
 }
 
 HandleManager::HandleEntry::HandleEntry(uint32_t nextFreeIndex)
-    : nextFreeIndex(nextFreeIndex),
-      counter(1),
-      active(0),
-      endOfList(0),
-      entry(nullptr)
+    : nextFreeIndex(nextFreeIndex), counter(1), active(0), entry(nullptr)
 {
 }
 
@@ -55,73 +51,75 @@ HandleManager::HandleManager()
 void HandleManager::Reset()
 {
     m_activeEntryCount = 0;
-    m_firstFreeEntry = 0;
+    m_firstFreeEntry = END_OF_LIST;
 
-    for (uint32_t i = 0; i < MAX_ENTRIES - 1; ++i)
-    {
-        // Initialize each entry with the next free entry
-        m_entries[i] = HandleEntry(i + 1);
-    }
-
-    m_entries[MAX_ENTRIES - 1] = HandleEntry();
-    m_entries[MAX_ENTRIES - 1].endOfList = true;
+    m_pages.clear();
 }
 
 Handle HandleManager::Add(void *p, uint32_t type)
 {
-    assert(m_activeEntryCount < MAX_ENTRIES - 1 &&
-           "HandleManager::Add: Entry list full.");
-    assert(type >= 0 && type <= 31 && "HandleManager::Add: Invalid type.");
-
-    const int newIndex = m_firstFreeEntry;
-    assert(newIndex < MAX_ENTRIES &&
-           "HandleManager::Add: First free entry is invalid.");
-    assert(m_entries[newIndex].active == false &&
+    assert(type < (1u << Handle::TYPE_BITS) &&
+           "HandleManager::Add: Invalid type.");
+
+    if (m_firstFreeEntry == END_OF_LIST)
+    {
+        AddPage();
+    }
+
+    const uint32_t newIndex = m_firstFreeEntry;
+    HandleEntry &newEntry = GetEntry(newIndex);
+    assert(newEntry.active == false &&
            "HandleManager::Add: First free entry is already being used.");
-    assert(!m_entries[newIndex].endOfList &&
-           "HandleManager::Add: First free entry is end of list.");
 
-    m_firstFreeEntry = m_entries[newIndex].nextFreeIndex;
+    m_firstFreeEntry = newEntry.nextFreeIndex;
     // Next free index no longer used
-    m_entries[newIndex].nextFreeIndex = 0;
-    m_entries[newIndex].counter = m_entries[newIndex].counter + 1;
+    newEntry.nextFreeIndex = END_OF_LIST;
+    newEntry.counter = newEntry.counter + 1;
     // Wrap around counter properly
-    if (m_entries[newIndex].counter == 0)
+    if (newEntry.counter == 0)
     {
-        m_entries[newIndex].counter = 1;
+        newEntry.counter = 1;
     }
     // Entry is now being used
-    m_entries[newIndex].active = true;
-    m_entries[newIndex].entry = p;
+    newEntry.active = true;
+    newEntry.entry = p;
 
     ++m_activeEntryCount;
 
-    return Handle(newIndex, m_entries[newIndex].counter, type);
+    return Handle(newIndex, newEntry.counter, type);
 }
 
 void HandleManager::Update(Handle handle, void *p)
 {
-    const int index = handle.index;
-    assert(m_entries[index].counter == handle.counter &&
+    const uint32_t index = handle.index;
+    assert((index >> PAGE_BITS) < m_pages.size() &&
+           "HandleManager::Update: Handle index out of range.");
+
+    HandleEntry &entry = GetEntry(index);
+    assert(entry.counter == handle.counter &&
            "HandleManager::Update: Handle is out of date.");
-    assert(m_entries[index].active == true &&
+    assert(entry.active == true &&
            "HandleManager::Update: Handle no longer active.");
 
-    m_entries[index].entry = p;
+    entry.entry = p;
 }
 
 void HandleManager::Remove(const Handle handle)
 {
     const uint32_t index = handle.index;
+    assert((index >> PAGE_BITS) < m_pages.size() &&
+           "HandleManager::Remove: Handle index out of range.");
+
+    HandleEntry &entry = GetEntry(index);
     assert(
-        m_entries[index].counter == handle.counter &&
+        entry.counter == handle.counter &&
         "HandleManager::Remove: Entry does not exist or Handle out of date.");
-    assert(m_entries[index].active == true &&
+    assert(entry.active == true &&
            "HandleManager::Remove: Handle no longer active.");
 
     // Store first free entry index
-    m_entries[index].nextFreeIndex = m_firstFreeEntry;
-    m_entries[index].active = 0;
+    entry.nextFreeIndex = m_firstFreeEntry;
+    entry.active = 0;
     // Set first free entry to this entry
     m_firstFreeEntry = index;
 
@@ -142,14 +140,19 @@ void *HandleManager::Get(Handle handle) const
 
 bool HandleManager::Get(const Handle handle, void **out) const
 {
-    const int index = handle.index;
-    if (m_entries[index].counter != handle.counter ||
-        m_entries[index].active == false)
+    const uint32_t index = handle.index;
+    if ((index >> PAGE_BITS) >= m_pages.size())
     {
         return false;
     }
 
-    *out = m_entries[index].entry;
+    const HandleEntry &entry = GetEntry(index);
+    if (entry.counter != handle.counter || entry.active == false)
+    {
+        return false;
+    }
+
+    *out = entry.entry;
     return true;
 }
 
@@ -157,4 +160,24 @@ int HandleManager::GetCount() const
 {
     return m_activeEntryCount;
 }
+
+void HandleManager::AddPage()
+{
+    assert(m_pages.size() < ((uint64_t)1 << (Handle::INDEX_BITS - PAGE_BITS)) &&
+           "HandleManager::AddPage: Entry list full.");
+
+    const uint32_t firstIndex = (uint32_t)m_pages.size() * PAGE_SIZE;
+
+    std::unique_ptr<HandleEntry[]> page(new HandleEntry[PAGE_SIZE]);
+    for (uint32_t i = 0; i < PAGE_SIZE - 1; ++i)
+    {
+        // Initialize each entry with the next free entry
+        page[i].nextFreeIndex = firstIndex + i + 1;
+    }
+    // Last entry of the page continues on to the rest of the free list
+    page[PAGE_SIZE - 1].nextFreeIndex = m_firstFreeEntry;
+
+    m_pages.push_back(std::move(page));
+    m_firstFreeEntry = firstIndex;
+}
 }
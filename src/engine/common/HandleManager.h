@@ -31,6 +31,7 @@
 
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include "Handle.h"
 
@@ -40,20 +41,27 @@ namespace ds
  * The HandleManager class maps Handles to HandleEntry
  * objects. These HandleEntry objects provide a pointer
  * to the data the Handle should refer to.
+ *
+ * HandleEntry objects are stored in fixed size pages, more
+ * pages are allocated as more handles are added. Pages are
+ * never moved, so growing the manager doesn't copy any
+ * entries.
  */
 class HandleManager
 {
 public:
     enum
     {
-        MAX_ENTRIES = 4096
+        // Number of bits of an index used to select the entry within a page
+        PAGE_BITS = 12,
+        // Number of HandleEntrys in each page
+        PAGE_SIZE = 1 << PAGE_BITS
     };
 
     /**
      * Default constructor.
      *
-     * Creates HandleManager, clears all HandleEntrys
-     * ready for use.
+     * Creates an empty HandleManager, ready for use.
      */
     HandleManager();
 
@@ -66,7 +74,6 @@ public:
      * Add new data to the HandleManager and return a Handle
      * that can be used to refer to that data.
      *
-     * @pre  HandleManager must not be full.
      * @pre  Type must be between 0 and 31 inclusive.
      *
      * @param  p       void *, pointer to data that Handle should refer to.
@@ -150,9 +157,8 @@ private:
     HandleManager &operator=(const HandleManager &handleManager);
 
     /**
-     * Each HandleEntry is initialized so that it holds a pointer to
-     * the next free HandleEntry. The HandleEntry at "MAX_ENTRIES" is
-     * set to indicate that it is at the end of the list.
+     * Each free HandleEntry holds the index of the next free HandleEntry.
+     * The last free HandleEntry holds END_OF_LIST.
      */
     struct HandleEntry
     {
@@ -167,20 +173,39 @@ private:
          */
         explicit HandleEntry(uint32_t nextFreeIndex);
 
-        // Bitfield
         // Index to next free HandleEntry
-        uint32_t nextFreeIndex : 12;
+        uint32_t nextFreeIndex;
+        // Bitfield
         // Generation counter
-        uint32_t counter : 15;
+        uint32_t counter : Handle::COUNTER_BITS;
         // Is this entry being used?
         uint32_t active : 1;
-        // Is this entry the end of the list?
-        uint32_t endOfList : 1;
         // Data ptr
         void *entry;
     };
 
-    HandleEntry m_entries[MAX_ENTRIES];
+    // Index marking the end of the free list
+    static const uint32_t END_OF_LIST = 0xFFFFFFFF;
+
+    /**
+     * Get the HandleEntry at the given index.
+     *
+     * @pre  Index must be less than the number of entries allocated.
+     *
+     * @param   index  uint32_t, index of the entry.
+     * @return         HandleEntry &, entry at that index.
+     */
+    HandleEntry &GetEntry(uint32_t index);
+    const HandleEntry &GetEntry(uint32_t index) const;
+
+    /**
+     * Allocate another page of free HandleEntrys and add them to the free
+     * list.
+     */
+    void AddPage();
+
+    // Pages of HandleEntrys
+    std::vector<std::unique_ptr<HandleEntry[]>> m_pages;
 
     // Number of active entries
     int m_activeEntryCount;
@@ -188,6 +213,17 @@ private:
     uint32_t m_firstFreeEntry;
 };
 
+inline HandleManager::HandleEntry &HandleManager::GetEntry(uint32_t index)
+{
+    return m_pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)];
+}
+
+inline const HandleManager::HandleEntry &
+HandleManager::GetEntry(uint32_t index) const
+{
+    return m_pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)];
+}
+
 template <typename T>
 inline bool HandleManager::GetAs(Handle handle, T *out) const
 {
@@ -15,20 +15,24 @@ void StreamBuffer::Insert(size_t size, const void *const dataIn)
 {
     if (dataIn != nullptr)
     {
+        // Make sure we aren't writing to storage other stream buffers are
+        // reading from
+        Detach();
+
         // If the data is too big for the buffer
-        if ((m_buffer.size() + size) > m_buffer.capacity())
+        if ((m_buffer->size() + size) > m_buffer->capacity())
         {
             // Reserve some more memory
-            m_buffer.reserve((m_buffer.capacity() + size) * 2);
+            m_buffer->reserve((m_buffer->capacity() + size) * 2);
         }
 
         // Resize the array before copying data to it (this keeps the vector
         // size up
         // to date)
-        m_buffer.resize(m_buffer.size() + size);
+        m_buffer->resize(m_buffer->size() + size);
 
-        int writePos = m_buffer.size() - size;
-        memcpy(&m_buffer[writePos], dataIn, size);
+        int writePos = m_buffer->size() - size;
+        memcpy(&(*m_buffer)[writePos], dataIn, size);
     }
 }
 
@@ -41,7 +45,7 @@ bool StreamBuffer::Extract(size_t size, void *const dataOut)
     {
         if (dataOut != nullptr)
         {
-            memcpy(dataOut, &m_buffer[m_readPos], size);
+            memcpy(dataOut, &(*m_buffer)[m_readPos], size);
         }
 
         m_readPos += size;
@@ -54,12 +58,29 @@ bool StreamBuffer::Extract(size_t size, void *const dataOut)
 
 size_t StreamBuffer::AvailableBytes() const
 {
-    return m_buffer.size() - m_readPos;
+    size_t availableBytes = 0;
+
+    if (m_buffer != nullptr)
+    {
+        availableBytes = m_buffer->size() - m_readPos;
+    }
+
+    return availableBytes;
 }
 
 void StreamBuffer::Clear()
 {
-    m_buffer.clear();
+    // If we are the only user of the storage, keep it around so it's memory
+    // can be re-used, otherwise just let go of it.
+    if (IsShared())
+    {
+        m_buffer.reset();
+    }
+    else if (m_buffer != nullptr)
+    {
+        m_buffer->clear();
+    }
+
     m_readPos = 0;
 }
 
@@ -68,16 +89,55 @@ const void *StreamBuffer::GetDataPtr() const
     const void *ptr = nullptr;
 
     // Only get data ptr if buffer size is greater than 0 and less than size of buffer
-    if (m_buffer.size() > 0 && m_readPos < m_buffer.size())
+    if (AvailableBytes() > 0)
     {
-        ptr = &m_buffer[m_readPos];
+        ptr = &(*m_buffer)[m_readPos];
     }
 
     return ptr;
 }
 
+bool StreamBuffer::IsShared() const
+{
+    return (m_buffer != nullptr && m_buffer.use_count() > 1);
+}
+
+void StreamBuffer::Detach()
+{
+    if (m_buffer == nullptr)
+    {
+        m_buffer = std::make_shared<std::vector<Byte_t>>();
+        m_readPos = 0;
+    }
+    else if (IsShared())
+    {
+        // Copy only the data that is left to read
+        std::shared_ptr<std::vector<Byte_t>> unique =
+            std::make_shared<std::vector<Byte_t>>(
+                m_buffer->begin() + m_readPos, m_buffer->end());
+
+        m_buffer = unique;
+        m_readPos = 0;
+    }
+    else if (m_readPos == m_buffer->size())
+    {
+        // Everything has been read, re-use the storage from the start
+        m_buffer->clear();
+        m_readPos = 0;
+    }
+}
+
 void AppendStreamBuffer(StreamBuffer &to, const StreamBuffer &from)
 {
-    to.Insert(from.AvailableBytes(), from.GetDataPtr());
+    // Nothing left to read in 'to', so share the storage of 'from' rather than
+    // copying it.
+    if (to.AvailableBytes() == 0)
+    {
+        to = from;
+    }
+    else
+    {
+        to.Insert(from.AvailableBytes(), from.GetDataPtr());
+    }
 }
 }
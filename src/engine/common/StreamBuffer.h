@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 namespace ds_com
@@ -11,6 +13,12 @@ namespace ds_com
  * When an object is inserted into the stream buffer the object is copied
  * directly, no constructors and destructors are called. For this reason, the
  * stream buffer should only be used to store POD types.
+ *
+ * Copies of a stream buffer share the same underlying storage and only keep
+ * their own read position, so handing a stream buffer to many readers costs a
+ * reference count increment rather than a copy of its contents. The storage is
+ * copied lazily, the first time a stream buffer that shares its storage is
+ * written to (copy-on-write).
  */
 class StreamBuffer
 {
@@ -88,9 +96,22 @@ public:
      */
     const void *GetDataPtr() const;
 
+    /**
+     * Does this stream buffer share its storage with another stream buffer?
+     *
+     * @return bool, TRUE if the storage is shared, FALSE otherwise.
+     */
+    bool IsShared() const;
+
 private:
+    /**
+     * Make sure this stream buffer is the sole owner of it's storage, copying
+     * the unread portion of the storage if it is currently shared.
+     */
+    void Detach();
+
     size_t m_readPos;
-    std::vector<Byte_t> m_buffer;
+    std::shared_ptr<std::vector<Byte_t>> m_buffer;
 };
 
 /**
@@ -114,6 +135,9 @@ StreamBuffer &operator>>(StreamBuffer &buffer, T &dataOut);
 /**
  * Append all data in the 'from' buffer onto the end of the 'to' buffer.
  *
+ * If the 'to' buffer has no data left to read, it will share the storage of
+ * the 'from' buffer instead of copying it.
+ *
  * @param to   StreamBuffer &, StreamBuffer to append data to.
  * @param from const StreamBuffer &, StreamBuffer to get data from.
  */
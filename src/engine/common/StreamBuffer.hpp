@@ -26,7 +26,7 @@ bool StreamBuffer::Peek(T *const dataOut) const
     {
         if (dataOut != nullptr)
         {
-            memcpy(dataOut, &m_buffer[m_readPos], dataSize);
+            memcpy(dataOut, &(*m_buffer)[m_readPos], dataSize);
         }
 
         result = true;
@@ -45,18 +45,6 @@ void StreamBuffer::Set(const T *const dataIn)
         // Clear stream buffer
         Clear();
 
-        // If the data is too big for the buffer
-        if ((m_buffer.size() + dataSize) > m_buffer.capacity())
-        {
-            // Reserve some more memory
-            m_buffer.reserve((m_buffer.capacity() + dataSize) * 2);
-        }
-
-        // Resize the array before copying data to it (this keeps the vector
-        // size up to date)
-        m_buffer.resize(m_buffer.size() + dataSize);
-
-        int writePos = m_buffer.size() - dataSize;
-        memcpy(&m_buffer[writePos], dataIn, dataSize);
+        Insert(dataSize, dataIn);
     }
 }
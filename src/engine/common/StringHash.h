@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace ds_com
+{
+/**
+ * 32-bit FNV-1a hash of a string.
+ */
+typedef uint32_t StringHash;
+
+/**
+ * Hash the given string at compile time, so the hash can be used as a case
+ * label or template argument. Strings only known at run time should use the
+ * std::string overload.
+ *
+ * For example:
+ *
+ *     switch (ds_com::HashString(name))
+ *     {
+ *     case ds_com::HashString("renderComponent"):
+ *         ...
+ *     }
+ *
+ * @param   string  const char *, null-terminated string to hash.
+ * @param   hash    StringHash, hash of the characters before the string, leave
+ * as default.
+ * @return          StringHash, hash of the string.
+ */
+constexpr StringHash HashString(const char *string,
+                                StringHash hash = 2166136261u)
+{
+    return (*string == '\0')
+               ? hash
+               : HashString(string + 1,
+                            (hash ^ (StringHash)(unsigned char)*string) *
+                                16777619u);
+}
+
+/**
+ * Hash the given string at run time, gives the same hash as the compile time
+ * HashString for the same characters.
+ *
+ * @param   string  const std::string &, string to hash.
+ * @return          StringHash, hash of the string.
+ */
+inline StringHash HashString(const std::string &string)
+{
+    StringHash hash = 2166136261u;
+
+    for (char c : string)
+    {
+        hash = (hash ^ (StringHash)(unsigned char)c) * 16777619u;
+    }
+
+    return hash;
+}
+}
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cassert>
+#include <iostream>
 
 #include "engine/common/StringIntern.h"
 
@@ -11,25 +13,173 @@ StringIntern &StringIntern::Instance()
     return instance;
 }
 
-StringIntern::StringId StringIntern::Intern(std::string string)
+StringIntern::StringId StringIntern::Intern(const std::string &string)
 {
-    StringId id = (StringId)m_strings.size();
+    ds_com::StringHash hash = ds_com::HashString(string);
+    uint32_t shardIndex = GetShardIndex(hash);
+    Shard &shard = *m_shards[shardIndex];
 
-    m_strings.push_back(string);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    StringId id = 0;
+    bool found = false;
+
+    // Different strings may have the same hash, so compare the strings too
+    auto range = shard.ids.equal_range(hash);
+    for (auto it = range.first; it != range.second && !found; ++it)
+    {
+        if (GetEntry(it->second).string == string)
+        {
+            id = it->second;
+            found = true;
+        }
+    }
+
+    uint32_t index = shard.numStrings.load(std::memory_order_relaxed);
+    if (!found &&
+        index >= m_maxStringsPerShard.load(std::memory_order_relaxed))
+    {
+        // Only report the first overflow of each shard
+        if (!shard.isFull)
+        {
+            std::cerr << "StringIntern::Intern: Too many strings interned, "
+                         "interning '"
+                      << string << "' and any more as <overflow>."
+                      << std::endl;
+            shard.isFull = true;
+        }
+
+        id = m_overflowId;
+    }
+    else if (!found)
+    {
+        uint32_t pageIndex = index >> PageBits;
+
+        Entry *page = shard.pages[pageIndex].load(std::memory_order_relaxed);
+        if (page == nullptr)
+        {
+            page = new Entry[PageSize];
+            shard.pages[pageIndex].store(page, std::memory_order_release);
+        }
+
+        Entry &entry = page[index & (PageSize - 1)];
+        entry.string = string;
+        entry.hash = hash;
+
+        id = (StringId)((index << ShardBits) | shardIndex);
+        shard.ids.insert(std::make_pair(hash, id));
+
+        // Publish the string to threads reading it without the lock
+        shard.numStrings.store(index + 1, std::memory_order_release);
+    }
 
     return id;
 }
 
 const std::string &StringIntern::GetString(StringIntern::StringId id) const
 {
-    assert((uint32_t)id < m_strings.size() && "StringIntern::GetString(): "
-                                              "Attempted to get string with "
-                                              "invalid StringId.");
-    return (m_strings[(uint32_t)id]);
+    return GetEntry(id).string;
+}
+
+ds_com::StringHash StringIntern::GetHash(StringIntern::StringId id) const
+{
+    return GetEntry(id).hash;
+}
+
+#ifndef NDEBUG
+std::string StringIntern::LookupHash(ds_com::StringHash hash) const
+{
+    std::string string = "<unknown>";
+
+    const Shard &shard = *m_shards[GetShardIndex(hash)];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.ids.find(hash);
+    if (it != shard.ids.end())
+    {
+        string = GetEntry(it->second).string;
+    }
+
+    return string;
+}
+#endif
+
+size_t StringIntern::GetNumStrings() const
+{
+    size_t numStrings = 0;
+
+    for (const auto &shard : m_shards)
+    {
+        numStrings += shard->numStrings.load(std::memory_order_acquire);
+    }
+
+    return numStrings;
+}
+
+StringIntern::StringId StringIntern::GetOverflowId() const
+{
+    return m_overflowId;
+}
+
+void StringIntern::SetMaxStringsPerShard(uint32_t maxStrings)
+{
+    m_maxStringsPerShard.store(
+        std::min(maxStrings, (uint32_t)(MaxPages * PageSize)),
+        std::memory_order_relaxed);
 }
 
 StringIntern::StringIntern()
 {
-    
+    m_overflowId = 0;
+    m_maxStringsPerShard.store(MaxPages * PageSize, std::memory_order_relaxed);
+
+    for (auto &shard : m_shards)
+    {
+        shard = std::unique_ptr<Shard>(new Shard());
+        shard->numStrings.store(0, std::memory_order_relaxed);
+        shard->isFull = false;
+
+        for (auto &page : shard->pages)
+        {
+            page.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    m_overflowId = Intern("<overflow>");
+}
+
+StringIntern::~StringIntern()
+{
+    for (auto &shard : m_shards)
+    {
+        for (auto &page : shard->pages)
+        {
+            delete[] page.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+uint32_t StringIntern::GetShardIndex(ds_com::StringHash hash)
+{
+    // Use the high bits of the hash, the low bits are used by the shard's
+    // hash map.
+    return (hash >> (32 - ShardBits)) & (NumShards - 1);
+}
+
+const StringIntern::Entry &
+StringIntern::GetEntry(StringIntern::StringId id) const
+{
+    const Shard &shard = *m_shards[id & (NumShards - 1)];
+    uint32_t index = id >> ShardBits;
+
+    assert(index < shard.numStrings.load(std::memory_order_acquire) &&
+           "StringIntern::GetString(): Attempted to get string with invalid "
+           "StringId.");
+
+    const Entry *page =
+        shard.pages[index >> PageBits].load(std::memory_order_acquire);
+
+    return page[index & (PageSize - 1)];
 }
 }
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <vector>
+#include <unordered_map>
+
+#include "engine/common/StringHash.h"
 
 namespace ds
 {
@@ -13,6 +18,21 @@ namespace ds
  * uniquely refers to that string. That string can then be retrieved from
  * anywhere in the program using that id. This is useful because our messaging
  * system does not allow the passing of std::strings (a non-POD type).
+ *
+ * Interning the same string more than once returns the same id, so the table
+ * only grows with the number of distinct strings interned.
+ *
+ * Each interned string also has it's ds_com::StringHash, which can be compared
+ * against hashes computed at compile time, i.e. to switch on an interned
+ * string.
+ *
+ * Each shard holds a limited number of strings. Strings interned once their
+ * shard is full aren't stored, they get the overflow id instead, whose string
+ * is "<overflow>".
+ *
+ * Strings may be interned and retrieved from multiple threads. The table is
+ * split into shards by string hash so threads interning different strings
+ * rarely contend, and strings are retrieved without locking.
  */
 class StringIntern
 {
@@ -33,26 +53,131 @@ public:
      * Intern the given string, receiving a StringId which can be used to refer
      * to that string.
      *
-     * @param   string  std::string, string to intern.
+     * @param   string  const std::string &, string to intern.
      * @return          StringId, id used to refer to given string.
      */
-    StringId Intern(std::string string);
+    StringId Intern(const std::string &string);
 
     /**
      * Get the string associated with the given StringId.
      *
+     * The reference returned stays valid for the lifetime of the program.
+     *
      * @param   id  StringId, string id to get string for.
      * @return      const std::string &, string associated with given string id.
      */
     const std::string &GetString(StringId id) const;
 
+    /**
+     * Get the hash of the string associated with the given StringId.
+     *
+     * @param   id  StringId, string id to get hash for.
+     * @return      ds_com::StringHash, hash of the string.
+     */
+    ds_com::StringHash GetHash(StringId id) const;
+
+#ifndef NDEBUG
+    /**
+     * Find the interned string with the given hash, for diagnostics. Only
+     * available in debug builds.
+     *
+     * @param   hash  ds_com::StringHash, hash to look up.
+     * @return        std::string, interned string with that hash or
+     * "<unknown>" if no string with that hash has been interned.
+     */
+    std::string LookupHash(ds_com::StringHash hash) const;
+#endif
+
+    /**
+     * Get the number of distinct strings interned.
+     *
+     * @return  size_t, number of strings interned.
+     */
+    size_t GetNumStrings() const;
+
+    /**
+     * Get the id given for strings interned into a full shard.
+     *
+     * @return  StringId, id of the "<overflow>" string.
+     */
+    StringId GetOverflowId() const;
+
+    /**
+     * Limit the number of strings stored in each shard, mainly to test
+     * overflowing them. Limits above the size of a shard's arena are clamped.
+     *
+     * @param  maxStrings  uint32_t, maximum number of strings per shard.
+     */
+    void SetMaxStringsPerShard(uint32_t maxStrings);
+
 private:
+    // Number of bits of a StringId used for the shard index
+    static const unsigned int ShardBits = 4;
+    static const unsigned int NumShards = 1u << ShardBits;
+    // Number of strings stored in each page of a shard's arena
+    static const unsigned int PageBits = 10;
+    static const unsigned int PageSize = 1u << PageBits;
+    // Maximum number of pages in each shard's arena
+    static const unsigned int MaxPages = 1024;
+
+    /**
+     * An interned string and it's hash.
+     */
+    struct Entry
+    {
+        std::string string;
+        ds_com::StringHash hash;
+    };
+
+    /**
+     * A subset of the interned strings, selected by hash.
+     */
+    struct Shard
+    {
+        // Guards interning into the shard
+        mutable std::mutex mutex;
+        // Ids of the strings stored in this shard, keyed by string hash
+        std::unordered_multimap<ds_com::StringHash, StringId> ids;
+        // Arena of strings, pages are never moved or freed once allocated so
+        // references to strings stay valid.
+        std::atomic<Entry *> pages[MaxPages];
+        // Number of strings stored in the shard
+        std::atomic<uint32_t> numStrings;
+        // Has a string been interned as overflow?
+        bool isFull;
+    };
+
     /**
      * Private StringIntern constructor, to ensure that no more than one
      * instance of this class is created.
      */
     StringIntern();
 
-    std::vector<std::string> m_strings;
+    /**
+     * Frees the pages of the arenas.
+     */
+    ~StringIntern();
+
+    /**
+     * Get the shard the string with the given hash is stored in.
+     *
+     * @param   hash  ds_com::StringHash, hash of the string.
+     * @return        uint32_t, index of the shard.
+     */
+    static uint32_t GetShardIndex(ds_com::StringHash hash);
+
+    /**
+     * Get the arena entry of the given string id.
+     *
+     * @param   id  StringId, string id to get entry for.
+     * @return      const Entry &, entry of the string.
+     */
+    const Entry &GetEntry(StringId id) const;
+
+    std::unique_ptr<Shard> m_shards[NumShards];
+    // Id of the string given when a shard is full
+    StringId m_overflowId;
+    // Maximum number of strings stored in each shard
+    std::atomic<uint32_t> m_maxStringsPerShard;
 };
 }
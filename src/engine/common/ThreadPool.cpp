@@ -0,0 +1,209 @@
+#include <algorithm>
+
+#include "engine/common/ThreadPool.h"
+
+namespace ds_com
+{
+// Pool and index of the worker running on this thread, if any
+static thread_local ThreadPool *t_workerPool = nullptr;
+static thread_local unsigned int t_workerIndex = 0;
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+{
+    m_numPendingTasks = 0;
+    m_nextQueue = 0;
+    m_isRunning = true;
+
+    // Always have at least one queue, so tasks can be submitted to a pool
+    // without any worker threads and run with RunPendingTask.
+    unsigned int numQueues = (numThreads > 0) ? numThreads : 1;
+    for (unsigned int i = 0; i < numQueues; ++i)
+    {
+        m_queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+    }
+
+    for (unsigned int i = 0; i < numThreads; ++i)
+    {
+        m_threads.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_isRunning = false;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto &thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::Submit(Task task)
+{
+    // Keep tasks submitted by a worker on that worker's queue, otherwise
+    // spread them across the queues.
+    unsigned int queueIndex = 0;
+    if (t_workerPool == this)
+    {
+        queueIndex = t_workerIndex;
+    }
+    else
+    {
+        queueIndex = m_nextQueue++ % m_queues.size();
+    }
+
+    // Counted before it's queued, so a worker taking it straight away can't
+    // wrap the count below zero
+    ++m_numPendingTasks;
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queueIndex]->mutex);
+        m_queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+
+    // Wake a sleeping worker
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_wakeCondition.notify_one();
+}
+
+bool ThreadPool::RunPendingTask()
+{
+    bool result = false;
+
+    Task task;
+    if (TakeTask((t_workerPool == this) ? t_workerIndex : 0, &task))
+    {
+        task();
+        result = true;
+    }
+
+    return result;
+}
+
+void ThreadPool::ParallelFor(size_t begin,
+                             size_t end,
+                             size_t grainSize,
+                             const RangeTask &function)
+{
+    if (begin < end)
+    {
+        const size_t count = end - begin;
+        if (grainSize == 0)
+        {
+            grainSize = 1;
+        }
+
+        // One subrange per worker plus one for the calling thread, unless
+        // that would make them smaller than the grain size.
+        size_t numRanges = (count + grainSize - 1) / grainSize;
+        numRanges = std::min(numRanges, m_threads.size() + 1);
+        const size_t rangeSize = (count + numRanges - 1) / numRanges;
+
+        std::atomic<size_t> numRemaining(0);
+
+        for (size_t rangeBegin = begin + rangeSize; rangeBegin < end;
+             rangeBegin += rangeSize)
+        {
+            const size_t rangeEnd = std::min(rangeBegin + rangeSize, end);
+
+            ++numRemaining;
+            Submit([&function, &numRemaining, rangeBegin, rangeEnd]()
+                   {
+                       function(rangeBegin, rangeEnd);
+                       --numRemaining;
+                   });
+        }
+
+        // Calling thread takes the first subrange
+        function(begin, std::min(begin + rangeSize, end));
+
+        while (numRemaining > 0)
+        {
+            if (!RunPendingTask())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+unsigned int ThreadPool::GetNumThreads() const
+{
+    return (unsigned int)m_threads.size();
+}
+
+void ThreadPool::WorkerLoop(unsigned int workerIndex)
+{
+    t_workerPool = this;
+    t_workerIndex = workerIndex;
+
+    while (true)
+    {
+        Task task;
+        if (TakeTask(workerIndex, &task))
+        {
+            task();
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wakeCondition.wait(lock, [this]()
+                                 {
+                                     return !m_isRunning ||
+                                            m_numPendingTasks > 0;
+                                 });
+
+            // Only stop once all submitted tasks have been taken
+            if (!m_isRunning && m_numPendingTasks == 0)
+            {
+                break;
+            }
+        }
+    }
+
+    t_workerPool = nullptr;
+}
+
+bool ThreadPool::TakeTask(unsigned int workerIndex, Task *task)
+{
+    bool result = false;
+
+    // Take the most recently pushed task from our own queue first, it's data
+    // is the most likely to still be in cache.
+    {
+        WorkQueue &queue = *m_queues[workerIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            *task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            result = true;
+        }
+    }
+
+    // Otherwise steal the oldest task from another queue
+    for (size_t i = 1; i < m_queues.size() && !result; ++i)
+    {
+        WorkQueue &queue = *m_queues[(workerIndex + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            *task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            result = true;
+        }
+    }
+
+    if (result)
+    {
+        --m_numPendingTasks;
+    }
+
+    return result;
+}
+}
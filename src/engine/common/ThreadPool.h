@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ds_com
+{
+/**
+ * A pool of worker threads that execute submitted tasks.
+ *
+ * Each worker thread has it's own queue of tasks. Tasks submitted from a
+ * worker thread are pushed onto that worker's queue, other tasks are
+ * distributed across the queues in turn. A worker takes tasks from the back of
+ * it's own queue and, when that is empty, steals tasks from the front of the
+ * other workers' queues.
+ */
+class ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+    typedef std::function<void(size_t, size_t)> RangeTask;
+
+    /**
+     * Create a thread pool with the given number of worker threads.
+     *
+     * @param  numThreads  unsigned int, number of worker threads to create.
+     */
+    explicit ThreadPool(unsigned int numThreads);
+
+    /**
+     * Destructor. Finishes all submitted tasks before joining the worker
+     * threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * Submit a task to be executed by one of the worker threads.
+     *
+     * @param  task  Task, task to execute.
+     */
+    void Submit(Task task);
+
+    /**
+     * Execute a single pending task on the calling thread, if there is one.
+     *
+     * Useful to let a thread that is waiting on the pool help out.
+     *
+     * @return  bool, TRUE if a task was executed, FALSE otherwise.
+     */
+    bool RunPendingTask();
+
+    /**
+     * Split the range [begin, end) into subranges and call the given function
+     * on each, spread across the worker threads and the calling thread.
+     * Returns once every subrange has been processed.
+     *
+     * While waiting the calling thread runs other pending tasks, which may
+     * include tasks not submitted by this call.
+     *
+     * @param  begin      size_t, start of the range.
+     * @param  end        size_t, end of the range (exclusive).
+     * @param  grainSize  size_t, minimum number of elements in a subrange.
+     * @param  function   const RangeTask &, function called with the start
+     * and end (exclusive) of each subrange.
+     */
+    void ParallelFor(size_t begin,
+                     size_t end,
+                     size_t grainSize,
+                     const RangeTask &function);
+
+    /**
+     * Get the number of worker threads in the pool.
+     *
+     * @return  unsigned int, number of worker threads.
+     */
+    unsigned int GetNumThreads() const;
+
+private:
+    /**
+     * Queue of tasks belonging to a single worker thread.
+     */
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * Main loop of each worker thread.
+     *
+     * @param  workerIndex  unsigned int, index of the worker running the loop.
+     */
+    void WorkerLoop(unsigned int workerIndex);
+
+    /**
+     * Take a task, preferring the given worker's queue and stealing from the
+     * other workers' queues otherwise.
+     *
+     * @param   workerIndex  unsigned int, index of the queue to look in first.
+     * @param   task         Task *, where the task taken should be stored.
+     * @return               bool, TRUE if a task was taken, FALSE otherwise.
+     */
+    bool TakeTask(unsigned int workerIndex, Task *task);
+
+    // One queue per worker thread
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    // Number of tasks submitted but not yet taken by any thread
+    std::atomic<size_t> m_numPendingTasks;
+    // Queue the next task submitted from outside the pool goes to
+    std::atomic<unsigned int> m_nextQueue;
+    bool m_isRunning;
+
+    // Used to put idle workers to sleep
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;
+};
+}
@@ -1,14 +1,20 @@
 #pragma once
 
-#include <unordered_map>
+#include <algorithm>
+#include <functional>
 #include <vector>
 
+#include "engine/entity/ComponentStorage.h"
 #include "engine/entity/IComponentManager.h"
 
 namespace ds
 {
 /**
  * Templated on component type (a struct). Manages components of that type.
+ *
+ * Components are stored as a sparse set: components are tightly packed in a
+ * dense array and a sparse array, indexed by entity index, maps each entity to
+ * it's component. Looking up, adding and removing components are all O(1).
  */
 template <typename T>
 class ComponentManager : public IComponentManager
@@ -62,7 +68,31 @@ public:
      */
     virtual bool RemoveInstance(Instance i);
 
+    /**
+     * Remove several component instances from the manager at once.
+     *
+     * Invalid and duplicate instances are ignored.
+     *
+     * @param   instances  const std::vector<Instance> &, the component
+     * instances to remove.
+     * @return             unsigned int, number of instances removed.
+     */
+    virtual unsigned int
+    RemoveInstances(const std::vector<Instance> &instances);
+
 protected:
+    /**
+     * Called when a component instance is about to be removed, before any
+     * data is moved. Override to remove any references other components hold
+     * to the instance.
+     *
+     * See TransformComponentManager for an example of the correct usage
+     * of this method.
+     *
+     * @param   i  const Instance &, instance about to be removed.
+     */
+    virtual void OnRemoveInstance(const Instance &i);
+
     /**
      * Think of the Instance identifier as a pointer address. When the
      * component is swapped around in memory, it's address changes and this
@@ -75,7 +105,9 @@ protected:
      * of this method.
      *
      * Called before any data is actually moved, so oldAddress can still be
-     * used to reference about to be moved component.
+     * used to reference about to be moved component. Components are only
+     * moved into the slot of a removed component, so newAddress always refers
+     * to a component that OnRemoveInstance has already been called for.
      *
      * @post    Once overriden, all references to "old" should be replaced
      *          with reference to "new".
@@ -86,22 +118,24 @@ protected:
     virtual void OnAddressChange(const Instance &oldAddress,
                                  const Instance &newAddress);
 
-    /** Map entity to index into vector of instance data */
-    typedef std::unordered_map<uint32_t, size_t> EntityMap;
-
     /**
      * Parallel arrays, mapping entity id to data belonging to that instance.
+     * Components are kept in the storage selected for the component type (see
+     * ComponentStorage).
      */
     struct InstanceData
     {
         std::vector<Entity> entity;
-        std::vector<T> component;
+        ComponentStorage<T> component;
     };
 
-    /** Collection of entities and components */
+    /** Collection of entities and components, tightly packed */
     InstanceData m_data;
-    /** Map entity to index into vector of instance data */
-    EntityMap m_map;
+    /**
+     * Map entity index to index into instance data, -1 if the entity has no
+     * component.
+     */
+    std::vector<int> m_sparse;
 };
 
 #include "engine/entity/ComponentManager.hpp"
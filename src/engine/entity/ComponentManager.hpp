@@ -16,10 +16,15 @@ ComponentManager<T>::CreateComponentForEntity(Entity entity)
     unsigned int newIndex = m_data.entity.size();
 
     m_data.entity.push_back(entity);
-    m_data.component.push_back(T());
+    m_data.component.PushBack();
 
-    // Put new entry into the map (mapping index array to Entity)
-    m_map[entity.id] = newIndex;
+    // Point the entity's slot in the sparse array at the new instance
+    const unsigned int entityIndex = entity.GetIndex();
+    if (entityIndex >= m_sparse.size())
+    {
+        m_sparse.resize(entityIndex + 1, -1);
+    }
+    m_sparse[entityIndex] = newIndex;
 
     // Return instance to caller
     return Instance::MakeInstance(newIndex);
@@ -29,11 +34,14 @@ template <typename T>
 Instance ComponentManager<T>::GetInstanceForEntity(Entity entity) const
 {
     int index = -1;
-    EntityMap::const_iterator it = m_map.find(entity.id);
+    const unsigned int entityIndex = entity.GetIndex();
 
-    if (it != m_map.end())
+    // The entity's slot may hold a component of an older generation of the
+    // entity, so check the entity actually matches.
+    if (entityIndex < m_sparse.size() && m_sparse[entityIndex] != -1 &&
+        m_data.entity[m_sparse[entityIndex]].id == entity.id)
     {
-        index = it->second;
+        index = m_sparse[entityIndex];
     }
 
     return Instance::MakeInstance(index);
@@ -46,7 +54,7 @@ Entity ComponentManager<T>::GetEntityForInstance(Instance i) const
 
     const int index = i.index;
 
-    if (index < GetNumInstances() && index >= 0)
+    if (index >= 0 && (unsigned int)index < GetNumInstances())
     {
         e = m_data.entity[index];
     }
@@ -54,6 +62,11 @@ Entity ComponentManager<T>::GetEntityForInstance(Instance i) const
     return e;
 }
 
+template <typename T>
+void ComponentManager<T>::OnRemoveInstance(const Instance &i)
+{
+}
+
 template <typename T>
 void ComponentManager<T>::OnAddressChange(const Instance &oldAddress,
                                           const Instance &newAddress)
@@ -64,8 +77,9 @@ void ComponentManager<T>::OnAddressChange(const Instance &oldAddress,
  * Be very careful with this method, if overriding component manager
  * manages a component which contains references to other components,
  * this method will not keep those references intact. In cases like
- * the above, you should override OnAddressChange to keep the references
- * intact. For an example of this, see TransformComponentManager.
+ * the above, you should override OnRemoveInstance and OnAddressChange to keep
+ * the references intact. For an example of this, see
+ * TransformComponentManager.
  */
 template <typename T>
 bool ComponentManager<T>::RemoveInstance(Instance i)
@@ -76,36 +90,66 @@ bool ComponentManager<T>::RemoveInstance(Instance i)
     // with element we want to remove and reducing the number
     // of active instances.
     const int index = i.index;
-    const unsigned int lastIndex = GetNumInstances() - 1;
 
     // Make sure we are trying to delete a valid instance
-    if (index < GetNumInstances() && index >= 0)
+    if (index >= 0 && (unsigned int)index < GetNumInstances())
     {
-        // Get the entity at the index to destroy
-        Entity entityToDestroy = m_data.entity[index];
-        // Get the entity at the end of the array
-        Entity lastEntity = m_data.entity[lastIndex];
+        const unsigned int lastIndex = GetNumInstances() - 1;
+
+        // Remove references to the deleted component
+        OnRemoveInstance(i);
 
-        // Update the references of the deleted component
-        OnAddressChange(index, -1);
-        // Update the references of the moved component
-        OnAddressChange(lastIndex, index);
+        // Remove the sparse entry for the destroyed entity
+        m_sparse[m_data.entity[index].GetIndex()] = -1;
 
-        // Move last entity's data
-        m_data.entity[index] = m_data.entity[lastIndex];
-        m_data.component[index] = m_data.component[lastIndex];
+        if ((unsigned int)index != lastIndex)
+        {
+            // Update the references of the moved component
+            OnAddressChange(Instance::MakeInstance(lastIndex), i);
 
-        // Update map entry for the swapped entity
-        m_map[lastEntity.id] = index;
-        // Remove the map entry for the destroyed entity
-        m_map.erase(entityToDestroy.id);
+            // Move last entity's data
+            m_data.entity[index] = m_data.entity[lastIndex];
+            m_data.component.Move(lastIndex, index);
+
+            // Update sparse entry for the swapped entity
+            m_sparse[m_data.entity[index].GetIndex()] = index;
+        }
 
         // Destroy component at end of array
         m_data.entity.pop_back();
-        m_data.component.pop_back();
+        m_data.component.PopBack();
 
         result = true;
     }
 
     return result;
 }
+
+template <typename T>
+unsigned int
+ComponentManager<T>::RemoveInstances(const std::vector<Instance> &instances)
+{
+    unsigned int numRemoved = 0;
+
+    // Remove from the back of the array to the front. Removing an instance
+    // only moves the last instance, which is never one still to be removed,
+    // so the remaining instances stay valid.
+    std::vector<int> indices;
+    indices.reserve(instances.size());
+    for (const Instance &i : instances)
+    {
+        indices.push_back(i.index);
+    }
+    std::sort(indices.begin(), indices.end(), std::greater<int>());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    for (int index : indices)
+    {
+        if (RemoveInstance(Instance::MakeInstance(index)))
+        {
+            ++numRemoved;
+        }
+    }
+
+    return numRemoved;
+}
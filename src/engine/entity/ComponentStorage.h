@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ds
+{
+/**
+ * Stores components as an array of structures: all of the data members of a
+ * component are stored together.
+ */
+template <typename T>
+class AosComponentStorage
+{
+public:
+    /**
+     * Get the number of components stored.
+     *
+     * @return  size_t, number of components.
+     */
+    size_t Size() const
+    {
+        return m_components.size();
+    }
+
+    /**
+     * Add a default constructed component to the end of the storage.
+     */
+    void PushBack()
+    {
+        m_components.push_back(T());
+    }
+
+    /**
+     * Remove the component at the end of the storage.
+     */
+    void PopBack()
+    {
+        m_components.pop_back();
+    }
+
+    /**
+     * Copy the component at one index over the component at another.
+     *
+     * @param  from  size_t, index of the component to copy.
+     * @param  to    size_t, index of the component to overwrite.
+     */
+    void Move(size_t from, size_t to)
+    {
+        m_components[to] = m_components[from];
+    }
+
+    T &operator[](size_t index)
+    {
+        return m_components[index];
+    }
+
+    const T &operator[](size_t index) const
+    {
+        return m_components[index];
+    }
+
+private:
+    std::vector<T> m_components;
+};
+
+/**
+ * Storage used by ComponentManager for components of type T.
+ *
+ * By default components are stored as an array of structures. To store a
+ * component type differently, i.e. as a structure of arrays so loops that only
+ * touch some data members don't pull the others into cache, specialize this
+ * class for that component type. The specialization must provide Size,
+ * PushBack, PopBack and Move; how it exposes the component data is up to the
+ * component's manager. See TransformComponent for an example.
+ */
+template <typename T>
+class ComponentStorage : public AosComponentStorage<T>
+{
+};
+}
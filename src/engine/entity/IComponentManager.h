@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "engine/entity/Entity.h"
 #include "engine/entity/Instance.h"
@@ -69,5 +70,17 @@ public:
      * @return     bool, TRUE if the remove was successful, FALSE otherwise.
      */
     virtual bool RemoveInstance(Instance i) = 0;
+
+    /**
+     * Remove several component instances from the manager at once.
+     *
+     * Invalid and duplicate instances are ignored.
+     *
+     * @param   instances  const std::vector<Instance> &, the component
+     * instances to remove.
+     * @return             unsigned int, number of instances removed.
+     */
+    virtual unsigned int
+    RemoveInstances(const std::vector<Instance> &instances) = 0;
 };
 }
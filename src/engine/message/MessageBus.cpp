@@ -1,6 +1,7 @@
 #include <algorithm>
 
 #include "engine/message/MessageBus.h"
+#include "engine/message/MessageHelper.h"
 
 namespace ds
 {
@@ -20,6 +21,48 @@ bool MessageBus::AddSystem(std::weak_ptr<ISystem> system)
     if (it == m_systems.end())
     {
         m_systems.insert(it, system);
+        m_isSubscriber.push_back(false);
+        m_messagesFiltered.push_back(ds_msg::MessageStream());
+        result = true;
+    }
+
+    return result;
+}
+
+bool MessageBus::Subscribe(std::weak_ptr<ISystem> system,
+                           ds_msg::MessageType messageType)
+{
+    bool result = false;
+
+    // Find the system
+    std::vector<std::weak_ptr<ISystem>>::const_iterator it =
+        std::find_if(m_systems.begin(), m_systems.end(),
+                     [&](const std::weak_ptr<ISystem> &busSystem)
+                     {
+                         return busSystem.lock() == system.lock();
+                     });
+
+    if (it != m_systems.end())
+    {
+        size_t systemIndex = it - m_systems.begin();
+        size_t typeIndex = static_cast<size_t>(messageType);
+
+        if (typeIndex >= m_subscribers.size())
+        {
+            m_subscribers.resize(typeIndex + 1);
+        }
+
+        std::vector<size_t> &subscribers = m_subscribers[typeIndex];
+
+        // Only subscribe once
+        if (std::find(subscribers.begin(), subscribers.end(), systemIndex) ==
+            subscribers.end())
+        {
+            subscribers.push_back(systemIndex);
+        }
+
+        m_isSubscriber[systemIndex] = true;
+
         result = true;
     }
 
@@ -43,15 +86,59 @@ void MessageBus::CollectAllMessages()
 
 void MessageBus::BroadcastAllMessages()
 {
-    for (auto &system : m_systems)
+    bool hasSubscribers =
+        std::find(m_isSubscriber.begin(), m_isSubscriber.end(), true) !=
+        m_isSubscriber.end();
+
+    // Sort messages into the streams of the systems subscribed to them
+    if (hasSubscribers)
+    {
+        // Read from a copy so the message store is left untouched for systems
+        // without subscriptions.
+        ds_msg::MessageStream messages = m_messageStoreTemp;
+
+        while (messages.AvailableBytes() != 0)
+        {
+            ds_msg::MessageHeader header;
+            messages >> header;
+
+            size_t typeIndex = static_cast<size_t>(header.type);
+            if (typeIndex < m_subscribers.size())
+            {
+                for (size_t systemIndex : m_subscribers[typeIndex])
+                {
+                    ds_msg::AppendMessage(&m_messagesFiltered[systemIndex],
+                                          header.type, header.size,
+                                          messages.GetDataPtr());
+                }
+            }
+
+            messages.Extract(header.size);
+        }
+    }
+
+    for (size_t i = 0; i < m_systems.size(); ++i)
     {
         // Convert weak pointer to shared pointer temporarily
-        std::shared_ptr<ISystem> systemPtr = system.lock();
+        std::shared_ptr<ISystem> systemPtr = m_systems[i].lock();
 
         if (systemPtr)
         {
-            systemPtr->PostMessages(m_messageStoreTemp);
+            if (m_isSubscriber[i])
+            {
+                // Don't bother posting an empty stream
+                if (m_messagesFiltered[i].AvailableBytes() != 0)
+                {
+                    systemPtr->PostMessages(m_messagesFiltered[i]);
+                }
+            }
+            else
+            {
+                systemPtr->PostMessages(m_messageStoreTemp);
+            }
         }
+
+        m_messagesFiltered[i].Clear();
     }
 
     m_messageStoreTemp.Clear();
@@ -66,4 +153,28 @@ ds_msg::MessageStream MessageBus::CollectMessages()
 {
     return m_messageStoreTemp;
 }
+
+ds_msg::MessageStream MessageBus::CollectMessages(
+    const std::vector<ds_msg::MessageType> &messageTypes)
+{
+    ds_msg::MessageStream collected;
+    ds_msg::MessageStream messages = m_messageStoreTemp;
+
+    while (messages.AvailableBytes() != 0)
+    {
+        ds_msg::MessageHeader header;
+        messages >> header;
+
+        if (std::find(messageTypes.begin(), messageTypes.end(), header.type) !=
+            messageTypes.end())
+        {
+            ds_msg::AppendMessage(&collected, header.type, header.size,
+                                  messages.GetDataPtr());
+        }
+
+        messages.Extract(header.size);
+    }
+
+    return collected;
+}
 }
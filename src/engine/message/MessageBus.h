@@ -32,6 +32,24 @@ public:
      */
     bool AddSystem(std::weak_ptr<ISystem> system);
 
+    /**
+     * Subscribe a system to a type of message.
+     *
+     * A system that has subscribed to at least one type of message will only
+     * be posted messages of the types it has subscribed to. A system that has
+     * not subscribed to any type of message is posted every message.
+     *
+     * The system must have been added to the message bus first.
+     *
+     * @param   system       std::weak_ptr<ISystem>, system to subscribe.
+     * @param   messageType  ds_msg::MessageType, type of message to subscribe
+     *                       the system to.
+     * @return               bool, TRUE if the system was subscribed
+     *                       successfully, FALSE otherwise.
+     */
+    bool Subscribe(std::weak_ptr<ISystem> system,
+                   ds_msg::MessageType messageType);
+
     /**
      * Collect all messages from the systems the message bus manages.
      *
@@ -44,6 +62,14 @@ public:
      * Broadcast all messages collected by the message bus to the systems
      * managed by the message bus.
      *
+     * Every system that has not subscribed to specific message types is handed
+     * the same message stream, which shares it's storage with the message
+     * bus, so the cost of a broadcast does not depend on the number of bytes of
+     * messages collected. Systems with subscriptions are handed a stream
+     * containing only the messages they subscribed to, in the order they were
+     * collected. The collected messages are only walked once, regardless of
+     * the number of systems.
+     *
      * Purges all messages when finished.
      */
     void BroadcastAllMessages();
@@ -71,8 +97,27 @@ public:
      */
     ds_msg::MessageStream CollectMessages();
 
+    /**
+     * Collect messages of the given types from the Message Bus.
+     *
+     * @param   messageTypes  const std::vector<ds_msg::MessageType> &, types
+     * of messages to collect.
+     * @return                ds_msg::MessageStream, stream of messages of the
+     * given types.
+     */
+    ds_msg::MessageStream
+    CollectMessages(const std::vector<ds_msg::MessageType> &messageTypes);
+
 private:
     std::vector<std::weak_ptr<ISystem>> m_systems;
+    // Whether or not each system (by index) only receives the messages it has
+    // subscribed to.
+    std::vector<bool> m_isSubscriber;
+    // Indices of the systems subscribed to each message type (indexed by
+    // message type).
+    std::vector<std::vector<size_t>> m_subscribers;
+    // Messages each system (by index) will be posted this frame.
+    std::vector<ds_msg::MessageStream> m_messagesFiltered;
 
     ds_msg::MessageStream m_messageStoreTemp;
 };
@@ -1,3 +1,4 @@
+#include "engine/common/StringHash.h"
 #include "engine/message/MessageFactory.h"
 
 namespace ds_msg
@@ -6,7 +7,9 @@ MessageStream MessageFactory::ConstructMessage(std::string messageString)
 {
     MessageStream stream;
 
-    if (messageString == "console_toggle")
+    switch (ds_com::HashString(messageString))
+    {
+    case ds_com::HashString("console_toggle"):
     {
         MessageHeader header;
         header.type = ds_msg::MessageType::ConsoleToggle;
@@ -15,8 +18,9 @@ MessageStream MessageFactory::ConstructMessage(std::string messageString)
         ConsoleToggle consoleToggle;
 
         stream << header << consoleToggle;
+        break;
     }
-    else if (messageString == "quit")
+    case ds_com::HashString("quit"):
     {
         MessageHeader header;
         header.type = ds_msg::MessageType::QuitEvent;
@@ -25,6 +29,10 @@ MessageStream MessageFactory::ConstructMessage(std::string messageString)
         QuitEvent quitEvent;
 
         stream << header << quitEvent;
+        break;
+    }
+    default:
+        break;
     }
 
     return stream;
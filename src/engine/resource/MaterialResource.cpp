@@ -8,6 +8,11 @@
 
 namespace ds
 {
+MaterialResource::MaterialResource()
+{
+    m_instanced = false;
+}
+
 std::unique_ptr<IResource>
 MaterialResource::CreateFromFile(std::string filePath)
 {
@@ -178,6 +183,15 @@ MaterialResource::CreateFromFile(std::string filePath)
                 static_cast<MaterialResource *>(materialResource.get())
                     ->AddUniformBlock(uniformBlock);
             }
+
+            // Optional, shaders that place each mesh from the Instances
+            // uniform block can draw many copies of a mesh at once
+            bool instanced = false;
+            if (config.GetBool("instanced", &instanced))
+            {
+                static_cast<MaterialResource *>(materialResource.get())
+                    ->SetInstanced(instanced);
+            }
         }
         else
         {
@@ -268,6 +282,16 @@ MaterialResource::GetUniformBlocks() const
     return m_uniformBlocks;
 }
 
+bool MaterialResource::IsInstanced() const
+{
+    return m_instanced;
+}
+
+void MaterialResource::SetInstanced(bool instanced)
+{
+    m_instanced = instanced;
+}
+
 // void MaterialResource::AddUniform(const ds_render::Uniform &uniform)
 // {
 //     // Find a uniform with the same name
@@ -13,6 +13,11 @@ namespace ds
 class MaterialResource : public IResource
 {
 public:
+    /**
+     * Create an empty, not instanced, material resource.
+     */
+    MaterialResource();
+
     /**
      * Create a material resource from file.
      *
@@ -104,6 +109,22 @@ public:
      */
     const std::vector<ds_render::UniformBlock> &GetUniformBlocks() const;
 
+    /**
+     * Get whether the shader of this material supports instanced drawing.
+     *
+     * @return  bool, TRUE if the shader reads model matrices from the
+     * Instances uniform block, FALSE otherwise.
+     */
+    bool IsInstanced() const;
+
+    /**
+     * Set whether the shader of this material supports instanced drawing.
+     *
+     * @param  instanced  bool, TRUE if the shader reads model matrices from
+     * the Instances uniform block, FALSE otherwise.
+     */
+    void SetInstanced(bool instanced);
+
 private:
     /** Path to material shader file */
     std::string m_shaderPath;
@@ -113,5 +134,7 @@ private:
     std::vector<ds_render::UniformBlock> m_uniformBlocks;
     /** This resource's file path */
     std::string m_filePath;
+    /** Whether the shader supports instanced drawing */
+    bool m_instanced;
 };
 }
@@ -55,6 +55,11 @@ ds_msg::MessageStream Console::CollectMessages()
     return tmp;
 }
 
+bool Console::RequiresMainThread() const
+{
+    return false;
+}
+
 void Console::Flush()
 {
     std::cout << m_buffer.str();
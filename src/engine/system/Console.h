@@ -58,6 +58,13 @@ public:
      */
     virtual ds_msg::MessageStream CollectMessages();
 
+    /**
+     * The console system may be updated on a worker thread.
+     *
+     * @return  bool, FALSE.
+     */
+    virtual bool RequiresMainThread() const;
+
 private:
     /**
      * Flush the consoles output buffer to output.
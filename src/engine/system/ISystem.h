@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "engine/Config.h"
 #include "engine/message/Message.h"
 #include "engine/system/script/ScriptBindingSet.h"
@@ -42,6 +44,22 @@ public:
      */
     virtual void Update(float deltaTime) = 0;
 
+    /**
+     * Optionally present the state of the system, once per frame on the main
+     * thread after all of the frame's updates.
+     *
+     * Updates happen at a fixed timestep, so a frame may contain any number of
+     * them. The interpolation factor is how far the frame is between the last
+     * update and the next, and can be used to blend between the previous and
+     * current state of the system.
+     *
+     * @param  interpolation  float, fraction of a timestep in the range [0, 1)
+     * between the last update and the next.
+     */
+    virtual void Present(float interpolation)
+    {
+    }
+
     /**
      * Perform any teardown of the system.
      */
@@ -72,6 +90,36 @@ public:
      */
     virtual ds_msg::MessageStream CollectMessages() = 0;
 
+    /**
+     * Does the system have to be updated on the main thread?
+     *
+     * Systems that use thread-affine APIs (windowing, graphics contexts, etc.)
+     * must be updated on the main thread. Other systems may be updated
+     * concurrently with each other on worker threads.
+     *
+     * @return  bool, TRUE if the system must be updated on the main thread,
+     * FALSE otherwise.
+     */
+    virtual bool RequiresMainThread() const
+    {
+        return true;
+    }
+
+    /**
+     * Optionally return the types of messages the system handles.
+     *
+     * If the system returns any message types, only messages of those types
+     * will be posted to the system. Otherwise, all messages are posted to the
+     * system.
+     *
+     * @return  std::vector<ds_msg::MessageType>, types of messages the system
+     * wants to be posted.
+     */
+    virtual std::vector<ds_msg::MessageType> GetMessageSubscriptions() const
+    {
+        return std::vector<ds_msg::MessageType>();
+    }
+
     /**
      * Optionally return any required script bindings.
      *
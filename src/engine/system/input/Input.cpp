@@ -122,6 +122,19 @@ ds_msg::MessageStream Input::CollectMessages()
     return tmp;
 }
 
+bool Input::RequiresMainThread() const
+{
+    return false;
+}
+
+std::vector<ds_msg::MessageType> Input::GetMessageSubscriptions() const
+{
+    std::vector<ds_msg::MessageType> subscriptions;
+    subscriptions.push_back(ds_msg::MessageType::KeyboardEvent);
+
+    return subscriptions;
+}
+
 ScriptBindingSet Input::GetScriptBindings() const
 {
     ScriptBindingSet scriptBindings;
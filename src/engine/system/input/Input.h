@@ -75,6 +75,21 @@ public:
      */
     virtual ds_msg::MessageStream CollectMessages();
 
+    /**
+     * The input system may be updated on a worker thread.
+     *
+     * @return  bool, FALSE.
+     */
+    virtual bool RequiresMainThread() const;
+
+    /**
+     * Return the types of messages the input system handles.
+     *
+     * @return  std::vector<ds_msg::MessageType>, types of messages the
+     * input system wants to be posted.
+     */
+    virtual std::vector<ds_msg::MessageType> GetMessageSubscriptions() const;
+
     /**
      * Return required script bindings.
      *
@@ -55,7 +55,10 @@ void Platform::Update(float deltaTime)
 
     // Process events
     ProcessEvents(&m_messagesReceived);
+}
 
+void Platform::Present(float interpolation)
+{
     m_video.Update();
 }
 
@@ -80,6 +83,14 @@ ds_msg::MessageStream Platform::CollectMessages()
     return tmp;
 }
 
+std::vector<ds_msg::MessageType> Platform::GetMessageSubscriptions() const
+{
+    std::vector<ds_msg::MessageType> subscriptions;
+    subscriptions.push_back(ds_msg::MessageType::ConsoleToggle);
+
+    return subscriptions;
+}
+
 void Platform::AppendSDL2EventToGeneratedMessages(SDL_Event event)
 {
     ds_msg::MessageHeader header;
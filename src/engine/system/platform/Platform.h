@@ -34,6 +34,14 @@ public:
      */
     virtual void Update(float deltaTime);
 
+    /**
+     * Swap the window's buffers, displaying the last frame rendered.
+     *
+     * @param  interpolation  float, fraction of a timestep between the last
+     * update and the next.
+     */
+    virtual void Present(float interpolation);
+
     /**
      * Shutdown the system.
      */
@@ -58,6 +66,14 @@ public:
      */
     virtual ds_msg::MessageStream CollectMessages();
 
+    /**
+     * Return the types of messages the platform handles.
+     *
+     * @return  std::vector<ds_msg::MessageType>, types of messages the
+     * platform wants to be posted.
+     */
+    virtual std::vector<ds_msg::MessageType> GetMessageSubscriptions() const;
+
 private:
     /**
      * Translate an SDL2 event into a message and append it to the list of
@@ -0,0 +1,322 @@
+#include <cstring>
+
+#include "engine/system/render/CommandBuffer.h"
+
+namespace ds_render
+{
+// Copy a command out of the command data, which may not be aligned for it
+template <typename T>
+static void ReadCommand(const char *data, T *command)
+{
+    memcpy(reinterpret_cast<char *>(command), data, sizeof(T));
+}
+
+CommandBuffer::CommandBuffer()
+{
+    m_numCommands = 0;
+}
+
+void CommandBuffer::Clear()
+{
+    m_commands.clear();
+    m_numCommands = 0;
+}
+
+void CommandBuffer::ClearBuffers(bool colour, bool depth, bool stencil)
+{
+    ClearBuffersCommand command;
+    command.colour = colour;
+    command.depth = depth;
+    command.stencil = stencil;
+
+    AppendCommand(CommandType::ClearBuffers, sizeof(command), &command, 0,
+                  nullptr);
+}
+
+void CommandBuffer::SetProgram(ProgramHandle programHandle)
+{
+    SetProgramCommand command;
+    command.program = programHandle;
+
+    AppendCommand(CommandType::SetProgram, sizeof(command), &command, 0,
+                  nullptr);
+}
+
+void CommandBuffer::BindTextureToSampler(ProgramHandle programHandle,
+                                         const std::string &samplerName,
+                                         TextureHandle textureHandle)
+{
+    BindTextureToSamplerCommand command;
+    command.program = programHandle;
+    command.samplerName = ds::StringIntern::Instance().Intern(samplerName);
+    command.texture = textureHandle;
+
+    AppendCommand(CommandType::BindTextureToSampler, sizeof(command), &command,
+                  0, nullptr);
+}
+
+void CommandBuffer::UnbindTextureFromSampler(TextureHandle textureHandle)
+{
+    UnbindTextureFromSamplerCommand command;
+    command.texture = textureHandle;
+
+    AppendCommand(CommandType::UnbindTextureFromSampler, sizeof(command),
+                  &command, 0, nullptr);
+}
+
+void CommandBuffer::UpdateConstantBufferData(
+    ConstantBufferHandle constantBufferHandle,
+    const ConstantBufferDescription &constantBufferDescription)
+{
+    UpdateConstantBufferCommand command;
+    command.constantBuffer = constantBufferHandle;
+    command.bufferSize = constantBufferDescription.GetBufferSize();
+    command.offset = 0;
+    command.numBytes = command.bufferSize;
+
+    AppendCommand(CommandType::UpdateConstantBufferData, sizeof(command),
+                  &command, command.numBytes,
+                  constantBufferDescription.GetDataPtr());
+}
+
+void CommandBuffer::UpdateConstantBufferSubData(
+    ConstantBufferHandle constantBufferHandle,
+    const ConstantBufferDescription &constantBufferDescription,
+    size_t offset,
+    size_t numBytes)
+{
+    UpdateConstantBufferCommand command;
+    command.constantBuffer = constantBufferHandle;
+    command.bufferSize = constantBufferDescription.GetBufferSize();
+    command.offset = offset;
+    command.numBytes = numBytes;
+
+    AppendCommand(
+        CommandType::UpdateConstantBufferSubData, sizeof(command), &command,
+        numBytes,
+        (const char *)constantBufferDescription.GetDataPtr() + offset);
+}
+
+void CommandBuffer::BindConstantBufferRange(
+    ConstantBufferHandle constantBufferHandle, size_t offset, size_t numBytes)
+{
+    BindConstantBufferRangeCommand command;
+    command.constantBuffer = constantBufferHandle;
+    command.offset = offset;
+    command.numBytes = numBytes;
+
+    AppendCommand(CommandType::BindConstantBufferRange, sizeof(command),
+                  &command, 0, nullptr);
+}
+
+void CommandBuffer::DrawVertices(VertexBufferHandle buffer,
+                                 PrimitiveType primitiveType,
+                                 size_t startingVertex,
+                                 size_t numVertices)
+{
+    DrawCommand command;
+    command.vertexBuffer = buffer;
+    command.primitiveType = primitiveType;
+    command.start = startingVertex;
+    command.count = numVertices;
+    command.numInstances = 1;
+
+    AppendCommand(CommandType::DrawVertices, sizeof(command), &command, 0,
+                  nullptr);
+}
+
+void CommandBuffer::DrawVerticesIndexed(VertexBufferHandle buffer,
+                                        IndexBufferHandle indexBuffer,
+                                        PrimitiveType primitiveType,
+                                        size_t startingIndex,
+                                        size_t numIndices)
+{
+    DrawCommand command;
+    command.vertexBuffer = buffer;
+    command.indexBuffer = indexBuffer;
+    command.primitiveType = primitiveType;
+    command.start = startingIndex;
+    command.count = numIndices;
+    command.numInstances = 1;
+
+    AppendCommand(CommandType::DrawVerticesIndexed, sizeof(command), &command,
+                  0, nullptr);
+}
+
+void CommandBuffer::DrawVerticesIndexedInstanced(
+    VertexBufferHandle buffer,
+    IndexBufferHandle indexBuffer,
+    PrimitiveType primitiveType,
+    size_t startingIndex,
+    size_t numIndices,
+    size_t numInstances)
+{
+    DrawCommand command;
+    command.vertexBuffer = buffer;
+    command.indexBuffer = indexBuffer;
+    command.primitiveType = primitiveType;
+    command.start = startingIndex;
+    command.count = numIndices;
+    command.numInstances = numInstances;
+
+    AppendCommand(CommandType::DrawVerticesIndexedInstanced, sizeof(command),
+                  &command, 0, nullptr);
+}
+
+void CommandBuffer::Execute(IRenderer *renderer) const
+{
+    // Constant buffer data is handed to the renderer in a description, only
+    // reallocated when a buffer of a different size is updated
+    ConstantBufferDescription constantBufferData;
+
+    size_t position = 0;
+    while (position < m_commands.size())
+    {
+        CommandHeader header;
+        ReadCommand(&m_commands[position], &header);
+        position += sizeof(header);
+
+        const char *payload = &m_commands[position];
+
+        switch (header.type)
+        {
+        case CommandType::ClearBuffers:
+        {
+            ClearBuffersCommand command;
+            ReadCommand(payload, &command);
+            renderer->ClearBuffers(command.colour, command.depth,
+                                   command.stencil);
+            break;
+        }
+        case CommandType::SetProgram:
+        {
+            SetProgramCommand command;
+            ReadCommand(payload, &command);
+            renderer->SetProgram(command.program);
+            break;
+        }
+        case CommandType::BindTextureToSampler:
+        {
+            BindTextureToSamplerCommand command;
+            ReadCommand(payload, &command);
+            renderer->BindTextureToSampler(
+                command.program,
+                ds::StringIntern::Instance().GetString(command.samplerName),
+                command.texture);
+            break;
+        }
+        case CommandType::UnbindTextureFromSampler:
+        {
+            UnbindTextureFromSamplerCommand command;
+            ReadCommand(payload, &command);
+            renderer->UnbindTextureFromSampler(command.texture);
+            break;
+        }
+        case CommandType::UpdateConstantBufferData:
+        case CommandType::UpdateConstantBufferSubData:
+        {
+            UpdateConstantBufferCommand command;
+            ReadCommand(payload, &command);
+
+            if (constantBufferData.GetBufferSize() != command.bufferSize)
+            {
+                constantBufferData =
+                    ConstantBufferDescription(command.bufferSize);
+            }
+
+            ConstantBufferDescription::Member member;
+            member.offset = command.offset;
+            constantBufferData.InsertMemberData(member, command.numBytes,
+                                                payload + sizeof(command));
+
+            if (header.type == CommandType::UpdateConstantBufferData)
+            {
+                renderer->UpdateConstantBufferData(command.constantBuffer,
+                                                   constantBufferData);
+            }
+            else
+            {
+                renderer->UpdateConstantBufferSubData(
+                    command.constantBuffer, constantBufferData, command.offset,
+                    command.numBytes);
+            }
+            break;
+        }
+        case CommandType::BindConstantBufferRange:
+        {
+            BindConstantBufferRangeCommand command;
+            ReadCommand(payload, &command);
+            renderer->BindConstantBufferRange(
+                command.constantBuffer, command.offset, command.numBytes);
+            break;
+        }
+        case CommandType::DrawVertices:
+        {
+            DrawCommand command;
+            ReadCommand(payload, &command);
+            renderer->DrawVertices(command.vertexBuffer, command.primitiveType,
+                                   command.start, command.count);
+            break;
+        }
+        case CommandType::DrawVerticesIndexed:
+        {
+            DrawCommand command;
+            ReadCommand(payload, &command);
+            renderer->DrawVerticesIndexed(
+                command.vertexBuffer, command.indexBuffer,
+                command.primitiveType, command.start, command.count);
+            break;
+        }
+        case CommandType::DrawVerticesIndexedInstanced:
+        {
+            DrawCommand command;
+            ReadCommand(payload, &command);
+            renderer->DrawVerticesIndexedInstanced(
+                command.vertexBuffer, command.indexBuffer,
+                command.primitiveType, command.start, command.count,
+                command.numInstances);
+            break;
+        }
+        default:
+            break;
+        }
+
+        position += header.size;
+    }
+}
+
+size_t CommandBuffer::GetNumCommands() const
+{
+    return m_numCommands;
+}
+
+size_t CommandBuffer::GetNumBytes() const
+{
+    return m_commands.size();
+}
+
+void CommandBuffer::AppendCommand(CommandType type,
+                                  size_t commandSize,
+                                  const void *command,
+                                  size_t dataSize,
+                                  const void *data)
+{
+    CommandHeader header;
+    header.type = type;
+    header.size = commandSize + dataSize;
+
+    // One resize per command, the vector only reallocates as it first grows
+    size_t position = m_commands.size();
+    m_commands.resize(position + sizeof(header) + header.size);
+
+    memcpy(&m_commands[position], &header, sizeof(header));
+    position += sizeof(header);
+    memcpy(&m_commands[position], command, commandSize);
+    if (dataSize > 0)
+    {
+        memcpy(&m_commands[position + commandSize], data, dataSize);
+    }
+
+    ++m_numCommands;
+}
+}
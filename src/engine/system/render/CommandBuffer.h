@@ -0,0 +1,293 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "engine/common/StringIntern.h"
+#include "engine/system/render/IRenderer.h"
+
+namespace ds_render
+{
+/**
+ * Records renderer operations to be made later, in order, by the thread that
+ * owns the renderer.
+ *
+ * Each operation is stored as a command header followed by a POD payload, the
+ * same way messages are. Constant buffer data is copied in after it's payload
+ * and sampler names are interned, so nothing recorded refers to memory the
+ * caller may change or free. Commands are packed into a single byte array
+ * that is reused between frames, rather than a stream buffer, as recording a
+ * command is then a single append.
+ *
+ * Recording never touches the renderer, so a frame can be split between
+ * threads each recording into a command buffer of their own. The render
+ * thread then executes the buffers one after another. A command buffer may be
+ * executed any number of times, by any number of threads, as long as it
+ * isn't recorded to at the same time.
+ *
+ * Only the operations made while drawing are recorded. Creating resources and
+ * writing streaming constant buffers return results the caller needs
+ * straight away, so they are still made on the renderer itself.
+ */
+class CommandBuffer
+{
+public:
+    /**
+     * Create an empty command buffer.
+     */
+    CommandBuffer();
+
+    /**
+     * Remove all commands, keeping the memory allocated for them.
+     */
+    void Clear();
+
+    /**
+     * Record IRenderer::ClearBuffers.
+     *
+     * @param  colour   bool, TRUE to clear colour buffer, FALSE otherwise.
+     * @param  depth    bool, TRUE to clear depth buffer, FALSE otherwise.
+     * @param  stencil  bool, TRUE to clear stencil buffer, FALSE otherwise.
+     */
+    void ClearBuffers(bool colour, bool depth, bool stencil);
+
+    /**
+     * Record IRenderer::SetProgram.
+     *
+     * @param  programHandle  ProgramHandle, program to set as the current
+     * program.
+     */
+    void SetProgram(ProgramHandle programHandle);
+
+    /**
+     * Record IRenderer::BindTextureToSampler.
+     *
+     * @param  programHandle  ProgramHandle, program containing the sampler.
+     * @param  samplerName    const std::string &, name of the sampler in the
+     * program. Interned, so recording a name seen before doesn't allocate.
+     * @param  textureHandle  TextureHandle, texture to bind to the sampler.
+     */
+    void BindTextureToSampler(ProgramHandle programHandle,
+                              const std::string &samplerName,
+                              TextureHandle textureHandle);
+
+    /**
+     * Record IRenderer::UnbindTextureFromSampler.
+     *
+     * @param  textureHandle  TextureHandle, texture to unbind.
+     */
+    void UnbindTextureFromSampler(TextureHandle textureHandle);
+
+    /**
+     * Record IRenderer::UpdateConstantBufferData. The description's data is
+     * copied into the command buffer.
+     *
+     * @param  constantBufferHandle       ConstantBufferHandle, constant buffer
+     * to update.
+     * @param  constantBufferDescription  const ConstantBufferDescription &,
+     * new constant buffer data.
+     */
+    void UpdateConstantBufferData(
+        ConstantBufferHandle constantBufferHandle,
+        const ConstantBufferDescription &constantBufferDescription);
+
+    /**
+     * Record IRenderer::UpdateConstantBufferSubData. Only the bytes updated
+     * are copied into the command buffer.
+     *
+     * @param  constantBufferHandle       ConstantBufferHandle, constant buffer
+     * to update.
+     * @param  constantBufferDescription  const ConstantBufferDescription &,
+     * new constant buffer data.
+     * @param  offset                     size_t, offset in bytes of the data
+     * to update.
+     * @param  numBytes                   size_t, number of bytes to update.
+     */
+    void UpdateConstantBufferSubData(
+        ConstantBufferHandle constantBufferHandle,
+        const ConstantBufferDescription &constantBufferDescription,
+        size_t offset,
+        size_t numBytes);
+
+    /**
+     * Record IRenderer::BindConstantBufferRange.
+     *
+     * @param  constantBufferHandle  ConstantBufferHandle, constant buffer.
+     * @param  offset                size_t, offset of the range in bytes.
+     * @param  numBytes              size_t, size of the range in bytes.
+     */
+    void BindConstantBufferRange(ConstantBufferHandle constantBufferHandle,
+                                 size_t offset,
+                                 size_t numBytes);
+
+    /**
+     * Record IRenderer::DrawVertices.
+     *
+     * @param  buffer          VertexBufferHandle, vertex buffer to draw from.
+     * @param  primitiveType   PrimitiveType, primitives to draw with vertices.
+     * @param  startingVertex  size_t, index of the vertex to begin drawing
+     * from.
+     * @param  numVertices     size_t, number of vertices to draw.
+     */
+    void DrawVertices(VertexBufferHandle buffer,
+                      PrimitiveType primitiveType,
+                      size_t startingVertex,
+                      size_t numVertices);
+
+    /**
+     * Record IRenderer::DrawVerticesIndexed.
+     *
+     * @param  buffer         VertexBufferHandle, vertex buffer to draw from.
+     * @param  indexBuffer    IndexBufferHandle, index buffer to draw with.
+     * @param  primitiveType  PrimitiveType, primitives to draw with vertices.
+     * @param  startingIndex  size_t, index to begin drawing from.
+     * @param  numIndices     size_t, number of indices to draw.
+     */
+    void DrawVerticesIndexed(VertexBufferHandle buffer,
+                             IndexBufferHandle indexBuffer,
+                             PrimitiveType primitiveType,
+                             size_t startingIndex,
+                             size_t numIndices);
+
+    /**
+     * Record IRenderer::DrawVerticesIndexedInstanced.
+     *
+     * @param  buffer         VertexBufferHandle, vertex buffer to draw from.
+     * @param  indexBuffer    IndexBufferHandle, index buffer to draw with.
+     * @param  primitiveType  PrimitiveType, primitives to draw with vertices.
+     * @param  startingIndex  size_t, index to begin drawing from.
+     * @param  numIndices     size_t, number of indices to draw.
+     * @param  numInstances   size_t, number of instances to draw.
+     */
+    void DrawVerticesIndexedInstanced(VertexBufferHandle buffer,
+                                      IndexBufferHandle indexBuffer,
+                                      PrimitiveType primitiveType,
+                                      size_t startingIndex,
+                                      size_t numIndices,
+                                      size_t numInstances);
+
+    /**
+     * Make the recorded operations on a renderer, in the order recorded. The
+     * commands are kept, so they can be executed again.
+     *
+     * @param  renderer  IRenderer *, renderer to make the operations on.
+     */
+    void Execute(IRenderer *renderer) const;
+
+    /**
+     * Get the number of commands recorded.
+     *
+     * @return  size_t, number of commands.
+     */
+    size_t GetNumCommands() const;
+
+    /**
+     * Get the size of the commands recorded, including the constant buffer
+     * data copied.
+     *
+     * @return  size_t, size of the commands in bytes.
+     */
+    size_t GetNumBytes() const;
+
+private:
+    /**
+     * Type of a command.
+     */
+    enum class CommandType
+    {
+        ClearBuffers,
+        SetProgram,
+        BindTextureToSampler,
+        UnbindTextureFromSampler,
+        UpdateConstantBufferData,
+        UpdateConstantBufferSubData,
+        BindConstantBufferRange,
+        DrawVertices,
+        DrawVerticesIndexed,
+        DrawVerticesIndexedInstanced
+    };
+
+    /**
+     * Command header, used to extract the command payload correctly.
+     */
+    struct CommandHeader
+    {
+        CommandType type;
+        size_t size;
+    };
+
+    // Command payloads
+    struct ClearBuffersCommand
+    {
+        bool colour;
+        bool depth;
+        bool stencil;
+    };
+
+    struct SetProgramCommand
+    {
+        ProgramHandle program;
+    };
+
+    struct BindTextureToSamplerCommand
+    {
+        ProgramHandle program;
+        ds::StringIntern::StringId samplerName; // Interned sampler name
+        TextureHandle texture;
+    };
+
+    struct UnbindTextureFromSamplerCommand
+    {
+        TextureHandle texture;
+    };
+
+    // Followed by numBytes of data, to write at offset
+    struct UpdateConstantBufferCommand
+    {
+        ConstantBufferHandle constantBuffer;
+        size_t bufferSize; // Size of the whole constant buffer
+        size_t offset;
+        size_t numBytes;
+    };
+
+    struct BindConstantBufferRangeCommand
+    {
+        ConstantBufferHandle constantBuffer;
+        size_t offset;
+        size_t numBytes;
+    };
+
+    // Payload of every type of draw, numInstances only used when instanced
+    struct DrawCommand
+    {
+        VertexBufferHandle vertexBuffer;
+        IndexBufferHandle indexBuffer;
+        PrimitiveType primitiveType;
+        size_t start;
+        size_t count;
+        size_t numInstances;
+    };
+
+    /**
+     * Append a command to the command stream.
+     *
+     * @param  type         CommandType, type of the command.
+     * @param  commandSize  size_t, size of the command payload struct.
+     * @param  command      const void *, command payload.
+     * @param  dataSize     size_t, size of the data following the payload, 0
+     * if none.
+     * @param  data         const void *, data following the payload, nullptr
+     * if none.
+     */
+    void AppendCommand(CommandType type,
+                       size_t commandSize,
+                       const void *command,
+                       size_t dataSize,
+                       const void *data);
+
+    /** Headers and payloads of the commands, in the order recorded */
+    std::vector<char> m_commands;
+    /** Number of commands in m_commands */
+    size_t m_numCommands;
+};
+}
@@ -1,3 +1,5 @@
+#include <cassert>
+#include <cstring>
 #include <iostream>
 
 #include "engine/system/render/ConstantBufferDescription.h"
@@ -56,6 +58,42 @@ void ConstantBufferDescription::InsertMemberData(const std::string &memberName,
     }
 }
 
+bool ConstantBufferDescription::GetMember(const std::string &memberName,
+                                          Member *member) const
+{
+    bool result = false;
+
+    // Try to find offset for member
+    std::map<std::string, size_t>::const_iterator it =
+        m_offsetMap.find(memberName);
+
+    // Members that the renderer didn't find are left without an offset
+    if (it != m_offsetMap.end() && it->second < m_data.size())
+    {
+        member->offset = it->second;
+        result = true;
+    }
+    else
+    {
+        std::cerr << "ConstantBufferDescription::GetMember: No member with "
+                     "name '"
+                  << memberName << "'." << std::endl;
+    }
+
+    return result;
+}
+
+void ConstantBufferDescription::InsertMemberData(Member member,
+                                                 size_t dataSize,
+                                                 const void *data)
+{
+    assert(member.offset + dataSize <= m_data.size() &&
+           "ConstantBufferDescription::InsertMemberData: Data doesn't fit in "
+           "data store.");
+
+    memcpy(&m_data[member.offset], data, dataSize);
+}
+
 std::vector<std::string> ConstantBufferDescription::GetMemberNames() const
 {
     std::vector<std::string> memberNames;
@@ -11,10 +11,24 @@ namespace ds_render
  * class as a bridge.
  *
  * A data store is created by the renderer and you fill it's data up.
+ *
+ * Members are named, but looking a name up every time a member is written is
+ * slow. Data written often, such as per object data, should find the member
+ * once with GetMember and write to it with the Member returned.
  */
 class ConstantBufferDescription
 {
 public:
+    /**
+     * A member of the data store, found by name once so that it can be
+     * written to without looking the name up again.
+     */
+    struct Member
+    {
+        /** Offset of the member in the data store, in bytes */
+        size_t offset;
+    };
+
     /**
      * Create a constant buffer data store of the given size;
      *
@@ -49,6 +63,32 @@ public:
                           size_t dataSize,
                           const void *data);
 
+    /**
+     * Find a member of the data store by name.
+     *
+     * Offsets are set by the renderer, so this should be called after the
+     * description has been filled in by the renderer.
+     *
+     * @param   memberName  const std::string &, name of the member.
+     * @param   member      Member *, where to store the member if found. Not
+     * modified otherwise.
+     * @return              bool, TRUE if the member was found and it's offset
+     * set, FALSE otherwise.
+     */
+    bool GetMember(const std::string &memberName, Member *member) const;
+
+    /**
+     * Insert data into a member of the ConstantBufferDescription.
+     *
+     * @pre  member must have been found in this description, and the data
+     * must fit in the data store from the member's offset.
+     *
+     * @param  member    Member, member to insert data into.
+     * @param  dataSize  size_t, size of the data to insert.
+     * @param  data      const void *, data to insert.
+     */
+    void InsertMemberData(Member member, size_t dataSize, const void *data);
+
     /**
      * Get a list of the names of all members in the constant buffer.
      *
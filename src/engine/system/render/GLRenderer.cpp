@@ -1,3 +1,4 @@
+#include <cstring>
 #include <iostream>
 
 #include "engine/system/render/GLRenderer.h"
@@ -5,6 +6,20 @@
 
 namespace ds_render
 {
+GLRenderer::GLRenderer()
+{
+    // Largest alignment any implementation requires, until Init asks
+    m_constantBufferOffsetAlignment = 256;
+    m_programBinariesSupported = false;
+
+    // OpenGL's initial state
+    m_state.program = 0;
+    m_state.vertexArray = 0;
+    m_state.indexBuffer = 0;
+    m_state.activeTextureUnit = 0;
+    m_state.uniformBuffer = 0;
+}
+
 bool GLRenderer::Init(unsigned int viewportWidth, unsigned int viewportHeight)
 {
     bool result = false;
@@ -22,6 +37,17 @@ bool GLRenderer::Init(unsigned int viewportWidth, unsigned int viewportHeight)
         result = true;
     }
 
+    GLint offsetAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    if (offsetAlignment > 0)
+    {
+        m_constantBufferOffsetAlignment = offsetAlignment;
+    }
+
+    GLint numProgramBinaryFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numProgramBinaryFormats);
+    m_programBinariesSupported = (numProgramBinaryFormats > 0);
+
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
     glClearDepth(1.0f);
@@ -87,6 +113,8 @@ GLRenderer::CreateVertexBuffer(BufferUsageType usage,
     GLuint vao = 0;
 
     glGenVertexArrays(1, &vao);
+    // Bound around the cached state, which it is put back to after. It's
+    // index buffer starts unbound, as the cache assumes.
     glBindVertexArray(vao);
     // Bind vertex buffer
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -108,7 +136,7 @@ GLRenderer::CreateVertexBuffer(BufferUsageType usage,
             (char *)NULL + attributeDescriptor.offset);
     }
 
-    glBindVertexArray(0);
+    glBindVertexArray(m_state.vertexArray);
 
     // Return handle to VAO
     return ((VertexBufferHandle)StoreOpenGLObject(
@@ -122,7 +150,9 @@ IndexBufferHandle GLRenderer::CreateIndexBuffer(BufferUsageType usage,
     GLuint ibo = 0;
 
     glGenBuffers(1, &ibo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+    // Binds it to the vertex array bound, draws with that vertex array bind
+    // their own
+    BindElementArrayBuffer(ibo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, numBytes, data,
                  ToGLBufferUsageType(usage));
 
@@ -189,6 +219,13 @@ GLRenderer::CreateProgram(const std::vector<ShaderHandle> &shaders)
         glAttachShader(program, shaderObject);
     }
 
+    // Keep the linked binary so it can be cached
+    if (m_programBinariesSupported)
+    {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                            GL_TRUE);
+    }
+
     // Link shaders into shader program
     glLinkProgram(program);
 
@@ -216,6 +253,71 @@ GLRenderer::CreateProgram(const std::vector<ShaderHandle> &shaders)
         // No error, create program
         handle = (ProgramHandle)StoreOpenGLObject(program,
                                                   GLObjectType::ProgramObject);
+        StoreProgramInterface(program);
+    }
+
+    return handle;
+}
+
+bool GLRenderer::GetProgramBinary(ProgramHandle programHandle,
+                                  std::vector<char> *binary) const
+{
+    bool result = false;
+
+    GLuint program = 0;
+    if (m_programBinariesSupported && binary != nullptr &&
+        GetOpenGLObject(programHandle, GLObjectType::ProgramObject, &program))
+    {
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+        if (length > 0)
+        {
+            // The binary is stored after the format it's in
+            GLenum format = GL_NONE;
+            GLsizei numWritten = 0;
+            binary->resize(sizeof(format) + length);
+            glGetProgramBinary(program, length, &numWritten, &format,
+                               &(*binary)[sizeof(format)]);
+            memcpy(&(*binary)[0], &format, sizeof(format));
+            binary->resize(sizeof(format) + numWritten);
+
+            result = (numWritten > 0);
+        }
+    }
+
+    return result;
+}
+
+ProgramHandle GLRenderer::CreateProgramFromBinary(size_t numBytes,
+                                                  const void *binary)
+{
+    ProgramHandle handle;
+
+    GLenum format = GL_NONE;
+    if (m_programBinariesSupported && numBytes > sizeof(format))
+    {
+        memcpy(&format, binary, sizeof(format));
+
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, format,
+                        (const char *)binary + sizeof(format),
+                        numBytes - sizeof(format));
+
+        // Fails if the binary was made by a different driver
+        int linkResult = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linkResult);
+
+        if (linkResult == GL_FALSE)
+        {
+            glDeleteProgram(program);
+        }
+        else
+        {
+            handle = (ProgramHandle)StoreOpenGLObject(
+                program, GLObjectType::ProgramObject);
+            StoreProgramInterface(program);
+        }
     }
 
     return handle;
@@ -227,7 +329,7 @@ void GLRenderer::SetProgram(ProgramHandle programHandle)
     GLuint program;
     if (GetOpenGLObject(programHandle, GLObjectType::ProgramObject, &program))
     {
-        glUseProgram(program);
+        UseProgram(program);
     }
     else
     {
@@ -247,7 +349,14 @@ TextureHandle GLRenderer::Create2DTexture(ImageFormat format,
     // Create OpenGL texture object
     GLuint tex;
     glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    // Texture units may be in use, put back what was bound after
+    const unsigned int unit = m_state.activeTextureUnit;
+    GLuint previousTex = 0;
+    if (unit < m_state.textures.size())
+    {
+        previousTex = m_state.textures[unit];
+    }
+    BindTexture(unit, tex);
 
     glTexImage2D(GL_TEXTURE_2D, 0, ToGLInternalImageFormat(internalFormat),
                  width, height, 0, ToGLImageFormat(format),
@@ -277,8 +386,7 @@ TextureHandle GLRenderer::Create2DTexture(ImageFormat format,
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
                     maxAnisotropy);
 
-    // Unbind texture object
-    glBindTexture(GL_TEXTURE_2D, 0);
+    BindTexture(unit, previousTex);
 
     // Create handle to texture object
     return (TextureHandle)StoreOpenGLObject(tex, GLObjectType::TextureObject);
@@ -288,46 +396,62 @@ void GLRenderer::BindTextureToSampler(ProgramHandle programHandle,
                                       const std::string &samplerName,
                                       TextureHandle textureHandle)
 {
-    // Is texture already bound to a texture slot?
-    std::vector<TextureHandle>::iterator it =
-        std::find(m_textureSlots.begin(), m_textureSlots.end(), textureHandle);
-
-    // Texture not already bound
-    if (it == m_textureSlots.end())
+    GLuint tex = 0;
+    if (GetOpenGLObject(textureHandle, GLObjectType::TextureObject, &tex))
     {
-        // Find an empty texture slot
-        it = std::find(m_textureSlots.begin(), m_textureSlots.end(),
-                       TextureHandle());
+        // Is texture already bound to a texture slot?
+        std::vector<TextureHandle>::iterator it = std::find(
+            m_textureSlots.begin(), m_textureSlots.end(), textureHandle);
 
-        // Insert into slot
-        if (it != m_textureSlots.end())
+        // Texture not already bound
+        if (it == m_textureSlots.end())
         {
-            *it = textureHandle;
-        }
-        // Or add it to end if no empty texture slot found
-        else
-        {
-            // Update iterator
-            it = m_textureSlots.insert(m_textureSlots.end(), textureHandle);
+            // Find an empty texture slot, preferably the one the texture was
+            // left bound to when last unbound
+            it = std::find(m_textureSlots.begin(), m_textureSlots.end(),
+                           TextureHandle());
+            for (unsigned int i = 0; i < m_textureSlots.size() &&
+                                     i < m_state.textures.size();
+                 ++i)
+            {
+                if (m_textureSlots[i] == TextureHandle() &&
+                    m_state.textures[i] == tex)
+                {
+                    it = m_textureSlots.begin() + i;
+                }
+            }
+
+            // Insert into slot
+            if (it != m_textureSlots.end())
+            {
+                *it = textureHandle;
+            }
+            // Or add it to end if no empty texture slot found
+            else
+            {
+                // Update iterator
+                it = m_textureSlots.insert(m_textureSlots.end(), textureHandle);
+            }
         }
-    }
 
-    // Calculate texture slot index
-    unsigned int textureSlot = it - m_textureSlots.begin();
+        // Calculate texture slot index
+        unsigned int textureSlot = it - m_textureSlots.begin();
 
-    // Bind GL texture
-    GLuint tex = 0;
-    if (GetOpenGLObject(textureHandle, GLObjectType::TextureObject, &tex))
-    {
-        glActiveTexture(GL_TEXTURE0 + textureSlot);
-        glBindTexture(GL_TEXTURE_2D, tex);
+        // Bind GL texture
+        BindTexture(textureSlot, tex);
 
         GLuint program = 0;
         if (GetOpenGLObject(programHandle, GLObjectType::ProgramObject,
                             &program))
         {
-            glUniform1i(glGetUniformLocation(program, samplerName.c_str()),
-                        textureSlot);
+            // Point the sampler at the slot, if it isn't already. Like
+            // glUniform1i, assumes the program is the one set.
+            ProgramUniform *sampler = GetProgramUniform(program, samplerName);
+            if (sampler != nullptr && sampler->value != (GLint)textureSlot)
+            {
+                glUniform1i(sampler->location, textureSlot);
+                sampler->value = textureSlot;
+            }
         }
         else
         {
@@ -349,17 +473,13 @@ void GLRenderer::UnbindTextureFromSampler(TextureHandle textureHandle)
     // Find texture slot of texture
     std::vector<TextureHandle>::iterator it =
         std::find(m_textureSlots.begin(), m_textureSlots.end(), textureHandle);
-    unsigned int textureSlot = it - m_textureSlots.begin();
 
-    // Insert into empty texture handle
+    // Free the slot. The OpenGL texture is left bound until another texture
+    // needs the unit, so binding it again before then costs nothing.
     if (it != m_textureSlots.end())
     {
         *it = TextureHandle();
     }
-
-    // Unbind OpenGL texture from sampler
-    glActiveTexture(GL_TEXTURE0 + textureSlot);
-    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void GLRenderer::GetConstantBufferDescription(
@@ -376,8 +496,13 @@ void GLRenderer::GetConstantBufferDescription(
             // From
             // https://www.packtpub.com/books/content/opengl-40-using-uniform-blocks-and-uniform-buffer-objects
             // Get index of uniform block
-            GLuint blockIndex =
-                glGetUniformBlockIndex(program, constantBufferName.c_str());
+            GLuint blockIndex = GL_INVALID_INDEX;
+            ProgramUniformBlock *block =
+                GetProgramUniformBlock(program, constantBufferName);
+            if (block != nullptr)
+            {
+                blockIndex = block->index;
+            }
 
             // Get size of uniform block (GL size may differ from C++ size)
             GLint blockSize;
@@ -454,44 +579,173 @@ void GLRenderer::GetConstantBufferDescription(
 ConstantBufferHandle GLRenderer::CreateConstantBuffer(
     const ConstantBufferDescription &constantBufferDescription)
 {
-    // Create OpenGL buffer object and copy data to it
+    // Create OpenGL buffer object and copy data to it. Constant buffers are
+    // rewritten every frame, so hint that they change.
     GLuint ubo;
     glGenBuffers(1, &ubo);
-    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    BindUniformBuffer(ubo);
     glBufferData(GL_UNIFORM_BUFFER, constantBufferDescription.GetBufferSize(),
-                 constantBufferDescription.GetDataPtr(), GL_STATIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+                 constantBufferDescription.GetDataPtr(), GL_DYNAMIC_DRAW);
 
     // Create handle to ubo object
     ConstantBufferHandle constantBufferHandle =
         (ConstantBufferHandle)StoreOpenGLObject(
             ubo, GLObjectType::ConstantBufferObject);
 
-    // Find an empty binding point
-    std::vector<ConstantBufferHandle>::iterator it =
-        std::find(m_constantBufferBindingPoints.begin(),
-                  m_constantBufferBindingPoints.end(), ConstantBufferHandle());
+    AddConstantBufferBindingPoint(constantBufferHandle, ubo);
 
-    // Binding point found, insert into binding point
-    if (it != m_constantBufferBindingPoints.end())
+    return constantBufferHandle;
+}
+
+ConstantBufferHandle GLRenderer::CreateStreamingConstantBuffer(size_t numBytes)
+{
+    // Storage only, data is written a range at a time
+    GLuint ubo;
+    glGenBuffers(1, &ubo);
+    BindUniformBuffer(ubo);
+    glBufferData(GL_UNIFORM_BUFFER, numBytes, nullptr, GL_STREAM_DRAW);
+
+    ConstantBufferHandle constantBufferHandle =
+        (ConstantBufferHandle)StoreOpenGLObject(
+            ubo, GLObjectType::ConstantBufferObject);
+
+    AddConstantBufferBindingPoint(constantBufferHandle, ubo);
+
+    StreamingBuffer streamingBuffer;
+    streamingBuffer.handle = constantBufferHandle;
+    streamingBuffer.size = numBytes;
+    streamingBuffer.head = 0;
+    streamingBuffer.current.begin = 0;
+    streamingBuffer.current.end = 0;
+    streamingBuffer.current.fence = 0;
+    m_streamingBuffers.push_back(streamingBuffer);
+
+    return constantBufferHandle;
+}
+
+size_t GLRenderer::GetConstantBufferOffsetAlignment() const
+{
+    return m_constantBufferOffsetAlignment;
+}
+
+bool GLRenderer::WriteStreamingConstantBuffer(
+    ConstantBufferHandle constantBufferHandle,
+    size_t numBytes,
+    const void *data,
+    size_t *offset)
+{
+    bool result = false;
+
+    StreamingBuffer *streamingBuffer = nullptr;
+    for (StreamingBuffer &buffer : m_streamingBuffers)
     {
-        *it = constantBufferHandle;
+        if (buffer.handle == constantBufferHandle)
+        {
+            streamingBuffer = &buffer;
+        }
+    }
+
+    GLuint ubo = 0;
+    if (streamingBuffer != nullptr &&
+        GetOpenGLObject(constantBufferHandle,
+                        GLObjectType::ConstantBufferObject, &ubo))
+    {
+        BindUniformBuffer(ubo);
+
+        // Draws using the last range written have all been made by now
+        if (streamingBuffer->current.begin != streamingBuffer->current.end)
+        {
+            streamingBuffer->current.fence =
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            streamingBuffer->inFlight.push_back(streamingBuffer->current);
+        }
+
+        // Too big to ever fit, replace the storage with storage for a few
+        // writes this size. Draws still reading the old storage keep it
+        // alive, so there is nothing to wait for.
+        if (numBytes > streamingBuffer->size)
+        {
+            for (const StreamingRange &range : streamingBuffer->inFlight)
+            {
+                glDeleteSync(range.fence);
+            }
+            streamingBuffer->inFlight.clear();
+
+            streamingBuffer->size = 3 * numBytes;
+            streamingBuffer->head = 0;
+            glBufferData(GL_UNIFORM_BUFFER, streamingBuffer->size, nullptr,
+                         GL_STREAM_DRAW);
+        }
+
+        // Start at the next aligned offset, or wrap around to the start if
+        // there isn't room before the end
+        const size_t alignment = m_constantBufferOffsetAlignment;
+        size_t begin =
+            (streamingBuffer->head + alignment - 1) / alignment * alignment;
+        if (begin + numBytes > streamingBuffer->size)
+        {
+            begin = 0;
+        }
+
+        WaitForStreamingRange(streamingBuffer, begin, begin + numBytes);
+
+        // Nothing is reading the range any more, so no need for the driver to
+        // synchronize
+        void *mapped = glMapBufferRange(
+            GL_UNIFORM_BUFFER, begin, numBytes,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                GL_MAP_UNSYNCHRONIZED_BIT);
+        if (mapped != nullptr)
+        {
+            memcpy(mapped, data, numBytes);
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+
+            streamingBuffer->current.begin = begin;
+            streamingBuffer->current.end = begin + numBytes;
+            streamingBuffer->head = begin + numBytes;
+
+            *offset = begin;
+            result = true;
+        }
+        else
+        {
+            std::cerr << "GLRenderer::WriteStreamingConstantBuffer: Failed to "
+                         "map constant buffer."
+                      << std::endl;
+
+            streamingBuffer->current.begin = 0;
+            streamingBuffer->current.end = 0;
+        }
     }
-    // Or add it to end if no empty constant buffer binding point found
     else
     {
-        // Update iterator
-        it = m_constantBufferBindingPoints.insert(
-            m_constantBufferBindingPoints.end(), constantBufferHandle);
+        std::cerr << "GLRenderer::WriteStreamingConstantBuffer: Failed to get "
+                     "streaming constant buffer associated with constant "
+                     "buffer handle provided."
+                  << std::endl;
     }
 
-    // Calculate binding point index
-    unsigned int bindingPointIndex = it - m_constantBufferBindingPoints.begin();
-
-    // Bind ubo to binding point
-    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPointIndex, ubo);
+    return result;
+}
 
-    return constantBufferHandle;
+void GLRenderer::BindConstantBufferRange(
+    ConstantBufferHandle constantBufferHandle, size_t offset, size_t numBytes)
+{
+    unsigned int bindingPointIndex = 0;
+    GLuint ubo = 0;
+    if (GetConstantBufferBindingPoint(constantBufferHandle,
+                                      &bindingPointIndex) &&
+        GetOpenGLObject(constantBufferHandle,
+                        GLObjectType::ConstantBufferObject, &ubo))
+    {
+        BindUniformBufferRange(bindingPointIndex, ubo, offset, numBytes);
+    }
+    else
+    {
+        std::cerr << "GLRenderer::BindConstantBufferRange: Constant buffer "
+                     "hasn't been bound to a binding point!"
+                  << std::endl;
+    }
 }
 
 // ConstantBufferHandle
@@ -633,28 +887,25 @@ void GLRenderer::BindConstantBuffer(ProgramHandle programHandle,
                                     ConstantBufferHandle constantBufferHandle)
 {
     // Find constant buffer object's binding point
-    std::vector<ConstantBufferHandle>::iterator it =
-        std::find(m_constantBufferBindingPoints.begin(),
-                  m_constantBufferBindingPoints.end(), constantBufferHandle);
-
-    // Binding point found
-    if (it != m_constantBufferBindingPoints.end())
+    unsigned int bindingPointIndex = 0;
+    if (GetConstantBufferBindingPoint(constantBufferHandle,
+                                      &bindingPointIndex))
     {
-        // Calculate binding point index
-        unsigned int bindingPointIndex =
-            it - m_constantBufferBindingPoints.begin();
-
         // Get program object
         GLuint program = 0;
         if (GetOpenGLObject(programHandle, GLObjectType::ProgramObject,
                             &program))
         {
-            // Get constant buffer block index
-            GLuint blockIndex =
-                glGetUniformBlockIndex(program, constantBufferName.c_str());
-            // Bind block index to binding point index, which ubo (constant
-            // buffer) is also bound to
-            glUniformBlockBinding(program, blockIndex, bindingPointIndex);
+            // Bind block to binding point index, which ubo (constant buffer)
+            // is also bound to, if it isn't already
+            ProgramUniformBlock *block =
+                GetProgramUniformBlock(program, constantBufferName);
+            if (block != nullptr && block->bindingPoint != bindingPointIndex)
+            {
+                glUniformBlockBinding(program, block->index,
+                                      bindingPointIndex);
+                block->bindingPoint = bindingPointIndex;
+            }
         }
         else
         {
@@ -679,11 +930,12 @@ void GLRenderer::UpdateConstantBufferData(
     if (GetOpenGLObject(constantBufferHandle,
                         GLObjectType::ConstantBufferObject, &ubo))
     {
-        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
-        glBufferData(GL_UNIFORM_BUFFER,
-                     constantBufferDescription.GetBufferSize(),
-                     constantBufferDescription.GetDataPtr(), GL_STATIC_DRAW);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        // The buffer was created with the description's size, so write into
+        // the storage it has rather than reallocating it with glBufferData
+        BindUniformBuffer(ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0,
+                        constantBufferDescription.GetBufferSize(),
+                        constantBufferDescription.GetDataPtr());
     }
     else
     {
@@ -694,14 +946,38 @@ void GLRenderer::UpdateConstantBufferData(
     }
 }
 
+void GLRenderer::UpdateConstantBufferSubData(
+    ConstantBufferHandle constantBufferHandle,
+    const ConstantBufferDescription &constantBufferDescription,
+    size_t offset,
+    size_t numBytes)
+{
+    GLuint ubo = 0;
+    if (GetOpenGLObject(constantBufferHandle,
+                        GLObjectType::ConstantBufferObject, &ubo))
+    {
+        BindUniformBuffer(ubo);
+        glBufferSubData(
+            GL_UNIFORM_BUFFER, offset, numBytes,
+            (const char *)constantBufferDescription.GetDataPtr() + offset);
+    }
+    else
+    {
+        std::cerr << "GLRenderer::UpdateConstantBufferSubData: Failed to get "
+                     "constant buffer associated with constant buffer handle "
+                     "provided."
+                  << std::endl;
+    }
+}
+
 void GLRenderer::DrawVertices(VertexBufferHandle buffer,
                               PrimitiveType primitiveType,
                               size_t startingVertex,
                               size_t numVertices)
 {
+    // Left bound, so draws of the same vertex buffer after needn't bind it
     BindVertexBuffer(buffer);
     glDrawArrays(ToGLPrimitiveType(primitiveType), startingVertex, numVertices);
-    UnbindVertexBuffer();
 }
 
 void GLRenderer::DrawVerticesIndexed(VertexBufferHandle buffer,
@@ -714,8 +990,21 @@ void GLRenderer::DrawVerticesIndexed(VertexBufferHandle buffer,
     BindIndexBuffer(indexBuffer);
     glDrawElements(ToGLPrimitiveType(primitiveType), numIndices,
                    GL_UNSIGNED_INT, (unsigned int *)NULL + startingIndex);
-    UnbindIndexBuffer();
-    UnbindVertexBuffer();
+}
+
+void GLRenderer::DrawVerticesIndexedInstanced(VertexBufferHandle buffer,
+                                              IndexBufferHandle indexBuffer,
+                                              PrimitiveType primitiveType,
+                                              size_t startingIndex,
+                                              size_t numIndices,
+                                              size_t numInstances)
+{
+    BindVertexBuffer(buffer);
+    BindIndexBuffer(indexBuffer);
+    glDrawElementsInstanced(ToGLPrimitiveType(primitiveType), numIndices,
+                            GL_UNSIGNED_INT,
+                            (unsigned int *)NULL + startingIndex,
+                            numInstances);
 }
 
 ds::Handle GLRenderer::StoreOpenGLObject(GLuint glObject, GLObjectType type)
@@ -724,29 +1013,15 @@ ds::Handle GLRenderer::StoreOpenGLObject(GLuint glObject, GLObjectType type)
     GLObject obj;
     obj.object = glObject;
 
-    // Insert object into vector so we can get it's address and pass it to
-    // the
-    // handle.
+    // Insert object into deque so we can get it's address and pass it to the
+    // handle. Pushing onto the back of a deque never moves the elements
+    // already in it, so the addresses held by existing handles stay valid.
     m_openGLObjects.push_back(obj);
-    // Location in vector of GLObject we just added
-    size_t loc = m_openGLObjects.size() - 1;
+    GLObject &stored = m_openGLObjects.back();
     // Get address of GLObject and create handle from it
-    ds::Handle handle =
-        m_handleManager.Add((void *)&m_openGLObjects[loc], (uint32_t)type);
-    // Store handle with GLObject
-    m_openGLObjects[loc].handle = handle;
+    stored.handle = m_handleManager.Add((void *)&stored, (uint32_t)type);
 
-    // Because pushing an element back on the vector might cause the vector
-    // to
-    // realloc, and hence the address of all GLObjects in the vector change,
-    // update the address of all handles.
-    for (unsigned int i = 0; i < m_openGLObjects.size(); ++i)
-    {
-        ds::Handle handle = m_openGLObjects[i].handle;
-        m_handleManager.Update(handle, &m_openGLObjects[i]);
-    }
-
-    return handle;
+    return stored.handle;
 }
 
 bool GLRenderer::GetOpenGLObject(ds::Handle handle,
@@ -787,13 +1062,106 @@ bool GLRenderer::GetOpenGLObject(ds::Handle handle,
     return result;
 }
 
+void GLRenderer::AddConstantBufferBindingPoint(
+    ConstantBufferHandle constantBufferHandle, GLuint ubo)
+{
+    // Find an empty binding point
+    std::vector<ConstantBufferHandle>::iterator it =
+        std::find(m_constantBufferBindingPoints.begin(),
+                  m_constantBufferBindingPoints.end(), ConstantBufferHandle());
+
+    // Binding point found, insert into binding point
+    if (it != m_constantBufferBindingPoints.end())
+    {
+        *it = constantBufferHandle;
+    }
+    // Or add it to end if no empty constant buffer binding point found
+    else
+    {
+        // Update iterator
+        it = m_constantBufferBindingPoints.insert(
+            m_constantBufferBindingPoints.end(), constantBufferHandle);
+    }
+
+    // Calculate binding point index
+    unsigned int bindingPointIndex = it - m_constantBufferBindingPoints.begin();
+
+    // Bind ubo to binding point
+    BindUniformBufferRange(bindingPointIndex, ubo, 0, 0);
+}
+
+bool GLRenderer::GetConstantBufferBindingPoint(
+    ConstantBufferHandle constantBufferHandle,
+    unsigned int *bindingPoint) const
+{
+    bool result = false;
+
+    // Find constant buffer object's binding point
+    std::vector<ConstantBufferHandle>::const_iterator it =
+        std::find(m_constantBufferBindingPoints.begin(),
+                  m_constantBufferBindingPoints.end(), constantBufferHandle);
+
+    if (it != m_constantBufferBindingPoints.end())
+    {
+        *bindingPoint = it - m_constantBufferBindingPoints.begin();
+        result = true;
+    }
+
+    return result;
+}
+
+void GLRenderer::WaitForStreamingRange(StreamingBuffer *streamingBuffer,
+                                       size_t begin,
+                                       size_t end)
+{
+    // Find the newest fenced range overlapping the range
+    size_t numToWaitFor = 0;
+    for (size_t i = 0; i < streamingBuffer->inFlight.size(); ++i)
+    {
+        const StreamingRange &range = streamingBuffer->inFlight[i];
+        if (range.begin < end && begin < range.end)
+        {
+            numToWaitFor = i + 1;
+        }
+    }
+
+    if (numToWaitFor > 0)
+    {
+        GLsync fence = streamingBuffer->inFlight[numToWaitFor - 1].fence;
+
+        // Flush the first time, so the fence is sure to be signalled
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        GLenum waitResult = GL_TIMEOUT_EXPIRED;
+        while (waitResult == GL_TIMEOUT_EXPIRED)
+        {
+            waitResult = glClientWaitSync(fence, flags, 1000000);
+            flags = 0;
+        }
+
+        if (waitResult == GL_WAIT_FAILED)
+        {
+            std::cerr << "GLRenderer::WaitForStreamingRange: Failed to wait "
+                         "for streaming constant buffer range."
+                      << std::endl;
+        }
+    }
+
+    // Fences signal in order, so every range before the one waited for is
+    // done with too
+    for (size_t i = 0; i < numToWaitFor; ++i)
+    {
+        glDeleteSync(streamingBuffer->inFlight.front().fence);
+        streamingBuffer->inFlight.pop_front();
+    }
+}
+
 void GLRenderer::BindVertexBuffer(VertexBufferHandle vertexBufferHandle)
 {
     GLuint vao;
     if (GetOpenGLObject(vertexBufferHandle, GLObjectType::VertexArrayObject,
                         &vao))
     {
-        glBindVertexArray(vao);
+        BindVertexArray(vao);
     }
     else
     {
@@ -803,18 +1171,13 @@ void GLRenderer::BindVertexBuffer(VertexBufferHandle vertexBufferHandle)
     }
 }
 
-void GLRenderer::UnbindVertexBuffer()
-{
-    glBindVertexArray(0);
-}
-
 void GLRenderer::BindIndexBuffer(IndexBufferHandle indexBufferHandle)
 {
     GLuint ibo;
     if (GetOpenGLObject(indexBufferHandle, GLObjectType::IndexBufferObject,
                         &ibo))
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        BindElementArrayBuffer(ibo);
     }
     else
     {
@@ -823,9 +1186,190 @@ void GLRenderer::BindIndexBuffer(IndexBufferHandle indexBufferHandle)
     }
 }
 
-void GLRenderer::UnbindIndexBuffer()
+void GLRenderer::StoreProgramInterface(GLuint program)
 {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    ProgramInterface &programInterface = m_programInterfaces[program];
+
+    // Uniforms outside of uniform blocks, the only ones with locations
+    GLint numUniforms = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &numUniforms);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+    std::vector<GLchar> name(maxNameLength + 1);
+    for (GLint i = 0; i < numUniforms; ++i)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = GL_NONE;
+        glGetActiveUniform(program, i, name.size(), &length, &size, &type,
+                           &name[0]);
+
+        GLint location = glGetUniformLocation(program, &name[0]);
+        if (location != -1)
+        {
+            ProgramUniform uniform;
+            uniform.location = location;
+            uniform.value = -1;
+            programInterface.uniforms[std::string(&name[0], length)] =
+                uniform;
+        }
+    }
+
+    GLint numUniformBlocks = 0;
+    GLint maxBlockNameLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &numUniformBlocks);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH,
+                   &maxBlockNameLength);
+    name.resize(maxBlockNameLength + 1);
+    for (GLint i = 0; i < numUniformBlocks; ++i)
+    {
+        GLsizei length = 0;
+        glGetActiveUniformBlockName(program, i, name.size(), &length,
+                                    &name[0]);
+
+        ProgramUniformBlock uniformBlock;
+        uniformBlock.index = i;
+        uniformBlock.bindingPoint = GL_INVALID_INDEX;
+        programInterface.uniformBlocks[std::string(&name[0], length)] =
+            uniformBlock;
+    }
+}
+
+GLRenderer::ProgramUniform *
+GLRenderer::GetProgramUniform(GLuint program, const std::string &uniformName)
+{
+    ProgramUniform *uniform = nullptr;
+
+    std::unordered_map<GLuint, ProgramInterface>::iterator programInterface =
+        m_programInterfaces.find(program);
+    if (programInterface != m_programInterfaces.end())
+    {
+        std::unordered_map<std::string, ProgramUniform>::iterator it =
+            programInterface->second.uniforms.find(uniformName);
+        if (it != programInterface->second.uniforms.end())
+        {
+            uniform = &it->second;
+        }
+    }
+
+    return uniform;
+}
+
+GLRenderer::ProgramUniformBlock *
+GLRenderer::GetProgramUniformBlock(GLuint program,
+                                   const std::string &uniformBlockName)
+{
+    ProgramUniformBlock *uniformBlock = nullptr;
+
+    std::unordered_map<GLuint, ProgramInterface>::iterator programInterface =
+        m_programInterfaces.find(program);
+    if (programInterface != m_programInterfaces.end())
+    {
+        std::unordered_map<std::string, ProgramUniformBlock>::iterator it =
+            programInterface->second.uniformBlocks.find(uniformBlockName);
+        if (it != programInterface->second.uniformBlocks.end())
+        {
+            uniformBlock = &it->second;
+        }
+    }
+
+    return uniformBlock;
+}
+
+void GLRenderer::UseProgram(GLuint program)
+{
+    if (program != m_state.program)
+    {
+        glUseProgram(program);
+        m_state.program = program;
+    }
+}
+
+void GLRenderer::BindVertexArray(GLuint vao)
+{
+    if (vao != m_state.vertexArray)
+    {
+        glBindVertexArray(vao);
+
+        // The index buffer bound changes with the vertex array
+        m_vertexArrayIndexBuffers[m_state.vertexArray] = m_state.indexBuffer;
+        m_state.vertexArray = vao;
+        m_state.indexBuffer = m_vertexArrayIndexBuffers[vao];
+    }
+}
+
+void GLRenderer::BindElementArrayBuffer(GLuint ibo)
+{
+    if (ibo != m_state.indexBuffer)
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        m_state.indexBuffer = ibo;
+    }
+}
+
+void GLRenderer::BindTexture(unsigned int unit, GLuint tex)
+{
+    if (unit >= m_state.textures.size())
+    {
+        m_state.textures.resize(unit + 1, 0);
+    }
+
+    if (tex != m_state.textures[unit])
+    {
+        if (unit != m_state.activeTextureUnit)
+        {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            m_state.activeTextureUnit = unit;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, tex);
+        m_state.textures[unit] = tex;
+    }
+}
+
+void GLRenderer::BindUniformBuffer(GLuint ubo)
+{
+    if (ubo != m_state.uniformBuffer)
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        m_state.uniformBuffer = ubo;
+    }
+}
+
+void GLRenderer::BindUniformBufferRange(unsigned int bindingPointIndex,
+                                        GLuint ubo,
+                                        size_t offset,
+                                        size_t numBytes)
+{
+    if (bindingPointIndex >= m_state.uniformBufferRanges.size())
+    {
+        BufferRange unbound;
+        unbound.buffer = 0;
+        unbound.offset = 0;
+        unbound.size = 0;
+        m_state.uniformBufferRanges.resize(bindingPointIndex + 1, unbound);
+    }
+
+    BufferRange &range = m_state.uniformBufferRanges[bindingPointIndex];
+    if (ubo != range.buffer || offset != range.offset ||
+        numBytes != range.size)
+    {
+        if (numBytes == 0)
+        {
+            glBindBufferBase(GL_UNIFORM_BUFFER, bindingPointIndex, ubo);
+        }
+        else
+        {
+            glBindBufferRange(GL_UNIFORM_BUFFER, bindingPointIndex, ubo,
+                              offset, numBytes);
+        }
+
+        range.buffer = ubo;
+        range.offset = offset;
+        range.size = numBytes;
+        // Binding to an indexed binding point binds to the generic one too
+        m_state.uniformBuffer = ubo;
+    }
 }
 
 GLenum GLRenderer::ToGLBufferUsageType(BufferUsageType usage) const
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <deque>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <GL/glew.h>
@@ -15,6 +18,11 @@ namespace ds_render
 class GLRenderer : public IRenderer
 {
 public:
+    /**
+     * Create a renderer, Init must be called before it is used.
+     */
+    GLRenderer();
+
     /**
      * Allows renderer to perform any necessary initialization.
      *
@@ -123,6 +131,32 @@ public:
     virtual ProgramHandle
     CreateProgram(const std::vector<ShaderHandle> &shaders);
 
+    /**
+     * Get the linked binary of a program, to create it from later with
+     * CreateProgramFromBinary instead of compiling it's shaders again.
+     *
+     * @param   programHandle  ProgramHandle, handle to program.
+     * @param   binary         std::vector<char> *, where to store the binary.
+     * @return                 bool, TRUE if the binary was got, FALSE if the
+     * renderer can't get program binaries.
+     */
+    virtual bool GetProgramBinary(ProgramHandle programHandle,
+                                  std::vector<char> *binary) const;
+
+    /**
+     * Create a program from a binary got with GetProgramBinary.
+     *
+     * Binaries only work with the driver that made them, so this fails once
+     * the driver changes and the program must be created from source again.
+     *
+     * @param   numBytes  size_t, size of the binary in bytes.
+     * @param   binary    const void *, binary.
+     * @return            ProgramHandle, handle to created program, or an
+     * invalid handle on failure.
+     */
+    virtual ProgramHandle CreateProgramFromBinary(size_t numBytes,
+                                                  const void *binary);
+
     /**
      * Set a shader program as the current shader program
      *
@@ -233,6 +267,83 @@ public:
         ConstantBufferHandle constantBufferHandle,
         const ConstantBufferDescription &constantBufferDescription);
 
+    /**
+     * Update part of the data associated with the given constant buffer,
+     * leaving the rest as it is.
+     *
+     * @param  constantBufferHandle       ConstantBufferHandle, handle to
+     * constant buffer to update data of.
+     * @param  constantBufferDescription  const ConstantBufferDescription &,
+     * new constant buffer data.
+     * @param  offset                     size_t, offset in bytes of the data
+     * to update.
+     * @param  numBytes                   size_t, number of bytes to update.
+     */
+    virtual void UpdateConstantBufferSubData(
+        ConstantBufferHandle constantBufferHandle,
+        const ConstantBufferDescription &constantBufferDescription,
+        size_t offset,
+        size_t numBytes);
+
+    /**
+     * Create a constant buffer that data is streamed to every frame, rather
+     * than rewritten in place.
+     *
+     * The buffer is used as a ring. Each write is fenced once the draws
+     * using it have been made (at the next write), and a write waits on the
+     * fences of the older data it would overwrite, so the CPU only waits on
+     * the GPU once it is a whole buffer ahead. Data is written through an
+     * unsynchronized mapping, so the driver never stalls on the buffer
+     * either.
+     *
+     * @param   numBytes  size_t, size of the buffer in bytes.
+     * @return            ConstantBufferHandle, handle to created constant
+     * buffer object.
+     */
+    virtual ConstantBufferHandle CreateStreamingConstantBuffer(size_t numBytes);
+
+    /**
+     * Get the alignment required of the offset of a constant buffer range
+     * bound with BindConstantBufferRange.
+     *
+     * @return  size_t, GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, in bytes.
+     */
+    virtual size_t GetConstantBufferOffsetAlignment() const;
+
+    /**
+     * Write data to the next free part of a streaming constant buffer.
+     *
+     * @param   constantBufferHandle  ConstantBufferHandle, handle to a
+     * constant buffer created with CreateStreamingConstantBuffer.
+     * @param   numBytes              size_t, number of bytes to write.
+     * @param   data                  const void *, data to write.
+     * @param   offset                size_t *, where to store the offset the
+     * data was written at, aligned to GetConstantBufferOffsetAlignment.
+     * @return                        bool, TRUE if the data was written,
+     * FALSE otherwise.
+     */
+    virtual bool
+    WriteStreamingConstantBuffer(ConstantBufferHandle constantBufferHandle,
+                                 size_t numBytes,
+                                 const void *data,
+                                 size_t *offset);
+
+    /**
+     * Make draws read part of a constant buffer, at the binding point of the
+     * constant buffer.
+     *
+     * @param  constantBufferHandle  ConstantBufferHandle, handle to constant
+     * buffer.
+     * @param  offset                size_t, offset of the range in bytes,
+     * aligned to GetConstantBufferOffsetAlignment.
+     * @param  numBytes              size_t, size of the range in bytes, at
+     * least the size of the constant buffer in the programs reading it.
+     */
+    virtual void
+    BindConstantBufferRange(ConstantBufferHandle constantBufferHandle,
+                            size_t offset,
+                            size_t numBytes);
+
     /**
      * Draw a number of vertices in a vertex buffer.
      *
@@ -267,6 +378,28 @@ public:
                                      size_t startingIndex,
                                      size_t numIndices);
 
+    /**
+     * Draw a number of instances of the vertices in a vertex buffer, chosen
+     * and ordered by the index buffer, in a single draw call.
+     *
+     * The program bound is responsible for placing each instance, by reading
+     * it's data from a constant buffer using gl_InstanceID.
+     *
+     * @param  buffer          VertexBufferHandle, vertex buffer to draw from.
+     * @param  indexBuffer     IndexBufferHandle, index buffer to determine
+     * which vertices to draw and in what order.
+     * @param  primitiveType   PrimitiveType, primitives to draw with vertices.
+     * @param  startingIndex   size_t, index to begin drawing from.
+     * @param  numIndices      size_t, number of indices to draw.
+     * @param  numInstances    size_t, number of instances to draw.
+     */
+    virtual void DrawVerticesIndexedInstanced(VertexBufferHandle buffer,
+                                              IndexBufferHandle indexBuffer,
+                                              PrimitiveType primitiveType,
+                                              size_t startingIndex,
+                                              size_t numIndices,
+                                              size_t numInstances);
+
 private:
     /**
      * A GLuint can represent one of many different OpenGL objects,
@@ -283,6 +416,103 @@ private:
         ConstantBufferObject
     };
 
+    /**
+     * Part of a streaming constant buffer written to, that draws made since
+     * may still be reading.
+     */
+    struct StreamingRange
+    {
+        /** Offset of the first byte */
+        size_t begin;
+        /** Offset after the last byte */
+        size_t end;
+        /** Signalled once the draws made before it have completed */
+        GLsync fence;
+    };
+
+    /**
+     * State of a constant buffer created with CreateStreamingConstantBuffer.
+     */
+    struct StreamingBuffer
+    {
+        /** Handle of the constant buffer */
+        ConstantBufferHandle handle;
+        /** Size of the buffer in bytes */
+        size_t size;
+        /** Offset the next write starts looking for space from */
+        size_t head;
+        /** Last range written, not yet fenced as draws may still be made
+         * with it. Empty (begin == end) if none */
+        StreamingRange current;
+        /** Fenced ranges, oldest first */
+        std::deque<StreamingRange> inFlight;
+    };
+
+    /**
+     * Uniform outside of any uniform block of a program.
+     */
+    struct ProgramUniform
+    {
+        /** Location of the uniform */
+        GLint location;
+        /** Integer value last set (the texture unit of a sampler), -1 if
+         * not set yet */
+        GLint value;
+    };
+
+    /**
+     * Uniform block of a program.
+     */
+    struct ProgramUniformBlock
+    {
+        /** Index of the uniform block */
+        GLuint index;
+        /** Binding point last bound to, GL_INVALID_INDEX if not bound yet */
+        GLuint bindingPoint;
+    };
+
+    /**
+     * Uniforms and uniform blocks of a program, by name, found when it was
+     * linked.
+     */
+    struct ProgramInterface
+    {
+        std::unordered_map<std::string, ProgramUniform> uniforms;
+        std::unordered_map<std::string, ProgramUniformBlock> uniformBlocks;
+    };
+
+    /**
+     * Range of a buffer bound to an indexed binding point.
+     */
+    struct BufferRange
+    {
+        GLuint buffer;
+        size_t offset;
+        /** Size in bytes, 0 for the whole buffer */
+        size_t size;
+    };
+
+    /**
+     * OpenGL state last set by the renderer. Nothing else makes OpenGL
+     * calls, so a call setting state to what it is here is redundant and is
+     * skipped.
+     */
+    struct GLState
+    {
+        GLuint program;
+        GLuint vertexArray;
+        /** Index buffer bound to vertexArray, index buffer bindings are part
+         * of the vertex array */
+        GLuint indexBuffer;
+        unsigned int activeTextureUnit;
+        /** 2D texture bound to each texture unit */
+        std::vector<GLuint> textures;
+        /** Generic uniform buffer binding */
+        GLuint uniformBuffer;
+        /** Range bound to each uniform buffer binding point */
+        std::vector<BufferRange> uniformBufferRanges;
+    };
+
     /** Each OpenGL object is stored with it's handle so that the handles can be
      * updated easily. */
     struct GLObject
@@ -322,6 +552,46 @@ private:
                          GLObjectType type,
                          GLuint *openGLObject) const;
 
+    /**
+     * Give a constant buffer a binding point of it's own and bind it there.
+     *
+     * @param   constantBufferHandle  ConstantBufferHandle, handle to constant
+     * buffer.
+     * @param   ubo                   GLuint, OpenGL buffer of the constant
+     * buffer.
+     */
+    void
+    AddConstantBufferBindingPoint(ConstantBufferHandle constantBufferHandle,
+                                  GLuint ubo);
+
+    /**
+     * Find the binding point a constant buffer is bound to.
+     *
+     * @param   constantBufferHandle  ConstantBufferHandle, handle to constant
+     * buffer.
+     * @param   bindingPoint          unsigned int *, where to store the
+     * binding point index if found. Not modified otherwise.
+     * @return                        bool, TRUE if the constant buffer has a
+     * binding point, FALSE otherwise.
+     */
+    bool
+    GetConstantBufferBindingPoint(ConstantBufferHandle constantBufferHandle,
+                                  unsigned int *bindingPoint) const;
+
+    /**
+     * Wait for the fenced ranges of a streaming buffer that overlap the given
+     * range to be finished with, then forget them. Ranges are fenced in
+     * order, so the ranges fenced before them are forgotten too.
+     *
+     * @param  streamingBuffer  StreamingBuffer *, streaming buffer.
+     * @param  begin            size_t, offset of the first byte of the range.
+     * @param  end              size_t, offset after the last byte of the
+     * range.
+     */
+    void WaitForStreamingRange(StreamingBuffer *streamingBuffer,
+                               size_t begin,
+                               size_t end);
+
     /**
      * Bind a vertex buffer for drawing.
      *
@@ -330,11 +600,6 @@ private:
      */
     void BindVertexBuffer(VertexBufferHandle vertexBufferHandle);
 
-    /**
-     * Unbind current vertex buffers.
-     */
-    void UnbindVertexBuffer();
-
     /**
      * Bind an index buffer for drawing.
      *
@@ -344,9 +609,88 @@ private:
     void BindIndexBuffer(IndexBufferHandle indexBufferHandle);
 
     /**
-     * Unbind current index buffer.
+     * Find the uniforms and uniform blocks of a program just linked, so they
+     * needn't be looked up by name again.
+     *
+     * @param  program  GLuint, OpenGL program, linked successfully.
      */
-    void UnbindIndexBuffer();
+    void StoreProgramInterface(GLuint program);
+
+    /**
+     * Get a uniform of a program, as found when it was linked.
+     *
+     * @param   program      GLuint, OpenGL program.
+     * @param   uniformName  const std::string &, name of the uniform.
+     * @return               ProgramUniform *, uniform, or nullptr if the
+     * program has no active uniform outside a uniform block by that name.
+     */
+    ProgramUniform *GetProgramUniform(GLuint program,
+                                      const std::string &uniformName);
+
+    /**
+     * Get a uniform block of a program, as found when it was linked.
+     *
+     * @param   program           GLuint, OpenGL program.
+     * @param   uniformBlockName  const std::string &, name of the uniform
+     * block.
+     * @return                    ProgramUniformBlock *, uniform block, or
+     * nullptr if the program has no active uniform block by that name.
+     */
+    ProgramUniformBlock *
+    GetProgramUniformBlock(GLuint program,
+                           const std::string &uniformBlockName);
+
+    /**
+     * Make a program current, unless it already is.
+     *
+     * @param  program  GLuint, OpenGL program.
+     */
+    void UseProgram(GLuint program);
+
+    /**
+     * Bind a vertex array, unless it already is bound.
+     *
+     * @param  vao  GLuint, OpenGL vertex array.
+     */
+    void BindVertexArray(GLuint vao);
+
+    /**
+     * Bind an index buffer to the vertex array bound, unless it already is.
+     *
+     * @param  ibo  GLuint, OpenGL buffer.
+     */
+    void BindElementArrayBuffer(GLuint ibo);
+
+    /**
+     * Bind a 2D texture to a texture unit, unless it already is.
+     *
+     * @param  unit  unsigned int, texture unit index.
+     * @param  tex   GLuint, OpenGL texture.
+     */
+    void BindTexture(unsigned int unit, GLuint tex);
+
+    /**
+     * Bind a buffer to the generic uniform buffer binding, unless it already
+     * is.
+     *
+     * @param  ubo  GLuint, OpenGL buffer.
+     */
+    void BindUniformBuffer(GLuint ubo);
+
+    /**
+     * Bind a range of a buffer to an indexed uniform buffer binding point,
+     * unless it already is.
+     *
+     * @param  bindingPointIndex  unsigned int, binding point index.
+     * @param  ubo                GLuint, OpenGL buffer.
+     * @param  offset             size_t, offset of the range in bytes.
+     * @param  numBytes           size_t, size of the range in bytes, 0 for
+     * the whole buffer.
+     */
+    void BindUniformBufferRange(unsigned int bindingPointIndex,
+                                GLuint ubo,
+                                size_t offset,
+                                size_t numBytes);
 
     /**
      * Convert a BufferUsageType to an OpenGL-specific equivalent.
@@ -412,14 +756,31 @@ private:
     ds::HandleManager m_handleManager;
     /**
      * All OpenGL objects that have been created by this renderer and their
-     * handles.
+     * handles. A deque, so objects never move once stored and the handle
+     * manager's pointers to them stay valid.
      */
-    std::vector<GLObject> m_openGLObjects;
+    std::deque<GLObject> m_openGLObjects;
 
     /** Texture slots used/available */
     std::vector<TextureHandle> m_textureSlots;
 
     /** Uniform binding points used/available */
     std::vector<ConstantBufferHandle> m_constantBufferBindingPoints;
+
+    /** Constant buffers created with CreateStreamingConstantBuffer */
+    std::vector<StreamingBuffer> m_streamingBuffers;
+
+    /** GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT */
+    size_t m_constantBufferOffsetAlignment;
+    /** Whether the driver can save and load program binaries */
+    bool m_programBinariesSupported;
+
+    /** Interface of each program created, by OpenGL program */
+    std::unordered_map<GLuint, ProgramInterface> m_programInterfaces;
+
+    /** OpenGL state last set */
+    GLState m_state;
+    /** Index buffer bound to each vertex array that isn't bound */
+    std::unordered_map<GLuint, GLuint> m_vertexArrayIndexBuffers;
 };
 }
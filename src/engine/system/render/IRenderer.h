@@ -125,6 +125,32 @@ public:
     virtual ProgramHandle
     CreateProgram(const std::vector<ShaderHandle> &shaders) = 0;
 
+    /**
+     * Get the linked binary of a program, to create it from later with
+     * CreateProgramFromBinary instead of compiling it's shaders again.
+     *
+     * @param   programHandle  ProgramHandle, handle to program.
+     * @param   binary         std::vector<char> *, where to store the binary.
+     * @return                 bool, TRUE if the binary was got, FALSE if the
+     * renderer can't get program binaries.
+     */
+    virtual bool GetProgramBinary(ProgramHandle programHandle,
+                                  std::vector<char> *binary) const = 0;
+
+    /**
+     * Create a program from a binary got with GetProgramBinary.
+     *
+     * Binaries only work with the driver that made them, so this fails once
+     * the driver changes and the program must be created from source again.
+     *
+     * @param   numBytes  size_t, size of the binary in bytes.
+     * @param   binary    const void *, binary.
+     * @return            ProgramHandle, handle to created program, or an
+     * invalid handle on failure.
+     */
+    virtual ProgramHandle CreateProgramFromBinary(size_t numBytes,
+                                                  const void *binary) = 0;
+
     /**
      * Set a shader program as the current shader program
      *
@@ -235,6 +261,88 @@ public:
         ConstantBufferHandle constantBufferHandle,
         const ConstantBufferDescription &constantBufferDescription) = 0;
 
+    /**
+     * Update part of the data associated with the given constant buffer,
+     * leaving the rest as it is.
+     *
+     * @param  constantBufferHandle       ConstantBufferHandle, handle to
+     * constant buffer to update data of.
+     * @param  constantBufferDescription  const ConstantBufferDescription &,
+     * new constant buffer data.
+     * @param  offset                     size_t, offset in bytes of the data
+     * to update.
+     * @param  numBytes                   size_t, number of bytes to update.
+     */
+    virtual void UpdateConstantBufferSubData(
+        ConstantBufferHandle constantBufferHandle,
+        const ConstantBufferDescription &constantBufferDescription,
+        size_t offset,
+        size_t numBytes) = 0;
+
+    /**
+     * Create a constant buffer that data is streamed to every frame, rather
+     * than rewritten in place.
+     *
+     * Data written to it with WriteStreamingConstantBuffer is placed after
+     * the data written before, wrapping around to the start once the end is
+     * reached. Data still in use by draws already made is never overwritten,
+     * the renderer waits for those draws instead, so the buffer should be
+     * large enough to hold a few frames of data. The buffer grows if a single
+     * write doesn't fit.
+     *
+     * Like any other constant buffer, it is bound to programs with
+     * BindConstantBuffer. Draws then read the part of it bound with
+     * BindConstantBufferRange.
+     *
+     * @param   numBytes  size_t, size of the buffer in bytes.
+     * @return            ConstantBufferHandle, handle to created constant
+     * buffer object.
+     */
+    virtual ConstantBufferHandle
+    CreateStreamingConstantBuffer(size_t numBytes) = 0;
+
+    /**
+     * Get the alignment required of the offset of a constant buffer range
+     * bound with BindConstantBufferRange.
+     *
+     * @return  size_t, alignment in bytes.
+     */
+    virtual size_t GetConstantBufferOffsetAlignment() const = 0;
+
+    /**
+     * Write data to the next free part of a streaming constant buffer.
+     *
+     * @param   constantBufferHandle  ConstantBufferHandle, handle to a
+     * constant buffer created with CreateStreamingConstantBuffer.
+     * @param   numBytes              size_t, number of bytes to write.
+     * @param   data                  const void *, data to write.
+     * @param   offset                size_t *, where to store the offset the
+     * data was written at, aligned to GetConstantBufferOffsetAlignment.
+     * @return                        bool, TRUE if the data was written,
+     * FALSE otherwise.
+     */
+    virtual bool WriteStreamingConstantBuffer(
+        ConstantBufferHandle constantBufferHandle,
+        size_t numBytes,
+        const void *data,
+        size_t *offset) = 0;
+
+    /**
+     * Make draws read part of a constant buffer, at the binding point of the
+     * constant buffer.
+     *
+     * @param  constantBufferHandle  ConstantBufferHandle, handle to constant
+     * buffer.
+     * @param  offset                size_t, offset of the range in bytes,
+     * aligned to GetConstantBufferOffsetAlignment.
+     * @param  numBytes              size_t, size of the range in bytes, at
+     * least the size of the constant buffer in the programs reading it.
+     */
+    virtual void
+    BindConstantBufferRange(ConstantBufferHandle constantBufferHandle,
+                            size_t offset,
+                            size_t numBytes) = 0;
+
     /**
      * Draw a number of vertices in a vertex buffer.
      *
@@ -273,6 +381,28 @@ public:
                                      size_t startingIndex,
                                      size_t numIndices) = 0;
 
+    /**
+     * Draw a number of instances of the vertices in a vertex buffer, chosen
+     * and ordered by the index buffer, in a single draw call.
+     *
+     * The program bound is responsible for placing each instance, by reading
+     * it's data from a constant buffer using the instance index.
+     *
+     * @param  buffer          VertexBufferHandle, vertex buffer to draw from.
+     * @param  indexBuffer     IndexBufferHandle, index buffer to determine
+     * which vertices to draw and in what order.
+     * @param  primitiveType   PrimitiveType, primitives to draw with vertices.
+     * @param  startingIndex   size_t, index to begin drawing from.
+     * @param  numIndices      size_t, number of indices to draw.
+     * @param  numInstances    size_t, number of instances to draw.
+     */
+    virtual void DrawVerticesIndexedInstanced(VertexBufferHandle buffer,
+                                              IndexBufferHandle indexBuffer,
+                                              PrimitiveType primitiveType,
+                                              size_t startingIndex,
+                                              size_t numIndices,
+                                              size_t numInstances) = 0;
+
 private:
 };
 }
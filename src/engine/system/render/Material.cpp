@@ -2,6 +2,11 @@
 
 namespace ds_render
 {
+Material::Material()
+{
+    m_instanced = false;
+}
+
 ProgramHandle Material::GetProgram() const
 {
     return m_program;
@@ -18,7 +23,8 @@ void Material::AddTexture(const std::string &samplerName,
     m_textures.push_back(std::pair<std::string, Texture>(samplerName, texture));
 }
 
-const std::vector<std::pair<std::string, Texture>> &Material::GetTextures()
+const std::vector<std::pair<std::string, Texture>> &
+Material::GetTextures() const
 {
     return m_textures;
 }
@@ -29,4 +35,14 @@ void Material::AddConstantBuffer(const std::string &constantBufferName,
     m_constantBuffers.push_back(std::pair<std::string, ConstantBuffer>(
         constantBufferName, constantBuffer));
 }
+
+bool Material::IsInstanced() const
+{
+    return m_instanced;
+}
+
+void Material::SetInstanced(bool instanced)
+{
+    m_instanced = instanced;
+}
 }
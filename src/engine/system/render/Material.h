@@ -11,6 +11,12 @@ namespace ds_render
 class Material
 {
 public:
+    /**
+     * Create a material with no program or textures, drawn one mesh at a
+     * time.
+     */
+    Material();
+
     /**
      * Get the shader program this material uses.
      *
@@ -40,7 +46,7 @@ public:
      * @return  const std::vector<std::pair<std::string, Texture>> &, list of
      * sampler names and their corresponding textures.
      */
-    const std::vector<std::pair<std::string, Texture>> &GetTextures();
+    const std::vector<std::pair<std::string, Texture>> &GetTextures() const;
 
     /**
      * Add a constant buffer to this material.
@@ -53,9 +59,29 @@ public:
     void AddConstantBuffer(const std::string &constantBufferName,
                            const ConstantBuffer &constantBuffer);
 
+    /**
+     * Get whether this material's program draws many meshes in one call.
+     *
+     * @return  bool, TRUE if the program reads each mesh's model matrix from
+     * the Instances constant buffer, FALSE if it reads it from the Object
+     * constant buffer.
+     */
+    bool IsInstanced() const;
+
+    /**
+     * Set whether this material's program draws many meshes in one call.
+     *
+     * @param  instanced  bool, TRUE if the program reads each mesh's model
+     * matrix from the Instances constant buffer, FALSE if it reads it from
+     * the Object constant buffer.
+     */
+    void SetInstanced(bool instanced);
+
 private:
     /** Shader program */
     ProgramHandle m_program;
+    /** Whether the shader program supports instancing */
+    bool m_instanced;
     /** Material textures */
     std::vector<std::pair<std::string, Texture>> m_textures;
     /** Material constant buffer */
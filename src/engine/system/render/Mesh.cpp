@@ -13,12 +13,14 @@ Mesh::Mesh()
 Mesh::Mesh(VertexBufferHandle vertexBuffer,
      IndexBufferHandle indexBuffer,
      size_t startingIndex,
-     size_t numIndices)
+     size_t numIndices,
+     const ds_math::AABB &bounds)
 {
     m_vertexBuffer = vertexBuffer;
     m_indexBuffer = indexBuffer;
     m_startingIndex = startingIndex;
     m_numIndices = numIndices;
+    m_bounds = bounds;
 }
 
 VertexBufferHandle Mesh::GetVertexBuffer() const
@@ -60,4 +62,14 @@ void Mesh::SetNumIndices(size_t numIndices)
 {
     m_numIndices = numIndices;
 }
+
+const ds_math::AABB &Mesh::GetBounds() const
+{
+    return m_bounds;
+}
+
+void Mesh::SetBounds(const ds_math::AABB &bounds)
+{
+    m_bounds = bounds;
+}
 }
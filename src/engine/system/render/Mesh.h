@@ -4,6 +4,8 @@
 
 #include "engine/system/render/RenderCommon.h"
 
+#include "math/AABB.h"
+
 // TODO: Create Mesh class: VB handle, IB handle, startingIndex,
 // numIndicesToDraw
 
@@ -30,11 +32,14 @@ public:
      * begin drawing.
      * @param  numIndices     size_t, number of indices from starting index to
      * draw.
+     * @param  bounds         const ds_math::AABB &, bounding box of the
+     * mesh's vertices in model space.
      */
     Mesh(VertexBufferHandle vertexBuffer,
          IndexBufferHandle indexBuffer,
          size_t startingIndex,
-         size_t numIndices);
+         size_t numIndices,
+         const ds_math::AABB &bounds);
 
     /**
      * Get handle to the vertex buffer of the mesh.
@@ -96,6 +101,20 @@ public:
      */
     void SetNumIndices(size_t numIndices);
 
+    /**
+     * Get the bounding box of the mesh's vertices in model space.
+     *
+     * @return  const ds_math::AABB &, bounding box of the mesh.
+     */
+    const ds_math::AABB &GetBounds() const;
+
+    /**
+     * Set the bounding box of the mesh's vertices in model space.
+     *
+     * @param  bounds  const ds_math::AABB &, bounding box of the mesh.
+     */
+    void SetBounds(const ds_math::AABB &bounds);
+
 private:
     /** Vertex buffer of mesh */
     VertexBufferHandle m_vertexBuffer;
@@ -105,6 +124,8 @@ private:
     size_t m_startingIndex;
     /** Number of indices from starting index to draw */
     size_t m_numIndices;
+    /** Bounding box of vertices in model space, used for culling */
+    ds_math::AABB m_bounds;
     // TODO: Primitive Type?
 };
 }
@@ -0,0 +1,173 @@
+#include "engine/system/render/NullRenderer.h"
+
+namespace ds_render
+{
+bool NullRenderer::Init(unsigned int viewportWidth,
+                        unsigned int viewportHeight)
+{
+    return true;
+}
+
+void NullRenderer::SetClearColour(float r, float g, float b, float a)
+{
+}
+
+void NullRenderer::ClearBuffers(bool colour, bool depth, bool stencil)
+{
+}
+
+void NullRenderer::ResizeViewport(unsigned int newViewportWidth,
+                                  unsigned int newViewportHeight)
+{
+}
+
+VertexBufferHandle
+NullRenderer::CreateVertexBuffer(BufferUsageType usage,
+                                 const VertexBufferDescription &description,
+                                 size_t numBytes,
+                                 const void *data)
+{
+    return VertexBufferHandle();
+}
+
+IndexBufferHandle NullRenderer::CreateIndexBuffer(BufferUsageType usage,
+                                                  size_t numBytes,
+                                                  const void *data)
+{
+    return IndexBufferHandle();
+}
+
+ShaderHandle NullRenderer::CreateShaderObject(ShaderType shaderType,
+                                              size_t shaderSourceSize,
+                                              const char *shaderSource)
+{
+    return ShaderHandle();
+}
+
+ProgramHandle
+NullRenderer::CreateProgram(const std::vector<ShaderHandle> &shaders)
+{
+    return ProgramHandle();
+}
+
+bool NullRenderer::GetProgramBinary(ProgramHandle programHandle,
+                                    std::vector<char> *binary) const
+{
+    return false;
+}
+
+ProgramHandle NullRenderer::CreateProgramFromBinary(size_t numBytes,
+                                                    const void *binary)
+{
+    return ProgramHandle();
+}
+
+void NullRenderer::SetProgram(ProgramHandle programHandle)
+{
+}
+
+TextureHandle NullRenderer::Create2DTexture(ImageFormat format,
+                                            RenderDataType imageDataType,
+                                            InternalImageFormat internalFormat,
+                                            bool generateMipMaps,
+                                            unsigned int width,
+                                            unsigned int height,
+                                            const void *data)
+{
+    return TextureHandle();
+}
+
+void NullRenderer::BindTextureToSampler(ProgramHandle programHandle,
+                                        const std::string &samplerName,
+                                        TextureHandle textureHandle)
+{
+}
+
+void NullRenderer::UnbindTextureFromSampler(TextureHandle textureHandle)
+{
+}
+
+void NullRenderer::GetConstantBufferDescription(
+    ProgramHandle programHandle,
+    const std::string &constantBufferName,
+    ConstantBufferDescription *constantBufferDescription)
+{
+}
+
+ConstantBufferHandle NullRenderer::CreateConstantBuffer(
+    const ConstantBufferDescription &constantBufferDescription)
+{
+    return ConstantBufferHandle();
+}
+
+void NullRenderer::BindConstantBuffer(ProgramHandle programHandle,
+                                      const std::string &constantBufferName,
+                                      ConstantBufferHandle constantBufferHandle)
+{
+}
+
+void NullRenderer::UpdateConstantBufferData(
+    ConstantBufferHandle constantBufferHandle,
+    const ConstantBufferDescription &constantBufferDescription)
+{
+}
+
+void NullRenderer::UpdateConstantBufferSubData(
+    ConstantBufferHandle constantBufferHandle,
+    const ConstantBufferDescription &constantBufferDescription,
+    size_t offset,
+    size_t numBytes)
+{
+}
+
+ConstantBufferHandle
+NullRenderer::CreateStreamingConstantBuffer(size_t numBytes)
+{
+    return ConstantBufferHandle();
+}
+
+size_t NullRenderer::GetConstantBufferOffsetAlignment() const
+{
+    return 1;
+}
+
+bool NullRenderer::WriteStreamingConstantBuffer(
+    ConstantBufferHandle constantBufferHandle,
+    size_t numBytes,
+    const void *data,
+    size_t *offset)
+{
+    *offset = 0;
+
+    return true;
+}
+
+void NullRenderer::BindConstantBufferRange(
+    ConstantBufferHandle constantBufferHandle, size_t offset, size_t numBytes)
+{
+}
+
+void NullRenderer::DrawVertices(VertexBufferHandle buffer,
+                                PrimitiveType primitiveType,
+                                size_t startingVertex,
+                                size_t numVertices)
+{
+}
+
+void NullRenderer::DrawVerticesIndexed(VertexBufferHandle buffer,
+                                       IndexBufferHandle indexBuffer,
+                                       PrimitiveType primitiveType,
+                                       size_t startingIndex,
+                                       size_t numIndices)
+{
+}
+
+void NullRenderer::DrawVerticesIndexedInstanced(VertexBufferHandle buffer,
+                                                IndexBufferHandle indexBuffer,
+                                                PrimitiveType primitiveType,
+                                                size_t startingIndex,
+                                                size_t numIndices,
+                                                size_t numInstances)
+{
+}
+}
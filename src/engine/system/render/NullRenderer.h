@@ -0,0 +1,96 @@
+#pragma once
+
+#include "engine/system/render/IRenderer.h"
+
+namespace ds_render
+{
+/**
+ * Renderer that draws nothing, for running without a graphics context (on a
+ * build server, or to measure the cost of submitting a frame on it's own).
+ *
+ * Every operation succeeds and does nothing. Resources created are given
+ * null handles.
+ */
+class NullRenderer : public IRenderer
+{
+public:
+    virtual bool Init(unsigned int viewportWidth, unsigned int viewportHeight);
+    virtual void SetClearColour(float r, float g, float b, float a);
+    virtual void ClearBuffers(bool colour = true,
+                              bool depth = true,
+                              bool stencil = true);
+    virtual void ResizeViewport(unsigned int newViewportWidth,
+                                unsigned int newViewportHeight);
+    virtual VertexBufferHandle
+    CreateVertexBuffer(BufferUsageType usage,
+                       const VertexBufferDescription &description,
+                       size_t numBytes,
+                       const void *data);
+    virtual IndexBufferHandle
+    CreateIndexBuffer(BufferUsageType usage, size_t numBytes, const void *data);
+    virtual ShaderHandle CreateShaderObject(ShaderType shaderType,
+                                            size_t shaderSourceSize,
+                                            const char *shaderSource);
+    virtual ProgramHandle
+    CreateProgram(const std::vector<ShaderHandle> &shaders);
+    virtual bool GetProgramBinary(ProgramHandle programHandle,
+                                  std::vector<char> *binary) const;
+    virtual ProgramHandle CreateProgramFromBinary(size_t numBytes,
+                                                  const void *binary);
+    virtual void SetProgram(ProgramHandle programHandle);
+    virtual TextureHandle Create2DTexture(ImageFormat format,
+                                          RenderDataType imageDataType,
+                                          InternalImageFormat internalFormat,
+                                          bool generateMipMaps,
+                                          unsigned int width,
+                                          unsigned int height,
+                                          const void *data);
+    virtual void BindTextureToSampler(ProgramHandle programHandle,
+                                      const std::string &samplerName,
+                                      TextureHandle textureHandle);
+    virtual void UnbindTextureFromSampler(TextureHandle textureHandle);
+    virtual void GetConstantBufferDescription(
+        ProgramHandle programHandle,
+        const std::string &constantBufferName,
+        ConstantBufferDescription *constantBufferDescription);
+    virtual ConstantBufferHandle CreateConstantBuffer(
+        const ConstantBufferDescription &constantBufferDescription);
+    virtual void BindConstantBuffer(ProgramHandle programHandle,
+                                    const std::string &constantBufferName,
+                                    ConstantBufferHandle constantBufferHandle);
+    virtual void UpdateConstantBufferData(
+        ConstantBufferHandle constantBufferHandle,
+        const ConstantBufferDescription &constantBufferDescription);
+    virtual void UpdateConstantBufferSubData(
+        ConstantBufferHandle constantBufferHandle,
+        const ConstantBufferDescription &constantBufferDescription,
+        size_t offset,
+        size_t numBytes);
+    virtual ConstantBufferHandle CreateStreamingConstantBuffer(size_t numBytes);
+    virtual size_t GetConstantBufferOffsetAlignment() const;
+    virtual bool
+    WriteStreamingConstantBuffer(ConstantBufferHandle constantBufferHandle,
+                                 size_t numBytes,
+                                 const void *data,
+                                 size_t *offset);
+    virtual void
+    BindConstantBufferRange(ConstantBufferHandle constantBufferHandle,
+                            size_t offset,
+                            size_t numBytes);
+    virtual void DrawVertices(VertexBufferHandle buffer,
+                              PrimitiveType primitiveType,
+                              size_t startingVertex,
+                              size_t numVertices);
+    virtual void DrawVerticesIndexed(VertexBufferHandle buffer,
+                                     IndexBufferHandle indexBuffer,
+                                     PrimitiveType primitiveType,
+                                     size_t startingIndex,
+                                     size_t numIndices);
+    virtual void DrawVerticesIndexedInstanced(VertexBufferHandle buffer,
+                                              IndexBufferHandle indexBuffer,
+                                              PrimitiveType primitiveType,
+                                              size_t startingIndex,
+                                              size_t numIndices,
+                                              size_t numInstances);
+};
+}
@@ -0,0 +1,217 @@
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#include "engine/system/render/ProgramCache.h"
+
+namespace ds_render
+{
+// Start of a program binary file, followed by it's version
+static const uint32_t BinaryFileMagic = 0x42505344; // "DSPB"
+static const uint32_t BinaryFileVersion = 1;
+// Largest program binary loaded, bigger sizes are taken as corrupt
+static const uint64_t MaxBinarySize = 64 * 1024 * 1024;
+
+// Hash bytes into a 64-bit FNV-1a style hash. Shader sources run to many
+// kilobytes, so they're hashed 8 bytes at a time rather than byte by byte.
+static uint64_t HashBytes(const void *data, size_t numBytes, uint64_t hash)
+{
+    const char *bytes = (const char *)data;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= numBytes; i += sizeof(uint64_t))
+    {
+        uint64_t word = 0;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    for (; i < numBytes; ++i)
+    {
+        hash = (hash ^ (unsigned char)bytes[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+ProgramCache::ProgramCache()
+{
+    m_statistics.numRequests = 0;
+    m_statistics.numCompiled = 0;
+    m_statistics.numCreatedFromBinary = 0;
+    m_statistics.creationTime = 0.0;
+}
+
+uint64_t
+ProgramCache::HashShaderSources(const std::vector<ShaderSource> &shaderSources)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    // Sizes are hashed too, so sources can't run into each other
+    for (const ShaderSource &shaderSource : shaderSources)
+    {
+        uint32_t type = (uint32_t)shaderSource.type;
+        uint64_t size = shaderSource.source.size();
+        hash = HashBytes(&type, sizeof(type), hash);
+        hash = HashBytes(&size, sizeof(size), hash);
+        hash = HashBytes(shaderSource.source.data(), size, hash);
+    }
+
+    return hash;
+}
+
+ProgramHandle
+ProgramCache::GetProgram(IRenderer *renderer,
+                         const std::vector<ShaderSource> &shaderSources)
+{
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+
+    ProgramHandle program;
+    uint64_t key = HashShaderSources(shaderSources);
+
+    std::unordered_map<uint64_t, ProgramHandle>::const_iterator it =
+        m_programs.find(key);
+    if (it != m_programs.end())
+    {
+        program = it->second;
+    }
+    else
+    {
+        // Create it from it's binary, if there is one
+        std::unordered_map<uint64_t, std::vector<char>>::const_iterator
+            binary = m_binaries.find(key);
+        if (binary != m_binaries.end())
+        {
+            program = renderer->CreateProgramFromBinary(
+                binary->second.size(), binary->second.data());
+            if (program != ProgramHandle())
+            {
+                ++m_statistics.numCreatedFromBinary;
+            }
+        }
+
+        // Or compile it if there isn't, or it was made by another driver
+        if (program == ProgramHandle())
+        {
+            std::vector<ShaderHandle> shaders;
+            for (const ShaderSource &shaderSource : shaderSources)
+            {
+                shaders.push_back(renderer->CreateShaderObject(
+                    shaderSource.type, shaderSource.source.size(),
+                    shaderSource.source.c_str()));
+            }
+            program = renderer->CreateProgram(shaders);
+            ++m_statistics.numCompiled;
+
+            std::vector<char> programBinary;
+            if (program != ProgramHandle() &&
+                renderer->GetProgramBinary(program, &programBinary))
+            {
+                m_binaries[key].swap(programBinary);
+            }
+            else
+            {
+                m_binaries.erase(key);
+            }
+        }
+
+        // Programs failing to compile are tried again next time asked for
+        if (program != ProgramHandle())
+        {
+            m_programs[key] = program;
+        }
+    }
+
+    ++m_statistics.numRequests;
+    m_statistics.creationTime +=
+        std::chrono::duration<double, std::milli>(Clock::now() - start)
+            .count();
+
+    return program;
+}
+
+bool ProgramCache::LoadBinaries(const std::string &filePath)
+{
+    bool result = false;
+
+    std::ifstream file(filePath.c_str(), std::ios::in | std::ios::binary);
+
+    // Size of the file, no entry can be bigger than what's left of it
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = file.good() ? (uint64_t)file.tellg() : 0;
+    file.seekg(0, std::ios::beg);
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t numBinaries = 0;
+    file.read((char *)&magic, sizeof(magic));
+    file.read((char *)&version, sizeof(version));
+    file.read((char *)&numBinaries, sizeof(numBinaries));
+
+    if (file.good() && magic == BinaryFileMagic &&
+        version == BinaryFileVersion)
+    {
+        std::unordered_map<uint64_t, std::vector<char>> binaries;
+        for (uint32_t i = 0; i < numBinaries && file.good(); ++i)
+        {
+            uint64_t key = 0;
+            uint64_t size = 0;
+            file.read((char *)&key, sizeof(key));
+            file.read((char *)&size, sizeof(size));
+
+            // Reject sizes of a corrupt file before allocating for them
+            if (file.good() &&
+                (size > MaxBinarySize ||
+                 size > fileSize - (uint64_t)file.tellg()))
+            {
+                file.setstate(std::ios::failbit);
+            }
+
+            if (file.good() && size > 0)
+            {
+                std::vector<char> &binary = binaries[key];
+                binary.resize(size);
+                file.read(&binary[0], size);
+            }
+        }
+
+        // Only use the binaries if the whole file was read
+        if (file.good())
+        {
+            for (auto &binary : binaries)
+            {
+                m_binaries[binary.first].swap(binary.second);
+            }
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+bool ProgramCache::SaveBinaries(const std::string &filePath) const
+{
+    std::ofstream file(filePath.c_str(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+
+    uint32_t numBinaries = m_binaries.size();
+    file.write((const char *)&BinaryFileMagic, sizeof(BinaryFileMagic));
+    file.write((const char *)&BinaryFileVersion, sizeof(BinaryFileVersion));
+    file.write((const char *)&numBinaries, sizeof(numBinaries));
+
+    for (const auto &binary : m_binaries)
+    {
+        uint64_t size = binary.second.size();
+        file.write((const char *)&binary.first, sizeof(binary.first));
+        file.write((const char *)&size, sizeof(size));
+        file.write(binary.second.data(), size);
+    }
+
+    return file.good();
+}
+
+const ProgramCacheStatistics &ProgramCache::GetStatistics() const
+{
+    return m_statistics;
+}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "engine/system/render/IRenderer.h"
+
+namespace ds_render
+{
+/**
+ * Counts and time of the programs a program cache was asked for.
+ */
+struct ProgramCacheStatistics
+{
+    /** Programs asked for */
+    unsigned int numRequests;
+    /** Programs compiled and linked from their shader sources */
+    unsigned int numCompiled;
+    /** Programs created from a binary loaded from file */
+    unsigned int numCreatedFromBinary;
+    /** Time spent getting programs, in milliseconds */
+    double creationTime;
+};
+
+/**
+ * Creates each program once, however many times it's asked for.
+ *
+ * Programs are keyed by a 64 bit hash of their shader types and sources, so
+ * materials using the same shaders share a program rather than compiling it
+ * again.
+ *
+ * The binaries of the programs compiled can be saved to file and loaded on
+ * the next run, programs are then created from them without compiling.
+ * Binaries only work with the driver that made them, a program whose binary
+ * fails is compiled from source again and it's binary replaced.
+ *
+ * Programs are created with the renderer given, a cache should only ever be
+ * given one renderer.
+ */
+class ProgramCache
+{
+public:
+    /**
+     * Source of one of the shaders of a program.
+     */
+    struct ShaderSource
+    {
+        ShaderType type;
+        std::string source;
+    };
+
+    /**
+     * Create an empty cache.
+     */
+    ProgramCache();
+
+    /**
+     * Hash the shaders of a program, the key it's cached by.
+     *
+     * @param   shaderSources  const std::vector<ShaderSource> &, shaders of
+     * the program.
+     * @return                 uint64_t, hash of the shaders.
+     */
+    static uint64_t
+    HashShaderSources(const std::vector<ShaderSource> &shaderSources);
+
+    /**
+     * Get the program made of the given shaders, creating it if it hasn't
+     * been already.
+     *
+     * @param   renderer       IRenderer *, renderer to create the program
+     * with.
+     * @param   shaderSources  const std::vector<ShaderSource> &, shaders of
+     * the program.
+     * @return                 ProgramHandle, handle to program, invalid if it
+     * failed to compile or link.
+     */
+    ProgramHandle GetProgram(IRenderer *renderer,
+                             const std::vector<ShaderSource> &shaderSources);
+
+    /**
+     * Load program binaries saved with SaveBinaries, for programs asked for
+     * after to be created from.
+     *
+     * @param   filePath  const std::string &, file to load from.
+     * @return            bool, TRUE if the file was loaded, FALSE if it
+     * doesn't exist or isn't a program binary file.
+     */
+    bool LoadBinaries(const std::string &filePath);
+
+    /**
+     * Save the binaries of the programs created and loaded so far.
+     *
+     * @param   filePath  const std::string &, file to save to.
+     * @return            bool, TRUE if the file was saved, FALSE otherwise.
+     */
+    bool SaveBinaries(const std::string &filePath) const;
+
+    /**
+     * Get counts and time of the programs asked for so far.
+     *
+     * @return  const ProgramCacheStatistics &, statistics.
+     */
+    const ProgramCacheStatistics &GetStatistics() const;
+
+private:
+    /** Programs created, by hash of their shaders */
+    std::unordered_map<uint64_t, ProgramHandle> m_programs;
+    /** Program binaries, by hash of the program's shaders */
+    std::unordered_map<uint64_t, std::vector<char>> m_binaries;
+    /** Counts and time of the programs asked for */
+    ProgramCacheStatistics m_statistics;
+};
+}
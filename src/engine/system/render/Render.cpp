@@ -10,12 +10,20 @@
 #include "engine/resource/TerrainResource.h"
 #include "engine/system/render/GLRenderer.h"
 #include "engine/system/render/Render.h"
+#include "math/AABB.h"
+#include "math/Frustum.h"
 #include "math/MathHelper.h"
 #include "math/Matrix4.h"
 #include "math/Vector4.h"
 
 namespace ds
 {
+// Sizes of the rings object and instance matrices are streamed through. About
+// three frames of 10,000 objects at the usual 256 byte offset alignment, they
+// grow if a frame needs more.
+static const size_t ObjectStreamSize = 8 * 1024 * 1024;
+static const size_t InstanceStreamSize = 2 * 1024 * 1024;
+
 bool Render::Initialize(const Config &config)
 {
     bool result = true;
@@ -27,7 +35,31 @@ bool Render::Initialize(const Config &config)
     m_factory.RegisterCreator<ShaderResource>(ShaderResource::CreateFromFile);
     m_factory.RegisterCreator<TextureResource>(TextureResource::CreateFromFile);
     m_factory.RegisterCreator<TerrainResource>(TerrainResource::CreateFromFile);
-    
+
+    // Number of threads to update world transforms on, besides the main
+    // thread. Default to updating them on the main thread only.
+    unsigned int numTransformThreads = 0;
+    if (config.GetUnsignedInt("Render.transformThreads",
+                              &numTransformThreads) &&
+        numTransformThreads > 0)
+    {
+        m_transformThreadPool = std::unique_ptr<ds_com::ThreadPool>(
+            new ds_com::ThreadPool(numTransformThreads));
+    }
+    m_transformComponentManager.SetThreadPool(m_transformThreadPool.get());
+
+    // Laid out as in C++ until the renderer finds where the program has them
+    m_sceneViewMatrix.offset = 0;
+    m_sceneProjectionMatrix.offset = sizeof(ds_math::Matrix4);
+
+    // Program binaries are only cached across runs if given a file to keep
+    // them in
+    if (!config.GetString("Render.programCacheFile", &m_programCacheFilePath))
+    {
+        m_programCacheFilePath.clear();
+    }
+
+    m_statistics = RenderStatistics();
 
     return result;
 }
@@ -36,17 +68,36 @@ void Render::Update(float deltaTime)
 {
     ProcessEvents(&m_messagesReceived);
 
+    // Make sure renderer has been created
+    if (m_renderer != nullptr)
+    {
+        // World transforms are updated once per step, so frames can be drawn
+        // between the last two
+        m_transformComponentManager.UpdateWorldTransforms();
+        UpdateSceneTree();
+    }
+}
+
+void Render::Present(float interpolation)
+{
     // Make sure renderer has been created
     if (m_renderer != nullptr)
     {
         m_renderer->ClearBuffers();
 
-        RenderScene();
+        RenderScene(interpolation);
     }
 }
 
 void Render::Shutdown()
 {
+    if (m_renderer != nullptr && !m_programCacheFilePath.empty())
+    {
+        m_programCache.SaveBinaries(m_programCacheFilePath);
+    }
+
+    m_transformComponentManager.SetThreadPool(nullptr);
+    m_transformThreadPool.reset();
 }
 
 void Render::PostMessages(const ds_msg::MessageStream &messages)
@@ -63,6 +114,25 @@ ds_msg::MessageStream Render::CollectMessages()
     return tmp;
 }
 
+std::vector<ds_msg::MessageType> Render::GetMessageSubscriptions() const
+{
+    std::vector<ds_msg::MessageType> subscriptions;
+    subscriptions.push_back(ds_msg::MessageType::GraphicsContextCreated);
+    subscriptions.push_back(ds_msg::MessageType::CreateComponent);
+
+    return subscriptions;
+}
+
+const RenderStatistics &Render::GetStatistics() const
+{
+    return m_statistics;
+}
+
+const ds_render::ProgramCacheStatistics &Render::GetProgramStatistics() const
+{
+    return m_programCache.GetStatistics();
+}
+
 void Render::ProcessEvents(ds_msg::MessageStream *messages)
 {
     while (messages->AvailableBytes() != 0)
@@ -95,31 +165,17 @@ void Render::ProcessEvents(ds_msg::MessageStream *messages)
 
                     m_renderer->Init(viewportWidth, viewportHeight);
 
-                    // Need a program to get information about Scene and Object
-                    // constant
-                    // buffers, so create a "fake" one.
-                    // Create shader program
-                    std::unique_ptr<ShaderResource> shaderResource =
-                        m_factory.CreateResource<ShaderResource>(
-                            "../assets/constantBuffer.shader");
-
-                    // Load each shader
-                    std::vector<ds_render::ShaderHandle> shaders;
-                    std::vector<ds_render::ShaderType> shaderTypes =
-                        shaderResource->GetShaderTypes();
-                    for (auto shaderType : shaderTypes)
+                    if (!m_programCacheFilePath.empty())
                     {
-                        const std::string &shaderSource =
-                            shaderResource->GetShaderSource(shaderType);
-
-                        // Append shader to list
-                        shaders.push_back(m_renderer->CreateShaderObject(
-                            shaderType, shaderSource.size(),
-                            shaderSource.c_str()));
+                        m_programCache.LoadBinaries(m_programCacheFilePath);
                     }
-                    // Compile shaders into shader program
+
+                    // Need a program to get information about Scene and Object
+                    // constant buffers, so create a "fake" one. It's cached
+                    // like any other, so warm starts don't compile it either.
                     ds_render::ProgramHandle fakeShader =
-                        m_renderer->CreateProgram(shaders);
+                        CreateProgramFromShaderResource(
+                            "../assets/constantBuffer.shader");
 
                     // Set shader data descriptions
                     m_sceneBufferDescrip = ds_render::ConstantBufferDescription(2 * sizeof(ds_math::Matrix4));
@@ -154,8 +210,37 @@ void Render::ProcessEvents(ds_msg::MessageStream *messages)
 
                     m_sceneMatrices =
                         m_renderer->CreateConstantBuffer(m_sceneBufferDescrip);
+                    // Object and instance matrices are written every draw,
+                    // so they're streamed through a ring of a few frames'
+                    // worth
                     m_objectMatrices =
-                        m_renderer->CreateConstantBuffer(m_objectBufferDescrip);
+                        m_renderer->CreateStreamingConstantBuffer(
+                            ObjectStreamSize);
+
+                    // Instanced programs declare the Instances block std140,
+                    // so the matrices are packed from the start of it
+                    m_instanceBufferDescrip =
+                        ds_render::ConstantBufferDescription(
+                            ds_render::RenderQueue::MaxInstancesPerDraw *
+                            sizeof(ds_math::Matrix4));
+                    m_instanceBufferDescrip.AddMember(
+                        "Instances.modelMatrices");
+                    m_instanceBufferDescrip.SetMemberOffset(
+                        "Instances.modelMatrices", 0);
+                    m_instanceMatrices =
+                        m_renderer->CreateStreamingConstantBuffer(
+                            InstanceStreamSize);
+
+                    // Find the members written every frame now, rather than
+                    // by name each time they're written
+                    m_sceneBufferDescrip.GetMember("Scene.viewMatrix",
+                                                   &m_sceneViewMatrix);
+                    m_sceneBufferDescrip.GetMember("Scene.projectionMatrix",
+                                                   &m_sceneProjectionMatrix);
+                    m_renderQueue.SetObjectBuffer(m_objectMatrices,
+                                                  &m_objectBufferDescrip);
+                    m_renderQueue.SetInstanceBuffer(m_instanceMatrices,
+                                                    &m_instanceBufferDescrip);
 
                     break;
                 }
@@ -175,9 +260,10 @@ void Render::ProcessEvents(ds_msg::MessageStream *messages)
             if (componentData.LoadMemory(StringIntern::Instance().GetString(
                     createComponentMsg.componentData)))
             {
-                std::string componentType = StringIntern::Instance().GetString(
-                    createComponentMsg.componentType);
-                if (componentType == "renderComponent")
+                switch (StringIntern::Instance().GetHash(
+                    createComponentMsg.componentType))
+                {
+                case ds_com::HashString("renderComponent"):
                 {
                     std::string meshName;
                     std::string materialName;
@@ -192,31 +278,54 @@ void Render::ProcessEvents(ds_msg::MessageStream *messages)
                         std::stringstream materialResourcePath;
                         materialResourcePath << "../assets/" << materialName;
 
-                        // Create Mesh
-                        ds_render::Mesh mesh =
-                            CreateMeshFromMeshResource(meshResourcePath.str());
+                        // Create Mesh, once per mesh resource
+                        auto mesh = m_meshes.find(meshResourcePath.str());
+                        if (mesh == m_meshes.end())
+                        {
+                            mesh = m_meshes
+                                       .insert(std::make_pair(
+                                           meshResourcePath.str(),
+                                           CreateMeshFromMeshResource(
+                                               meshResourcePath.str())))
+                                       .first;
+                        }
 
-                        // Create material
-                        ds_render::Material material =
-                            CreateMaterialFromMaterialResource(
-                                materialResourcePath.str(), m_sceneMatrices,
-                                m_objectMatrices);
+                        // Create material, once per material resource
+                        auto material =
+                            m_materials.find(materialResourcePath.str());
+                        if (material == m_materials.end())
+                        {
+                            material =
+                                m_materials
+                                    .insert(std::make_pair(
+                                        materialResourcePath.str(),
+                                        CreateMaterialFromMaterialResource(
+                                            materialResourcePath.str(),
+                                            m_sceneMatrices, m_objectMatrices,
+                                            m_instanceMatrices)))
+                                    .first;
+                        }
 
                         Instance i =
                             m_renderComponentManager.CreateComponentForEntity(
                                 createComponentMsg.entity);
-                        m_renderComponentManager.SetMaterial(i, material);
-                        m_renderComponentManager.SetMesh(i, mesh);
+                        m_renderComponentManager.SetMaterial(
+                            i, material->second);
+                        m_renderComponentManager.SetMesh(i, mesh->second);
+
+                        AddToSceneTree(createComponentMsg.entity);
                     }
+                    break;
                 }
-                else if (componentType == "transformComponent")
+                case ds_com::HashString("transformComponent"):
                 {
                     TransformComponentManager::
                         CreateComponentForEntityFromConfig(
                             &m_transformComponentManager,
                             createComponentMsg.entity, componentData);
+                    break;
                 }
-                else if(componentType == "terrainComponent")
+                case ds_com::HashString("terrainComponent"):
                 {
                     std::string heightMapName;
                     std::string materialName;
@@ -233,7 +342,7 @@ void Render::ProcessEvents(ds_msg::MessageStream *messages)
                         materialResourcePath << "../assets/" << materialName;
                         
                         ds_render::Material material = 
-                        CreateMaterialFromMaterialResource(materialResourcePath.str(), m_sceneMatrices, m_objectMatrices);
+                        CreateMaterialFromMaterialResource(materialResourcePath.str(), m_sceneMatrices, m_objectMatrices, m_instanceMatrices);
                         // above function does this
                         // std::unique_ptr<MaterialResource> materialResource = 
                         // m_factory.CreateResource<materialResource>(materialResourcePath.str());
@@ -345,16 +454,24 @@ void Render::ProcessEvents(ds_msg::MessageStream *messages)
                                 sizeof(unsigned int) * indices.size(),
                                 &indices[0]);
 
-                        ds_render::Mesh mesh =
-                            ds_render::Mesh(vb, ib, 0, indices.size());                    
+                        ds_render::Mesh mesh = ds_render::Mesh(
+                            vb, ib, 0, indices.size(),
+                            ds_math::AABB::FromPoints(positions.data(),
+                                                      positions.size()));
+
                     
                         Instance i =
                         m_renderComponentManager.CreateComponentForEntity(createComponentMsg.entity);
                         
                         m_renderComponentManager.SetMaterial(i, material);
                         m_renderComponentManager.SetMesh(i, mesh);
+
+                        AddToSceneTree(createComponentMsg.entity);
                     }
-                                        
+                    break;
+                }
+                default:
+                    break;
                 }
             }
             break;
@@ -475,13 +592,16 @@ ds_render::Mesh Render::CreateMeshFromMeshResource(const std::string &filePath)
         sizeof(unsigned int) * indices.size(), &indices[0]);
 
     // Create Mesh
-    return ds_render::Mesh(vb, ib, 0, meshResource->GetIndicesCount());
+    return ds_render::Mesh(
+        vb, ib, 0, meshResource->GetIndicesCount(),
+        ds_math::AABB::FromPoints(positions.data(), positions.size()));
 }
 
 ds_render::Material Render::CreateMaterialFromMaterialResource(
     const std::string &filePath,
     ds_render::ConstantBufferHandle sceneMatrices,
-    ds_render::ConstantBufferHandle objectMatrices)
+    ds_render::ConstantBufferHandle objectMatrices,
+    ds_render::ConstantBufferHandle instanceMatrices)
 {
     ds_render::Material material;
 
@@ -489,26 +609,9 @@ ds_render::Material Render::CreateMaterialFromMaterialResource(
     std::unique_ptr<MaterialResource> materialResource =
         m_factory.CreateResource<MaterialResource>(filePath);
 
-    // Create shader program
-    std::unique_ptr<ShaderResource> shaderResource =
-        m_factory.CreateResource<ShaderResource>(
-            materialResource->GetShaderResourceFilePath());
-
-    // Load each shader
-    std::vector<ds_render::ShaderHandle> shaders;
-    std::vector<ds_render::ShaderType> shaderTypes =
-        shaderResource->GetShaderTypes();
-    for (auto shaderType : shaderTypes)
-    {
-        const std::string &shaderSource =
-            shaderResource->GetShaderSource(shaderType);
-
-        // Append shader to list
-        shaders.push_back(m_renderer->CreateShaderObject(
-            shaderType, shaderSource.size(), shaderSource.c_str()));
-    }
-    // Compile shaders into shader program
-    ds_render::ProgramHandle shaderProgram = m_renderer->CreateProgram(shaders);
+    // Create shader program, shared with materials using the same shaders
+    ds_render::ProgramHandle shaderProgram = CreateProgramFromShaderResource(
+        materialResource->GetShaderResourceFilePath());
 
     // Set shader program of material
     material.SetProgram(shaderProgram);
@@ -526,78 +629,172 @@ ds_render::Material Render::CreateMaterialFromMaterialResource(
                                              textureResourceFilePath));
     }
 
-    // Bind constant buffers to program
+    // Bind constant buffers to program, instanced programs read their model
+    // matrices from the Instances block instead of the Object block
+    material.SetInstanced(materialResource->IsInstanced());
     m_renderer->BindConstantBuffer(material.GetProgram(), "Scene",
                                    sceneMatrices);
-    m_renderer->BindConstantBuffer(material.GetProgram(), "Object",
-                                   objectMatrices);
+    if (material.IsInstanced())
+    {
+        m_renderer->BindConstantBuffer(material.GetProgram(), "Instances",
+                                       instanceMatrices);
+    }
+    else
+    {
+        m_renderer->BindConstantBuffer(material.GetProgram(), "Object",
+                                       objectMatrices);
+    }
 
     return material;
 }
 
-void Render::RenderScene()
+ds_render::ProgramHandle
+Render::CreateProgramFromShaderResource(const std::string &filePath)
+{
+    std::unique_ptr<ShaderResource> shaderResource =
+        m_factory.CreateResource<ShaderResource>(filePath);
+
+    // Gather the source of each shader
+    std::vector<ds_render::ProgramCache::ShaderSource> shaderSources;
+    std::vector<ds_render::ShaderType> shaderTypes =
+        shaderResource->GetShaderTypes();
+    for (auto shaderType : shaderTypes)
+    {
+        ds_render::ProgramCache::ShaderSource shaderSource;
+        shaderSource.type = shaderType;
+        shaderSource.source = shaderResource->GetShaderSource(shaderType);
+        shaderSources.push_back(shaderSource);
+    }
+
+    return m_programCache.GetProgram(m_renderer.get(), shaderSources);
+}
+
+void Render::AddToSceneTree(Entity entity)
+{
+    Instance renderInstance =
+        m_renderComponentManager.GetInstanceForEntity(entity);
+    Instance transformInstance =
+        m_transformComponentManager.GetInstanceForEntity(entity);
+
+    if (renderInstance.IsValid() && transformInstance.IsValid())
+    {
+        ds_math::AABB bounds = ds_math::AABB::Transform(
+            m_renderComponentManager.GetMesh(renderInstance).GetBounds(),
+            m_transformComponentManager.GetWorldTransform(transformInstance));
+
+        if (m_sceneTree.Contains(entity))
+        {
+            m_sceneTree.Update(entity, bounds);
+        }
+        else
+        {
+            m_sceneTree.Insert(entity, bounds);
+        }
+    }
+}
+
+void Render::UpdateSceneTree()
+{
+    // Only entities that moved need their bounds updated, transform
+    // components created this frame are among them
+    for (const Instance &transformInstance :
+         m_transformComponentManager.GetUpdatedInstances())
+    {
+        AddToSceneTree(m_transformComponentManager.GetEntityForInstance(
+            transformInstance));
+    }
+
+    // Refitting keeps the structure the tree was built with, which gets worse
+    // as entities move, so rebuild once about as many updates as entities
+    // have been made
+    if (m_sceneTree.GetNumUpdatesSinceRebuild() >
+        m_sceneTree.GetNumEntities())
+    {
+        m_sceneTree.Rebuild();
+    }
+    else
+    {
+        m_sceneTree.Refit();
+    }
+}
+
+void Render::RenderScene(float interpolation)
 {
     // Update scene constant buffer
     m_sceneBufferDescrip.InsertMemberData(
-        "Scene.viewMatrix", sizeof(ds_math::Matrix4), &m_viewMatrix);
-    m_sceneBufferDescrip.InsertMemberData("Scene.projectionMatrix",
-                                          sizeof(ds_math::Matrix4),
-                                          &m_projectionMatrix);
+        m_sceneViewMatrix, sizeof(ds_math::Matrix4), &m_viewMatrix);
+    m_sceneBufferDescrip.InsertMemberData(
+        m_sceneProjectionMatrix, sizeof(ds_math::Matrix4), &m_projectionMatrix);
     m_renderer->UpdateConstantBufferData(m_sceneMatrices, m_sceneBufferDescrip);
 
-    // For each render component
+    // Only the entities in the view frustum are drawn, found without testing
+    // every entity
+    const ds_math::Matrix4 viewProjection = m_projectionMatrix * m_viewMatrix;
+    ds_math::Frustum frustum(viewProjection);
+    m_visibleEntities.clear();
+    m_sceneTree.QueryFrustum(frustum, &m_visibleEntities);
+
+    // Entities are drawn between their last two updates, the render queue
+    // keeps pointers to the transforms so they're stored until it's submitted
+    m_renderQueue.Clear();
+    m_interpolatedTransforms.resize(m_visibleEntities.size());
+    for (size_t i = 0; i < m_visibleEntities.size(); ++i)
+    {
+        Entity entity = m_visibleEntities[i];
+        Instance renderInstance =
+            m_renderComponentManager.GetInstanceForEntity(entity);
+        ds_math::Matrix4 &worldTransform = m_interpolatedTransforms[i];
+        worldTransform =
+            m_transformComponentManager.GetInterpolatedWorldTransform(
+                m_transformComponentManager.GetInstanceForEntity(entity),
+                interpolation);
+
+        // Depth of the object's origin, front to back within each state
+        ds_math::Vector4 clip =
+            viewProjection * ds_math::Vector4(worldTransform.data[3].x,
+                                              worldTransform.data[3].y,
+                                              worldTransform.data[3].z, 1.0f);
+        float depth = (clip.w > 0.0f) ? (clip.z / clip.w + 1.0f) * 0.5f : 0.0f;
+
+        m_renderQueue.Push(
+            &m_renderComponentManager.GetMaterial(renderInstance),
+            &m_renderComponentManager.GetMesh(renderInstance), &worldTransform,
+            depth);
+    }
+
+    // Objects without a transform have no known position, so are always
+    // drawn
+    unsigned int numUnplaced = 0;
     for (unsigned int i = 0; i < m_renderComponentManager.GetNumInstances();
          ++i)
     {
         Instance renderInstance = Instance::MakeInstance(i);
-        // Get transform component
         Entity entity =
             m_renderComponentManager.GetEntityForInstance(renderInstance);
-        Instance transformInstance =
-            m_transformComponentManager.GetInstanceForEntity(entity);
 
-        // If has transform instance
-        if (transformInstance.IsValid())
+        if (!m_sceneTree.Contains(entity))
         {
-            // Update object constant buffer with world transform of this
-            // transform instance
-            m_objectBufferDescrip.InsertMemberData(
-                "Object.modelMatrix", sizeof(ds_math::Matrix4),
-                &m_transformComponentManager.GetWorldTransform(
-                    transformInstance));
-            m_renderer->UpdateConstantBufferData(m_objectMatrices,
-                                                 m_objectBufferDescrip);
-        }
-
-        // Get mesh
-        ds_render::Mesh mesh = m_renderComponentManager.GetMesh(renderInstance);
-        // Get material
-        ds_render::Material material =
-            m_renderComponentManager.GetMaterial(renderInstance);
-
-        // Set shader program
-        m_renderer->SetProgram(material.GetProgram());
-
-        // For each texture in material, bind it to shader
-        for (auto samplerTexture : material.GetTextures())
-        {
-            m_renderer->BindTextureToSampler(
-                material.GetProgram(), samplerTexture.first,
-                samplerTexture.second.GetTextureHandle());
-        }
-
-        // Draw mesh
-        m_renderer->DrawVerticesIndexed(
-            mesh.GetVertexBuffer(), mesh.GetIndexBuffer(),
-            ds_render::PrimitiveType::TriangleStrip, mesh.GetStartingIndex(),
-            mesh.GetNumIndices());
-
-        // For each texture in material, unbind
-        for (auto samplerTexture : material.GetTextures())
-        {
-            m_renderer->UnbindTextureFromSampler(
-                samplerTexture.second.GetTextureHandle());
+            m_renderQueue.Push(
+                &m_renderComponentManager.GetMaterial(renderInstance),
+                &m_renderComponentManager.GetMesh(renderInstance), nullptr,
+                0.0f);
+            ++numUnplaced;
         }
     }
+
+    // Group objects sharing state so it is only set once per group, and
+    // copies of a mesh with an instanced material are drawn together
+    m_renderQueue.Sort();
+    ds_render::RenderQueueStatistics queueStatistics =
+        m_renderQueue.Submit(m_renderer.get());
+
+    m_statistics.numVisible =
+        (unsigned int)m_visibleEntities.size() + numUnplaced;
+    m_statistics.numCulled =
+        m_renderComponentManager.GetNumInstances() - m_statistics.numVisible;
+    m_statistics.numProgramChanges = queueStatistics.numProgramChanges;
+    m_statistics.numTextureChanges = queueStatistics.numTextureChanges;
+    m_statistics.numMeshChanges = queueStatistics.numMeshChanges;
+    m_statistics.numDrawCalls = queueStatistics.numDraws;
 }
 }
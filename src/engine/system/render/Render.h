@@ -1,5 +1,6 @@
 #pragma once
 
+#include <map>
 #include <string>
 
 #include "engine/resource/ResourceFactory.h"
@@ -7,14 +8,37 @@
 #include "engine/system/render/IRenderer.h"
 #include "engine/system/render/Material.h"
 #include "engine/system/render/Mesh.h"
+#include "engine/system/render/ProgramCache.h"
 #include "engine/system/render/RenderComponentManager.h"
+#include "engine/system/render/RenderQueue.h"
 #include "engine/system/render/Texture.h"
+#include "engine/system/scene/BoundingVolumeHierarchy.h"
 #include "engine/system/scene/TransformComponentManager.h"
 
 #include "math/Vector3.h"
 
 namespace ds
 {
+/**
+ * Counts of what the render system did in the last frame.
+ */
+struct RenderStatistics
+{
+    /** Render components drawn */
+    unsigned int numVisible;
+    /** Render components skipped as they were outside the view frustum */
+    unsigned int numCulled;
+    /** Shader programs set */
+    unsigned int numProgramChanges;
+    /** Sets of textures bound */
+    unsigned int numTextureChanges;
+    /** Draws of a different mesh than the draw before */
+    unsigned int numMeshChanges;
+    /** Draw calls made, fewer than the render components drawn when they
+     * are instanced */
+    unsigned int numDrawCalls;
+};
+
 /**
  * The render system is responsible for rendering the world, it contains all
  * render specific data, including the render component data for each entity.
@@ -39,6 +63,15 @@ public:
      */
     virtual void Update(float deltaTime);
 
+    /**
+     * Render the scene, with objects drawn between their world transforms
+     * of the last two updates.
+     *
+     * @param  interpolation  float, fraction of a timestep between the last
+     * update and the next.
+     */
+    virtual void Present(float interpolation);
+
     /**
      * Perform teardown of the render system.
      */
@@ -63,6 +96,29 @@ public:
      */
     virtual ds_msg::MessageStream CollectMessages();
 
+    /**
+     * Return the types of messages the render system handles.
+     *
+     * @return  std::vector<ds_msg::MessageType>, types of messages the
+     * render system wants to be posted.
+     */
+    virtual std::vector<ds_msg::MessageType> GetMessageSubscriptions() const;
+
+    /**
+     * Get counts of what the render system did in the last frame.
+     *
+     * @return  const RenderStatistics &, statistics of the last frame.
+     */
+    const RenderStatistics &GetStatistics() const;
+
+    /**
+     * Get counts and time of the shader programs created, which happens as
+     * materials are loaded.
+     *
+     * @return  const ds_render::ProgramCacheStatistics &, program statistics.
+     */
+    const ds_render::ProgramCacheStatistics &GetProgramStatistics() const;
+
 private:
     /**
      * Process messages in the given message stream.
@@ -88,24 +144,39 @@ private:
      */
     ds_render::Mesh CreateMeshFromMeshResource(const std::string &filePath);
 
+    /**
+     * Get the shader program of a shader resource, compiling it only if no
+     * shader resource with the same sources has been before.
+     *
+     * @param   filePath  const std::string &, path to shader resource.
+     * @return            ds_render::ProgramHandle, handle to program.
+     */
+    ds_render::ProgramHandle
+    CreateProgramFromShaderResource(const std::string &filePath);
+
     /**
      * Create a Material object from a path to a material resource.
      *
-     * Will attempt to bind Scene and Object constant buffers by default.
+     * Will attempt to bind Scene and Object constant buffers by default, or
+     * Scene and Instances constant buffers for instanced materials.
      *
-     * @param   filePath        const std::string &, path to material resource.
-     * @param   sceneMatrices   ds_render::ConstantBufferHandle, handle to
+     * @param   filePath          const std::string &, path to material
+     * resource.
+     * @param   sceneMatrices     ds_render::ConstantBufferHandle, handle to
      * constant buffer containing scene matrix data.
-     * @param   objectMatrices  ds_render::ConstantBufferHandle, handle to
+     * @param   objectMatrices    ds_render::ConstantBufferHandle, handle to
      * constant buffer containing object matrix data.
-     * @return                  ds_render::Material, material created.
+     * @param   instanceMatrices  ds_render::ConstantBufferHandle, handle to
+     * constant buffer containing the object matrices of an instanced draw.
+     * @return                    ds_render::Material, material created.
      */
     // ds_render::Material
     // CreateMaterialFromMaterialResource(const std::string &filePath);
     ds_render::Material CreateMaterialFromMaterialResource(
         const std::string &filePath,
         ds_render::ConstantBufferHandle sceneMatrices,
-        ds_render::ConstantBufferHandle objectMatrices);
+        ds_render::ConstantBufferHandle objectMatrices,
+        ds_render::ConstantBufferHandle instanceMatrices);
 
     /**
      * Create a render component for the given entity using the given component
@@ -118,10 +189,27 @@ private:
     // void CreateRenderComponentFor(Entity entity,
     //                               const std::string &componentData);
 
+    /**
+     * Insert an entity into the scene tree, or update it's bounds if already
+     * there, if it has both a render and a transform component.
+     *
+     * @param  entity  Entity, entity to add.
+     */
+    void AddToSceneTree(Entity entity);
+
+    /**
+     * Bring the scene tree up to date with the world transforms updated by
+     * the last update.
+     */
+    void UpdateSceneTree();
+
     /**
      * Render the scene.
+     *
+     * @param  interpolation  float, fraction of the way from the world
+     * transforms before the last update to the current ones.
      */
-    void RenderScene();
+    void RenderScene(float interpolation);
 
     /** Messages generated and received by this system */
     ds_msg::MessageStream m_messagesGenerated, m_messagesReceived;
@@ -135,6 +223,26 @@ private:
     ds_render::RenderComponentManager m_renderComponentManager;
     /** Transform component manager */
     TransformComponentManager m_transformComponentManager;
+    /** Threads used to update world transforms, if any */
+    std::unique_ptr<ds_com::ThreadPool> m_transformThreadPool;
+    /** World space bounds of entities with render and transform components */
+    BoundingVolumeHierarchy m_sceneTree;
+    /** Entities found in the view frustum, reused between frames */
+    std::vector<Entity> m_visibleEntities;
+    /** World transforms of the visible entities, as drawn this frame */
+    std::vector<ds_math::Matrix4> m_interpolatedTransforms;
+    /** Meshes to draw this frame, reused between frames */
+    ds_render::RenderQueue m_renderQueue;
+    /** Meshes created for render components, by mesh resource path. Shared
+     * so that copies of a mesh can be drawn instanced */
+    std::map<std::string, ds_render::Mesh> m_meshes;
+    /** Materials created for render components, by material resource
+     * path */
+    std::map<std::string, ds_render::Material> m_materials;
+    /** Programs created, shared by materials with the same shaders */
+    ds_render::ProgramCache m_programCache;
+    /** File program binaries are loaded from and saved to, none if empty */
+    std::string m_programCacheFilePath;
 
     ds_render::Mesh m_mesh;
     ds_render::Material m_material;
@@ -142,11 +250,19 @@ private:
 
     ds_render::ConstantBufferHandle m_sceneMatrices;
     ds_render::ConstantBufferHandle m_objectMatrices;
+    ds_render::ConstantBufferHandle m_instanceMatrices;
     ds_render::ConstantBufferDescription m_sceneBufferDescrip;
     ds_render::ConstantBufferDescription m_objectBufferDescrip;
+    ds_render::ConstantBufferDescription m_instanceBufferDescrip;
+    /** Members of m_sceneBufferDescrip, found once it's created */
+    ds_render::ConstantBufferDescription::Member m_sceneViewMatrix;
+    ds_render::ConstantBufferDescription::Member m_sceneProjectionMatrix;
 
     ds_math::Matrix4 m_viewMatrix;
     ds_math::Matrix4 m_projectionMatrix;
+
+    /** Statistics of the last frame rendered */
+    RenderStatistics m_statistics;
 };
 // bool result = true;
 
@@ -0,0 +1,430 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "engine/system/render/RenderQueue.h"
+
+namespace ds_render
+{
+const unsigned int RenderQueue::KeyFieldBits;
+const unsigned int RenderQueue::MaxInstancesPerDraw;
+
+// Mask of a single key field
+static const uint64_t KeyFieldMask =
+    (1ull << RenderQueue::KeyFieldBits) - 1;
+
+// Radix sort digits, one byte at a time
+static const unsigned int RadixBits = 8;
+static const unsigned int RadixSize = 1 << RadixBits;
+static const unsigned int NumRadixPasses = 64 / RadixBits;
+
+// Append room for a constant buffer block to the data to stream, starting at
+// an offset it can be bound at. Returns the offset of the block.
+static size_t AppendBlock(size_t alignment,
+                          size_t numBytes,
+                          std::vector<char> *data)
+{
+    size_t offset = (data->size() + alignment - 1) / alignment * alignment;
+    data->resize(offset + numBytes);
+
+    return offset;
+}
+
+RenderQueue::RenderQueue()
+{
+    m_objectBufferDescription = nullptr;
+    m_objectModelMatrix.offset = 0;
+    m_instanceBufferDescription = nullptr;
+    m_instanceModelMatrices.offset = 0;
+}
+
+uint64_t RenderQueue::MakeKey(const Material &material,
+                              const Mesh &mesh,
+                              float depth)
+{
+    // FNV-1a of the texture handles, folded into the field
+    uint64_t textureHash = 14695981039346656037ull;
+    for (const auto &samplerTexture : material.GetTextures())
+    {
+        textureHash ^= (uint64_t)samplerTexture.second.GetTextureHandle();
+        textureHash *= 1099511628211ull;
+    }
+    textureHash ^= textureHash >> 32;
+    textureHash ^= textureHash >> 16;
+
+    uint64_t meshId = mesh.GetVertexBuffer().index * 31u +
+                      mesh.GetIndexBuffer().index;
+
+    float clampedDepth = std::min(std::max(depth, 0.0f), 1.0f);
+    uint64_t quantizedDepth = (uint64_t)(clampedDepth * KeyFieldMask);
+
+    return ((material.GetProgram().index & KeyFieldMask)
+            << (3 * KeyFieldBits)) |
+           ((textureHash & KeyFieldMask) << (2 * KeyFieldBits)) |
+           ((meshId & KeyFieldMask) << KeyFieldBits) | quantizedDepth;
+}
+
+void RenderQueue::SetObjectBuffer(
+    ConstantBufferHandle objectMatrices,
+    const ConstantBufferDescription *objectBufferDescription)
+{
+    m_objectMatrices = objectMatrices;
+    m_objectBufferDescription = nullptr;
+
+    if (objectBufferDescription->GetMember("Object.modelMatrix",
+                                           &m_objectModelMatrix))
+    {
+        m_objectBufferDescription = objectBufferDescription;
+    }
+}
+
+void RenderQueue::SetInstanceBuffer(
+    ConstantBufferHandle instanceMatrices,
+    const ConstantBufferDescription *instanceBufferDescription)
+{
+    m_instanceMatrices = instanceMatrices;
+    m_instanceBufferDescription = nullptr;
+
+    if (instanceBufferDescription->GetMember("Instances.modelMatrices",
+                                             &m_instanceModelMatrices))
+    {
+        assert(m_instanceModelMatrices.offset +
+                       MaxInstancesPerDraw * sizeof(ds_math::Matrix4) <=
+                   instanceBufferDescription->GetBufferSize() &&
+               "RenderQueue::SetInstanceBuffer: Instance buffer is too small "
+               "for MaxInstancesPerDraw matrices.");
+        m_instanceBufferDescription = instanceBufferDescription;
+    }
+}
+
+void RenderQueue::Clear()
+{
+    m_items.clear();
+    m_entries.clear();
+}
+
+void RenderQueue::Push(const Material *material,
+                       const Mesh *mesh,
+                       const ds_math::Matrix4 *worldTransform,
+                       float depth)
+{
+    Item item;
+    item.material = material;
+    item.mesh = mesh;
+    item.worldTransform = worldTransform;
+
+    SortEntry entry;
+    entry.key = MakeKey(*material, *mesh, depth);
+    entry.item = (uint32_t)m_items.size();
+
+    m_items.push_back(item);
+    m_entries.push_back(entry);
+}
+
+void RenderQueue::Sort()
+{
+    const size_t numEntries = m_entries.size();
+
+    // Count the occurrences of every digit of every pass in one read
+    size_t counts[NumRadixPasses * RadixSize];
+    std::fill(counts, counts + NumRadixPasses * RadixSize, 0);
+    for (const SortEntry &entry : m_entries)
+    {
+        for (unsigned int pass = 0; pass < NumRadixPasses; ++pass)
+        {
+            ++counts[pass * RadixSize +
+                     ((entry.key >> (pass * RadixBits)) & (RadixSize - 1))];
+        }
+    }
+
+    m_sortBuffer.resize(numEntries);
+    for (unsigned int pass = 0; pass < NumRadixPasses; ++pass)
+    {
+        size_t *passCounts = &counts[pass * RadixSize];
+
+        // Every key has the same digit, so the pass wouldn't move anything.
+        // Common for the upper bytes of each field.
+        bool skip = false;
+        for (unsigned int digit = 0; digit < RadixSize && !skip; ++digit)
+        {
+            skip = (passCounts[digit] == numEntries);
+        }
+
+        if (!skip)
+        {
+            // Turn counts into the position of the first entry of each digit
+            size_t offset = 0;
+            for (unsigned int digit = 0; digit < RadixSize; ++digit)
+            {
+                size_t count = passCounts[digit];
+                passCounts[digit] = offset;
+                offset += count;
+            }
+
+            // Stable scatter, so earlier passes' order is kept within a digit
+            const unsigned int shift = pass * RadixBits;
+            for (const SortEntry &entry : m_entries)
+            {
+                size_t digit = (entry.key >> shift) & (RadixSize - 1);
+                m_sortBuffer[passCounts[digit]++] = entry;
+            }
+
+            m_entries.swap(m_sortBuffer);
+        }
+    }
+}
+
+RenderQueueStatistics RenderQueue::Submit(IRenderer *renderer)
+{
+    RenderQueueStatistics statistics;
+    statistics.numDraws = 0;
+    statistics.numInstances = 0;
+    statistics.numProgramChanges = 0;
+    statistics.numTextureChanges = 0;
+    statistics.numMeshChanges = 0;
+
+    const size_t alignment = renderer->GetConstantBufferOffsetAlignment();
+    const ds_math::Matrix4 identity(1.0f);
+
+    // Lay out the draws and the constant buffer blocks they bind
+    m_draws.clear();
+    m_objectData.clear();
+    m_instanceData.clear();
+
+    // Instanced draws bind a whole Instances block, so the data streamed must
+    // reach the end of the last one's
+    size_t instanceDataSize = 0;
+
+    size_t position = 0;
+    while (position < m_entries.size())
+    {
+        const Item &item = m_items[m_entries[position].item];
+
+        Draw draw;
+        draw.position = position;
+        draw.numInstances = 1;
+        draw.instanced = (item.material->IsInstanced() &&
+                          m_instanceBufferDescription != nullptr);
+        draw.dataOffset = 0;
+
+        if (draw.instanced)
+        {
+            bool sameRun = true;
+            while (sameRun && draw.numInstances < MaxInstancesPerDraw &&
+                   position + draw.numInstances < m_entries.size())
+            {
+                const Item &next =
+                    m_items[m_entries[position + draw.numInstances].item];
+                sameRun = CanInstance(item, next);
+
+                if (sameRun)
+                {
+                    ++draw.numInstances;
+                }
+            }
+
+            // Only the matrices of the run are written, the shader never
+            // reads past gl_InstanceID. Items without a transform are placed
+            // at the origin.
+            draw.dataOffset = AppendBlock(
+                alignment, m_instanceModelMatrices.offset +
+                               draw.numInstances * sizeof(ds_math::Matrix4),
+                &m_instanceData);
+            instanceDataSize = draw.dataOffset +
+                               m_instanceBufferDescription->GetBufferSize();
+
+            char *matrices = &m_instanceData[draw.dataOffset] +
+                             m_instanceModelMatrices.offset;
+            for (size_t i = 0; i < draw.numInstances; ++i)
+            {
+                const Item &instance = m_items[m_entries[position + i].item];
+                const ds_math::Matrix4 *transform =
+                    (instance.worldTransform != nullptr)
+                        ? instance.worldTransform
+                        : &identity;
+                std::memcpy(matrices + i * sizeof(ds_math::Matrix4), transform,
+                            sizeof(ds_math::Matrix4));
+            }
+        }
+        else if (m_objectBufferDescription != nullptr)
+        {
+            // Start from the description's data, so members other than the
+            // model matrix keep their values
+            const size_t blockSize = m_objectBufferDescription->GetBufferSize();
+            draw.dataOffset = AppendBlock(alignment, blockSize, &m_objectData);
+            char *block = &m_objectData[draw.dataOffset];
+            std::memcpy(block, m_objectBufferDescription->GetDataPtr(),
+                        blockSize);
+
+            if (item.worldTransform != nullptr)
+            {
+                std::memcpy(block + m_objectModelMatrix.offset,
+                            item.worldTransform, sizeof(ds_math::Matrix4));
+            }
+        }
+
+        m_draws.push_back(draw);
+        position += draw.numInstances;
+    }
+
+    // Write every block of the frame with one call per buffer
+    size_t objectBase = 0;
+    bool objectStreamed =
+        (!m_objectData.empty() &&
+         renderer->WriteStreamingConstantBuffer(
+             m_objectMatrices, m_objectData.size(), &m_objectData[0],
+             &objectBase));
+
+    size_t instanceBase = 0;
+    bool instanceStreamed = false;
+    if (!m_instanceData.empty())
+    {
+        m_instanceData.resize(instanceDataSize);
+        instanceStreamed = renderer->WriteStreamingConstantBuffer(
+            m_instanceMatrices, m_instanceData.size(), &m_instanceData[0],
+            &instanceBase);
+    }
+
+    // State set by the previous draw, nullptr before the first
+    const Material *currentMaterial = nullptr;
+    const Mesh *currentMesh = nullptr;
+
+    for (const Draw &draw : m_draws)
+    {
+        const Item &item = m_items[m_entries[draw.position].item];
+        const Material &material = *item.material;
+        const Mesh &mesh = *item.mesh;
+
+        bool programChanged =
+            (currentMaterial == nullptr ||
+             currentMaterial->GetProgram() != material.GetProgram());
+
+        if (programChanged)
+        {
+            renderer->SetProgram(material.GetProgram());
+            ++statistics.numProgramChanges;
+        }
+
+        // Samplers belong to the program, so a new program needs it's
+        // textures bound even if they haven't changed
+        if (programChanged || !SameTextures(*currentMaterial, material))
+        {
+            if (currentMaterial != nullptr)
+            {
+                for (const auto &samplerTexture :
+                     currentMaterial->GetTextures())
+                {
+                    renderer->UnbindTextureFromSampler(
+                        samplerTexture.second.GetTextureHandle());
+                }
+            }
+
+            for (const auto &samplerTexture : material.GetTextures())
+            {
+                renderer->BindTextureToSampler(
+                    material.GetProgram(), samplerTexture.first,
+                    samplerTexture.second.GetTextureHandle());
+            }
+            ++statistics.numTextureChanges;
+        }
+        currentMaterial = &material;
+
+        if (currentMesh == nullptr ||
+            currentMesh->GetVertexBuffer() != mesh.GetVertexBuffer() ||
+            currentMesh->GetIndexBuffer() != mesh.GetIndexBuffer())
+        {
+            ++statistics.numMeshChanges;
+        }
+        currentMesh = &mesh;
+
+        if (draw.instanced)
+        {
+            if (instanceStreamed)
+            {
+                renderer->BindConstantBufferRange(
+                    m_instanceMatrices, instanceBase + draw.dataOffset,
+                    m_instanceBufferDescription->GetBufferSize());
+            }
+
+            renderer->DrawVerticesIndexedInstanced(
+                mesh.GetVertexBuffer(), mesh.GetIndexBuffer(),
+                PrimitiveType::TriangleStrip, mesh.GetStartingIndex(),
+                mesh.GetNumIndices(), draw.numInstances);
+        }
+        else
+        {
+            if (objectStreamed)
+            {
+                renderer->BindConstantBufferRange(
+                    m_objectMatrices, objectBase + draw.dataOffset,
+                    m_objectBufferDescription->GetBufferSize());
+            }
+
+            renderer->DrawVerticesIndexed(
+                mesh.GetVertexBuffer(), mesh.GetIndexBuffer(),
+                PrimitiveType::TriangleStrip, mesh.GetStartingIndex(),
+                mesh.GetNumIndices());
+        }
+        ++statistics.numDraws;
+        statistics.numInstances += draw.numInstances;
+    }
+
+    // Leave no textures bound, as drawing each item on it's own did
+    if (currentMaterial != nullptr)
+    {
+        for (const auto &samplerTexture : currentMaterial->GetTextures())
+        {
+            renderer->UnbindTextureFromSampler(
+                samplerTexture.second.GetTextureHandle());
+        }
+    }
+
+    return statistics;
+}
+
+size_t RenderQueue::GetNumItems() const
+{
+    return m_items.size();
+}
+
+uint64_t RenderQueue::GetKey(size_t position) const
+{
+    return m_entries[position].key;
+}
+
+bool RenderQueue::SameTextures(const Material &material1,
+                               const Material &material2)
+{
+    const auto &textures1 = material1.GetTextures();
+    const auto &textures2 = material2.GetTextures();
+
+    bool same = (textures1.size() == textures2.size());
+    for (size_t i = 0; i < textures1.size() && same; ++i)
+    {
+        same = (textures1[i].second.GetTextureHandle() ==
+                    textures2[i].second.GetTextureHandle() &&
+                textures1[i].first == textures2[i].first);
+    }
+
+    return same;
+}
+
+bool RenderQueue::CanInstance(const Item &first, const Item &item)
+{
+    const Mesh &firstMesh = *first.mesh;
+    const Mesh &mesh = *item.mesh;
+
+    bool sameMaterial =
+        (first.material == item.material ||
+         (item.material->IsInstanced() &&
+          first.material->GetProgram() == item.material->GetProgram() &&
+          SameTextures(*first.material, *item.material)));
+
+    return sameMaterial &&
+           (first.mesh == item.mesh ||
+            (firstMesh.GetVertexBuffer() == mesh.GetVertexBuffer() &&
+             firstMesh.GetIndexBuffer() == mesh.GetIndexBuffer() &&
+             firstMesh.GetStartingIndex() == mesh.GetStartingIndex() &&
+             firstMesh.GetNumIndices() == mesh.GetNumIndices()));
+}
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/system/render/ConstantBufferDescription.h"
+#include "engine/system/render/IRenderer.h"
+#include "engine/system/render/Material.h"
+#include "engine/system/render/Mesh.h"
+
+#include "math/Matrix4.h"
+
+namespace ds_render
+{
+/**
+ * Counts of the renderer calls made to submit a render queue.
+ */
+struct RenderQueueStatistics
+{
+    /** Draw calls made */
+    unsigned int numDraws;
+    /** Meshes drawn, more than the draw calls made when instancing */
+    unsigned int numInstances;
+    /** Calls to IRenderer::SetProgram */
+    unsigned int numProgramChanges;
+    /** Times the textures bound were replaced by another set */
+    unsigned int numTextureChanges;
+    /** Times the mesh drawn differed from the one drawn before it */
+    unsigned int numMeshChanges;
+};
+
+/**
+ * Queue of meshes to draw in a frame, sorted to minimize renderer state
+ * changes.
+ *
+ * Each item is given a 64 bit sort key made up of (from most to least
+ * significant bits) it's program, the set of textures of it's material, it's
+ * mesh and it's depth. Sorting the keys groups items sharing a program, then
+ * textures, then mesh, drawing each group front to back. Submit then only
+ * calls the renderer when the state actually changes between items.
+ *
+ * Keys hold truncated handle indices and a hash of the textures, so two
+ * different states may share a key. This only costs extra state changes,
+ * Submit always compares the states themselves.
+ *
+ * Consecutive items of an instanced material sharing a mesh are drawn with a
+ * single instanced draw call, their world transforms written to the
+ * Instances constant buffer. The program of an instanced material should
+ * declare it as:
+ *
+ *     layout(std140) uniform Instances { mat4 modelMatrices[256]; };
+ *
+ * and place each instance with modelMatrices[gl_InstanceID].
+ *
+ * Items refer to materials, meshes and transforms by pointer, these must stay
+ * valid until the queue is submitted.
+ */
+class RenderQueue
+{
+public:
+    /**
+     * Number of bits of the key used for each field.
+     */
+    static const unsigned int KeyFieldBits = 16;
+
+    /**
+     * Most instances drawn by one instanced draw call, as many model matrices
+     * as fit in the smallest constant buffer OpenGL allows (16KB).
+     */
+    static const unsigned int MaxInstancesPerDraw = 256;
+
+    /**
+     * Create an empty queue, with no constant buffers to write world
+     * transforms to.
+     */
+    RenderQueue();
+
+    /**
+     * Build the sort key of an item.
+     *
+     * @param   material  const Material &, material of the item.
+     * @param   mesh      const Mesh &, mesh of the item.
+     * @param   depth     float, depth of the item in [0, 1], 0 nearest the
+     * camera. Clamped to this range.
+     * @return            uint64_t, sort key.
+     */
+    static uint64_t
+    MakeKey(const Material &material, const Mesh &mesh, float depth);
+
+    /**
+     * Remove all items from the queue, keeping the memory allocated for
+     * them.
+     */
+    void Clear();
+
+    /**
+     * Add an item to the queue.
+     *
+     * @param  material        const Material *, material to draw with.
+     * @param  mesh            const Mesh *, mesh to draw.
+     * @param  worldTransform  const ds_math::Matrix4 *, world transform of the
+     * mesh, or nullptr if it has none (the model matrix of the object buffer
+     * description is used).
+     * @param  depth           float, depth of the item in [0, 1], 0 nearest
+     * the camera.
+     */
+    void Push(const Material *material,
+              const Mesh *mesh,
+              const ds_math::Matrix4 *worldTransform,
+              float depth);
+
+    /**
+     * Sort the items by key with a least significant digit radix sort. Items
+     * with equal keys keep the order they were pushed in.
+     */
+    void Sort();
+
+    /**
+     * Set the constant buffer to stream each item's world transform to. It's
+     * Object.modelMatrix member is found once here, so submitting doesn't
+     * look it up for every item.
+     *
+     * @param  objectMatrices           ConstantBufferHandle, constant buffer
+     * created with IRenderer::CreateStreamingConstantBuffer, bound to the
+     * Object block of programs.
+     * @param  objectBufferDescription  const ConstantBufferDescription *,
+     * layout of the Object block, with an Object.modelMatrix member. It's
+     * data is used for the other members, and the model matrix of items
+     * without a transform. Must stay valid while the queue is used.
+     */
+    void
+    SetObjectBuffer(ConstantBufferHandle objectMatrices,
+                    const ConstantBufferDescription *objectBufferDescription);
+
+    /**
+     * Set the constant buffer to stream the world transforms of each
+     * instanced draw to. Until set, instanced materials are drawn one item at
+     * a time like any other.
+     *
+     * @param  instanceMatrices           ConstantBufferHandle, constant
+     * buffer created with IRenderer::CreateStreamingConstantBuffer, bound to
+     * the Instances block of programs.
+     * @param  instanceBufferDescription  const ConstantBufferDescription *,
+     * layout of the Instances block, with an Instances.modelMatrices member
+     * followed by room for MaxInstancesPerDraw matrices. Must stay valid
+     * while the queue is used.
+     */
+    void SetInstanceBuffer(
+        ConstantBufferHandle instanceMatrices,
+        const ConstantBufferDescription *instanceBufferDescription);
+
+    /**
+     * Draw the items in their current order, only changing the program and
+     * textures when they differ from the previous item. Runs of items
+     * sharing an instanced material and a mesh are drawn together, up to
+     * MaxInstancesPerDraw at a time.
+     *
+     * The world transforms of every draw are laid out first, then written to
+     * each streaming constant buffer at once. Each draw then binds the range
+     * holding it's transforms, so the renderer never waits for a draw to
+     * finish before updating a constant buffer for the next one.
+     *
+     * @param   renderer  IRenderer *, renderer to draw with.
+     * @return            RenderQueueStatistics, renderer calls made.
+     */
+    RenderQueueStatistics Submit(IRenderer *renderer);
+
+    /**
+     * Get the number of items in the queue.
+     *
+     * @return  size_t, number of items.
+     */
+    size_t GetNumItems() const;
+
+    /**
+     * Get the sort key of the item at the given position in the queue.
+     *
+     * @param   position  size_t, position in the queue (sorted if Sort has
+     * been called since the last Push).
+     * @return            uint64_t, sort key of the item.
+     */
+    uint64_t GetKey(size_t position) const;
+
+private:
+    /**
+     * Mesh to draw and the state to draw it with.
+     */
+    struct Item
+    {
+        /** Material to draw with */
+        const Material *material;
+        /** Mesh to draw */
+        const Mesh *mesh;
+        /** World transform, nullptr if none */
+        const ds_math::Matrix4 *worldTransform;
+    };
+
+    /**
+     * A draw call to make, of one item or a run of instanced items.
+     */
+    struct Draw
+    {
+        /** Position in m_entries of the first item drawn */
+        size_t position;
+        /** Number of items drawn */
+        size_t numInstances;
+        /** Whether drawn instanced, from the instance buffer */
+        bool instanced;
+        /** Offset of the draw's constant buffer block in the data streamed,
+         * if any */
+        size_t dataOffset;
+    };
+
+    /**
+     * Sort key of an item, sorted in place of the items themselves.
+     */
+    struct SortEntry
+    {
+        /** Sort key */
+        uint64_t key;
+        /** Position of the item in m_items */
+        uint32_t item;
+    };
+
+    /**
+     * Test whether two materials bind the same textures to the same samplers.
+     *
+     * @param   material1  const Material &, first material.
+     * @param   material2  const Material &, second material.
+     * @return             bool, TRUE if the textures are the same, FALSE
+     * otherwise.
+     */
+    static bool SameTextures(const Material &material1,
+                             const Material &material2);
+
+    /**
+     * Test whether an item can be drawn in the same instanced draw call as
+     * the first item of a run.
+     *
+     * @param   first  const Item &, first item of the run, of an instanced
+     * material.
+     * @param   item   const Item &, item to test.
+     * @return         bool, TRUE if the item has the same program, textures
+     * and mesh, FALSE otherwise.
+     */
+    static bool CanInstance(const Item &first, const Item &item);
+
+    /** Items, in the order pushed */
+    std::vector<Item> m_items;
+    /** Keys of the items, in draw order */
+    std::vector<SortEntry> m_entries;
+    /** Scratch space for sorting, reused between frames */
+    std::vector<SortEntry> m_sortBuffer;
+    /** Draws of the queue being submitted */
+    std::vector<Draw> m_draws;
+    /** Object blocks of the queue being submitted, to stream */
+    std::vector<char> m_objectData;
+    /** Instances blocks of the queue being submitted, to stream */
+    std::vector<char> m_instanceData;
+
+    /** Streaming constant buffer of world transforms drawn one at a time */
+    ConstantBufferHandle m_objectMatrices;
+    /** Layout of m_objectMatrices, nullptr if not set */
+    const ConstantBufferDescription *m_objectBufferDescription;
+    /** Object.modelMatrix member of m_objectBufferDescription */
+    ConstantBufferDescription::Member m_objectModelMatrix;
+    /** Streaming constant buffer of world transforms drawn instanced */
+    ConstantBufferHandle m_instanceMatrices;
+    /** Layout of m_instanceMatrices, nullptr if not set */
+    const ConstantBufferDescription *m_instanceBufferDescription;
+    /** Instances.modelMatrices member of m_instanceBufferDescription */
+    ConstantBufferDescription::Member m_instanceModelMatrices;
+};
+}
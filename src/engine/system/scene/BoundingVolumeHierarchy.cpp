@@ -0,0 +1,565 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "engine/system/scene/BoundingVolumeHierarchy.h"
+
+namespace ds
+{
+BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+{
+    m_root = -1;
+    m_freeList = -1;
+    m_numEntities = 0;
+    m_numUpdatesSinceRebuild = 0;
+}
+
+void BoundingVolumeHierarchy::Insert(Entity entity,
+                                     const ds_math::AABB &bounds)
+{
+    assert(!Contains(entity) && "BoundingVolumeHierarchy::Insert(): Entity "
+                                "is already in the hierarchy.");
+
+    int leaf = AllocateNode();
+    Node &leafNode = m_nodes[leaf];
+    leafNode.bounds = bounds;
+    leafNode.parent = -1;
+    leafNode.children[0] = -1;
+    leafNode.children[1] = -1;
+    leafNode.entity = entity;
+    leafNode.outOfDate = false;
+
+    if (entity.GetIndex() >= m_sparse.size())
+    {
+        m_sparse.resize(entity.GetIndex() + 1, -1);
+    }
+    m_sparse[entity.GetIndex()] = leaf;
+    ++m_numEntities;
+
+    if (m_root == -1)
+    {
+        m_root = leaf;
+    }
+    else
+    {
+        // Replace the sibling with a new parent of the sibling and the leaf
+        int sibling = FindBestSibling(bounds);
+        int oldParent = m_nodes[sibling].parent;
+        int newParent = AllocateNode();
+
+        Node &parentNode = m_nodes[newParent];
+        parentNode.bounds =
+            ds_math::AABB::Merge(m_nodes[sibling].bounds, bounds);
+        parentNode.parent = oldParent;
+        parentNode.children[0] = sibling;
+        parentNode.children[1] = leaf;
+        // Ancestors of out of date nodes are out of date too
+        parentNode.outOfDate = m_nodes[sibling].outOfDate;
+
+        m_nodes[sibling].parent = newParent;
+        m_nodes[leaf].parent = newParent;
+
+        if (oldParent == -1)
+        {
+            m_root = newParent;
+        }
+        else
+        {
+            Node &oldParentNode = m_nodes[oldParent];
+            oldParentNode.children[oldParentNode.children[0] == sibling ? 0
+                                                                        : 1] =
+                newParent;
+
+            RefitAncestors(oldParent);
+        }
+    }
+}
+
+bool BoundingVolumeHierarchy::Remove(Entity entity)
+{
+    bool removed = false;
+
+    if (Contains(entity))
+    {
+        int leaf = m_sparse[entity.GetIndex()];
+        int parent = m_nodes[leaf].parent;
+
+        if (parent == -1)
+        {
+            m_root = -1;
+        }
+        else
+        {
+            // Replace the parent with the leaf's sibling
+            const Node &parentNode = m_nodes[parent];
+            int sibling = parentNode.children[parentNode.children[0] == leaf
+                                                  ? 1
+                                                  : 0];
+            int grandparent = parentNode.parent;
+
+            m_nodes[sibling].parent = grandparent;
+
+            if (grandparent == -1)
+            {
+                m_root = sibling;
+            }
+            else
+            {
+                Node &grandparentNode = m_nodes[grandparent];
+                grandparentNode
+                    .children[grandparentNode.children[0] == parent ? 0 : 1] =
+                    sibling;
+
+                RefitAncestors(grandparent);
+            }
+
+            FreeNode(parent);
+        }
+
+        FreeNode(leaf);
+        m_sparse[entity.GetIndex()] = -1;
+        --m_numEntities;
+        removed = true;
+    }
+
+    return removed;
+}
+
+bool BoundingVolumeHierarchy::Contains(Entity entity) const
+{
+    return (entity.GetIndex() < m_sparse.size() &&
+            m_sparse[entity.GetIndex()] != -1 &&
+            m_nodes[m_sparse[entity.GetIndex()]].entity.id == entity.id);
+}
+
+void BoundingVolumeHierarchy::Update(Entity entity,
+                                     const ds_math::AABB &bounds)
+{
+    assert(Contains(entity) && "BoundingVolumeHierarchy::Update(): Entity "
+                               "is not in the hierarchy.");
+
+    int leaf = m_sparse[entity.GetIndex()];
+    m_nodes[leaf].bounds = bounds;
+
+    // Mark ancestors out of date, stopping at the first that already is as
+    // it's ancestors will be too
+    int node = m_nodes[leaf].parent;
+    while (node != -1 && !m_nodes[node].outOfDate)
+    {
+        m_nodes[node].outOfDate = true;
+        node = m_nodes[node].parent;
+    }
+
+    ++m_numUpdatesSinceRebuild;
+}
+
+void BoundingVolumeHierarchy::Refit()
+{
+    if (m_root != -1 && m_nodes[m_root].outOfDate)
+    {
+        // Collect the out of date nodes parent before child
+        m_refitOrder.clear();
+        m_refitOrder.push_back(m_root);
+        for (size_t i = 0; i < m_refitOrder.size(); ++i)
+        {
+            const Node &node = m_nodes[m_refitOrder[i]];
+
+            for (int child : node.children)
+            {
+                if (m_nodes[child].outOfDate)
+                {
+                    m_refitOrder.push_back(child);
+                }
+            }
+        }
+
+        // Then recalculate them child before parent
+        for (auto it = m_refitOrder.rbegin(); it != m_refitOrder.rend(); ++it)
+        {
+            Node &node = m_nodes[*it];
+            node.bounds =
+                ds_math::AABB::Merge(m_nodes[node.children[0]].bounds,
+                                     m_nodes[node.children[1]].bounds);
+            node.outOfDate = false;
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::Rebuild()
+{
+    // Gather the leaves in entity order, which reads the nodes in far fewer
+    // cache misses than walking the tree
+    m_leaves.clear();
+    m_leaves.reserve(m_numEntities);
+    for (int node : m_sparse)
+    {
+        if (node != -1)
+        {
+            const Node &leafNode = m_nodes[node];
+
+            BuildLeaf leaf;
+            leaf.center[0] = leafNode.bounds.center.x;
+            leaf.center[1] = leafNode.bounds.center.y;
+            leaf.center[2] = leafNode.bounds.center.z;
+            leaf.bounds = leafNode.bounds;
+            leaf.entity = leafNode.entity;
+            m_leaves.push_back(leaf);
+        }
+    }
+
+    // Then lay the nodes out again from scratch, parent before child, so
+    // queries walk through memory in order
+    m_nodes.clear();
+    m_freeList = -1;
+    m_root = -1;
+
+    if (!m_leaves.empty())
+    {
+        m_nodes.reserve(2 * m_leaves.size() - 1);
+        m_root = BuildSubtree(0, m_leaves.size());
+        m_nodes[m_root].parent = -1;
+    }
+
+    m_numUpdatesSinceRebuild = 0;
+}
+
+size_t BoundingVolumeHierarchy::GetNumEntities() const
+{
+    return m_numEntities;
+}
+
+size_t BoundingVolumeHierarchy::GetNumUpdatesSinceRebuild() const
+{
+    return m_numUpdatesSinceRebuild;
+}
+
+ds_math::AABB BoundingVolumeHierarchy::GetBounds() const
+{
+    return (m_root != -1) ? m_nodes[m_root].bounds : ds_math::AABB();
+}
+
+void BoundingVolumeHierarchy::QueryFrustum(const ds_math::Frustum &frustum,
+                                           std::vector<Entity> *entities) const
+{
+    Query([&frustum](const ds_math::AABB &bounds)
+          {
+              Overlap overlap = Overlap::Outside;
+              if (frustum.Contains(bounds))
+              {
+                  overlap = Overlap::Inside;
+              }
+              else if (frustum.Intersects(bounds))
+              {
+                  overlap = Overlap::Intersecting;
+              }
+
+              return overlap;
+          },
+          entities);
+}
+
+void BoundingVolumeHierarchy::QueryAABB(const ds_math::AABB &bounds,
+                                        std::vector<Entity> *entities) const
+{
+    Query([&bounds](const ds_math::AABB &nodeBounds)
+          {
+              Overlap overlap = Overlap::Outside;
+              if (ds_math::AABB::Intersects(bounds, nodeBounds))
+              {
+                  // Contained if no further from the center on any axis
+                  ds_math::Vector3 offset = nodeBounds.center - bounds.center;
+                  bool inside =
+                      (std::fabs(offset.x) + nodeBounds.extents.x <=
+                           bounds.extents.x &&
+                       std::fabs(offset.y) + nodeBounds.extents.y <=
+                           bounds.extents.y &&
+                       std::fabs(offset.z) + nodeBounds.extents.z <=
+                           bounds.extents.z);
+
+                  overlap = inside ? Overlap::Inside : Overlap::Intersecting;
+              }
+
+              return overlap;
+          },
+          entities);
+}
+
+void BoundingVolumeHierarchy::QueryRay(const ds_math::Vector3 &origin,
+                                       const ds_math::Vector3 &direction,
+                                       float maxDistance,
+                                       std::vector<Entity> *entities) const
+{
+    // Division by zero gives infinities, which the slab test handles
+    const float inverseX = 1.0f / direction.x;
+    const float inverseY = 1.0f / direction.y;
+    const float inverseZ = 1.0f / direction.z;
+
+    Query([&](const ds_math::AABB &bounds)
+          {
+              // Distances along the ray to the planes of each pair of faces
+              float x1 = (bounds.center.x - bounds.extents.x - origin.x) *
+                         inverseX;
+              float x2 = (bounds.center.x + bounds.extents.x - origin.x) *
+                         inverseX;
+              float y1 = (bounds.center.y - bounds.extents.y - origin.y) *
+                         inverseY;
+              float y2 = (bounds.center.y + bounds.extents.y - origin.y) *
+                         inverseY;
+              float z1 = (bounds.center.z - bounds.extents.z - origin.z) *
+                         inverseZ;
+              float z2 = (bounds.center.z + bounds.extents.z - origin.z) *
+                         inverseZ;
+
+              float enter = std::max(std::max(std::min(x1, x2),
+                                              std::min(y1, y2)),
+                                     std::max(std::min(z1, z2), 0.0f));
+              float exit = std::min(std::min(std::max(x1, x2),
+                                             std::max(y1, y2)),
+                                    std::min(std::max(z1, z2), maxDistance));
+
+              return (enter <= exit) ? Overlap::Intersecting
+                                     : Overlap::Outside;
+          },
+          entities);
+}
+
+void BoundingVolumeHierarchy::QueryRadius(const ds_math::Vector3 &center,
+                                          float radius,
+                                          std::vector<Entity> *entities) const
+{
+    const float radiusSquared = radius * radius;
+
+    Query([&](const ds_math::AABB &bounds)
+          {
+              // Distance from the point to the nearest point in the box
+              float dx = std::max(
+                  std::fabs(center.x - bounds.center.x) - bounds.extents.x,
+                  0.0f);
+              float dy = std::max(
+                  std::fabs(center.y - bounds.center.y) - bounds.extents.y,
+                  0.0f);
+              float dz = std::max(
+                  std::fabs(center.z - bounds.center.z) - bounds.extents.z,
+                  0.0f);
+
+              return (dx * dx + dy * dy + dz * dz <= radiusSquared)
+                         ? Overlap::Intersecting
+                         : Overlap::Outside;
+          },
+          entities);
+}
+
+template <typename Test>
+void BoundingVolumeHierarchy::Query(const Test &test,
+                                    std::vector<Entity> *entities) const
+{
+    if (m_root != -1)
+    {
+        std::vector<int> stack;
+        stack.reserve(64);
+        stack.push_back(m_root);
+
+        while (!stack.empty())
+        {
+            int nodeIndex = stack.back();
+            const Node &node = m_nodes[nodeIndex];
+            stack.pop_back();
+
+            Overlap overlap = test(node.bounds);
+
+            if (overlap == Overlap::Inside)
+            {
+                CollectEntities(nodeIndex, entities);
+            }
+            else if (overlap == Overlap::Intersecting)
+            {
+                if (node.children[0] == -1)
+                {
+                    entities->push_back(node.entity);
+                }
+                else
+                {
+                    stack.push_back(node.children[0]);
+                    stack.push_back(node.children[1]);
+                }
+            }
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::CollectEntities(
+    int node, std::vector<Entity> *entities) const
+{
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(node);
+
+    while (!stack.empty())
+    {
+        const Node &current = m_nodes[stack.back()];
+        stack.pop_back();
+
+        if (current.children[0] == -1)
+        {
+            entities->push_back(current.entity);
+        }
+        else
+        {
+            stack.push_back(current.children[0]);
+            stack.push_back(current.children[1]);
+        }
+    }
+}
+
+int BoundingVolumeHierarchy::AllocateNode()
+{
+    int node = m_freeList;
+
+    if (node != -1)
+    {
+        m_freeList = m_nodes[node].parent;
+    }
+    else
+    {
+        node = (int)m_nodes.size();
+        m_nodes.push_back(Node());
+    }
+
+    return node;
+}
+
+void BoundingVolumeHierarchy::FreeNode(int node)
+{
+    m_nodes[node].parent = m_freeList;
+    m_freeList = node;
+}
+
+int BoundingVolumeHierarchy::FindBestSibling(
+    const ds_math::AABB &bounds) const
+{
+    int node = m_root;
+    bool found = false;
+
+    while (!found && m_nodes[node].children[0] != -1)
+    {
+        const Node &current = m_nodes[node];
+        float area = current.bounds.GetSurfaceArea();
+        float mergedArea =
+            ds_math::AABB::Merge(current.bounds, bounds).GetSurfaceArea();
+
+        // Cost of a new parent of this node and the leaf
+        float cost = 2.0f * mergedArea;
+        // Every ancestor of the leaf below this node grows by this much
+        float inheritedCost = 2.0f * (mergedArea - area);
+
+        // Cost of inserting below each child
+        float childCosts[2];
+        for (unsigned int i = 0; i < 2; ++i)
+        {
+            const Node &child = m_nodes[current.children[i]];
+            float childMergedArea =
+                ds_math::AABB::Merge(child.bounds, bounds).GetSurfaceArea();
+
+            childCosts[i] = inheritedCost + childMergedArea;
+            if (child.children[0] != -1)
+            {
+                childCosts[i] -= child.bounds.GetSurfaceArea();
+            }
+        }
+
+        if (cost < childCosts[0] && cost < childCosts[1])
+        {
+            found = true;
+        }
+        else
+        {
+            node = current.children[childCosts[0] < childCosts[1] ? 0 : 1];
+        }
+    }
+
+    return node;
+}
+
+void BoundingVolumeHierarchy::RefitAncestors(int node)
+{
+    while (node != -1)
+    {
+        Node &current = m_nodes[node];
+        current.bounds =
+            ds_math::AABB::Merge(m_nodes[current.children[0]].bounds,
+                                 m_nodes[current.children[1]].bounds);
+        node = current.parent;
+    }
+}
+
+int BoundingVolumeHierarchy::BuildSubtree(size_t begin, size_t end)
+{
+    int root = AllocateNode();
+
+    if (end - begin == 1)
+    {
+        const BuildLeaf &leaf = m_leaves[begin];
+
+        Node &node = m_nodes[root];
+        node.bounds = leaf.bounds;
+        node.children[0] = -1;
+        node.children[1] = -1;
+        node.entity = leaf.entity;
+        node.outOfDate = false;
+
+        m_sparse[leaf.entity.GetIndex()] = root;
+    }
+    else
+    {
+        // Split at the median of the longest axis of the leaves' centers
+        float min[3];
+        float max[3];
+        for (unsigned int axis = 0; axis < 3; ++axis)
+        {
+            min[axis] = m_leaves[begin].center[axis];
+            max[axis] = m_leaves[begin].center[axis];
+        }
+        for (size_t i = begin + 1; i < end; ++i)
+        {
+            for (unsigned int axis = 0; axis < 3; ++axis)
+            {
+                min[axis] = std::min(min[axis], m_leaves[i].center[axis]);
+                max[axis] = std::max(max[axis], m_leaves[i].center[axis]);
+            }
+        }
+
+        unsigned int splitAxis = 0;
+        for (unsigned int axis = 1; axis < 3; ++axis)
+        {
+            if (max[axis] - min[axis] > max[splitAxis] - min[splitAxis])
+            {
+                splitAxis = axis;
+            }
+        }
+
+        size_t middle = begin + (end - begin) / 2;
+        std::nth_element(m_leaves.begin() + begin, m_leaves.begin() + middle,
+                         m_leaves.begin() + end,
+                         [splitAxis](const BuildLeaf &a, const BuildLeaf &b)
+                         {
+                             return (a.center[splitAxis] <
+                                     b.center[splitAxis]);
+                         });
+
+        int left = BuildSubtree(begin, middle);
+        int right = BuildSubtree(middle, end);
+
+        Node &node = m_nodes[root];
+        node.bounds = ds_math::AABB::Merge(m_nodes[left].bounds,
+                                           m_nodes[right].bounds);
+        node.children[0] = left;
+        node.children[1] = right;
+        node.outOfDate = false;
+
+        m_nodes[left].parent = root;
+        m_nodes[right].parent = root;
+    }
+
+    return root;
+}
+}
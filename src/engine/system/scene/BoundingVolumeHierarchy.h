@@ -0,0 +1,289 @@
+#pragma once
+
+#include <vector>
+
+#include "engine/entity/Entity.h"
+
+#include "math/AABB.h"
+#include "math/Frustum.h"
+#include "math/Vector3.h"
+
+namespace ds
+{
+/**
+ * Dynamic bounding volume hierarchy of entities, used to find the entities
+ * in a region of the world without visiting every entity.
+ *
+ * Each entity is a leaf holding it's world space bounding box, and each
+ * internal node holds the box containing both of it's children.
+ *
+ * Entities are inserted incrementally, next to the leaf that grows the tree
+ * the least. Moving an entity only updates it's leaf and marks the ancestors
+ * out of date, Refit then recalculates the out of date boxes without
+ * changing the structure of the tree. Refitting is cheap, but the tree gets
+ * looser as entities move far from where they were inserted, so Rebuild
+ * should be called once enough entities have moved (see
+ * GetNumUpdatesSinceRebuild).
+ *
+ * Queries return the entities whose boxes intersect the query volume, in no
+ * particular order. Queries expect the tree to be refitted.
+ */
+class BoundingVolumeHierarchy
+{
+public:
+    /**
+     * Default constructor, creates an empty hierarchy.
+     */
+    BoundingVolumeHierarchy();
+
+    /**
+     * Insert an entity into the hierarchy.
+     *
+     * @pre  Entity is not already in the hierarchy.
+     *
+     * @param  entity  Entity, entity to insert.
+     * @param  bounds  const ds_math::AABB &, world space bounding box of the
+     * entity.
+     */
+    void Insert(Entity entity, const ds_math::AABB &bounds);
+
+    /**
+     * Remove an entity from the hierarchy.
+     *
+     * @param   entity  Entity, entity to remove.
+     * @return          bool, TRUE if the entity was removed, FALSE if it was
+     * not in the hierarchy.
+     */
+    bool Remove(Entity entity);
+
+    /**
+     * Test whether an entity is in the hierarchy.
+     *
+     * @param   entity  Entity, entity to look for.
+     * @return          bool, TRUE if the entity is in the hierarchy, FALSE
+     * otherwise.
+     */
+    bool Contains(Entity entity) const;
+
+    /**
+     * Set the bounding box of an entity already in the hierarchy. The boxes
+     * of it's ancestors are updated by the next Refit.
+     *
+     * @pre  Entity is in the hierarchy.
+     *
+     * @param  entity  Entity, entity that moved.
+     * @param  bounds  const ds_math::AABB &, new world space bounding box of
+     * the entity.
+     */
+    void Update(Entity entity, const ds_math::AABB &bounds);
+
+    /**
+     * Recalculate the boxes of the internal nodes whose descendants were
+     * updated since the last refit. Only visits out of date nodes.
+     */
+    void Refit();
+
+    /**
+     * Rebuild the hierarchy from scratch, splitting the entities at the
+     * median of the longest axis of their centers at each level. Rebuilding
+     * also lays the nodes out in the order queries visit them.
+     */
+    void Rebuild();
+
+    /**
+     * Get the number of entities in the hierarchy.
+     *
+     * @return  size_t, number of entities.
+     */
+    size_t GetNumEntities() const;
+
+    /**
+     * Get the number of calls to Update since the hierarchy was last rebuilt.
+     *
+     * @return  size_t, number of updates.
+     */
+    size_t GetNumUpdatesSinceRebuild() const;
+
+    /**
+     * Get the bounding box of all the entities in the hierarchy.
+     *
+     * @return  ds_math::AABB, box containing all entities, or an empty box
+     * at the origin if there are none.
+     */
+    ds_math::AABB GetBounds() const;
+
+    /**
+     * Find the entities inside or intersecting a frustum.
+     *
+     * @param  frustum   const ds_math::Frustum &, frustum to test against.
+     * @param  entities  std::vector<Entity> *, entities found are appended
+     * to this.
+     */
+    void QueryFrustum(const ds_math::Frustum &frustum,
+                      std::vector<Entity> *entities) const;
+
+    /**
+     * Find the entities whose boxes intersect a box.
+     *
+     * @param  bounds    const ds_math::AABB &, box to test against.
+     * @param  entities  std::vector<Entity> *, entities found are appended
+     * to this.
+     */
+    void QueryAABB(const ds_math::AABB &bounds,
+                   std::vector<Entity> *entities) const;
+
+    /**
+     * Find the entities whose boxes are hit by a ray.
+     *
+     * @param  origin       const ds_math::Vector3 &, start of the ray.
+     * @param  direction    const ds_math::Vector3 &, direction of the ray,
+     * need not be normalized.
+     * @param  maxDistance  float, length of the ray, in multiples of the
+     * direction.
+     * @param  entities     std::vector<Entity> *, entities found are appended
+     * to this.
+     */
+    void QueryRay(const ds_math::Vector3 &origin,
+                  const ds_math::Vector3 &direction,
+                  float maxDistance,
+                  std::vector<Entity> *entities) const;
+
+    /**
+     * Find the entities whose boxes are within a distance of a point.
+     *
+     * @param  center    const ds_math::Vector3 &, point to measure from.
+     * @param  radius    float, distance from the point.
+     * @param  entities  std::vector<Entity> *, entities found are appended
+     * to this.
+     */
+    void QueryRadius(const ds_math::Vector3 &center,
+                     float radius,
+                     std::vector<Entity> *entities) const;
+
+private:
+    /**
+     * Node of the hierarchy, either a leaf holding an entity or an internal
+     * node with exactly two children.
+     */
+    struct Node
+    {
+        /** World space box of the entity, or containing both children */
+        ds_math::AABB bounds;
+        /** Parent node, -1 for the root */
+        int parent;
+        /** Child nodes, -1 for leaves */
+        int children[2];
+        /** Entity of a leaf */
+        Entity entity;
+        /** Does the box need recalculating from the children? */
+        bool outOfDate;
+    };
+
+    /**
+     * Leaf being rebuilt, with a copy of it's center so splitting doesn't
+     * need to look up the node.
+     */
+    struct BuildLeaf
+    {
+        /** Center of the leaf's box */
+        float center[3];
+        /** World space box of the entity */
+        ds_math::AABB bounds;
+        /** Entity of the leaf */
+        Entity entity;
+    };
+
+    /**
+     * Overlap of a node's box and a query volume.
+     */
+    enum class Overlap
+    {
+        /** Box is outside the volume, so is every box below it */
+        Outside,
+        /** Box intersects the volume, boxes below it need testing */
+        Intersecting,
+        /** Box is inside the volume, so is every box below it */
+        Inside
+    };
+
+    /**
+     * Find the entities whose boxes overlap a query volume, testing internal
+     * nodes first to skip whole subtrees. Subtrees inside the volume are
+     * collected without further tests.
+     *
+     * @param  test      const Test &, callable taking a const ds_math::AABB &
+     * and returning the Overlap of the box and the volume.
+     * @param  entities  std::vector<Entity> *, entities found are appended
+     * to this.
+     */
+    template <typename Test>
+    void Query(const Test &test, std::vector<Entity> *entities) const;
+
+    /**
+     * Append the entities of every leaf below a node.
+     *
+     * @param  node      int, index of the node.
+     * @param  entities  std::vector<Entity> *, entities are appended to this.
+     */
+    void CollectEntities(int node, std::vector<Entity> *entities) const;
+
+    /**
+     * Get a node from the free list, or a new one if the free list is empty.
+     *
+     * @return  int, index of the node.
+     */
+    int AllocateNode();
+
+    /**
+     * Return a node to the free list.
+     *
+     * @param  node  int, index of the node.
+     */
+    void FreeNode(int node);
+
+    /**
+     * Find the node to make the sibling of a new leaf, descending from the
+     * root while it is cheaper (in surface area) to insert below a node than
+     * next to it.
+     *
+     * @param   bounds  const ds_math::AABB &, box of the new leaf.
+     * @return          int, index of the sibling node.
+     */
+    int FindBestSibling(const ds_math::AABB &bounds) const;
+
+    /**
+     * Recalculate the boxes of a node and all it's ancestors from their
+     * children.
+     *
+     * @param  node  int, index of the first node to recalculate.
+     */
+    void RefitAncestors(int node);
+
+    /**
+     * Build a subtree from a range of leaves, allocating the nodes parent
+     * before child.
+     *
+     * @param   begin   size_t, first leaf in m_leaves.
+     * @param   end     size_t, position after the last leaf in m_leaves.
+     * @return          int, index of the root node of the subtree.
+     */
+    int BuildSubtree(size_t begin, size_t end);
+
+    /** Nodes, including free nodes */
+    std::vector<Node> m_nodes;
+    /** Root node, -1 if the hierarchy is empty */
+    int m_root;
+    /** First free node, free nodes are linked through their parent */
+    int m_freeList;
+    /** Map entity index to leaf node, -1 if the entity is not in the tree */
+    std::vector<int> m_sparse;
+    /** Number of entities in the hierarchy */
+    size_t m_numEntities;
+    /** Number of updates since the last rebuild */
+    size_t m_numUpdatesSinceRebuild;
+    /** Leaves being rebuilt, reused between rebuilds */
+    std::vector<BuildLeaf> m_leaves;
+    /** Out of date nodes being refitted, reused between refits */
+    std::vector<int> m_refitOrder;
+};
+}
@@ -1,17 +1,161 @@
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
+#include "engine/entity/ComponentStorage.h"
 #include "engine/entity/Instance.h"
 #include "math/Matrix4.h"
 
 namespace ds
 {
+/**
+ * Affine transform without it's last row, which is always (0, 0, 0, 1). Takes
+ * 48 bytes rather than the 64 of a Matrix4. Plain scalars, so arrays of them
+ * are copied and converted without constructor calls.
+ */
+struct AffineTransform3x4
+{
+    // Columns of the upper three rows
+    ds_math::scalar columns[4][3];
+};
+
+/**
+ * Converts between Matrix4 and the type local transforms are stored as.
+ */
+template <typename T>
+struct LocalTransformTraits;
+
+template <>
+struct LocalTransformTraits<ds_math::Matrix4>
+{
+    static const ds_math::Matrix4 &ToMatrix4(const ds_math::Matrix4 &local)
+    {
+        return local;
+    }
+
+    static const ds_math::Matrix4 &FromMatrix4(const ds_math::Matrix4 &matrix)
+    {
+        return matrix;
+    }
+};
+
+template <>
+struct LocalTransformTraits<AffineTransform3x4>
+{
+    static ds_math::Matrix4 ToMatrix4(const AffineTransform3x4 &local)
+    {
+        ds_math::Matrix4 matrix;
+        for (unsigned int col = 0; col < 4; ++col)
+        {
+            matrix.data[col].x = local.columns[col][0];
+            matrix.data[col].y = local.columns[col][1];
+            matrix.data[col].z = local.columns[col][2];
+        }
+
+        return matrix;
+    }
+
+    static AffineTransform3x4 FromMatrix4(const ds_math::Matrix4 &matrix)
+    {
+        AffineTransform3x4 local;
+        for (unsigned int col = 0; col < 4; ++col)
+        {
+            local.columns[col][0] = matrix.data[col].x;
+            local.columns[col][1] = matrix.data[col].y;
+            local.columns[col][2] = matrix.data[col].z;
+        }
+
+        return local;
+    }
+};
+
+/**
+ * Type local transforms are stored as. Local transforms are always affine and
+ * only read to compose world transforms, so by default they're stored
+ * without their last row. Defining DS_NO_COMPACT_TRANSFORMS (the
+ * DS_COMPACT_TRANSFORMS CMake option) stores them as Matrix4s.
+ */
+#ifdef DS_NO_COMPACT_TRANSFORMS
+typedef ds_math::Matrix4 LocalTransform;
+#else
+typedef AffineTransform3x4 LocalTransform;
+#endif
+
 struct TransformComponent
 {
-    ds_math::Matrix4 localTransform;
+    LocalTransform localTransform;
     ds_math::Matrix4 worldTransform;
+    // World transform before the last update, to interpolate from
+    ds_math::Matrix4 previousWorldTransform;
     Instance parent;
     Instance firstChild;
     Instance nextSibling;
     Instance prevSibling;
+    // Does the world transform need to be recalculated, did it change in the
+    // last update?
+    uint8_t dirty;
+};
+
+/**
+ * Transform components are stored as a structure of arrays, so loops that only
+ * need some of the data members (i.e. gathering world transforms for
+ * rendering) only stream those members through the cache.
+ */
+template <>
+class ComponentStorage<TransformComponent>
+{
+public:
+    size_t Size() const
+    {
+        return localTransform.size();
+    }
+
+    void PushBack()
+    {
+        localTransform.push_back(
+            LocalTransformTraits<LocalTransform>::FromMatrix4(
+                ds_math::Matrix4()));
+        worldTransform.push_back(ds_math::Matrix4());
+        previousWorldTransform.push_back(ds_math::Matrix4());
+        parent.push_back(Instance());
+        firstChild.push_back(Instance());
+        nextSibling.push_back(Instance());
+        prevSibling.push_back(Instance());
+        dirty.push_back(0);
+    }
+
+    void PopBack()
+    {
+        localTransform.pop_back();
+        worldTransform.pop_back();
+        previousWorldTransform.pop_back();
+        parent.pop_back();
+        firstChild.pop_back();
+        nextSibling.pop_back();
+        prevSibling.pop_back();
+        dirty.pop_back();
+    }
+
+    void Move(size_t from, size_t to)
+    {
+        localTransform[to] = localTransform[from];
+        worldTransform[to] = worldTransform[from];
+        previousWorldTransform[to] = previousWorldTransform[from];
+        parent[to] = parent[from];
+        firstChild[to] = firstChild[from];
+        nextSibling[to] = nextSibling[from];
+        prevSibling[to] = prevSibling[from];
+        dirty[to] = dirty[from];
+    }
+
+    std::vector<LocalTransform> localTransform;
+    std::vector<ds_math::Matrix4> worldTransform;
+    std::vector<ds_math::Matrix4> previousWorldTransform;
+    std::vector<Instance> parent;
+    std::vector<Instance> firstChild;
+    std::vector<Instance> nextSibling;
+    std::vector<Instance> prevSibling;
+    std::vector<uint8_t> dirty;
 };
 }
@@ -4,6 +4,39 @@
 
 namespace ds
 {
+// Fewest objects worth updating on another thread
+static const size_t MinTransformsPerTask = 1024;
+
+// Flags of an object's dirty value. The world transform needs recalculating,
+// the object is new so has no previous world transform to interpolate from,
+// or the world transform changed in the last update.
+static const uint8_t DirtyFlag = 1;
+static const uint8_t CreatedFlag = 2;
+static const uint8_t MovedFlag = 4;
+
+// Converts local transforms to and from Matrix4
+typedef LocalTransformTraits<LocalTransform> LocalTraits;
+
+TransformComponentManager::TransformComponentManager()
+{
+    m_hierarchyChanged = false;
+    m_anyDirty = false;
+    m_anyMoved = false;
+    m_threadPool = nullptr;
+}
+
+Instance TransformComponentManager::CreateComponentForEntity(Entity entity)
+{
+    Instance i = ComponentManager<TransformComponent>::CreateComponentForEntity(
+        entity);
+
+    m_data.component.dirty[i.index] = DirtyFlag | CreatedFlag;
+    m_anyDirty = true;
+    m_hierarchyChanged = true;
+
+    return i;
+}
+
 Instance TransformComponentManager::CreateComponentForEntityFromConfig(
     TransformComponentManager *transformComponentManager,
     Entity entity,
@@ -51,188 +84,427 @@ Instance TransformComponentManager::CreateComponentForEntityFromConfig(
     return instance;
 }
 
-const ds_math::Matrix4 &
-TransformComponentManager::GetLocalTransform(Instance i) const
+ds_math::Matrix4 TransformComponentManager::GetLocalTransform(Instance i) const
 {
-    assert(i.index >= 0 && i.index < GetNumInstances() &&
+    assert(i.index >= 0 && i.index < (int)GetNumInstances() &&
            "TransformComponentManager::GetLocalTransform tried to get invalid "
            "instance");
 
-    return m_data.component[i.index].localTransform;
+    return LocalTraits::ToMatrix4(m_data.component.localTransform[i.index]);
 }
 
 void TransformComponentManager::SetLocalTransform(
     Instance i, const ds_math::Matrix4 &matrix)
 {
-    assert(i.index >= 0 && i.index < GetNumInstances() &&
+    assert(i.index >= 0 && i.index < (int)GetNumInstances() &&
            "TransformComponentManager::SetLocalTransform tried to set invalid "
            "instance");
+    assert(ds_math::Matrix4::IsAffine(matrix) &&
+           "TransformComponentManager::SetLocalTransform tried to set "
+           "non-affine transform");
 
-    // Set local transform
-    m_data.component[i.index].localTransform = matrix;
-
-    // Get parent
-    Instance parent = m_data.component[i.index].parent;
-    // Get world transform of parent
-    ds_math::Matrix4 parentTransform =
-        parent.IsValid() ? m_data.component[parent.index].worldTransform
-                         : ds_math::Matrix4();
-
-    // Update Instance i's world transform and all it's children
-    UpdateWorldTransform(i, parentTransform);
+    // Set local transform, world transform is updated later
+    m_data.component.localTransform[i.index] =
+        LocalTraits::FromMatrix4(matrix);
+    m_data.component.dirty[i.index] |= DirtyFlag;
+    m_anyDirty = true;
 }
 
 const ds_math::Matrix4 &
 TransformComponentManager::GetWorldTransform(Instance i) const
 {
-    assert(i.index >= 0 && i.index < GetNumInstances() &&
+    assert(i.index >= 0 && i.index < (int)GetNumInstances() &&
            "TransformComponentManager::GetWorldTransform tried to get invalid "
            "instance");
 
-    return m_data.component[i.index].worldTransform;
+    return m_data.component.worldTransform[i.index];
+}
+
+ds_math::Matrix4
+TransformComponentManager::GetInterpolatedWorldTransform(
+    Instance i, float interpolation) const
+{
+    assert(i.index >= 0 && i.index < (int)GetNumInstances() &&
+           "TransformComponentManager::GetInterpolatedWorldTransform tried to "
+           "get invalid instance");
+
+    const ComponentStorage<TransformComponent> &components = m_data.component;
+
+    ds_math::Matrix4 worldTransform = components.worldTransform[i.index];
+
+    // Objects that didn't move in the last update are where they were
+    if (components.dirty[i.index] & MovedFlag)
+    {
+        worldTransform = ds_math::Matrix4::AffineInterpolate(
+            components.previousWorldTransform[i.index], worldTransform,
+            interpolation);
+    }
+
+    return worldTransform;
 }
 
 const Instance &TransformComponentManager::GetParent(Instance i) const
 {
     assert(
-        i.index >= 0 && i.index < GetNumInstances() &&
+        i.index >= 0 && i.index < (int)GetNumInstances() &&
         "TransformComponentManager::GetParent tried to get invalid instance");
 
-    return m_data.component[i.index].parent;
+    return m_data.component.parent[i.index];
 }
 
 void TransformComponentManager::SetParent(Instance i, Instance parent)
 {
     assert(
-        i.index >= 0 && i.index < GetNumInstances() &&
+        i.index >= 0 && i.index < (int)GetNumInstances() &&
         "TransformComponentManager::SetParent tried to set invalid instance");
 
-    // Set child's parent
-    m_data.component[i.index].parent = parent;
+    // Keep child where it is in the world
+    ds_math::Matrix4 worldTransform = CalculateWorldTransform(i);
 
-    // Update child's local transform -- is this correct?
-    m_data.component[i.index].localTransform =
-        m_data.component[i.index].worldTransform *
-        ds_math::Matrix4::Inverse(
-            m_data.component[parent.index].worldTransform);
+    // Remove child from it's current parent's children
+    Unlink(i);
 
-    // Set parent's child
-    // Is this first child of parent?
-    Instance firstChild = m_data.component[parent.index].firstChild;
-    if (firstChild.IsValid() == false)
+    // Set child's parent
+    m_data.component.parent[i.index] = parent;
+    m_data.component.dirty[i.index] |= DirtyFlag;
+    m_anyDirty = true;
+    m_hierarchyChanged = true;
+
+    if (parent.IsValid())
     {
-        m_data.component[parent.index].firstChild = i;
+        // Update child's local transform
+        m_data.component.localTransform[i.index] =
+            LocalTraits::FromMatrix4(ds_math::Matrix4::AffineMultiply(
+                worldTransform, ds_math::Matrix4::AffineInverse(
+                                    CalculateWorldTransform(parent))));
+
+        // Set parent's child
+        // Is this first child of parent?
+        Instance firstChild = m_data.component.firstChild[parent.index];
+        if (firstChild.IsValid() == false)
+        {
+            m_data.component.firstChild[parent.index] = i;
+        }
+        // Not the first child, therefore put in linked list of siblings
+        else
+        {
+            // Loop thru children until end of linked list
+            Instance currentChild = firstChild;
+            while (m_data.component.nextSibling[currentChild.index].IsValid())
+            {
+                currentChild = m_data.component.nextSibling[currentChild.index];
+            }
+
+            // Once at end of linked list, place child
+            m_data.component.nextSibling[currentChild.index] = i;
+            m_data.component.prevSibling[i.index] = currentChild;
+        }
     }
-    // Not the first child, therefore put in linked list of siblings
     else
     {
-        // Loop thru iren until end of linked list
-        Instance currentChild = firstChild;
-        while (m_data.component[currentChild.index].nextSibling.IsValid())
-        {
-            currentChild = m_data.component[currentChild.index].nextSibling;
-        }
-        // Once at end of linked list, place child
-        m_data.component[currentChild.index].nextSibling = i;
+        // No parent, local transform is the world transform
+        m_data.component.localTransform[i.index] =
+            LocalTraits::FromMatrix4(worldTransform);
     }
 }
 
 const Instance &TransformComponentManager::GetFirstChild(Instance i) const
 {
-    assert(i.index >= 0 && i.index < GetNumInstances() &&
+    assert(i.index >= 0 && i.index < (int)GetNumInstances() &&
            "TransformComponentManager::GetFirstChild tried to get invalid "
            "instance");
 
-    return m_data.component[i.index].firstChild;
+    return m_data.component.firstChild[i.index];
 }
 
 const Instance &TransformComponentManager::GetNextSibling(Instance i) const
 {
-    assert(i.index >= 0 && i.index < GetNumInstances() &&
+    assert(i.index >= 0 && i.index < (int)GetNumInstances() &&
            "TransformComponentManager::GetNextSibling tried to get invalid "
            "instance");
 
-    return m_data.component[i.index].nextSibling;
+    return m_data.component.nextSibling[i.index];
 }
 
 const Instance &TransformComponentManager::GetPrevSibling(Instance i) const
 {
-    assert(i.index >= 0 && i.index < GetNumInstances() &&
+    assert(i.index >= 0 && i.index < (int)GetNumInstances() &&
            "TransformComponentManager::GetPrevSibling tried to get invalid "
            "instance");
 
-    return m_data.component[i.index].prevSibling;
+    return m_data.component.prevSibling[i.index];
+}
+
+void TransformComponentManager::OnRemoveInstance(const Instance &i)
+{
+    ComponentStorage<TransformComponent> &components = m_data.component;
+
+    // Children of the removed instance become roots, keeping their place in
+    // the world. Taken before unlinking, which drops the parent's transform.
+    const ds_math::Matrix4 worldTransform = CalculateWorldTransform(i);
+
+    // Remove from parent's children
+    Unlink(i);
+
+    Instance child = components.firstChild[i.index];
+    while (child.IsValid())
+    {
+        Instance nextChild = components.nextSibling[child.index];
+
+        components.parent[child.index] = Instance::MakeInvalidInstance();
+        components.prevSibling[child.index] = Instance::MakeInvalidInstance();
+        components.nextSibling[child.index] = Instance::MakeInvalidInstance();
+        components.localTransform[child.index] =
+            LocalTraits::FromMatrix4(ds_math::Matrix4::AffineMultiply(
+                LocalTraits::ToMatrix4(components.localTransform[child.index]),
+                worldTransform));
+        components.dirty[child.index] |= DirtyFlag;
+        m_anyDirty = true;
+
+        child = nextChild;
+    }
+
+    components.firstChild[i.index] = Instance::MakeInvalidInstance();
+    m_hierarchyChanged = true;
 }
 
 void TransformComponentManager::OnAddressChange(const Instance &oldAddress,
                                                 const Instance &newAddress)
 {
-    // Loop thru all components
-    for (unsigned int i = 0; i < GetNumInstances(); ++i)
+    ComponentStorage<TransformComponent> &components = m_data.component;
+
+    const Instance &parent = components.parent[oldAddress.index];
+    const Instance &prevSibling = components.prevSibling[oldAddress.index];
+    const Instance &nextSibling = components.nextSibling[oldAddress.index];
+
+    // Only the instances linked to the moved instance reference it: it's
+    // parent (if first child), siblings and children.
+    if (prevSibling.IsValid())
+    {
+        components.nextSibling[prevSibling.index] = newAddress;
+    }
+    else if (parent.IsValid())
+    {
+        components.firstChild[parent.index] = newAddress;
+    }
+
+    if (nextSibling.IsValid())
+    {
+        components.prevSibling[nextSibling.index] = newAddress;
+    }
+
+    Instance child = components.firstChild[oldAddress.index];
+    while (child.IsValid())
+    {
+        components.parent[child.index] = newAddress;
+        child = components.nextSibling[child.index];
+    }
+
+    m_hierarchyChanged = true;
+}
+
+void TransformComponentManager::Unlink(Instance i)
+{
+    ComponentStorage<TransformComponent> &components = m_data.component;
+
+    const Instance parent = components.parent[i.index];
+    const Instance prevSibling = components.prevSibling[i.index];
+    const Instance nextSibling = components.nextSibling[i.index];
+
+    if (prevSibling.IsValid())
+    {
+        components.nextSibling[prevSibling.index] = nextSibling;
+    }
+    else if (parent.IsValid())
+    {
+        components.firstChild[parent.index] = nextSibling;
+    }
+
+    if (nextSibling.IsValid())
+    {
+        components.prevSibling[nextSibling.index] = prevSibling;
+    }
+
+    components.parent[i.index] = Instance::MakeInvalidInstance();
+    components.prevSibling[i.index] = Instance::MakeInvalidInstance();
+    components.nextSibling[i.index] = Instance::MakeInvalidInstance();
+}
+
+void TransformComponentManager::UpdateWorldTransforms()
+{
+    m_updatedInstances.clear();
+
+    if (m_anyDirty)
     {
-        // If any reference is referencing old instance address, update
-        // it to new address.
-        if (m_data.component[i].parent == oldAddress)
+        if (m_hierarchyChanged)
         {
-            m_data.component[i].parent = newAddress;
+            SortHierarchy();
         }
-        if (m_data.component[i].firstChild == oldAddress)
+
+        // Each depth only depends on the depth above it, so the objects at a
+        // given depth can be updated in any order.
+        for (size_t level = 0; level < m_levelStart.size(); ++level)
         {
-            // Case: first child of many siblings is removed
-            // (address changed to -1)
-            if (newAddress == -1)
+            const size_t begin = m_levelStart[level];
+            const size_t end = (level + 1 < m_levelStart.size())
+                                   ? m_levelStart[level + 1]
+                                   : m_hierarchyOrder.size();
+
+            if (m_threadPool != nullptr)
             {
-                // Move first child to next sibling
-                m_data.component[i].firstChild =
-                    m_data.component[oldAddress.index].nextSibling;
+                m_threadPool->ParallelFor(
+                    begin, end, MinTransformsPerTask,
+                    [this](size_t rangeBegin, size_t rangeEnd)
+                    {
+                        UpdateWorldTransformRange(rangeBegin, rangeEnd);
+                    });
             }
-            // Else just update address
             else
             {
-                m_data.component[i].firstChild = newAddress;
+                UpdateWorldTransformRange(begin, end);
             }
         }
-        if (m_data.component[i].nextSibling == oldAddress)
+
+    }
+
+    if (m_anyDirty || m_anyMoved)
+    {
+        // Record which instances were updated as the flags are cleared.
+        // Objects that moved in the update before and not in this one have
+        // stopped, so their previous world transform catches up.
+        ComponentStorage<TransformComponent> &components = m_data.component;
+        m_anyMoved = false;
+        for (unsigned int i = 0; i < GetNumInstances(); ++i)
         {
-            // Case: child of many siblings is about to be removed.
-            if (newAddress == -1)
+            if (components.dirty[i] & DirtyFlag)
             {
-                m_data.component[i].nextSibling =
-                    m_data.component[oldAddress.index].nextSibling;
+                m_updatedInstances.push_back(Instance::MakeInstance(i));
+                components.dirty[i] = MovedFlag;
+                m_anyMoved = true;
             }
-            else
+            else if (components.dirty[i] & MovedFlag)
             {
-                m_data.component[i].nextSibling = newAddress;
+                components.previousWorldTransform[i] =
+                    components.worldTransform[i];
+                components.dirty[i] = 0;
             }
         }
-        if (m_data.component[i].prevSibling == oldAddress)
+        m_anyDirty = false;
+    }
+}
+
+const std::vector<Instance> &
+TransformComponentManager::GetUpdatedInstances() const
+{
+    return m_updatedInstances;
+}
+
+void TransformComponentManager::SetThreadPool(ds_com::ThreadPool *threadPool)
+{
+    m_threadPool = threadPool;
+}
+
+void TransformComponentManager::SortHierarchy()
+{
+    const ComponentStorage<TransformComponent> &components = m_data.component;
+
+    m_hierarchyOrder.clear();
+    m_hierarchyOrder.reserve(GetNumInstances());
+    m_levelStart.clear();
+
+    // Roots first
+    m_levelStart.push_back(0);
+    for (unsigned int i = 0; i < GetNumInstances(); ++i)
+    {
+        if (!components.parent[i].IsValid())
+        {
+            m_hierarchyOrder.push_back(i);
+        }
+    }
+
+    // Then the children of each level, breadth first
+    size_t levelBegin = 0;
+    while (levelBegin < m_hierarchyOrder.size())
+    {
+        size_t levelEnd = m_hierarchyOrder.size();
+
+        for (size_t i = levelBegin; i < levelEnd; ++i)
         {
-            // Case: child of many siblings is about to be removed.
-            if (newAddress == -1)
+            Instance child = components.firstChild[m_hierarchyOrder[i]];
+            while (child.IsValid())
             {
-                m_data.component[i].prevSibling =
-                    m_data.component[oldAddress.index].prevSibling;
+                m_hierarchyOrder.push_back(child.index);
+                child = components.nextSibling[child.index];
             }
-            else
+        }
+
+        if (levelEnd < m_hierarchyOrder.size())
+        {
+            m_levelStart.push_back(levelEnd);
+        }
+        levelBegin = levelEnd;
+    }
+
+    m_hierarchyChanged = false;
+}
+
+void TransformComponentManager::UpdateWorldTransformRange(size_t begin,
+                                                          size_t end)
+{
+    ComponentStorage<TransformComponent> &components = m_data.component;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        const int index = m_hierarchyOrder[i];
+        const Instance &parent = components.parent[index];
+
+        // Children of dirty objects are dirty too
+        if (parent.IsValid())
+        {
+            components.dirty[index] |=
+                components.dirty[parent.index] & (DirtyFlag | CreatedFlag);
+        }
+
+        if (components.dirty[index] & DirtyFlag)
+        {
+            // Parent transform then local transform, local transforms are
+            // only expanded to Matrix4 here
+            ds_math::Matrix4 worldTransform =
+                LocalTraits::ToMatrix4(components.localTransform[index]);
+            if (parent.IsValid())
             {
-                m_data.component[i].prevSibling = newAddress;
+                worldTransform = ds_math::Matrix4::AffineMultiply(
+                    worldTransform, components.worldTransform[parent.index]);
             }
+
+            // New objects start where they're created rather than moving
+            // there from the origin
+            components.previousWorldTransform[index] =
+                (components.dirty[index] & CreatedFlag)
+                    ? worldTransform
+                    : components.worldTransform[index];
+            components.worldTransform[index] = worldTransform;
         }
     }
 }
 
-void TransformComponentManager::UpdateWorldTransform(
-    Instance i, const ds_math::Matrix4 &parentTransform)
+ds_math::Matrix4
+TransformComponentManager::CalculateWorldTransform(Instance i) const
 {
-    // Parent transform then local transform
-    m_data.component[i.index].worldTransform =
-        m_data.component[i.index].localTransform * parentTransform;
+    const ComponentStorage<TransformComponent> &components = m_data.component;
 
-    Instance child = m_data.component[i.index].firstChild;
-    while (child.IsValid())
+    ds_math::Matrix4 worldTransform =
+        LocalTraits::ToMatrix4(components.localTransform[i.index]);
+
+    Instance parent = components.parent[i.index];
+    while (parent.IsValid())
     {
-        UpdateWorldTransform(child, m_data.component[i.index].worldTransform);
-        child = m_data.component[child.index].nextSibling;
+        worldTransform = ds_math::Matrix4::AffineMultiply(
+            worldTransform,
+            LocalTraits::ToMatrix4(components.localTransform[parent.index]));
+        parent = components.parent[parent.index];
     }
+
+    return worldTransform;
 }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine/Config.h"
+#include "engine/common/ThreadPool.h"
 #include "engine/entity/ComponentManager.h"
 #include "engine/system/scene/TransformComponent.h"
 
@@ -13,10 +14,35 @@ namespace ds
  *  The transform component manager also forms the scenegraph of the world
  *  and so the transform component manager manages parent-child relations
  *  between objects.
+ *
+ *  World transforms are updated lazily: setting a local transform only marks
+ *  the object dirty, and UpdateWorldTransforms recalculates the world
+ *  transforms of all dirty objects and their descendants in one pass. Given a
+ *  thread pool, each depth of the hierarchy is split across it's threads.
+ *
+ *  The world transforms from before the last update are kept too, so objects
+ *  can be drawn between updates.
+ *
+ *  Local transforms are stored as LocalTransform, 3x4 affine matrices unless
+ *  compact transforms are disabled, and converted at the accessors.
  */
 class TransformComponentManager : public ComponentManager<TransformComponent>
 {
 public:
+    /**
+     * Default constructor.
+     */
+    TransformComponentManager();
+
+    /**
+     * Create a transform component for the given entity, with identity local
+     * and world transforms and no parent.
+     *
+     * @param   entity     Entity, entity to create component for.
+     * @return             Instance, the new component instance created.
+     */
+    virtual Instance CreateComponentForEntity(Entity entity);
+
     /**
      * Create a component for the given entity using a config file as a
      * description and return a component instance which can be used to refer to
@@ -41,14 +67,17 @@ public:
      *  of an object relative to it's parent.
      *
      *  @param  i   Instance, component instance to get transform matrix of.
-     *  @return     const ds_math::Matrix4 &, local transform matrix.
+     *  @return     ds_math::Matrix4, local transform matrix.
      */
-    const ds_math::Matrix4 &GetLocalTransform(Instance i) const;
+    ds_math::Matrix4 GetLocalTransform(Instance i) const;
 
     /**
-     *  Set the transform of an object relative to it's parent. This
-     *  method also updates the transforms of the object's children
-     *  (if the object has children).
+     *  Set the transform of an object relative to it's parent. The world
+     *  transforms of the object and it's children are updated by the next
+     *  call to UpdateWorldTransforms.
+     *
+     *  Transforms must be affine (i.e. built from translation, rotation and
+     *  scale), so they can be combined with the cheaper affine operations.
      *
      *  @param  i       Instance, component instance to set the transform
      *  matrix of.
@@ -57,7 +86,8 @@ public:
     void SetLocalTransform(Instance i, const ds_math::Matrix4 &matrix);
 
     /**
-     *  Get the world transform of the component instance.
+     *  Get the world transform of the component instance, as of the last call
+     *  to UpdateWorldTransforms.
      *
      *  @param  i   Instance, component instance to get the world transform
      *  of.
@@ -66,6 +96,24 @@ public:
      */
     const ds_math::Matrix4 &GetWorldTransform(Instance i) const;
 
+    /**
+     *  Get the world transform of the component instance between the last
+     *  two calls to UpdateWorldTransforms, i.e. to draw it between fixed
+     *  timestep updates.
+     *
+     *  Translation and scale are interpolated linearly and rotation with
+     *  Quaternion::Nlerp. Objects that didn't move in the last update get
+     *  their world transform.
+     *
+     *  @param  i              Instance, component instance to get the world
+     *  transform of.
+     *  @param  interpolation  float, fraction of the way from the world
+     *  transform before the last update to the current one, in [0, 1].
+     *  @return                ds_math::Matrix4, interpolated world transform.
+     */
+    ds_math::Matrix4 GetInterpolatedWorldTransform(Instance i,
+                                                   float interpolation) const;
+
     /**
      *  Get the component instance of the parent of the given component
      *  instance.
@@ -120,7 +168,42 @@ public:
      */
     const Instance &GetPrevSibling(Instance i) const;
 
+    /**
+     *  Recalculate the world transforms of all objects whose local transform
+     *  (or an ancestor's) changed since the last update.
+     *
+     *  Objects are visited parent before child, so each world transform is
+     *  calculated at most once.
+     */
+    void UpdateWorldTransforms();
+
+    /**
+     *  Get the component instances whose world transforms changed in the last
+     *  call to UpdateWorldTransforms, i.e. to update things placed in the
+     *  world by their transform.
+     *
+     *  @return     const std::vector<Instance> &, component instances updated.
+     */
+    const std::vector<Instance> &GetUpdatedInstances() const;
+
+    /**
+     *  Set the thread pool used to update world transforms in parallel. The
+     *  results are the same as updating serially.
+     *
+     *  @param  threadPool  ds_com::ThreadPool *, thread pool to use or nullptr
+     *  to update world transforms on the calling thread only.
+     */
+    void SetThreadPool(ds_com::ThreadPool *threadPool);
+
 private:
+    /**
+     *  Removes parent, child and sibling references to an object before it
+     *  is removed. Children of the object become root objects.
+     *
+     *  @param  i   const Instance &, instance about to be removed.
+     */
+    virtual void OnRemoveInstance(const Instance &i);
+
     /**
      *  Updates parent, child, sibling references before an object is
      *  moved from one place into memory to another.
@@ -132,14 +215,52 @@ private:
                                  const Instance &newAddress);
 
     /**
-     *  Update the world transform of a given component instance with the
-     *  new world transform of the given parent.
+     *  Sort the objects breadth first so that every object comes after it's
+     *  parent.
+     */
+    void SortHierarchy();
+
+    /**
+     *  Update the world transforms of a range of the sorted objects. The
+     *  world transforms of their parents must already be up to date.
+     *
+     *  @param  begin   size_t, first position in the sorted objects to update.
+     *  @param  end     size_t, position after the last object to update.
+     */
+    void UpdateWorldTransformRange(size_t begin, size_t end);
+
+    /**
+     *  Calculate the world transform of the given component instance from
+     *  the local transforms of it and it's ancestors, regardless of whether
+     *  the stored world transforms are up to date.
      *
-     *  @param  i   Instance, component instance to update world transform of.
-     *  @param  parentTransform     const ds_math::Matrix4 &, world transform
-     *  of the parent to update the child with.
+     *  @param  i   Instance, component instance to calculate world transform
+     *  of.
+     *  @return     ds_math::Matrix4, world transform of the instance.
      */
-    void UpdateWorldTransform(Instance i,
-                              const ds_math::Matrix4 &parentTransform);
+    ds_math::Matrix4 CalculateWorldTransform(Instance i) const;
+
+    /**
+     *  Remove the given component instance from it's parent's children and
+     *  from it's siblings, leaving it without a parent.
+     *
+     *  @param  i   Instance, component instance to unlink.
+     */
+    void Unlink(Instance i);
+
+    // Instance indices sorted breadth first, parent before child
+    std::vector<int> m_hierarchyOrder;
+    // Where each depth of the hierarchy starts in the sorted instances
+    std::vector<size_t> m_levelStart;
+    // Has the hierarchy changed since it was last sorted?
+    bool m_hierarchyChanged;
+    // Are any world transforms out of date?
+    bool m_anyDirty;
+    // Did any world transforms change in the last update?
+    bool m_anyMoved;
+    // Instances updated by the last UpdateWorldTransforms
+    std::vector<Instance> m_updatedInstances;
+    // Used to update each depth of the hierarchy in parallel, if set
+    ds_com::ThreadPool *m_threadPool;
 };
 }
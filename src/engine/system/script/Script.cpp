@@ -121,6 +121,19 @@ ds_msg::MessageStream Script::CollectMessages()
     return tmp;
 }
 
+bool Script::RequiresMainThread() const
+{
+    return false;
+}
+
+std::vector<ds_msg::MessageType> Script::GetMessageSubscriptions() const
+{
+    std::vector<ds_msg::MessageType> subscriptions;
+    subscriptions.push_back(ds_msg::MessageType::ScriptInterpret);
+
+    return subscriptions;
+}
+
 ScriptBindingSet Script::GetScriptBindings() const
 {
     ScriptBindingSet scriptBindings;
@@ -74,6 +74,21 @@ public:
      */
     virtual ds_msg::MessageStream CollectMessages();
 
+    /**
+     * The scripting system may be updated on a worker thread.
+     *
+     * @return  bool, FALSE.
+     */
+    virtual bool RequiresMainThread() const;
+
+    /**
+     * Return the types of messages the scripting system handles.
+     *
+     * @return  std::vector<ds_msg::MessageType>, types of messages the
+     * scripting system wants to be posted.
+     */
+    virtual std::vector<ds_msg::MessageType> GetMessageSubscriptions() const;
+
     /**
      * Return script bindings required by script system.
      *
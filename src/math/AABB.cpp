@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cmath>
+
+#include "AABB.h"
+
+namespace ds_math
+{
+AABB::AABB(const Vector3 &center, const Vector3 &extents)
+    : center(center), extents(extents)
+{
+}
+
+Vector3 AABB::GetMin() const
+{
+    return (center - extents);
+}
+
+Vector3 AABB::GetMax() const
+{
+    return (center + extents);
+}
+
+scalar AABB::GetSurfaceArea() const
+{
+    return ((scalar)8.0f * (extents.x * extents.y + extents.y * extents.z +
+                            extents.z * extents.x));
+}
+
+AABB AABB::FromMinMax(const Vector3 &min, const Vector3 &max)
+{
+    return (AABB((min + max) * (scalar)0.5f, (max - min) * (scalar)0.5f));
+}
+
+AABB AABB::FromPoints(const Vector3 *points, size_t count)
+{
+    AABB box;
+
+    if (count > 0)
+    {
+        Vector3 min = points[0];
+        Vector3 max = points[0];
+
+        for (size_t i = 1; i < count; ++i)
+        {
+            for (unsigned int axis = 0; axis < 3; ++axis)
+            {
+                if (points[i][axis] < min[axis])
+                {
+                    min[axis] = points[i][axis];
+                }
+                if (points[i][axis] > max[axis])
+                {
+                    max[axis] = points[i][axis];
+                }
+            }
+        }
+
+        box = AABB::FromMinMax(min, max);
+    }
+
+    return box;
+}
+
+AABB AABB::Transform(const AABB &box, const Matrix4 &mat)
+{
+    const Vector4 &col0 = mat.data[0];
+    const Vector4 &col1 = mat.data[1];
+    const Vector4 &col2 = mat.data[2];
+    const Vector4 &col3 = mat.data[3];
+    const Vector3 &c = box.center;
+    const Vector3 &e = box.extents;
+
+    // Each axis of the new extents is the sum of the absolute projections of
+    // the old extents onto it
+    return (AABB(Vector3(col0.x * c.x + col1.x * c.y + col2.x * c.z + col3.x,
+                         col0.y * c.x + col1.y * c.y + col2.y * c.z + col3.y,
+                         col0.z * c.x + col1.z * c.y + col2.z * c.z + col3.z),
+                 Vector3(std::fabs(col0.x) * e.x + std::fabs(col1.x) * e.y +
+                             std::fabs(col2.x) * e.z,
+                         std::fabs(col0.y) * e.x + std::fabs(col1.y) * e.y +
+                             std::fabs(col2.y) * e.z,
+                         std::fabs(col0.z) * e.x + std::fabs(col1.z) * e.y +
+                             std::fabs(col2.z) * e.z)));
+}
+
+AABB AABB::Merge(const AABB &box1, const AABB &box2)
+{
+    scalar minX = std::min(box1.center.x - box1.extents.x,
+                           box2.center.x - box2.extents.x);
+    scalar minY = std::min(box1.center.y - box1.extents.y,
+                           box2.center.y - box2.extents.y);
+    scalar minZ = std::min(box1.center.z - box1.extents.z,
+                           box2.center.z - box2.extents.z);
+    scalar maxX = std::max(box1.center.x + box1.extents.x,
+                           box2.center.x + box2.extents.x);
+    scalar maxY = std::max(box1.center.y + box1.extents.y,
+                           box2.center.y + box2.extents.y);
+    scalar maxZ = std::max(box1.center.z + box1.extents.z,
+                           box2.center.z + box2.extents.z);
+
+    return AABB(Vector3((minX + maxX) * (scalar)0.5f,
+                        (minY + maxY) * (scalar)0.5f,
+                        (minZ + maxZ) * (scalar)0.5f),
+                Vector3((maxX - minX) * (scalar)0.5f,
+                        (maxY - minY) * (scalar)0.5f,
+                        (maxZ - minZ) * (scalar)0.5f));
+}
+
+bool AABB::Intersects(const AABB &box1, const AABB &box2)
+{
+    return (std::fabs(box1.center.x - box2.center.x) <=
+                box1.extents.x + box2.extents.x &&
+            std::fabs(box1.center.y - box2.center.y) <=
+                box1.extents.y + box2.extents.y &&
+            std::fabs(box1.center.z - box2.center.z) <=
+                box1.extents.z + box2.extents.z);
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Matrix4.h"
+#include "Vector3.h"
+
+namespace ds_math
+{
+/**
+ * Axis-aligned bounding box, stored as a center and the (half) extents along
+ * each axis.
+ */
+class AABB
+{
+public:
+    /**
+     * Construct a box from a center and extents.
+     *
+     * @param  center   const Vector3 &, center of the box.
+     * @param  extents  const Vector3 &, distance from the center to the faces
+     * of the box along each axis.
+     */
+    AABB(const Vector3 &center = Vector3(),
+         const Vector3 &extents = Vector3());
+
+    /**
+     * Get the corner of the box with the smallest coordinates.
+     *
+     * @return  Vector3, minimum corner of the box.
+     */
+    Vector3 GetMin() const;
+    /**
+     * Get the corner of the box with the largest coordinates.
+     *
+     * @return  Vector3, maximum corner of the box.
+     */
+    Vector3 GetMax() const;
+    /**
+     * Get the surface area of the box.
+     *
+     * @return  scalar, surface area of the box.
+     */
+    scalar GetSurfaceArea() const;
+
+    /**
+     * Create a box from its minimum and maximum corners.
+     *
+     * @param   min  const Vector3 &, minimum corner of the box.
+     * @param   max  const Vector3 &, maximum corner of the box.
+     * @return       AABB, box with the given corners.
+     */
+    static AABB FromMinMax(const Vector3 &min, const Vector3 &max);
+    /**
+     * Create the smallest box that contains all the given points.
+     *
+     * @param   points  const Vector3 *, points to contain.
+     * @param   count   size_t, number of points.
+     * @return          AABB, box containing the points, or an empty box at
+     * the origin if there are no points.
+     */
+    static AABB FromPoints(const Vector3 *points, size_t count);
+    /**
+     * Create a box that contains the given box after it has been transformed
+     * by an affine matrix.
+     *
+     * The result is the smallest axis-aligned box containing the transformed
+     * box, so it may be larger than the original under rotation.
+     *
+     * @param   box  const AABB &, box to transform.
+     * @param   mat  const Matrix4 &, affine transform.
+     * @return       AABB, box containing the transformed box.
+     */
+    static AABB Transform(const AABB &box, const Matrix4 &mat);
+    /**
+     * Create the smallest box that contains both given boxes.
+     *
+     * @param   box1  const AABB &, box to contain.
+     * @param   box2  const AABB &, box to contain.
+     * @return        AABB, box containing both boxes.
+     */
+    static AABB Merge(const AABB &box1, const AABB &box2);
+    /**
+     * Test whether two boxes overlap. Boxes that only touch overlap.
+     *
+     * @param   box1  const AABB &, box to test.
+     * @param   box2  const AABB &, box to test.
+     * @return        bool, TRUE if the boxes overlap, FALSE otherwise.
+     */
+    static bool Intersects(const AABB &box1, const AABB &box2);
+
+    Vector3 center, extents;
+};
+}
@@ -0,0 +1,426 @@
+#include "Batch.h"
+#include "Simd.h"
+
+namespace ds_math
+{
+#ifdef DS_MATH_SSE
+static_assert(sizeof(Vector3) == 3 * sizeof(float),
+              "Vector3 must be exactly three packed scalars.");
+static_assert(sizeof(Quaternion) == 4 * sizeof(float),
+              "Quaternion must be exactly four packed scalars.");
+
+/**
+ * Load four consecutive Vector3s and transpose them into registers of x, y
+ * and z components.
+ */
+static inline void LoadVector3x4(const Vector3 *points,
+                                 __m128 *xs,
+                                 __m128 *ys,
+                                 __m128 *zs)
+{
+    // (x0, y0, z0, x1), (y1, z1, x2, y2), (z2, x3, y3, z3)
+    const float *data = &points[0].x;
+    __m128 a = _mm_loadu_ps(data);
+    __m128 b = _mm_loadu_ps(data + 4);
+    __m128 c = _mm_loadu_ps(data + 8);
+
+    __m128 b2c1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+    *xs = _mm_shuffle_ps(a, b2c1, _MM_SHUFFLE(2, 0, 3, 0));
+
+    __m128 a1b0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+    __m128 b3c2 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+    *ys = _mm_shuffle_ps(a1b0, b3c2, _MM_SHUFFLE(2, 0, 2, 0));
+
+    __m128 a2b1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+    *zs = _mm_shuffle_ps(a2b1, c, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+/**
+ * Transpose registers of x, y and z components back into four consecutive
+ * Vector3s.
+ */
+static inline void
+StoreVector3x4(__m128 xs, __m128 ys, __m128 zs, Vector3 *points)
+{
+    __m128 xyLow = _mm_unpacklo_ps(xs, ys);  // (x0, y0, x1, y1)
+    __m128 xyHigh = _mm_unpackhi_ps(xs, ys); // (x2, y2, x3, y3)
+
+    __m128 z0x1 = _mm_shuffle_ps(zs, xs, _MM_SHUFFLE(1, 1, 0, 0));
+    __m128 a = _mm_shuffle_ps(xyLow, z0x1, _MM_SHUFFLE(2, 0, 1, 0));
+
+    __m128 y1z1 = _mm_shuffle_ps(ys, zs, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 b = _mm_shuffle_ps(y1z1, xyHigh, _MM_SHUFFLE(1, 0, 2, 0));
+
+    __m128 z2x3 = _mm_shuffle_ps(zs, xyHigh, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 y3z3 = _mm_shuffle_ps(xyHigh, zs, _MM_SHUFFLE(3, 3, 3, 3));
+    __m128 c = _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0));
+
+    float *data = &points[0].x;
+    _mm_storeu_ps(data, a);
+    _mm_storeu_ps(data + 4, b);
+    _mm_storeu_ps(data + 8, c);
+}
+
+/**
+ * Load four consecutive Quaternions and transpose them into registers of x,
+ * y, z and w components.
+ */
+static inline void LoadQuaternionx4(const Quaternion *quaternions,
+                                    __m128 *xs,
+                                    __m128 *ys,
+                                    __m128 *zs,
+                                    __m128 *ws)
+{
+    *xs = _mm_loadu_ps(&quaternions[0].x);
+    *ys = _mm_loadu_ps(&quaternions[1].x);
+    *zs = _mm_loadu_ps(&quaternions[2].x);
+    *ws = _mm_loadu_ps(&quaternions[3].x);
+    _MM_TRANSPOSE4_PS(*xs, *ys, *zs, *ws);
+}
+
+/**
+ * Transpose registers of x, y, z and w components back into four consecutive
+ * Quaternions.
+ */
+static inline void StoreQuaternionx4(
+    __m128 xs, __m128 ys, __m128 zs, __m128 ws, Quaternion *quaternions)
+{
+    _MM_TRANSPOSE4_PS(xs, ys, zs, ws);
+    _mm_storeu_ps(&quaternions[0].x, xs);
+    _mm_storeu_ps(&quaternions[1].x, ys);
+    _mm_storeu_ps(&quaternions[2].x, zs);
+    _mm_storeu_ps(&quaternions[3].x, ws);
+}
+
+/**
+ * Scale registers of quaternion components to unit magnitude, with the same
+ * order of operations as Quaternion::Normalize.
+ */
+static inline void NormalizeQuaternionx4(__m128 *xs,
+                                         __m128 *ys,
+                                         __m128 *zs,
+                                         __m128 *ws,
+                                         NormalizePrecision precision)
+{
+    __m128 magSquared = _mm_add_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(*xs, *xs), _mm_mul_ps(*ys, *ys)),
+                   _mm_mul_ps(*zs, *zs)),
+        _mm_mul_ps(*ws, *ws));
+
+    __m128 inverseMag;
+    if (precision == NormalizePrecision::Fast)
+    {
+        inverseMag = ReciprocalSqrt(magSquared);
+    }
+    else
+    {
+        inverseMag = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(magSquared));
+    }
+
+    *xs = _mm_mul_ps(*xs, inverseMag);
+    *ys = _mm_mul_ps(*ys, inverseMag);
+    *zs = _mm_mul_ps(*zs, inverseMag);
+    *ws = _mm_mul_ps(*ws, inverseMag);
+}
+#endif
+
+void Batch::Multiply(const Matrix4 *m1,
+                     const Matrix4 *m2,
+                     Matrix4 *result,
+                     size_t count)
+{
+#ifdef DS_MATH_SSE
+    for (size_t i = 0; i < count; ++i)
+    {
+        __m128 columns[4];
+        LoadMatrix4(m1[i], columns);
+
+        __m128 products[4];
+        for (unsigned int col = 0; col < 4; ++col)
+        {
+            products[col] =
+                MultiplyColumn(columns, LoadVector4(m2[i].data[col]));
+        }
+
+        for (unsigned int col = 0; col < 4; ++col)
+        {
+            _mm_storeu_ps(&result[i].data[col].x, products[col]);
+        }
+    }
+#else
+    for (size_t i = 0; i < count; ++i)
+    {
+        result[i] = m1[i] * m2[i];
+    }
+#endif
+}
+
+void Batch::AffineMultiply(const Matrix4 *m1,
+                           const Matrix4 *m2,
+                           Matrix4 *result,
+                           size_t count)
+{
+#ifdef DS_MATH_SSE
+    for (size_t i = 0; i < count; ++i)
+    {
+        __m128 columns[4];
+        LoadMatrix4(m1[i], columns);
+
+        __m128 products[4];
+        for (unsigned int col = 0; col < 4; ++col)
+        {
+            __m128 c = LoadVector4(m2[i].data[col]);
+
+            // Last rows are known, so the last column of m1 only adds to the
+            // translation
+            __m128 product = _mm_mul_ps(columns[0], Splat<0>(c));
+            product = _mm_add_ps(product, _mm_mul_ps(columns[1], Splat<1>(c)));
+            product = _mm_add_ps(product, _mm_mul_ps(columns[2], Splat<2>(c)));
+            products[col] = product;
+        }
+        products[3] = _mm_add_ps(products[3], columns[3]);
+
+        for (unsigned int col = 0; col < 4; ++col)
+        {
+            _mm_storeu_ps(&result[i].data[col].x, products[col]);
+        }
+    }
+#else
+    for (size_t i = 0; i < count; ++i)
+    {
+        result[i] = Matrix4::AffineMultiply(m1[i], m2[i]);
+    }
+#endif
+}
+
+void Batch::TransformPoints(const Matrix4 &mat,
+                            const Vector3 *points,
+                            Vector3 *result,
+                            size_t count)
+{
+    size_t i = 0;
+
+#ifdef DS_MATH_SSE
+    // Four points at a time, with each register holding one component of all
+    // four points
+    __m128 columns[4];
+    LoadMatrix4(mat, columns);
+
+    const __m128 m00 = Splat<0>(columns[0]);
+    const __m128 m01 = Splat<1>(columns[0]);
+    const __m128 m02 = Splat<2>(columns[0]);
+    const __m128 m10 = Splat<0>(columns[1]);
+    const __m128 m11 = Splat<1>(columns[1]);
+    const __m128 m12 = Splat<2>(columns[1]);
+    const __m128 m20 = Splat<0>(columns[2]);
+    const __m128 m21 = Splat<1>(columns[2]);
+    const __m128 m22 = Splat<2>(columns[2]);
+    const __m128 m30 = Splat<0>(columns[3]);
+    const __m128 m31 = Splat<1>(columns[3]);
+    const __m128 m32 = Splat<2>(columns[3]);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 xs, ys, zs;
+        LoadVector3x4(points + i, &xs, &ys, &zs);
+
+        __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, xs),
+                                                     _mm_mul_ps(m10, ys)),
+                                          _mm_mul_ps(m20, zs)),
+                               m30);
+        __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, xs),
+                                                     _mm_mul_ps(m11, ys)),
+                                          _mm_mul_ps(m21, zs)),
+                               m31);
+        __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, xs),
+                                                     _mm_mul_ps(m12, ys)),
+                                          _mm_mul_ps(m22, zs)),
+                               m32);
+
+        StoreVector3x4(rx, ry, rz, result + i);
+    }
+#endif
+
+    // Remaining points
+    for (; i < count; ++i)
+    {
+        Vector4 transformed = mat * Vector4(points[i], 1.0f);
+        result[i] = Vector3(transformed.x, transformed.y, transformed.z);
+    }
+}
+
+void Batch::TransformVectors(const Matrix4 &mat,
+                             const Vector4 *vectors,
+                             Vector4 *result,
+                             size_t count)
+{
+#ifdef DS_MATH_SSE
+    __m128 columns[4];
+    LoadMatrix4(mat, columns);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        _mm_storeu_ps(&result[i].x,
+                      MultiplyColumn(columns, LoadVector4(vectors[i])));
+    }
+#else
+    for (size_t i = 0; i < count; ++i)
+    {
+        result[i] = mat * vectors[i];
+    }
+#endif
+}
+
+void Batch::CreateFromQuaternions(const Quaternion *quaternions,
+                                  Matrix4 *result,
+                                  size_t count)
+{
+    size_t i = 0;
+
+#ifdef DS_MATH_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    // Four quaternions at a time, with each register holding one component
+    // of all four quaternions
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y, z, w;
+        LoadQuaternionx4(quaternions + i, &x, &y, &z, &w);
+
+        // Same order of operations as Matrix4::CreateFromQuaternion
+        __m128 x2 = _mm_mul_ps(two, x);
+        __m128 y2 = _mm_mul_ps(two, y);
+        __m128 w2 = _mm_mul_ps(two, w);
+
+        __m128 xx = _mm_mul_ps(x2, x);
+        __m128 yy = _mm_mul_ps(y2, y);
+        __m128 zz = _mm_mul_ps(_mm_mul_ps(two, z), z);
+        __m128 xy = _mm_mul_ps(x2, y);
+        __m128 xz = _mm_mul_ps(x2, z);
+        __m128 yz = _mm_mul_ps(y2, z);
+        __m128 wx = _mm_mul_ps(w2, x);
+        __m128 wy = _mm_mul_ps(w2, y);
+        __m128 wz = _mm_mul_ps(w2, z);
+
+        __m128 columns[3][4] = {
+            {_mm_sub_ps(_mm_sub_ps(one, yy), zz), _mm_add_ps(xy, wz),
+             _mm_sub_ps(xz, wy), zero},
+            {_mm_sub_ps(xy, wz), _mm_sub_ps(_mm_sub_ps(one, xx), zz),
+             _mm_add_ps(yz, wx), zero},
+            {_mm_add_ps(xz, wy), _mm_sub_ps(yz, wx),
+             _mm_sub_ps(_mm_sub_ps(one, xx), yy), zero}};
+
+        // Transpose each column back to one per matrix
+        for (unsigned int col = 0; col < 3; ++col)
+        {
+            _MM_TRANSPOSE4_PS(columns[col][0], columns[col][1],
+                              columns[col][2], columns[col][3]);
+
+            for (unsigned int j = 0; j < 4; ++j)
+            {
+                _mm_storeu_ps(&result[i + j].data[col].x, columns[col][j]);
+            }
+        }
+
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            _mm_storeu_ps(&result[i + j].data[3].x,
+                          _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f));
+        }
+    }
+#endif
+
+    // Remaining quaternions
+    for (; i < count; ++i)
+    {
+        result[i] = Matrix4::CreateFromQuaternion(quaternions[i]);
+    }
+}
+
+void Batch::Normalize(const Quaternion *quaternions,
+                      Quaternion *result,
+                      size_t count,
+                      NormalizePrecision precision)
+{
+    size_t i = 0;
+
+#ifdef DS_MATH_SSE
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y, z, w;
+        LoadQuaternionx4(quaternions + i, &x, &y, &z, &w);
+        NormalizeQuaternionx4(&x, &y, &z, &w, precision);
+        StoreQuaternionx4(x, y, z, w, result + i);
+    }
+#endif
+
+    // Remaining quaternions
+    for (; i < count; ++i)
+    {
+        result[i] = Quaternion::Normalize(quaternions[i], precision);
+    }
+}
+
+void Batch::Nlerp(const Quaternion *q1,
+                  const Quaternion *q2,
+                  scalar t,
+                  Quaternion *result,
+                  size_t count,
+                  NormalizePrecision precision)
+{
+    size_t i = 0;
+
+#ifdef DS_MATH_SSE
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 t1 = _mm_set1_ps((scalar)1.0f - t);
+    const __m128 t2 = _mm_set1_ps(t);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x1, y1, z1, w1;
+        LoadQuaternionx4(q1 + i, &x1, &y1, &z1, &w1);
+        __m128 x2, y2, z2, w2;
+        LoadQuaternionx4(q2 + i, &x2, &y2, &z2, &w2);
+
+        __m128 dot = _mm_add_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(x1, x2), _mm_mul_ps(y1, y2)),
+                       _mm_mul_ps(z1, z2)),
+            _mm_mul_ps(w1, w2));
+
+        // Negate t for the pairs more than a half turn apart, to take the
+        // shortest path
+        __m128 negate = _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()),
+                                   signMask);
+        __m128 signedT2 = _mm_xor_ps(t2, negate);
+
+        __m128 x = _mm_add_ps(_mm_mul_ps(x1, t1), _mm_mul_ps(x2, signedT2));
+        __m128 y = _mm_add_ps(_mm_mul_ps(y1, t1), _mm_mul_ps(y2, signedT2));
+        __m128 z = _mm_add_ps(_mm_mul_ps(z1, t1), _mm_mul_ps(z2, signedT2));
+        __m128 w = _mm_add_ps(_mm_mul_ps(w1, t1), _mm_mul_ps(w2, signedT2));
+
+        NormalizeQuaternionx4(&x, &y, &z, &w, precision);
+        StoreQuaternionx4(x, y, z, w, result + i);
+    }
+#endif
+
+    // Remaining pairs
+    for (; i < count; ++i)
+    {
+        result[i] = Quaternion::Nlerp(q1[i], q2[i], t, precision);
+    }
+}
+
+void Batch::Slerp(const Quaternion *q1,
+                  const Quaternion *q2,
+                  scalar t,
+                  Quaternion *result,
+                  size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        result[i] = Quaternion::Slerp(q1[i], q2[i], t);
+    }
+}
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Matrix4.h"
+#include "Quaternion.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+namespace ds_math
+{
+/**
+ * Math operations on contiguous arrays of elements.
+ *
+ * Each operation gives the same result as applying the single element
+ * operation to every element, but processes several elements per instruction
+ * where SIMD kernels are available (see Simd.h).
+ *
+ * Elements are independent, so large arrays can be split into ranges and
+ * processed on several threads (i.e. with ds_com::ThreadPool::ParallelFor).
+ * Outputs may be the same array as an input, but must not otherwise overlap
+ * them.
+ */
+class Batch
+{
+public:
+    /**
+     * Multiply pairs of matrices, result[i] = m1[i] * m2[i].
+     *
+     * @param  m1      const Matrix4 *, first matrix of each pair.
+     * @param  m2      const Matrix4 *, second matrix of each pair.
+     * @param  result  Matrix4 *, where the products should be stored.
+     * @param  count   size_t, number of pairs.
+     */
+    static void Multiply(const Matrix4 *m1,
+                         const Matrix4 *m2,
+                         Matrix4 *result,
+                         size_t count);
+
+    /**
+     * Multiply pairs of affine matrices, result[i] =
+     * Matrix4::AffineMultiply(m1[i], m2[i]).
+     *
+     * @param  m1      const Matrix4 *, first affine matrix of each pair.
+     * @param  m2      const Matrix4 *, second affine matrix of each pair.
+     * @param  result  Matrix4 *, where the products should be stored.
+     * @param  count   size_t, number of pairs.
+     */
+    static void AffineMultiply(const Matrix4 *m1,
+                               const Matrix4 *m2,
+                               Matrix4 *result,
+                               size_t count);
+
+    /**
+     * Transform points by a matrix, result[i] = mat * (points[i], 1).
+     *
+     * @param  mat     const Matrix4 &, matrix to transform the points by.
+     * @param  points  const Vector3 *, points to transform.
+     * @param  result  Vector3 *, where the transformed points should be
+     * stored (the w component of the product is discarded).
+     * @param  count   size_t, number of points.
+     */
+    static void TransformPoints(const Matrix4 &mat,
+                                const Vector3 *points,
+                                Vector3 *result,
+                                size_t count);
+
+    /**
+     * Transform vectors by a matrix, result[i] = mat * vectors[i].
+     *
+     * @param  mat      const Matrix4 &, matrix to transform the vectors by.
+     * @param  vectors  const Vector4 *, vectors to transform.
+     * @param  result   Vector4 *, where the transformed vectors should be
+     * stored.
+     * @param  count    size_t, number of vectors.
+     */
+    static void TransformVectors(const Matrix4 &mat,
+                                 const Vector4 *vectors,
+                                 Vector4 *result,
+                                 size_t count);
+
+    /**
+     * Convert unit quaternions to rotation matrices, result[i] =
+     * Matrix4::CreateFromQuaternion(quaternions[i]).
+     *
+     * @param  quaternions  const Quaternion *, quaternions to convert.
+     * @param  result       Matrix4 *, where the matrices should be stored.
+     * @param  count        size_t, number of quaternions.
+     */
+    static void CreateFromQuaternions(const Quaternion *quaternions,
+                                      Matrix4 *result,
+                                      size_t count);
+
+    /**
+     * Normalize quaternions, result[i] =
+     * Quaternion::Normalize(quaternions[i], precision).
+     *
+     * @pre  Magnitude of each quaternion is not 0.
+     *
+     * @param  quaternions  const Quaternion *, quaternions to normalize.
+     * @param  result       Quaternion *, where the normalized quaternions
+     * should be stored.
+     * @param  count        size_t, number of quaternions.
+     * @param  precision    NormalizePrecision, how accurately to normalize.
+     */
+    static void
+    Normalize(const Quaternion *quaternions,
+              Quaternion *result,
+              size_t count,
+              NormalizePrecision precision = NormalizePrecision::Exact);
+
+    /**
+     * Interpolate linearly between pairs of unit quaternions, result[i] =
+     * Quaternion::Nlerp(q1[i], q2[i], t, precision).
+     *
+     * @param  q1         const Quaternion *, orientations at t = 0.
+     * @param  q2         const Quaternion *, orientations at t = 1.
+     * @param  t          scalar, interpolation factor in [0, 1].
+     * @param  result     Quaternion *, where the interpolated quaternions
+     * should be stored.
+     * @param  count      size_t, number of pairs.
+     * @param  precision  NormalizePrecision, how accurately to normalize.
+     */
+    static void Nlerp(const Quaternion *q1,
+                      const Quaternion *q2,
+                      scalar t,
+                      Quaternion *result,
+                      size_t count,
+                      NormalizePrecision precision = NormalizePrecision::Exact);
+
+    /**
+     * Interpolate spherically between pairs of unit quaternions, result[i] =
+     * Quaternion::Slerp(q1[i], q2[i], t).
+     *
+     * Most of the cost is in the trigonometric functions, so prefer Nlerp
+     * where constant angular velocity isn't needed.
+     *
+     * @param  q1      const Quaternion *, orientations at t = 0.
+     * @param  q2      const Quaternion *, orientations at t = 1.
+     * @param  t       scalar, interpolation factor in [0, 1].
+     * @param  result  Quaternion *, where the interpolated quaternions should
+     * be stored.
+     * @param  count   size_t, number of pairs.
+     */
+    static void Slerp(const Quaternion *q1,
+                      const Quaternion *q2,
+                      scalar t,
+                      Quaternion *result,
+                      size_t count);
+};
+}
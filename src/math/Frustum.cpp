@@ -0,0 +1,186 @@
+#include <cmath>
+
+#include "Frustum.h"
+
+namespace ds_math
+{
+Frustum::Frustum() : Frustum(Matrix4(1.0f))
+{
+}
+
+Frustum::Frustum(const Matrix4 &viewProjection)
+{
+    // Rows of the matrix, a point p is inside if -w <= x, y, z <= w in clip
+    // space, i.e. (row3 +/- rowN) . p >= 0 (Gribb & Hartmann)
+    Vector4 rows[4];
+    for (unsigned int row = 0; row < 4; ++row)
+    {
+        rows[row] = Vector4(viewProjection.data[0][row],
+                            viewProjection.data[1][row],
+                            viewProjection.data[2][row],
+                            viewProjection.data[3][row]);
+    }
+
+    Vector4 planes[NumPlanes] = {rows[3] + rows[0], rows[3] - rows[0],
+                                 rows[3] + rows[1], rows[3] - rows[1],
+                                 rows[3] + rows[2], rows[3] - rows[2]};
+
+    for (unsigned int i = 0; i < NumPaddedPlanes; ++i)
+    {
+        const Vector4 &plane = planes[(i < NumPlanes) ? i : i - 4];
+
+        // Normalize so distances to the plane are in world units
+        scalar inverseLength =
+            (scalar)1.0f / std::sqrt(plane.x * plane.x + plane.y * plane.y +
+                                     plane.z * plane.z);
+
+        m_normalX[i] = plane.x * inverseLength;
+        m_normalY[i] = plane.y * inverseLength;
+        m_normalZ[i] = plane.z * inverseLength;
+        m_distance[i] = plane.w * inverseLength;
+    }
+}
+
+Vector4 Frustum::GetPlane(Frustum::Plane plane) const
+{
+    return (Vector4(m_normalX[plane], m_normalY[plane], m_normalZ[plane],
+                    m_distance[plane]));
+}
+
+bool Frustum::Intersects(const AABB &box) const
+{
+#ifdef DS_MATH_SSE
+    return IntersectsSplatBox(
+        _mm_set1_ps(box.center.x), _mm_set1_ps(box.center.y),
+        _mm_set1_ps(box.center.z), _mm_set1_ps(box.extents.x),
+        _mm_set1_ps(box.extents.y), _mm_set1_ps(box.extents.z));
+#else
+    // The box is outside if it is entirely behind any plane: the distance of
+    // its center from the plane is less than -(projection of the extents
+    // onto the plane normal).
+    bool intersects = true;
+
+    for (unsigned int i = 0; i < NumPlanes && intersects; ++i)
+    {
+        scalar distance = m_normalX[i] * box.center.x +
+                          m_normalY[i] * box.center.y +
+                          m_normalZ[i] * box.center.z + m_distance[i];
+        scalar radius = std::fabs(m_normalX[i]) * box.extents.x +
+                        std::fabs(m_normalY[i]) * box.extents.y +
+                        std::fabs(m_normalZ[i]) * box.extents.z;
+
+        intersects = (distance + radius >= 0.0f);
+    }
+
+    return intersects;
+#endif
+}
+
+bool Frustum::Intersects(const AABB &box, const Matrix4 &transform) const
+{
+#ifdef DS_MATH_SSE
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    __m128 columns[4];
+    LoadMatrix4(transform, columns);
+
+    // Same as AABB::Transform, but kept in registers
+    __m128 centerX = _mm_set1_ps(box.center.x);
+    __m128 centerY = _mm_set1_ps(box.center.y);
+    __m128 centerZ = _mm_set1_ps(box.center.z);
+    __m128 center = _mm_add_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(columns[0], centerX),
+                              _mm_mul_ps(columns[1], centerY)),
+                   _mm_mul_ps(columns[2], centerZ)),
+        columns[3]);
+
+    __m128 extentsX = _mm_set1_ps(box.extents.x);
+    __m128 extentsY = _mm_set1_ps(box.extents.y);
+    __m128 extentsZ = _mm_set1_ps(box.extents.z);
+    __m128 extents = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, columns[0]), extentsX),
+                   _mm_mul_ps(_mm_andnot_ps(signMask, columns[1]), extentsY)),
+        _mm_mul_ps(_mm_andnot_ps(signMask, columns[2]), extentsZ));
+
+    return IntersectsSplatBox(Splat<0>(center), Splat<1>(center),
+                              Splat<2>(center), Splat<0>(extents),
+                              Splat<1>(extents), Splat<2>(extents));
+#else
+    return Intersects(AABB::Transform(box, transform));
+#endif
+}
+
+bool Frustum::Intersects(const Vector3 &center, scalar radius) const
+{
+    bool intersects = true;
+
+    for (unsigned int i = 0; i < NumPlanes && intersects; ++i)
+    {
+        scalar distance = m_normalX[i] * center.x + m_normalY[i] * center.y +
+                          m_normalZ[i] * center.z + m_distance[i];
+
+        intersects = (distance + radius >= 0.0f);
+    }
+
+    return intersects;
+}
+
+bool Frustum::Contains(const AABB &box) const
+{
+    // The box is inside if it is entirely in front of every plane
+    bool contains = true;
+
+    for (unsigned int i = 0; i < NumPlanes && contains; ++i)
+    {
+        scalar distance = m_normalX[i] * box.center.x +
+                          m_normalY[i] * box.center.y +
+                          m_normalZ[i] * box.center.z + m_distance[i];
+        scalar radius = std::fabs(m_normalX[i]) * box.extents.x +
+                        std::fabs(m_normalY[i]) * box.extents.y +
+                        std::fabs(m_normalZ[i]) * box.extents.z;
+
+        contains = (distance - radius >= 0.0f);
+    }
+
+    return contains;
+}
+
+#ifdef DS_MATH_SSE
+bool Frustum::IntersectsSplatBox(__m128 centerX,
+                                 __m128 centerY,
+                                 __m128 centerZ,
+                                 __m128 extentsX,
+                                 __m128 extentsY,
+                                 __m128 extentsZ) const
+{
+    // The box is outside if it is entirely behind any plane: the distance of
+    // its center from the plane is less than -(projection of the extents
+    // onto the plane normal). Four planes are tested at once.
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    __m128 outside = _mm_setzero_ps();
+    for (unsigned int i = 0; i < NumPaddedPlanes; i += 4)
+    {
+        __m128 normalX = _mm_loadu_ps(&m_normalX[i]);
+        __m128 normalY = _mm_loadu_ps(&m_normalY[i]);
+        __m128 normalZ = _mm_loadu_ps(&m_normalZ[i]);
+
+        __m128 distance = _mm_add_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX, centerX),
+                                  _mm_mul_ps(normalY, centerY)),
+                       _mm_mul_ps(normalZ, centerZ)),
+            _mm_loadu_ps(&m_distance[i]));
+        __m128 radius = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, normalX), extentsX),
+                       _mm_mul_ps(_mm_andnot_ps(signMask, normalY), extentsY)),
+            _mm_mul_ps(_mm_andnot_ps(signMask, normalZ), extentsZ));
+
+        outside = _mm_or_ps(
+            outside,
+            _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+    }
+
+    return (_mm_movemask_ps(outside) == 0);
+}
+#endif
+}
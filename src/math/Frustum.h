@@ -0,0 +1,122 @@
+#pragma once
+
+#include "AABB.h"
+#include "Matrix4.h"
+#include "Simd.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+namespace ds_math
+{
+/**
+ * View frustum, the six planes bounding the volume visible through a camera.
+ *
+ * Used to cull objects that can't be seen. Tests are conservative: anything
+ * intersecting the frustum is reported as visible, but a few objects just
+ * outside a corner of the frustum may be too.
+ */
+class Frustum
+{
+public:
+    /**
+     * Plane indices.
+     */
+    enum Plane
+    {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        NumPlanes
+    };
+
+    /**
+     * Construct a frustum from the identity view-projection, the clip space
+     * cube.
+     */
+    Frustum();
+    /**
+     * Construct the frustum of a view-projection matrix.
+     *
+     * @param  viewProjection  const Matrix4 &, matrix transforming world
+     * space to clip space (projection * view, for column vectors).
+     */
+    explicit Frustum(const Matrix4 &viewProjection);
+
+    /**
+     * Get one of the planes of the frustum.
+     *
+     * @param   plane  Plane, plane to get.
+     * @return         Vector4, unit normal pointing into the frustum (x, y,
+     * z) and distance from the origin (w).
+     */
+    Vector4 GetPlane(Plane plane) const;
+
+    /**
+     * Test whether a box intersects the frustum.
+     *
+     * @param   box  const AABB &, box to test.
+     * @return       bool, TRUE if the box is inside or intersects the
+     * frustum, FALSE if it is outside.
+     */
+    bool Intersects(const AABB &box) const;
+    /**
+     * Test whether a box intersects the frustum after it has been
+     * transformed by an affine matrix.
+     *
+     * Same as Intersects(AABB::Transform(box, transform)), without
+     * constructing the transformed box.
+     *
+     * @param   box        const AABB &, box to test, i.e. in model space.
+     * @param   transform  const Matrix4 &, affine transform to apply to the
+     * box, i.e. model to world space.
+     * @return             bool, TRUE if the transformed box is inside or
+     * intersects the frustum, FALSE if it is outside.
+     */
+    bool Intersects(const AABB &box, const Matrix4 &transform) const;
+    /**
+     * Test whether a sphere intersects the frustum.
+     *
+     * @param   center  const Vector3 &, center of the sphere.
+     * @param   radius  scalar, radius of the sphere.
+     * @return          bool, TRUE if the sphere is inside or intersects the
+     * frustum, FALSE if it is outside.
+     */
+    bool Intersects(const Vector3 &center, scalar radius) const;
+    /**
+     * Test whether a box is entirely inside the frustum.
+     *
+     * @param   box  const AABB &, box to test.
+     * @return       bool, TRUE if no part of the box is outside the frustum,
+     * FALSE otherwise.
+     */
+    bool Contains(const AABB &box) const;
+
+private:
+    // Planes padded to a multiple of the SIMD width, the extra planes repeat
+    // the near and far planes
+    static const unsigned int NumPaddedPlanes = 8;
+
+    // Plane components in structure of arrays order, so four planes can be
+    // tested at once
+    scalar m_normalX[NumPaddedPlanes];
+    scalar m_normalY[NumPaddedPlanes];
+    scalar m_normalZ[NumPaddedPlanes];
+    scalar m_distance[NumPaddedPlanes];
+
+#ifdef DS_MATH_SSE
+    /**
+     * Test a box, with each component of its center and extents broadcast to
+     * a register, against all planes.
+     */
+    bool IntersectsSplatBox(__m128 centerX,
+                            __m128 centerY,
+                            __m128 centerZ,
+                            __m128 extentsX,
+                            __m128 extentsY,
+                            __m128 extentsZ) const;
+#endif
+};
+}
@@ -3,9 +3,50 @@
 
 #include "MathHelper.h"
 #include "Matrix4.h"
+#include "Simd.h"
 
 namespace ds_math
 {
+#ifdef DS_MATH_SSE
+/**
+ * Calculate a pair of 2x2 sub-factors of a matrix (column, row) for each
+ * element, as used by the inverse:
+ *  (col2[B] * col3[A] - col3[B] * col2[A],
+ *   col2[B] * col3[A] - col3[B] * col2[A],
+ *   col1[B] * col3[A] - col3[B] * col1[A],
+ *   col1[B] * col2[A] - col2[B] * col1[A])
+ */
+template <int A, int B>
+static inline __m128 InverseSubFactors(const __m128 columns[4])
+{
+    __m128 swapA =
+        _mm_shuffle_ps(columns[3], columns[2], _MM_SHUFFLE(A, A, A, A));
+    __m128 swapB =
+        _mm_shuffle_ps(columns[3], columns[2], _MM_SHUFFLE(B, B, B, B));
+
+    __m128 swap0 =
+        _mm_shuffle_ps(columns[2], columns[1], _MM_SHUFFLE(B, B, B, B));
+    __m128 swap1 = _mm_shuffle_ps(swapA, swapA, _MM_SHUFFLE(2, 0, 0, 0));
+    __m128 swap2 = _mm_shuffle_ps(swapB, swapB, _MM_SHUFFLE(2, 0, 0, 0));
+    __m128 swap3 =
+        _mm_shuffle_ps(columns[2], columns[1], _MM_SHUFFLE(A, A, A, A));
+
+    return _mm_sub_ps(_mm_mul_ps(swap0, swap1), _mm_mul_ps(swap2, swap3));
+}
+
+/**
+ * Gather (col1[I], col0[I], col0[I], col0[I]), as used by the inverse.
+ */
+template <int I>
+static inline __m128 InverseColumnElements(const __m128 columns[4])
+{
+    __m128 temp =
+        _mm_shuffle_ps(columns[1], columns[0], _MM_SHUFFLE(I, I, I, I));
+
+    return _mm_shuffle_ps(temp, temp, _MM_SHUFFLE(2, 2, 2, 0));
+}
+#endif
+
 Matrix4::Matrix4()
 {
     data[0] = Vector4(1.0f, 0.0f, 0.0f, 0.0f);
@@ -166,13 +207,73 @@ bool Matrix4::operator!=(const Matrix4 &other) const
 
 Matrix4 Matrix4::Transpose(const Matrix4 &mat)
 {
+#ifdef DS_MATH_SSE
+    __m128 columns[4];
+    LoadMatrix4(mat, columns);
+
+    _MM_TRANSPOSE4_PS(columns[0], columns[1], columns[2], columns[3]);
+
+    return (Matrix4(StoreVector4(columns[0]), StoreVector4(columns[1]),
+                    StoreVector4(columns[2]), StoreVector4(columns[3])));
+#else
     return (Matrix4(mat[0].x, mat[0].y, mat[0].z, mat[0].w, mat[1].x, mat[1].y,
                     mat[1].z, mat[1].w, mat[2].x, mat[2].y, mat[2].z, mat[2].w,
                     mat[3].x, mat[3].y, mat[3].z, mat[3].w));
+#endif
 }
 
 Matrix4 Matrix4::Inverse(const Matrix4 &mat)
 {
+#ifdef DS_MATH_SSE
+    // Same Laplace expansion as below, calculating a column of co-factors at
+    // a time.
+    __m128 columns[4];
+    LoadMatrix4(mat, columns);
+
+    __m128 sub0 = InverseSubFactors<3, 2>(columns);
+    __m128 sub1 = InverseSubFactors<3, 1>(columns);
+    __m128 sub2 = InverseSubFactors<2, 1>(columns);
+    __m128 sub3 = InverseSubFactors<3, 0>(columns);
+    __m128 sub4 = InverseSubFactors<2, 0>(columns);
+    __m128 sub5 = InverseSubFactors<1, 0>(columns);
+
+    __m128 elements0 = InverseColumnElements<0>(columns);
+    __m128 elements1 = InverseColumnElements<1>(columns);
+    __m128 elements2 = InverseColumnElements<2>(columns);
+    __m128 elements3 = InverseColumnElements<3>(columns);
+
+    const __m128 signA = _mm_set_ps(1.0f, -1.0f, 1.0f, -1.0f);
+    const __m128 signB = _mm_set_ps(-1.0f, 1.0f, -1.0f, 1.0f);
+
+    __m128 inv0 = _mm_mul_ps(
+        signB, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(elements1, sub0),
+                                     _mm_mul_ps(elements2, sub1)),
+                          _mm_mul_ps(elements3, sub2)));
+    __m128 inv1 = _mm_mul_ps(
+        signA, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(elements0, sub0),
+                                     _mm_mul_ps(elements2, sub3)),
+                          _mm_mul_ps(elements3, sub4)));
+    __m128 inv2 = _mm_mul_ps(
+        signB, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(elements0, sub1),
+                                     _mm_mul_ps(elements1, sub3)),
+                          _mm_mul_ps(elements3, sub5)));
+    __m128 inv3 = _mm_mul_ps(
+        signA, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(elements0, sub2),
+                                     _mm_mul_ps(elements1, sub4)),
+                          _mm_mul_ps(elements2, sub5)));
+
+    // Determinant is the first column dotted with the first row of co-factors
+    __m128 row0 = _mm_shuffle_ps(_mm_shuffle_ps(inv0, inv1, 0),
+                                 _mm_shuffle_ps(inv2, inv3, 0),
+                                 _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 invDet = _mm_div_ps(
+        _mm_set1_ps(1.0f), HorizontalSum(_mm_mul_ps(columns[0], row0)));
+
+    return (Matrix4(StoreVector4(_mm_mul_ps(inv0, invDet)),
+                    StoreVector4(_mm_mul_ps(inv1, invDet)),
+                    StoreVector4(_mm_mul_ps(inv2, invDet)),
+                    StoreVector4(_mm_mul_ps(inv3, invDet))));
+#else
     // Uses Laplace expansion to find determinant and inverse of matrix
     // Find sub-factors (col, row).
     /* Sub-factor is determinant of 2x2 matrix left when:
@@ -234,6 +335,184 @@ Matrix4 Matrix4::Inverse(const Matrix4 &mat)
     Matrix4 inv = adj * invDet;
 
     return (inv);
+#endif
+}
+
+bool Matrix4::IsAffine(const Matrix4 &mat)
+{
+    return (mat[0].w == 0.0f && mat[1].w == 0.0f && mat[2].w == 0.0f &&
+            mat[3].w == 1.0f);
+}
+
+Matrix4 Matrix4::AffineInverse(const Matrix4 &mat)
+{
+    // Rows of the inverse of the upper 3x3 part are the cross products of
+    // it's columns, divided by the determinant.
+    scalar row0x = mat[1].y * mat[2].z - mat[1].z * mat[2].y;
+    scalar row0y = mat[1].z * mat[2].x - mat[1].x * mat[2].z;
+    scalar row0z = mat[1].x * mat[2].y - mat[1].y * mat[2].x;
+
+    scalar row1x = mat[2].y * mat[0].z - mat[2].z * mat[0].y;
+    scalar row1y = mat[2].z * mat[0].x - mat[2].x * mat[0].z;
+    scalar row1z = mat[2].x * mat[0].y - mat[2].y * mat[0].x;
+
+    scalar row2x = mat[0].y * mat[1].z - mat[0].z * mat[1].y;
+    scalar row2y = mat[0].z * mat[1].x - mat[0].x * mat[1].z;
+    scalar row2z = mat[0].x * mat[1].y - mat[0].y * mat[1].x;
+
+    scalar invDet =
+        1 / (mat[0].x * row0x + mat[0].y * row0y + mat[0].z * row0z);
+
+    row0x *= invDet;
+    row0y *= invDet;
+    row0z *= invDet;
+    row1x *= invDet;
+    row1y *= invDet;
+    row1z *= invDet;
+    row2x *= invDet;
+    row2y *= invDet;
+    row2z *= invDet;
+
+    // Inverse translation is the inverted translation rotated and scaled by
+    // the inverse 3x3 part
+    const Vector4 &t = mat[3];
+
+    return Matrix4(
+        Vector4(row0x, row1x, row2x, 0.0f), Vector4(row0y, row1y, row2y, 0.0f),
+        Vector4(row0z, row1z, row2z, 0.0f),
+        Vector4(-(row0x * t.x + row0y * t.y + row0z * t.z),
+                -(row1x * t.x + row1y * t.y + row1z * t.z),
+                -(row2x * t.x + row2y * t.y + row2z * t.z), 1.0f));
+}
+
+Matrix4 Matrix4::AffineMultiply(const Matrix4 &m1, const Matrix4 &m2)
+{
+    // Same order of operations as operator*, leaving out the terms the last
+    // rows make zero.
+#ifdef DS_MATH_SSE
+    __m128 columns[4];
+    LoadMatrix4(m1, columns);
+
+    Matrix4 result;
+
+    for (unsigned int col = 0; col < 4; ++col)
+    {
+        __m128 c = LoadVector4(m2.data[col]);
+
+        __m128 column = _mm_mul_ps(columns[0], Splat<0>(c));
+        column = _mm_add_ps(column, _mm_mul_ps(columns[1], Splat<1>(c)));
+        column = _mm_add_ps(column, _mm_mul_ps(columns[2], Splat<2>(c)));
+        if (col == 3)
+        {
+            column = _mm_add_ps(column, columns[3]);
+        }
+
+        _mm_storeu_ps(&result.data[col].x, column);
+    }
+
+    return result;
+#else
+    Matrix4 result;
+
+    for (unsigned int col = 0; col < 3; ++col)
+    {
+        const Vector4 &c = m2[col];
+
+        result[col] =
+            Vector4(m1[0].x * c.x + m1[1].x * c.y + m1[2].x * c.z,
+                    m1[0].y * c.x + m1[1].y * c.y + m1[2].y * c.z,
+                    m1[0].z * c.x + m1[1].z * c.y + m1[2].z * c.z, 0.0f);
+    }
+
+    const Vector4 &t = m2[3];
+
+    result[3] =
+        Vector4(m1[0].x * t.x + m1[1].x * t.y + m1[2].x * t.z + m1[3].x,
+                m1[0].y * t.x + m1[1].y * t.y + m1[2].y * t.z + m1[3].y,
+                m1[0].z * t.x + m1[1].z * t.y + m1[2].z * t.z + m1[3].z, 1.0f);
+
+    return result;
+#endif
+}
+
+/**
+ * Split the upper 3x3 part of an affine matrix into a rotation and a scale.
+ * Reflections are kept in the x scale.
+ */
+static void
+DecomposeAffine(const Matrix4 &mat, Quaternion *rotation, Vector3 *scale)
+{
+    Vector3 axes[3];
+    for (unsigned int col = 0; col < 3; ++col)
+    {
+        axes[col] = Vector3(mat[col].x, mat[col].y, mat[col].z);
+        (*scale)[col] = Vector3::Magnitude(axes[col]);
+    }
+
+    if (Vector3::Dot(Vector3::Cross(axes[0], axes[1]), axes[2]) < 0.0f)
+    {
+        scale->x = -scale->x;
+    }
+
+    for (unsigned int col = 0; col < 3; ++col)
+    {
+        if ((*scale)[col] != 0.0f)
+        {
+            axes[col] *= 1.0f / (*scale)[col];
+        }
+    }
+
+    // Rotation matrix to quaternion, dividing by the largest of the
+    // quaternion's components to keep precision. Element (row, col) is
+    // axes[col][row].
+    scalar trace = axes[0].x + axes[1].y + axes[2].z;
+    if (trace > 0.0f)
+    {
+        scalar s = std::sqrt(trace + 1.0f) * 2.0f;
+        *rotation = Quaternion((axes[1].z - axes[2].y) / s,
+                               (axes[2].x - axes[0].z) / s,
+                               (axes[0].y - axes[1].x) / s, 0.25f * s);
+    }
+    else if (axes[0].x > axes[1].y && axes[0].x > axes[2].z)
+    {
+        scalar s = std::sqrt(1.0f + axes[0].x - axes[1].y - axes[2].z) * 2.0f;
+        *rotation = Quaternion(0.25f * s, (axes[1].x + axes[0].y) / s,
+                               (axes[2].x + axes[0].z) / s,
+                               (axes[1].z - axes[2].y) / s);
+    }
+    else if (axes[1].y > axes[2].z)
+    {
+        scalar s = std::sqrt(1.0f + axes[1].y - axes[0].x - axes[2].z) * 2.0f;
+        *rotation = Quaternion((axes[1].x + axes[0].y) / s, 0.25f * s,
+                               (axes[2].y + axes[1].z) / s,
+                               (axes[2].x - axes[0].z) / s);
+    }
+    else
+    {
+        scalar s = std::sqrt(1.0f + axes[2].z - axes[0].x - axes[1].y) * 2.0f;
+        *rotation = Quaternion((axes[2].x + axes[0].z) / s,
+                               (axes[2].y + axes[1].z) / s, 0.25f * s,
+                               (axes[0].y - axes[1].x) / s);
+    }
+}
+
+Matrix4
+Matrix4::AffineInterpolate(const Matrix4 &m1, const Matrix4 &m2, scalar t)
+{
+    Quaternion rotation1, rotation2;
+    Vector3 scale1, scale2;
+    DecomposeAffine(m1, &rotation1, &scale1);
+    DecomposeAffine(m2, &rotation2, &scale2);
+
+    Matrix4 result =
+        CreateFromQuaternion(Quaternion::Nlerp(rotation1, rotation2, t));
+    Vector3 scale = scale1 + (scale2 - scale1) * t;
+    result[0] *= scale.x;
+    result[1] *= scale.y;
+    result[2] *= scale.z;
+    result[3] = m1[3] + (m2[3] - m1[3]) * t;
+
+    return result;
 }
 
 
@@ -344,6 +623,19 @@ Matrix4 operator-(const Matrix4 &m1, const Matrix4 &m2)
 
 Matrix4 operator*(const Matrix4 &m1, const Matrix4 &m2)
 {
+#ifdef DS_MATH_SSE
+    __m128 columns[4];
+    LoadMatrix4(m1, columns);
+
+    Matrix4 result;
+    for (unsigned int col = 0; col < 4; ++col)
+    {
+        _mm_storeu_ps(&result.data[col].x,
+                      MultiplyColumn(columns, LoadVector4(m2.data[col])));
+    }
+
+    return result;
+#else
     Vector4 row0(m1[0].x, m1[1].x, m1[2].x, m1[3].x);
     Vector4 row1(m1[0].y, m1[1].y, m1[2].y, m1[3].y);
     Vector4 row2(m1[0].z, m1[1].z, m1[2].z, m1[3].z);
@@ -360,10 +652,17 @@ Matrix4 operator*(const Matrix4 &m1, const Matrix4 &m2)
 
     return (
         Matrix4(resultColumn0, resultColumn1, resultColumn2, resultColumn3));
+#endif
 }
 
 Vector4 operator*(const Matrix4 &mat, const Vector4 &column)
 {
+#ifdef DS_MATH_SSE
+    __m128 columns[4];
+    LoadMatrix4(mat, columns);
+
+    return StoreVector4(MultiplyColumn(columns, LoadVector4(column)));
+#else
     Vector4 row0(mat[0].x, mat[1].x, mat[2].x, mat[3].x);
     Vector4 row1(mat[0].y, mat[1].y, mat[2].y, mat[3].y);
     Vector4 row2(mat[0].z, mat[1].z, mat[2].z, mat[3].z);
@@ -371,12 +670,32 @@ Vector4 operator*(const Matrix4 &mat, const Vector4 &column)
 
     return (Vector4(Vector4::Dot(row0, column), Vector4::Dot(row1, column),
                     Vector4::Dot(row2, column), Vector4::Dot(row3, column)));
+#endif
 }
 
 Vector4 operator*(const Vector4 &row, const Matrix4 &mat)
 {
+#ifdef DS_MATH_SSE
+    // Multiply the row by each column, then transpose the products so they
+    // can be summed vertically.
+    __m128 r = LoadVector4(row);
+    __m128 products[4];
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        products[i] = _mm_mul_ps(r, LoadVector4(mat.data[i]));
+    }
+
+    _MM_TRANSPOSE4_PS(products[0], products[1], products[2], products[3]);
+
+    __m128 result = _mm_add_ps(products[0], products[1]);
+    result = _mm_add_ps(result, products[2]);
+    result = _mm_add_ps(result, products[3]);
+
+    return StoreVector4(result);
+#else
     return (Vector4(Vector4::Dot(row, mat[0]), Vector4::Dot(row, mat[1]),
                     Vector4::Dot(row, mat[2]), Vector4::Dot(row, mat[3])));
+#endif
 }
 
 Matrix4 operator*(const Matrix4 &mat, scalar factor)
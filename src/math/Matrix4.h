@@ -190,6 +190,51 @@ public:
      * @return       Matrix4, matrix inverse.
      */
     static Matrix4 Inverse(const Matrix4 &mat);
+    /**
+     * Return TRUE if the given matrix is an affine transform, i.e. it's last
+     * row is (0, 0, 0, 1).
+     *
+     * @param   mat  const Matrix4 &, matrix to check.
+     * @return       bool, TRUE if the matrix is affine, FALSE otherwise.
+     */
+    static bool IsAffine(const Matrix4 &mat);
+    /**
+     * Return the inverse of the given affine matrix.
+     *
+     * Only the upper 3x3 part needs inverting, so this is much cheaper than
+     * Inverse. The result is undefined if the matrix is not affine.
+     *
+     * @param   mat  const Matrix4 &, affine matrix to find the inverse of.
+     * @return       Matrix4, matrix inverse.
+     */
+    static Matrix4 AffineInverse(const Matrix4 &mat);
+    /**
+     * Multiply two affine matrices.
+     *
+     * Gives the same result as m1 * m2 without multiplying by the known last
+     * rows. The result is undefined if either matrix is not affine.
+     *
+     * @param   m1  const Matrix4 &, first affine matrix.
+     * @param   m2  const Matrix4 &, second affine matrix.
+     * @return      Matrix4, product of the matrices.
+     */
+    static Matrix4 AffineMultiply(const Matrix4 &m1, const Matrix4 &m2);
+    /**
+     * Interpolate between two affine matrices, i.e. to draw a transform
+     * between two updates.
+     *
+     * The matrices are split into translation, rotation and scale. The
+     * translations and scales are interpolated linearly and the rotations
+     * with Quaternion::Nlerp. The result is undefined if either matrix is not
+     * affine or is sheared.
+     *
+     * @param   m1  const Matrix4 &, affine matrix at t = 0.
+     * @param   m2  const Matrix4 &, affine matrix at t = 1.
+     * @param   t   scalar, interpolation factor in [0, 1].
+     * @return      Matrix4, interpolated affine matrix.
+     */
+    static Matrix4
+    AffineInterpolate(const Matrix4 &m1, const Matrix4 &m2, scalar t);
 
     /**
      * Create an orthogonal projection matrix.
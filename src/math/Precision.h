@@ -12,4 +12,18 @@ typedef float scalar;
  * How 'close' two floats need to be in order to be considered equal.
  */
 const float FLOAT_ACCURACY = 10.0e-6f;
+
+/**
+ * How accurately a normalization should be calculated.
+ *
+ * Exact divides by the square root of the magnitude. Fast multiplies by a
+ * hardware reciprocal square root estimate refined with one Newton-Raphson
+ * step, which is within a few units in the last place and avoids the
+ * square root and divide.
+ */
+enum class NormalizePrecision
+{
+    Exact,
+    Fast
+};
 }
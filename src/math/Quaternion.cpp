@@ -2,9 +2,14 @@
 #include <cassert>
 
 #include "Quaternion.h"
+#include "Simd.h"
 
 namespace ds_math
 {
+// Cosine of the angle between orientations above which Slerp falls back to
+// Nlerp, as sin(angle) is too small to divide by accurately
+static const scalar SlerpThreshold = 0.9995f;
+
 Quaternion::Quaternion(scalar x, scalar y, scalar z, scalar w)
     : x(x), y(y), z(z), w(w)
 {
@@ -106,9 +111,9 @@ scalar Quaternion::Magnitude() const
     return (Quaternion::Magnitude(*this));
 }
 
-void Quaternion::Normalize()
+void Quaternion::Normalize(NormalizePrecision precision)
 {
-    *this = Quaternion::Normalize(*this);
+    *this = Quaternion::Normalize(*this, precision);
 }
 
 void Quaternion::Invert()
@@ -121,8 +126,24 @@ scalar Quaternion::Magnitude(const Quaternion &q)
     return sqrt(Quaternion::Dot(q, q));
 }
 
-Quaternion Quaternion::Normalize(const Quaternion &q)
+Quaternion Quaternion::Normalize(const Quaternion &q,
+                                 NormalizePrecision precision)
 {
+#ifdef DS_MATH_SSE
+    if (precision == NormalizePrecision::Fast)
+    {
+        scalar magSquared = Quaternion::Dot(q, q);
+
+        assert(magSquared != 0 &&
+               "Attempted to normalize a vector with zero magnitude.");
+
+        return (q * _mm_cvtss_f32(ReciprocalSqrt(_mm_set_ss(magSquared))));
+    }
+#else
+    // Without SSE there is no reciprocal square root estimate to use
+    (void)precision;
+#endif
+
     scalar mag = Quaternion::Magnitude(q);
 
     assert(mag != 0 && "Attempted to normalize a vector with zero magnitude.");
@@ -140,6 +161,50 @@ Quaternion Quaternion::Invert(const Quaternion &q)
     return (Quaternion(-q.x, -q.y, -q.z, -q.w));
 }
 
+Quaternion Quaternion::Nlerp(const Quaternion &q1,
+                             const Quaternion &q2,
+                             scalar t,
+                             NormalizePrecision precision)
+{
+    // q and -q are the same orientation, pick the one closest to q1
+    scalar t2 = (Quaternion::Dot(q1, q2) < 0.0f) ? -t : t;
+    scalar t1 = (scalar)1.0f - t;
+
+    return Quaternion::Normalize(Quaternion(q1.x * t1 + q2.x * t2,
+                                            q1.y * t1 + q2.y * t2,
+                                            q1.z * t1 + q2.z * t2,
+                                            q1.w * t1 + q2.w * t2),
+                                 precision);
+}
+
+Quaternion Quaternion::Slerp(const Quaternion &q1,
+                             const Quaternion &q2,
+                             scalar t)
+{
+    scalar cosAngle = Quaternion::Dot(q1, q2);
+    scalar sign = 1.0f;
+
+    // q and -q are the same orientation, pick the one closest to q1
+    if (cosAngle < 0.0f)
+    {
+        cosAngle = -cosAngle;
+        sign = -1.0f;
+    }
+
+    if (cosAngle > SlerpThreshold)
+    {
+        return Quaternion::Nlerp(q1, q2, t);
+    }
+
+    scalar angle = acos(cosAngle);
+    scalar inverseSin = ((scalar)1.0f) / sin(angle);
+    scalar t1 = sin(((scalar)1.0f - t) * angle) * inverseSin;
+    scalar t2 = sign * sin(t * angle) * inverseSin;
+
+    return (Quaternion(q1.x * t1 + q2.x * t2, q1.y * t1 + q2.y * t2,
+                       q1.z * t1 + q2.z * t2, q1.w * t1 + q2.w * t2));
+}
+
 Quaternion operator*(const Quaternion &q1, const Quaternion &q2)
 {
     return (Quaternion(q1.w * q2.x + q1.x * q2.w + q1.y * q2.z - q1.z * q2.y,
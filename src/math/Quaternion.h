@@ -109,8 +109,10 @@ public:
      * Normalize this quaternion.
      *
      * @pre  Magnitude of quaternion is not 0.
+     *
+     * @param  precision  NormalizePrecision, how accurately to normalize.
      */
-    void Normalize();
+    void Normalize(NormalizePrecision precision = NormalizePrecision::Exact);
     /**
      * Invert quaternion.
      */
@@ -128,10 +130,13 @@ public:
      *
      * @pre  Magnitude of quaternion is not 0.
      *
-     * @param   q  const Quaternion &, quaternion to normalize.
-     * @return     Quaternion, normalized quaternion.
+     * @param   q          const Quaternion &, quaternion to normalize.
+     * @param   precision  NormalizePrecision, how accurately to normalize.
+     * @return             Quaternion, normalized quaternion.
      */
-    static Quaternion Normalize(const Quaternion &q);
+    static Quaternion
+    Normalize(const Quaternion &q,
+              NormalizePrecision precision = NormalizePrecision::Exact);
     /**
      * Return the quaternion dot product of two given quaternions.
      *
@@ -147,6 +152,38 @@ public:
      * @return     Quaternion, inverted quaternion.
      */
     static Quaternion Invert(const Quaternion &q);
+    /**
+     * Interpolate linearly between two unit quaternions and normalize the
+     * result.
+     *
+     * Takes the shortest path between the orientations. Cheaper than Slerp
+     * but the angular velocity is not constant, the error is largest halfway
+     * between orientations that are far apart.
+     *
+     * @param   q1         const Quaternion &, orientation at t = 0.
+     * @param   q2         const Quaternion &, orientation at t = 1.
+     * @param   t          scalar, interpolation factor in [0, 1].
+     * @param   precision  NormalizePrecision, how accurately to normalize.
+     * @return             Quaternion, interpolated unit quaternion.
+     */
+    static Quaternion
+    Nlerp(const Quaternion &q1,
+          const Quaternion &q2,
+          scalar t,
+          NormalizePrecision precision = NormalizePrecision::Exact);
+    /**
+     * Interpolate spherically between two unit quaternions.
+     *
+     * Takes the shortest path between the orientations at constant angular
+     * velocity. Falls back to Nlerp when the orientations are almost equal.
+     *
+     * @param   q1  const Quaternion &, orientation at t = 0.
+     * @param   q2  const Quaternion &, orientation at t = 1.
+     * @param   t   scalar, interpolation factor in [0, 1].
+     * @return      Quaternion, interpolated unit quaternion.
+     */
+    static Quaternion
+    Slerp(const Quaternion &q1, const Quaternion &q2, scalar t);
 
     scalar x, y, z, w;
 };
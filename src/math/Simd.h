@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Matrix4.h"
+#include "Vector4.h"
+
+/**
+ * Selects the SIMD instruction set used by the math library at build time.
+ *
+ * SSE kernels are used whenever the compiler targets SSE2, which every x86-64
+ * compiler does. Defining DS_MATH_NO_SIMD (the DS_MATH_SIMD CMake option)
+ * forces the scalar implementations instead.
+ */
+#if !defined(DS_MATH_NO_SIMD) &&                                               \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define DS_MATH_SSE
+#endif
+
+#ifdef DS_MATH_SSE
+#include <emmintrin.h>
+
+namespace ds_math
+{
+static_assert(sizeof(scalar) == sizeof(float),
+              "SSE kernels only support single precision scalars.");
+static_assert(sizeof(Vector4) == 4 * sizeof(float),
+              "Vector4 must be exactly four packed scalars.");
+
+/**
+ * Load a Vector4 into an SSE register.
+ *
+ * Uses an unaligned load, objects allocated with new are not guaranteed to be
+ * 16 byte aligned before C++17 and it costs nothing on aligned data.
+ *
+ * @param   vec  const Vector4 &, vector to load.
+ * @return       __m128, register holding x, y, z and w.
+ */
+inline __m128 LoadVector4(const Vector4 &vec)
+{
+    return _mm_loadu_ps(&vec.x);
+}
+
+/**
+ * Store an SSE register into a Vector4.
+ *
+ * @param   reg  __m128, register holding x, y, z and w.
+ * @return       Vector4, vector with the register's values.
+ */
+inline Vector4 StoreVector4(__m128 reg)
+{
+    Vector4 vec;
+    _mm_storeu_ps(&vec.x, reg);
+
+    return vec;
+}
+
+/**
+ * Broadcast one element of a register to all four elements.
+ *
+ * @tparam  Index  int, index of the element to broadcast.
+ * @param   reg    __m128, register to broadcast element of.
+ * @return         __m128, element in every element.
+ */
+template <int Index>
+inline __m128 Splat(__m128 reg)
+{
+    return _mm_shuffle_ps(reg, reg, _MM_SHUFFLE(Index, Index, Index, Index));
+}
+
+/**
+ * Sum the four elements of a register into every element.
+ *
+ * @param   reg  __m128, register to sum.
+ * @return       __m128, sum of the elements in every element.
+ */
+inline __m128 HorizontalSum(__m128 reg)
+{
+    // (x + z, y + w, ...) then ((x + z) + (y + w), ...)
+    __m128 sum = _mm_add_ps(reg, _mm_movehl_ps(reg, reg));
+    return Splat<0>(_mm_add_ss(sum, Splat<1>(sum)));
+}
+
+/**
+ * Calculate the reciprocal square root of each element.
+ *
+ * The hardware estimate is only accurate to 12 bits, one Newton-Raphson step
+ * brings it to within a few units in the last place.
+ *
+ * @param   reg  __m128, register of positive values.
+ * @return       __m128, 1 / sqrt(value) for each element.
+ */
+inline __m128 ReciprocalSqrt(__m128 reg)
+{
+    // y' = y * (1.5 - 0.5 * x * y * y)
+    __m128 estimate = _mm_rsqrt_ps(reg);
+    __m128 halfReg = _mm_mul_ps(_mm_set1_ps(0.5f), reg);
+    __m128 correction = _mm_sub_ps(
+        _mm_set1_ps(1.5f),
+        _mm_mul_ps(halfReg, _mm_mul_ps(estimate, estimate)));
+
+    return _mm_mul_ps(estimate, correction);
+}
+
+/**
+ * Load the columns of a matrix into SSE registers.
+ *
+ * @param  mat      const Matrix4 &, matrix to load.
+ * @param  columns  __m128[4], registers to load the columns into.
+ */
+inline void LoadMatrix4(const Matrix4 &mat, __m128 columns[4])
+{
+    columns[0] = LoadVector4(mat.data[0]);
+    columns[1] = LoadVector4(mat.data[1]);
+    columns[2] = LoadVector4(mat.data[2]);
+    columns[3] = LoadVector4(mat.data[3]);
+}
+
+/**
+ * Multiply the matrix with the given columns by a column vector, summing in
+ * the same order as the scalar implementation.
+ *
+ * @param   columns  const __m128[4], columns of the matrix.
+ * @param   column   __m128, column vector to multiply.
+ * @return           __m128, product.
+ */
+inline __m128 MultiplyColumn(const __m128 columns[4], __m128 column)
+{
+    __m128 result = _mm_mul_ps(columns[0], Splat<0>(column));
+    result = _mm_add_ps(result, _mm_mul_ps(columns[1], Splat<1>(column)));
+    result = _mm_add_ps(result, _mm_mul_ps(columns[2], Splat<2>(column)));
+    result = _mm_add_ps(result, _mm_mul_ps(columns[3], Splat<3>(column)));
+
+    return result;
+}
+}
+#endif
@@ -1,6 +1,7 @@
 #include <cmath>
 #include <cassert>
 
+#include "Simd.h"
 #include "Vector4.h"
 
 namespace ds_math
@@ -80,30 +81,42 @@ const scalar &Vector4::operator[](unsigned int index) const
 
 const Vector4 &Vector4::operator*=(scalar factor)
 {
+#ifdef DS_MATH_SSE
+    *this = StoreVector4(_mm_mul_ps(LoadVector4(*this), _mm_set1_ps(factor)));
+#else
     x *= factor;
     y *= factor;
     z *= factor;
     w *= factor;
+#endif
 
     return (*this);
 }
 
 const Vector4 &Vector4::operator+=(const Vector4 &other)
 {
+#ifdef DS_MATH_SSE
+    *this = StoreVector4(_mm_add_ps(LoadVector4(*this), LoadVector4(other)));
+#else
     x += other.x;
     y += other.y;
     z += other.z;
     w += other.w;
+#endif
 
     return (*this);
 }
 
 const Vector4 &Vector4::operator-=(const Vector4 &other)
 {
+#ifdef DS_MATH_SSE
+    *this = StoreVector4(_mm_sub_ps(LoadVector4(*this), LoadVector4(other)));
+#else
     x -= other.x;
     y -= other.y;
     z -= other.z;
     w -= other.w;
+#endif
 
     return (*this);
 }
@@ -138,7 +151,12 @@ void Vector4::Invert()
 
 scalar Vector4::Dot(const Vector4 &v1, const Vector4 &v2)
 {
+#ifdef DS_MATH_SSE
+    return _mm_cvtss_f32(
+        HorizontalSum(_mm_mul_ps(LoadVector4(v1), LoadVector4(v2))));
+#else
     return ((v1.x * v2.x) + (v1.y * v2.y) + (v1.z * v2.z) + (v1.w * v2.w));
+#endif
 }
 
 scalar Vector4::Magnitude(const Vector4 &vec)
@@ -170,12 +188,20 @@ const Vector4 Vector4::UnitW = Vector4(0.0f, 0.0f, 0.0f, 1.0f);
 
 Vector4 operator+(const Vector4 &v1, const Vector4 &v2)
 {
+#ifdef DS_MATH_SSE
+    return StoreVector4(_mm_add_ps(LoadVector4(v1), LoadVector4(v2)));
+#else
     return (Vector4(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z, v1.w + v2.w));
+#endif
 }
 
 Vector4 operator-(const Vector4 &v1, const Vector4 &v2)
 {
+#ifdef DS_MATH_SSE
+    return StoreVector4(_mm_sub_ps(LoadVector4(v1), LoadVector4(v2)));
+#else
     return (Vector4(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z, v1.w - v2.w));
+#endif
 }
 
 Vector4 operator*(scalar factor, const Vector4 &vec)
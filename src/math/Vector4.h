@@ -5,7 +5,11 @@
 
 namespace ds_math
 {
-class Vector4
+/**
+ * Four component vector, aligned to 16 bytes so it can be loaded into a SIMD
+ * register.
+ */
+class alignas(16) Vector4
 {
 public:
     /**
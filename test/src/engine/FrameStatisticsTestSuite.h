@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+
+#include "engine/FrameStatistics.h"
+
+/**
+ * Statistics of no frames should all be zero.
+ */
+TEST(FrameStatistics, Empty)
+{
+    ds::FrameStatistics stats;
+
+    EXPECT_EQ(0u, stats.GetNumFrames());
+    EXPECT_DOUBLE_EQ(0.0, stats.GetLastFrameTime());
+    EXPECT_DOUBLE_EQ(0.0, stats.GetMinFrameTime());
+    EXPECT_DOUBLE_EQ(0.0, stats.GetMaxFrameTime());
+    EXPECT_DOUBLE_EQ(0.0, stats.GetAverageFrameTime());
+    EXPECT_DOUBLE_EQ(0.0, stats.GetPercentileFrameTime(99.0));
+}
+
+/**
+ * Min, max, average and last frame time should be calculated from the frames
+ * added.
+ */
+TEST(FrameStatistics, Basic)
+{
+    ds::FrameStatistics stats;
+
+    stats.AddFrameTime(20.0);
+    stats.AddFrameTime(10.0);
+    stats.AddFrameTime(30.0);
+
+    EXPECT_EQ(3u, stats.GetNumFrames());
+    EXPECT_DOUBLE_EQ(30.0, stats.GetLastFrameTime());
+    EXPECT_DOUBLE_EQ(10.0, stats.GetMinFrameTime());
+    EXPECT_DOUBLE_EQ(30.0, stats.GetMaxFrameTime());
+    EXPECT_DOUBLE_EQ(20.0, stats.GetAverageFrameTime());
+}
+
+/**
+ * Only the most recent frames should be kept track of.
+ */
+TEST(FrameStatistics, Wrap)
+{
+    ds::FrameStatistics stats(2);
+
+    stats.AddFrameTime(100.0);
+    stats.AddFrameTime(1.0);
+    stats.AddFrameTime(3.0);
+
+    EXPECT_EQ(2u, stats.GetNumFrames());
+    EXPECT_DOUBLE_EQ(3.0, stats.GetLastFrameTime());
+    EXPECT_DOUBLE_EQ(1.0, stats.GetMinFrameTime());
+    EXPECT_DOUBLE_EQ(3.0, stats.GetMaxFrameTime());
+    EXPECT_DOUBLE_EQ(2.0, stats.GetAverageFrameTime());
+
+    stats.Clear();
+    EXPECT_EQ(0u, stats.GetNumFrames());
+}
+
+/**
+ * Percentiles should use the nearest rank.
+ */
+TEST(FrameStatistics, Percentile)
+{
+    ds::FrameStatistics stats(100);
+
+    for (int i = 100; i >= 1; --i)
+    {
+        stats.AddFrameTime((double)i);
+    }
+
+    EXPECT_DOUBLE_EQ(1.0, stats.GetPercentileFrameTime(0.0));
+    EXPECT_DOUBLE_EQ(50.0, stats.GetPercentileFrameTime(50.0));
+    EXPECT_DOUBLE_EQ(99.0, stats.GetPercentileFrameTime(99.0));
+    EXPECT_DOUBLE_EQ(100.0, stats.GetPercentileFrameTime(100.0));
+}
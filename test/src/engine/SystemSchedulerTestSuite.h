@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "engine/SystemScheduler.h"
+
+/**
+ * System that records the order systems are updated in and the thread it was
+ * updated on.
+ */
+class SystemSchedulerTestSystem : public ds::ISystem
+{
+public:
+    SystemSchedulerTestSystem(int id,
+                              bool requiresMainThread,
+                              std::vector<int> *updateOrder,
+                              std::mutex *updateOrderMutex)
+        : m_id(id), m_requiresMainThread(requiresMainThread),
+          m_updateOrder(updateOrder), m_updateOrderMutex(updateOrderMutex)
+    {
+    }
+
+    virtual bool Initialize(const ds::Config &config)
+    {
+        return true;
+    }
+
+    virtual void Update(float deltaTime)
+    {
+        m_updateThread = std::this_thread::get_id();
+
+        std::lock_guard<std::mutex> lock(*m_updateOrderMutex);
+        m_updateOrder->push_back(m_id);
+    }
+
+    virtual void Shutdown()
+    {
+    }
+
+    virtual void PostMessages(const ds_msg::MessageStream &messages)
+    {
+    }
+
+    virtual ds_msg::MessageStream CollectMessages()
+    {
+        return ds_msg::MessageStream();
+    }
+
+    virtual bool RequiresMainThread() const
+    {
+        return m_requiresMainThread;
+    }
+
+    int m_id;
+    bool m_requiresMainThread;
+    std::vector<int> *m_updateOrder;
+    std::mutex *m_updateOrderMutex;
+    std::thread::id m_updateThread;
+};
+
+/**
+ * Get the position of the given id in the update order.
+ */
+static size_t SystemSchedulerUpdatePosition(const std::vector<int> &updateOrder,
+                                            int id)
+{
+    return std::find(updateOrder.begin(), updateOrder.end(), id) -
+           updateOrder.begin();
+}
+
+TEST(SystemScheduler, AddSystemOnlyOnce)
+{
+    ds::SystemScheduler scheduler;
+    std::vector<int> updateOrder;
+    std::mutex updateOrderMutex;
+    std::shared_ptr<ds::ISystem> system(new SystemSchedulerTestSystem(
+        0, true, &updateOrder, &updateOrderMutex));
+
+    EXPECT_EQ(true, scheduler.AddSystem(system));
+    EXPECT_EQ(false, scheduler.AddSystem(system));
+}
+
+TEST(SystemScheduler, DependencyCycleRejected)
+{
+    ds::SystemScheduler scheduler;
+    std::vector<int> updateOrder;
+    std::mutex updateOrderMutex;
+    std::shared_ptr<ds::ISystem> a(new SystemSchedulerTestSystem(
+        0, true, &updateOrder, &updateOrderMutex));
+    std::shared_ptr<ds::ISystem> b(new SystemSchedulerTestSystem(
+        1, true, &updateOrder, &updateOrderMutex));
+    std::shared_ptr<ds::ISystem> c(new SystemSchedulerTestSystem(
+        2, true, &updateOrder, &updateOrderMutex));
+    scheduler.AddSystem(a);
+    scheduler.AddSystem(b);
+    scheduler.AddSystem(c);
+
+    EXPECT_EQ(true, scheduler.AddDependency(b.get(), a.get()));
+    EXPECT_EQ(true, scheduler.AddDependency(c.get(), b.get()));
+    EXPECT_EQ(false, scheduler.AddDependency(a.get(), c.get()));
+    EXPECT_EQ(false, scheduler.AddDependency(a.get(), a.get()));
+}
+
+TEST(SystemScheduler, DependenciesRespectedSerially)
+{
+    ds::SystemScheduler scheduler;
+    std::vector<int> updateOrder;
+    std::mutex updateOrderMutex;
+    std::shared_ptr<ds::ISystem> a(new SystemSchedulerTestSystem(
+        0, true, &updateOrder, &updateOrderMutex));
+    std::shared_ptr<ds::ISystem> b(new SystemSchedulerTestSystem(
+        1, true, &updateOrder, &updateOrderMutex));
+    scheduler.AddSystem(a);
+    scheduler.AddSystem(b);
+    scheduler.AddDependency(a.get(), b.get());
+
+    scheduler.Update(0.1f);
+
+    ASSERT_EQ(2, updateOrder.size());
+    EXPECT_EQ(1, updateOrder[0]);
+    EXPECT_EQ(0, updateOrder[1]);
+}
+
+TEST(SystemScheduler, DependenciesRespectedWithWorkers)
+{
+    ds::SystemScheduler scheduler;
+    scheduler.SetNumWorkerThreads(4);
+
+    std::vector<int> updateOrder;
+    std::mutex updateOrderMutex;
+    std::vector<std::shared_ptr<SystemSchedulerTestSystem>> systems;
+    for (int i = 0; i < 8; ++i)
+    {
+        // Every other system must be updated on the main thread
+        systems.push_back(std::shared_ptr<SystemSchedulerTestSystem>(
+            new SystemSchedulerTestSystem(i, (i % 2) == 0, &updateOrder,
+                                          &updateOrderMutex)));
+        scheduler.AddSystem(systems.back());
+    }
+
+    // Chain of dependencies 7 -> 5 -> 3 -> 1 and 6 -> 1
+    scheduler.AddDependency(systems[5].get(), systems[7].get());
+    scheduler.AddDependency(systems[3].get(), systems[5].get());
+    scheduler.AddDependency(systems[1].get(), systems[3].get());
+    scheduler.AddDependency(systems[1].get(), systems[6].get());
+
+    for (int frame = 0; frame < 100; ++frame)
+    {
+        updateOrder.clear();
+        scheduler.Update(0.1f);
+
+        ASSERT_EQ(systems.size(), updateOrder.size());
+        EXPECT_LT(SystemSchedulerUpdatePosition(updateOrder, 7),
+                  SystemSchedulerUpdatePosition(updateOrder, 5));
+        EXPECT_LT(SystemSchedulerUpdatePosition(updateOrder, 5),
+                  SystemSchedulerUpdatePosition(updateOrder, 3));
+        EXPECT_LT(SystemSchedulerUpdatePosition(updateOrder, 3),
+                  SystemSchedulerUpdatePosition(updateOrder, 1));
+        EXPECT_LT(SystemSchedulerUpdatePosition(updateOrder, 6),
+                  SystemSchedulerUpdatePosition(updateOrder, 1));
+
+        for (auto &system : systems)
+        {
+            if (system->RequiresMainThread())
+            {
+                EXPECT_EQ(std::this_thread::get_id(), system->m_updateThread);
+            }
+        }
+    }
+
+    EXPECT_EQ(systems.size(), scheduler.GetSystemUpdateTimes().size());
+}
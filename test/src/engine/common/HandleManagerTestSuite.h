@@ -0,0 +1,82 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "engine/common/HandleManager.h"
+
+// Handles should refer to the data they were added with
+TEST(HandleManager, AddGet)
+{
+    ds::HandleManager manager;
+
+    int a = 1;
+    int b = 2;
+    ds::Handle handleA = manager.Add(&a, 1);
+    ds::Handle handleB = manager.Add(&b, 2);
+
+    EXPECT_EQ(2, manager.GetCount());
+    EXPECT_EQ(&a, manager.Get(handleA));
+    EXPECT_EQ(&b, manager.Get(handleB));
+    EXPECT_EQ(1u, handleA.type);
+    EXPECT_EQ(2u, handleB.type);
+
+    int out = 0;
+    EXPECT_TRUE(manager.GetAs<int>(handleB, &out));
+    EXPECT_EQ(2, out);
+}
+
+// Removed handles should no longer be valid, even once their entry is reused
+TEST(HandleManager, RemovedHandleIsStale)
+{
+    ds::HandleManager manager;
+
+    int a = 1;
+    int b = 2;
+    ds::Handle handleA = manager.Add(&a, 0);
+    manager.Remove(handleA);
+
+    EXPECT_EQ(0, manager.GetCount());
+    EXPECT_EQ(nullptr, manager.Get(handleA));
+
+    ds::Handle handleB = manager.Add(&b, 0);
+    EXPECT_EQ(handleA.index, handleB.index);
+    EXPECT_NE((uint64_t)handleA, (uint64_t)handleB);
+    EXPECT_EQ(nullptr, manager.Get(handleA));
+    EXPECT_EQ(&b, manager.Get(handleB));
+}
+
+// The manager should grow past a single page of entries
+TEST(HandleManager, Grows)
+{
+    ds::HandleManager manager;
+
+    const int numHandles = ds::HandleManager::PAGE_SIZE * 4 + 1;
+    std::vector<int> data(numHandles);
+    std::vector<ds::Handle> handles;
+    for (int i = 0; i < numHandles; ++i)
+    {
+        data[i] = i;
+        handles.push_back(manager.Add(&data[i], 0));
+    }
+
+    EXPECT_EQ(numHandles, manager.GetCount());
+    for (int i = 0; i < numHandles; ++i)
+    {
+        EXPECT_EQ(&data[i], manager.Get(handles[i]));
+    }
+}
+
+// Handles from beyond the entries allocated should be invalid
+TEST(HandleManager, OutOfRangeHandle)
+{
+    ds::HandleManager manager;
+
+    EXPECT_EQ(nullptr, manager.Get(ds::Handle(123456, 1, 0)));
+
+    int a = 1;
+    manager.Add(&a, 0);
+    manager.Reset();
+
+    EXPECT_EQ(0, manager.GetCount());
+    EXPECT_EQ(nullptr, manager.Get(ds::Handle(0, 2, 0)));
+}
@@ -218,3 +218,101 @@ TEST(StreamBuffer, SetStreamBufferLargerStructure)
     EXPECT_EQ(pA.y, pB.y);
     EXPECT_EQ(pA.z, pB.z);
 }
+
+TEST(StreamBuffer, CopiesShareStorage)
+{
+    ds_com::StreamBuffer stream;
+
+    float write = 2.5f;
+    stream << write;
+
+    ds_com::StreamBuffer copy = stream;
+    EXPECT_EQ(true, stream.IsShared());
+    EXPECT_EQ(stream.GetDataPtr(), copy.GetDataPtr());
+}
+
+TEST(StreamBuffer, CopiesHaveIndependentReadHeads)
+{
+    ds_com::StreamBuffer stream;
+
+    float write = 2.5f;
+    stream << write;
+
+    ds_com::StreamBuffer copy = stream;
+
+    float read = 0.0f;
+    copy >> read;
+    EXPECT_EQ(write, read);
+    EXPECT_EQ(0, copy.AvailableBytes());
+    EXPECT_EQ(sizeof(float), stream.AvailableBytes());
+
+    read = 0.0f;
+    stream >> read;
+    EXPECT_EQ(write, read);
+}
+
+TEST(StreamBuffer, WriteToCopyDoesntAffectOriginal)
+{
+    ds_com::StreamBuffer stream;
+
+    float write = 2.5f;
+    stream << write;
+
+    ds_com::StreamBuffer copy = stream;
+    copy << write;
+
+    EXPECT_EQ(false, stream.IsShared());
+    EXPECT_EQ(sizeof(float), stream.AvailableBytes());
+    EXPECT_EQ(2 * sizeof(float), copy.AvailableBytes());
+}
+
+TEST(StreamBuffer, ClearCopyDoesntAffectOriginal)
+{
+    ds_com::StreamBuffer stream;
+
+    float write = 2.5f;
+    stream << write;
+
+    ds_com::StreamBuffer copy = stream;
+    copy.Clear();
+
+    EXPECT_EQ(0, copy.AvailableBytes());
+    EXPECT_EQ(sizeof(float), stream.AvailableBytes());
+}
+
+TEST(StreamBuffer, AppendToEmptySharesStorage)
+{
+    ds_com::StreamBuffer from;
+    ds_com::StreamBuffer to;
+
+    float write = 2.5f;
+    from << write;
+
+    ds_com::AppendStreamBuffer(to, from);
+    EXPECT_EQ(from.GetDataPtr(), to.GetDataPtr());
+
+    float read = 0.0f;
+    to >> read;
+    EXPECT_EQ(write, read);
+}
+
+TEST(StreamBuffer, AppendToNonEmptyCopies)
+{
+    ds_com::StreamBuffer from;
+    ds_com::StreamBuffer to;
+
+    float writeA = 2.5f;
+    float writeB = -1.0f;
+    to << writeA;
+    from << writeB;
+
+    ds_com::AppendStreamBuffer(to, from);
+    EXPECT_EQ(false, to.IsShared());
+    EXPECT_EQ(sizeof(float), from.AvailableBytes());
+
+    float read = 0.0f;
+    to >> read;
+    EXPECT_EQ(writeA, read);
+    to >> read;
+    EXPECT_EQ(writeB, read);
+}
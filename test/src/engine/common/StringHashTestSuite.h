@@ -0,0 +1,47 @@
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "engine/common/StringHash.h"
+
+// Compile time hashes should match known FNV-1a values
+TEST(StringHash, KnownValues)
+{
+    static_assert(ds_com::HashString("") == 2166136261u,
+                  "Empty string hash should be the FNV offset basis.");
+    static_assert(ds_com::HashString("a") == 0xe40c292cu,
+                  "FNV-1a hash of \"a\" is incorrect.");
+
+    EXPECT_EQ(0xbf9cf968u, ds_com::HashString("foobar"));
+}
+
+// Run time hashes should match compile time hashes
+TEST(StringHash, RunTimeMatchesCompileTime)
+{
+    std::string string = "renderComponent";
+
+    EXPECT_EQ(ds_com::HashString("renderComponent"),
+              ds_com::HashString(string));
+    EXPECT_NE(ds_com::HashString("renderComponent"),
+              ds_com::HashString("transformComponent"));
+}
+
+// Hashes should be usable as case labels
+TEST(StringHash, Switch)
+{
+    int result = 0;
+
+    switch (ds_com::HashString(std::string("quit")))
+    {
+    case ds_com::HashString("console_toggle"):
+        result = 1;
+        break;
+    case ds_com::HashString("quit"):
+        result = 2;
+        break;
+    default:
+        break;
+    }
+
+    EXPECT_EQ(2, result);
+}
@@ -0,0 +1,139 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "engine/common/StringIntern.h"
+
+// Interning the same string twice should give the same id
+TEST(StringIntern, Deduplicates)
+{
+    ds::StringIntern &intern = ds::StringIntern::Instance();
+
+    ds::StringIntern::StringId id = intern.Intern("transformComponent");
+    size_t numStrings = intern.GetNumStrings();
+
+    EXPECT_EQ(id, intern.Intern(std::string("transformComponent")));
+    EXPECT_EQ(numStrings, intern.GetNumStrings());
+    EXPECT_EQ("transformComponent", intern.GetString(id));
+}
+
+// Different strings should get different ids
+TEST(StringIntern, DistinctStrings)
+{
+    ds::StringIntern &intern = ds::StringIntern::Instance();
+
+    ds::StringIntern::StringId a = intern.Intern("renderComponent");
+    ds::StringIntern::StringId b = intern.Intern("renderComponents");
+    ds::StringIntern::StringId empty = intern.Intern("");
+
+    EXPECT_NE(a, b);
+    EXPECT_NE(a, empty);
+    EXPECT_EQ("renderComponent", intern.GetString(a));
+    EXPECT_EQ("renderComponents", intern.GetString(b));
+    EXPECT_EQ("", intern.GetString(empty));
+}
+
+// References to interned strings should not move as more strings are interned
+TEST(StringIntern, StableReferences)
+{
+    ds::StringIntern &intern = ds::StringIntern::Instance();
+
+    const std::string &string = intern.GetString(intern.Intern("stable"));
+    const std::string *address = &string;
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        intern.Intern("stable" + std::to_string(i));
+    }
+
+    EXPECT_EQ(address, &intern.GetString(intern.Intern("stable")));
+    EXPECT_EQ("stable", *address);
+}
+
+// Interning the same strings from several threads should agree on their ids
+TEST(StringIntern, Concurrent)
+{
+    ds::StringIntern &intern = ds::StringIntern::Instance();
+
+    const int numThreads = 4;
+    const int numStrings = 1000;
+    std::vector<std::vector<ds::StringIntern::StringId>> ids(numThreads);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < numThreads; ++t)
+    {
+        threads.push_back(std::thread([&, t]()
+                                      {
+                                          for (int i = 0; i < numStrings; ++i)
+                                          {
+                                              ids[t].push_back(intern.Intern(
+                                                  "concurrent" +
+                                                  std::to_string(i)));
+                                          }
+                                      }));
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int i = 0; i < numStrings; ++i)
+    {
+        for (int t = 1; t < numThreads; ++t)
+        {
+            EXPECT_EQ(ids[0][i], ids[t][i]);
+        }
+        EXPECT_EQ("concurrent" + std::to_string(i),
+                  intern.GetString(ids[0][i]));
+    }
+}
+
+// Interned strings should have the same hash as computed at compile time
+TEST(StringIntern, Hash)
+{
+    ds::StringIntern &intern = ds::StringIntern::Instance();
+
+    ds::StringIntern::StringId id = intern.Intern("terrainComponent");
+
+    EXPECT_EQ(ds_com::HashString("terrainComponent"), intern.GetHash(id));
+#ifndef NDEBUG
+    EXPECT_EQ("terrainComponent",
+              intern.LookupHash(ds_com::HashString("terrainComponent")));
+    EXPECT_EQ("<unknown>",
+              intern.LookupHash(ds_com::HashString("notInterned")));
+#endif
+}
+
+// Strings interned into a full shard should get the overflow id rather than
+// being stored past the end of it
+TEST(StringIntern, Overflow)
+{
+    ds::StringIntern &intern = ds::StringIntern::Instance();
+
+    EXPECT_EQ("<overflow>", intern.GetString(intern.GetOverflowId()));
+
+    // No shard holds more strings than there are, so interning that many
+    // strings per shard fills at least one of them
+    uint32_t maxStrings = (uint32_t)intern.GetNumStrings();
+    ds::StringIntern::StringId stored = intern.Intern("notOverflowed");
+    intern.SetMaxStringsPerShard(maxStrings);
+
+    bool overflowed = false;
+    for (uint32_t i = 0; i < 16 * maxStrings; ++i)
+    {
+        ds::StringIntern::StringId id =
+            intern.Intern("overflow" + std::to_string(i));
+        overflowed |= (id == intern.GetOverflowId());
+    }
+
+    EXPECT_TRUE(overflowed);
+    EXPECT_GE(16 * (size_t)maxStrings, intern.GetNumStrings());
+
+    // Strings already interned keep their ids
+    EXPECT_EQ(stored, intern.Intern("notOverflowed"));
+    EXPECT_EQ("notOverflowed", intern.GetString(stored));
+
+    intern.SetMaxStringsPerShard(0xffffffff);
+}
@@ -0,0 +1,55 @@
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "engine/common/ThreadPool.h"
+
+// Every element of the range should be visited exactly once, in subranges no
+// smaller than the grain size (except the last)
+TEST(ThreadPool, ParallelFor)
+{
+    ds_com::ThreadPool threadPool(3);
+
+    std::vector<std::atomic<int>> visits(10000);
+    for (auto &visit : visits)
+    {
+        visit = 0;
+    }
+    std::atomic<int> numSmallRanges(0);
+
+    threadPool.ParallelFor(100, visits.size(), 64,
+                           [&](size_t begin, size_t end)
+                           {
+                               if (end - begin < 64 && end != visits.size())
+                               {
+                                   ++numSmallRanges;
+                               }
+
+                               for (size_t i = begin; i < end; ++i)
+                               {
+                                   ++visits[i];
+                               }
+                           });
+
+    for (size_t i = 0; i < visits.size(); ++i)
+    {
+        EXPECT_EQ((i < 100) ? 0 : 1, visits[i]) << "Element " << i;
+    }
+    EXPECT_EQ(0, numSmallRanges);
+}
+
+// A pool without worker threads should process the whole range on the calling
+// thread
+TEST(ThreadPool, ParallelForNoWorkers)
+{
+    ds_com::ThreadPool threadPool(0);
+
+    size_t numVisited = 0;
+    threadPool.ParallelFor(0, 1000, 1, [&](size_t begin, size_t end)
+                           {
+                               numVisited += end - begin;
+                           });
+
+    EXPECT_EQ(1000u, numVisited);
+}
@@ -0,0 +1,121 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "engine/entity/ComponentManager.h"
+
+/**
+ * Component manager of integers, for testing.
+ */
+class ComponentManagerTestManager : public ds::ComponentManager<int>
+{
+public:
+    void SetValue(ds::Instance i, int value)
+    {
+        m_data.component[i.index] = value;
+    }
+
+    int GetValue(ds::Instance i) const
+    {
+        return m_data.component[i.index];
+    }
+};
+
+/**
+ * Create an entity with the given index and generation.
+ */
+static ds::Entity ComponentManagerTestEntity(unsigned int index,
+                                             unsigned int generation = 0)
+{
+    ds::Entity entity;
+    entity.id = (generation << ds::Entity::ENTITY_INDEX_BITS) | index;
+
+    return entity;
+}
+
+// Components should be found by the entity they were created for
+TEST(ComponentManager, CreateAndLookup)
+{
+    ComponentManagerTestManager manager;
+
+    ds::Instance a =
+        manager.CreateComponentForEntity(ComponentManagerTestEntity(5));
+    ds::Instance b =
+        manager.CreateComponentForEntity(ComponentManagerTestEntity(1));
+
+    EXPECT_EQ(2u, manager.GetNumInstances());
+    EXPECT_EQ(a, manager.GetInstanceForEntity(ComponentManagerTestEntity(5)));
+    EXPECT_EQ(b, manager.GetInstanceForEntity(ComponentManagerTestEntity(1)));
+    EXPECT_EQ(5u, manager.GetEntityForInstance(a).GetIndex());
+
+    // No component for other entities or other generations of the entity
+    EXPECT_FALSE(
+        manager.GetInstanceForEntity(ComponentManagerTestEntity(2)).IsValid());
+    EXPECT_FALSE(manager.GetInstanceForEntity(ComponentManagerTestEntity(5, 1))
+                     .IsValid());
+}
+
+// Removing a component should move the last component into it's place
+TEST(ComponentManager, Remove)
+{
+    ComponentManagerTestManager manager;
+
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        ds::Instance instance =
+            manager.CreateComponentForEntity(ComponentManagerTestEntity(i));
+        manager.SetValue(instance, i * 10);
+    }
+
+    EXPECT_TRUE(manager.RemoveInstance(
+        manager.GetInstanceForEntity(ComponentManagerTestEntity(1))));
+    EXPECT_FALSE(manager.RemoveInstance(ds::Instance::MakeInstance(3)));
+
+    EXPECT_EQ(3u, manager.GetNumInstances());
+    EXPECT_FALSE(
+        manager.GetInstanceForEntity(ComponentManagerTestEntity(1)).IsValid());
+    for (unsigned int i : {0u, 2u, 3u})
+    {
+        ds::Instance instance =
+            manager.GetInstanceForEntity(ComponentManagerTestEntity(i));
+        ASSERT_TRUE(instance.IsValid());
+        EXPECT_EQ((int)i * 10, manager.GetValue(instance));
+    }
+}
+
+// Removing several components at once should remove exactly those components
+TEST(ComponentManager, RemoveInstances)
+{
+    ComponentManagerTestManager manager;
+
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        ds::Instance instance =
+            manager.CreateComponentForEntity(ComponentManagerTestEntity(i));
+        manager.SetValue(instance, i);
+    }
+
+    std::vector<ds::Instance> toRemove;
+    for (unsigned int i : {9u, 0u, 4u, 5u, 4u})
+    {
+        toRemove.push_back(
+            manager.GetInstanceForEntity(ComponentManagerTestEntity(i)));
+    }
+    toRemove.push_back(ds::Instance::MakeInvalidInstance());
+
+    EXPECT_EQ(4u, manager.RemoveInstances(toRemove));
+    EXPECT_EQ(6u, manager.GetNumInstances());
+
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        ds::Instance instance =
+            manager.GetInstanceForEntity(ComponentManagerTestEntity(i));
+        bool removed = (i == 0 || i == 4 || i == 5 || i == 9);
+
+        EXPECT_EQ(!removed, instance.IsValid());
+        if (instance.IsValid())
+        {
+            EXPECT_EQ((int)i, manager.GetValue(instance));
+        }
+    }
+}
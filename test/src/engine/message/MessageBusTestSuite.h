@@ -0,0 +1,177 @@
+#include "gtest/gtest.h"
+
+#include "engine/message/MessageBus.h"
+#include "engine/message/MessageHelper.h"
+
+/**
+ * System that just stores the messages posted to it.
+ */
+class MessageBusTestSystem : public ds::ISystem
+{
+public:
+    MessageBusTestSystem(const std::vector<ds_msg::MessageType> &subscriptions)
+        : m_subscriptions(subscriptions)
+    {
+    }
+
+    virtual bool Initialize(const ds::Config &config)
+    {
+        return true;
+    }
+
+    virtual void Update(float deltaTime)
+    {
+    }
+
+    virtual void Shutdown()
+    {
+    }
+
+    virtual void PostMessages(const ds_msg::MessageStream &messages)
+    {
+        AppendStreamBuffer(m_messagesReceived, messages);
+    }
+
+    virtual ds_msg::MessageStream CollectMessages()
+    {
+        ds_msg::MessageStream tmp = m_messagesGenerated;
+
+        m_messagesGenerated.Clear();
+
+        return tmp;
+    }
+
+    virtual std::vector<ds_msg::MessageType> GetMessageSubscriptions() const
+    {
+        return m_subscriptions;
+    }
+
+    std::vector<ds_msg::MessageType> ReceivedMessageTypes()
+    {
+        std::vector<ds_msg::MessageType> types;
+
+        while (m_messagesReceived.AvailableBytes() != 0)
+        {
+            ds_msg::MessageHeader header;
+            m_messagesReceived >> header;
+            m_messagesReceived.Extract(header.size);
+
+            types.push_back(header.type);
+        }
+
+        return types;
+    }
+
+    std::vector<ds_msg::MessageType> m_subscriptions;
+    ds_msg::MessageStream m_messagesGenerated, m_messagesReceived;
+};
+
+/**
+ * Create a message bus with the given systems added and subscribed.
+ */
+static void SetupMessageBus(
+    ds::MessageBus *bus,
+    const std::vector<std::shared_ptr<MessageBusTestSystem>> &systems)
+{
+    for (auto system : systems)
+    {
+        bus->AddSystem(system);
+
+        for (auto messageType : system->GetMessageSubscriptions())
+        {
+            bus->Subscribe(system, messageType);
+        }
+    }
+}
+
+/**
+ * Build a stream containing a quit event, a console toggle and another quit
+ * event.
+ */
+static ds_msg::MessageStream BuildMessageBusTestStream()
+{
+    ds_msg::MessageStream stream;
+
+    ds_msg::QuitEvent quitEvent;
+    ds_msg::ConsoleToggle consoleToggle;
+    ds_msg::AppendMessage(&stream, ds_msg::MessageType::QuitEvent,
+                          sizeof(ds_msg::QuitEvent), &quitEvent);
+    ds_msg::AppendMessage(&stream, ds_msg::MessageType::ConsoleToggle,
+                          sizeof(ds_msg::ConsoleToggle), &consoleToggle);
+    ds_msg::AppendMessage(&stream, ds_msg::MessageType::QuitEvent,
+                          sizeof(ds_msg::QuitEvent), &quitEvent);
+
+    return stream;
+}
+
+TEST(MessageBus, SubscribeFailsForUnknownSystem)
+{
+    ds::MessageBus bus;
+    std::shared_ptr<MessageBusTestSystem> system(
+        new MessageBusTestSystem(std::vector<ds_msg::MessageType>()));
+
+    EXPECT_EQ(false, bus.Subscribe(system, ds_msg::MessageType::QuitEvent));
+}
+
+TEST(MessageBus, UnsubscribedSystemReceivesAllMessages)
+{
+    ds::MessageBus bus;
+    std::shared_ptr<MessageBusTestSystem> system(
+        new MessageBusTestSystem(std::vector<ds_msg::MessageType>()));
+    SetupMessageBus(&bus, {system});
+
+    bus.PostMessages(BuildMessageBusTestStream());
+    bus.BroadcastAllMessages();
+
+    std::vector<ds_msg::MessageType> received = system->ReceivedMessageTypes();
+    ASSERT_EQ(3, received.size());
+    EXPECT_EQ(ds_msg::MessageType::QuitEvent, received[0]);
+    EXPECT_EQ(ds_msg::MessageType::ConsoleToggle, received[1]);
+    EXPECT_EQ(ds_msg::MessageType::QuitEvent, received[2]);
+}
+
+TEST(MessageBus, SubscribedSystemOnlyReceivesSubscribedMessages)
+{
+    ds::MessageBus bus;
+    std::shared_ptr<MessageBusTestSystem> quitSystem(new MessageBusTestSystem(
+        std::vector<ds_msg::MessageType>(1, ds_msg::MessageType::QuitEvent)));
+    std::shared_ptr<MessageBusTestSystem> toggleSystem(
+        new MessageBusTestSystem(std::vector<ds_msg::MessageType>(
+            1, ds_msg::MessageType::ConsoleToggle)));
+    std::shared_ptr<MessageBusTestSystem> allSystem(
+        new MessageBusTestSystem(std::vector<ds_msg::MessageType>()));
+    SetupMessageBus(&bus, {quitSystem, toggleSystem, allSystem});
+
+    bus.PostMessages(BuildMessageBusTestStream());
+    bus.BroadcastAllMessages();
+
+    std::vector<ds_msg::MessageType> received =
+        quitSystem->ReceivedMessageTypes();
+    ASSERT_EQ(2, received.size());
+    EXPECT_EQ(ds_msg::MessageType::QuitEvent, received[0]);
+    EXPECT_EQ(ds_msg::MessageType::QuitEvent, received[1]);
+
+    received = toggleSystem->ReceivedMessageTypes();
+    ASSERT_EQ(1, received.size());
+    EXPECT_EQ(ds_msg::MessageType::ConsoleToggle, received[0]);
+
+    received = allSystem->ReceivedMessageTypes();
+    EXPECT_EQ(3, received.size());
+}
+
+TEST(MessageBus, CollectMessagesOfType)
+{
+    ds::MessageBus bus;
+
+    bus.PostMessages(BuildMessageBusTestStream());
+
+    std::vector<ds_msg::MessageType> messageTypes;
+    messageTypes.push_back(ds_msg::MessageType::ConsoleToggle);
+    ds_msg::MessageStream collected = bus.CollectMessages(messageTypes);
+
+    ds_msg::MessageHeader header;
+    collected >> header;
+    EXPECT_EQ(ds_msg::MessageType::ConsoleToggle, header.type);
+    EXPECT_EQ(true, collected.Extract(header.size));
+    EXPECT_EQ(0, collected.AvailableBytes());
+}
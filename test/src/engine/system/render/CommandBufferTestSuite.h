@@ -0,0 +1,120 @@
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "engine/system/render/CommandBuffer.h"
+#include "engine/system/render/RecordingRenderer.h"
+#include "math/Matrix4.h"
+
+/**
+ * Record drawing a mesh at each of the given translations along x, updating
+ * the model matrix before each draw.
+ */
+static void RecordCommandBufferTestFrame(unsigned int program,
+                                         unsigned int firstTranslation,
+                                         unsigned int numTranslations,
+                                         ds_render::CommandBuffer *commands)
+{
+    ds_render::ConstantBufferDescription objectBufferDescription(
+        sizeof(ds_math::Matrix4));
+    ds_render::ConstantBufferDescription::Member modelMatrix;
+    modelMatrix.offset = 0;
+
+    commands->SetProgram(ds_render::ProgramHandle(program, 0, 0));
+    commands->BindTextureToSampler(ds_render::ProgramHandle(program, 0, 0),
+                                   "diffuse",
+                                   ds_render::TextureHandle(1, 0, 0));
+    for (unsigned int i = 0; i < numTranslations; ++i)
+    {
+        ds_math::Matrix4 transform = ds_math::Matrix4::CreateTranslationMatrix(
+            (float)(firstTranslation + i), 0.0f, 0.0f);
+        objectBufferDescription.InsertMemberData(
+            modelMatrix, sizeof(ds_math::Matrix4), &transform);
+        commands->UpdateConstantBufferData(ds_render::ConstantBufferHandle(),
+                                           objectBufferDescription);
+        commands->DrawVerticesIndexed(ds_render::VertexBufferHandle(1, 0, 0),
+                                      ds_render::IndexBufferHandle(1, 0, 0),
+                                      ds_render::PrimitiveType::TriangleStrip,
+                                      0, 3);
+    }
+    commands->UnbindTextureFromSampler(ds_render::TextureHandle(1, 0, 0));
+}
+
+// Executing should make the operations recorded, in order, with the data they
+// were recorded with even though it has since changed
+TEST(CommandBuffer, Execute)
+{
+    ds_render::CommandBuffer commands;
+    RecordCommandBufferTestFrame(1, 0, 10, &commands);
+    EXPECT_EQ(2u + 2 * 10 + 1, commands.GetNumCommands());
+
+    mock_renderer::RecordingRenderer renderer;
+    commands.Execute(&renderer);
+
+    EXPECT_EQ(1u, renderer.numSetProgram);
+    EXPECT_EQ(1u, renderer.numBindTexture);
+    EXPECT_EQ(10u, renderer.numUpdateConstantBuffer);
+    ASSERT_EQ(10u, renderer.draws.size());
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        const mock_renderer::RecordingRenderer::Draw &draw = renderer.draws[i];
+        EXPECT_EQ(ds_render::ProgramHandle(1, 0, 0), draw.program);
+        EXPECT_EQ(ds_render::VertexBufferHandle(1, 0, 0), draw.vertexBuffer);
+
+        const ds_math::Matrix4 &modelMatrix =
+            *(const ds_math::Matrix4 *)&draw.constantBufferData[0];
+        EXPECT_EQ(ds_math::Matrix4::CreateTranslationMatrix((float)i, 0.0f,
+                                                            0.0f),
+                  modelMatrix);
+    }
+
+    // Commands are kept after executing, until cleared
+    mock_renderer::RecordingRenderer again;
+    commands.Execute(&again);
+    EXPECT_EQ(10u, again.draws.size());
+
+    commands.Clear();
+    EXPECT_EQ(0u, commands.GetNumCommands());
+    EXPECT_EQ(0u, commands.GetNumBytes());
+}
+
+// Command buffers recorded on different threads should draw the whole frame
+// when executed one after another
+TEST(CommandBuffer, RecordOnThreads)
+{
+    const unsigned int numThreads = 4;
+    const unsigned int numPerThread = 100;
+
+    std::vector<ds_render::CommandBuffer> commands(numThreads);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < numThreads; ++i)
+    {
+        threads.push_back(std::thread(RecordCommandBufferTestFrame, i + 1,
+                                      i * numPerThread, numPerThread,
+                                      &commands[i]));
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    mock_renderer::RecordingRenderer renderer;
+    for (const ds_render::CommandBuffer &threadCommands : commands)
+    {
+        threadCommands.Execute(&renderer);
+    }
+
+    EXPECT_EQ(numThreads, renderer.numSetProgram);
+    ASSERT_EQ(numThreads * numPerThread, renderer.draws.size());
+    for (unsigned int i = 0; i < renderer.draws.size(); ++i)
+    {
+        const mock_renderer::RecordingRenderer::Draw &draw = renderer.draws[i];
+        EXPECT_EQ(ds_render::ProgramHandle(i / numPerThread + 1, 0, 0),
+                  draw.program);
+
+        const ds_math::Matrix4 &modelMatrix =
+            *(const ds_math::Matrix4 *)&draw.constantBufferData[0];
+        EXPECT_EQ((float)i, modelMatrix.data[3].x);
+    }
+}
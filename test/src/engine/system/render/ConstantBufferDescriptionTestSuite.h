@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+
+#include "engine/system/render/ConstantBufferDescription.h"
+#include "math/Matrix4.h"
+
+// Members found once should write to the same place as writing by name
+TEST(ConstantBufferDescription, GetMember)
+{
+    ds_render::ConstantBufferDescription description(
+        2 * sizeof(ds_math::Matrix4));
+    description.AddMember("Scene.viewMatrix");
+    description.AddMember("Scene.projectionMatrix");
+    description.SetMemberOffset("Scene.viewMatrix", 0);
+    description.SetMemberOffset("Scene.projectionMatrix",
+                                sizeof(ds_math::Matrix4));
+
+    ds_render::ConstantBufferDescription::Member projection;
+    ASSERT_TRUE(description.GetMember("Scene.projectionMatrix", &projection));
+    EXPECT_EQ(sizeof(ds_math::Matrix4), projection.offset);
+
+    ds_math::Matrix4 byName = ds_math::Matrix4::CreateTranslationMatrix(
+        1.0f, 2.0f, 3.0f);
+    ds_math::Matrix4 byMember = ds_math::Matrix4::CreateScaleMatrix(
+        2.0f, 2.0f, 2.0f);
+    description.InsertMemberData("Scene.viewMatrix", sizeof(ds_math::Matrix4),
+                                 &byName);
+    description.InsertMemberData(projection, sizeof(ds_math::Matrix4),
+                                 &byMember);
+
+    const ds_math::Matrix4 *data =
+        (const ds_math::Matrix4 *)description.GetDataPtr();
+    EXPECT_EQ(byName, data[0]);
+    EXPECT_EQ(byMember, data[1]);
+
+    // Unknown members, and members the renderer gave no offset, aren't found
+    ds_render::ConstantBufferDescription::Member missing = projection;
+    EXPECT_FALSE(description.GetMember("Scene.modelMatrix", &missing));
+    description.AddMember("Scene.unused");
+    EXPECT_FALSE(description.GetMember("Scene.unused", &missing));
+    EXPECT_EQ(projection.offset, missing.offset);
+}
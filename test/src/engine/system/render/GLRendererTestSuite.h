@@ -0,0 +1,499 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "engine/system/render/GLRenderer.h"
+
+/**
+ * Mock OpenGL backend for the GLEW entry points used by streaming constant
+ * buffers, programs and draws. Buffer storage is kept in memory and fences
+ * are only numbered, so what the renderer maps, fences and waits for can be
+ * checked without a graphics context. State changes are counted.
+ *
+ * Programs all have one sampler, "diffuse", and one uniform block, "Object".
+ */
+namespace mock_gl
+{
+/**
+ * A call to glMapBufferRange.
+ */
+struct Map
+{
+    GLintptr offset;
+    GLsizeiptr length;
+    GLbitfield access;
+};
+
+static GLuint g_nextName;
+static std::vector<char> g_storage;
+static std::vector<GLsizeiptr> g_bufferDataSizes;
+static std::vector<Map> g_maps;
+static intptr_t g_nextFence;
+static std::vector<intptr_t> g_waits;
+static std::vector<intptr_t> g_deletedFences;
+static GLintptr g_boundRangeOffset;
+static GLsizeiptr g_boundRangeSize;
+static unsigned int g_numUseProgram;
+static unsigned int g_numBindVertexArray;
+static unsigned int g_numBindElementArrayBuffer;
+static unsigned int g_numBindBufferRange;
+static unsigned int g_numUniformBlockBinding;
+static unsigned int g_numGetUniformLocation;
+static unsigned int g_numGetUniformBlockIndex;
+static unsigned int g_numDraws;
+
+static void GLAPIENTRY GenBuffers(GLsizei n, GLuint *buffers)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        buffers[i] = g_nextName++;
+    }
+}
+
+static void GLAPIENTRY GenVertexArrays(GLsizei n, GLuint *arrays)
+{
+    GenBuffers(n, arrays);
+}
+
+static void GLAPIENTRY BindBuffer(GLenum target, GLuint buffer)
+{
+    if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        ++g_numBindElementArrayBuffer;
+    }
+}
+
+static void GLAPIENTRY BindVertexArray(GLuint array)
+{
+    ++g_numBindVertexArray;
+}
+
+static void GLAPIENTRY EnableVertexAttribArray(GLuint index)
+{
+}
+
+static void GLAPIENTRY VertexAttribPointer(GLuint index,
+                                           GLint size,
+                                           GLenum type,
+                                           GLboolean normalized,
+                                           GLsizei stride,
+                                           const void *pointer)
+{
+}
+
+static void GLAPIENTRY BindBufferBase(GLenum target,
+                                      GLuint index,
+                                      GLuint buffer)
+{
+}
+
+static void GLAPIENTRY BindBufferRange(GLenum target,
+                                       GLuint index,
+                                       GLuint buffer,
+                                       GLintptr offset,
+                                       GLsizeiptr size)
+{
+    g_boundRangeOffset = offset;
+    g_boundRangeSize = size;
+    ++g_numBindBufferRange;
+}
+
+static void GLAPIENTRY BufferData(GLenum target,
+                                  GLsizeiptr size,
+                                  const void *data,
+                                  GLenum usage)
+{
+    g_storage.assign(size, 0);
+    g_bufferDataSizes.push_back(size);
+}
+
+static void *GLAPIENTRY MapBufferRange(GLenum target,
+                                       GLintptr offset,
+                                       GLsizeiptr length,
+                                       GLbitfield access)
+{
+    Map map;
+    map.offset = offset;
+    map.length = length;
+    map.access = access;
+    g_maps.push_back(map);
+
+    return &g_storage[offset];
+}
+
+static GLboolean GLAPIENTRY UnmapBuffer(GLenum target)
+{
+    return GL_TRUE;
+}
+
+static GLsync GLAPIENTRY FenceSync(GLenum condition, GLbitfield flags)
+{
+    return (GLsync)g_nextFence++;
+}
+
+static GLenum GLAPIENTRY ClientWaitSync(GLsync sync,
+                                        GLbitfield flags,
+                                        GLuint64 timeout)
+{
+    g_waits.push_back((intptr_t)sync);
+    return GL_CONDITION_SATISFIED;
+}
+
+static void GLAPIENTRY DeleteSync(GLsync sync)
+{
+    g_deletedFences.push_back((intptr_t)sync);
+}
+
+static GLuint GLAPIENTRY CreateShader(GLenum type)
+{
+    return g_nextName++;
+}
+
+static void GLAPIENTRY ShaderSource(GLuint shader,
+                                    GLsizei count,
+                                    const GLchar *const *string,
+                                    const GLint *length)
+{
+}
+
+static void GLAPIENTRY CompileShader(GLuint shader)
+{
+}
+
+static void GLAPIENTRY GetShaderiv(GLuint shader, GLenum pname, GLint *param)
+{
+    *param = GL_TRUE;
+}
+
+static GLuint GLAPIENTRY CreateProgram()
+{
+    return g_nextName++;
+}
+
+static void GLAPIENTRY AttachShader(GLuint program, GLuint shader)
+{
+}
+
+static void GLAPIENTRY LinkProgram(GLuint program)
+{
+}
+
+static void GLAPIENTRY GetProgramiv(GLuint program, GLenum pname, GLint *param)
+{
+    switch (pname)
+    {
+    case GL_ACTIVE_UNIFORMS:
+    case GL_ACTIVE_UNIFORM_BLOCKS:
+        *param = 1;
+        break;
+    case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+    case GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH:
+        *param = 16;
+        break;
+    default:
+        *param = GL_TRUE;
+        break;
+    }
+}
+
+static void GLAPIENTRY GetActiveUniform(GLuint program,
+                                        GLuint index,
+                                        GLsizei bufSize,
+                                        GLsizei *length,
+                                        GLint *size,
+                                        GLenum *type,
+                                        GLchar *name)
+{
+    strcpy(name, "diffuse");
+    *length = strlen(name);
+    *size = 1;
+    *type = GL_SAMPLER_2D;
+}
+
+static GLint GLAPIENTRY GetUniformLocation(GLuint program, const GLchar *name)
+{
+    ++g_numGetUniformLocation;
+    return (strcmp(name, "diffuse") == 0 ? 3 : -1);
+}
+
+static void GLAPIENTRY GetActiveUniformBlockName(GLuint program,
+                                                 GLuint uniformBlockIndex,
+                                                 GLsizei bufSize,
+                                                 GLsizei *length,
+                                                 GLchar *uniformBlockName)
+{
+    strcpy(uniformBlockName, "Object");
+    *length = strlen(uniformBlockName);
+}
+
+static GLuint GLAPIENTRY GetUniformBlockIndex(GLuint program,
+                                              const GLchar *uniformBlockName)
+{
+    ++g_numGetUniformBlockIndex;
+    return 0;
+}
+
+static void GLAPIENTRY UniformBlockBinding(GLuint program,
+                                           GLuint uniformBlockIndex,
+                                           GLuint uniformBlockBinding)
+{
+    ++g_numUniformBlockBinding;
+}
+
+static void GLAPIENTRY UseProgram(GLuint program)
+{
+    ++g_numUseProgram;
+}
+
+static void GLAPIENTRY DrawElementsInstanced(GLenum mode,
+                                             GLsizei count,
+                                             GLenum type,
+                                             const void *indices,
+                                             GLsizei primcount)
+{
+    ++g_numDraws;
+}
+
+/**
+ * Forget the state changes counted so far.
+ */
+static void ResetCounts()
+{
+    g_numUseProgram = 0;
+    g_numBindVertexArray = 0;
+    g_numBindElementArrayBuffer = 0;
+    g_numBindBufferRange = 0;
+    g_numUniformBlockBinding = 0;
+    g_numGetUniformLocation = 0;
+    g_numGetUniformBlockIndex = 0;
+    g_numDraws = 0;
+}
+
+/**
+ * Point the GLEW entry points at the mock backend and forget any calls made
+ * to it before.
+ */
+static void Install()
+{
+    g_nextName = 1;
+    g_storage.clear();
+    g_bufferDataSizes.clear();
+    g_maps.clear();
+    g_nextFence = 1;
+    g_waits.clear();
+    g_deletedFences.clear();
+    g_boundRangeOffset = 0;
+    g_boundRangeSize = 0;
+    ResetCounts();
+
+    glGenBuffers = GenBuffers;
+    glGenVertexArrays = GenVertexArrays;
+    glBindBuffer = BindBuffer;
+    glBindVertexArray = BindVertexArray;
+    glEnableVertexAttribArray = EnableVertexAttribArray;
+    glVertexAttribPointer = VertexAttribPointer;
+    glBindBufferBase = BindBufferBase;
+    glBindBufferRange = BindBufferRange;
+    glBufferData = BufferData;
+    glMapBufferRange = MapBufferRange;
+    glUnmapBuffer = UnmapBuffer;
+    glFenceSync = FenceSync;
+    glClientWaitSync = ClientWaitSync;
+    glDeleteSync = DeleteSync;
+    glCreateShader = CreateShader;
+    glShaderSource = ShaderSource;
+    glCompileShader = CompileShader;
+    glGetShaderiv = GetShaderiv;
+    glCreateProgram = CreateProgram;
+    glAttachShader = AttachShader;
+    glLinkProgram = LinkProgram;
+    glGetProgramiv = GetProgramiv;
+    glGetActiveUniform = GetActiveUniform;
+    glGetUniformLocation = GetUniformLocation;
+    glGetActiveUniformBlockName = GetActiveUniformBlockName;
+    glGetUniformBlockIndex = GetUniformBlockIndex;
+    glUniformBlockBinding = UniformBlockBinding;
+    glUseProgram = UseProgram;
+    glDrawElementsInstanced = DrawElementsInstanced;
+}
+}
+
+// Writes should go round the buffer at aligned offsets, through unsynchronized
+// maps, only waiting for the older write they overwrite once they wrap
+TEST(GLRenderer, WriteStreamingConstantBuffer)
+{
+    mock_gl::Install();
+
+    ds_render::GLRenderer renderer;
+    ds_render::ConstantBufferHandle handle =
+        renderer.CreateStreamingConstantBuffer(1024);
+    const size_t alignment = renderer.GetConstantBufferOffsetAlignment();
+
+    std::vector<char> data(100);
+    size_t offsets[5];
+    for (unsigned int i = 0; i < 5; ++i)
+    {
+        std::fill(data.begin(), data.end(), (char)(i + 1));
+        ASSERT_TRUE(renderer.WriteStreamingConstantBuffer(
+            handle, data.size(), &data[0], &offsets[i]));
+        EXPECT_EQ(0u, offsets[i] % alignment);
+    }
+
+    // 4 writes fit before the end, the 5th wraps over the 1st
+    EXPECT_EQ(0u, offsets[0]);
+    EXPECT_LT(offsets[0], offsets[1]);
+    EXPECT_LT(offsets[2], offsets[3]);
+    EXPECT_EQ(0u, offsets[4]);
+
+    // The 1st write is only waited for when overwritten, and no others are
+    ASSERT_EQ(1u, mock_gl::g_waits.size());
+    EXPECT_EQ(1, mock_gl::g_waits[0]);
+    ASSERT_EQ(1u, mock_gl::g_deletedFences.size());
+    EXPECT_EQ(1, mock_gl::g_deletedFences[0]);
+
+    ASSERT_EQ(5u, mock_gl::g_maps.size());
+    for (const mock_gl::Map &map : mock_gl::g_maps)
+    {
+        EXPECT_EQ(100, map.length);
+        EXPECT_NE(0u, map.access & GL_MAP_UNSYNCHRONIZED_BIT);
+    }
+    EXPECT_EQ(5, mock_gl::g_storage[0]);
+    EXPECT_EQ(4, mock_gl::g_storage[offsets[3]]);
+}
+
+// A write bigger than the buffer should replace the storage rather than wait
+// for anything
+TEST(GLRenderer, WriteStreamingConstantBufferGrows)
+{
+    mock_gl::Install();
+
+    ds_render::GLRenderer renderer;
+    ds_render::ConstantBufferHandle handle =
+        renderer.CreateStreamingConstantBuffer(1024);
+
+    std::vector<char> data(2000, 1);
+    size_t offset = 0;
+    ASSERT_TRUE(renderer.WriteStreamingConstantBuffer(handle, 100, &data[0],
+                                                      &offset));
+    ASSERT_TRUE(renderer.WriteStreamingConstantBuffer(handle, data.size(),
+                                                      &data[0], &offset));
+
+    EXPECT_EQ(0u, offset);
+    ASSERT_EQ(2u, mock_gl::g_bufferDataSizes.size());
+    EXPECT_LE((GLsizeiptr)data.size(), mock_gl::g_bufferDataSizes[1]);
+    EXPECT_TRUE(mock_gl::g_waits.empty());
+    EXPECT_EQ(1u, mock_gl::g_deletedFences.size());
+}
+
+// Binding a range should bind it at the buffer's binding point
+TEST(GLRenderer, BindConstantBufferRange)
+{
+    mock_gl::Install();
+
+    ds_render::GLRenderer renderer;
+    ds_render::ConstantBufferHandle handle =
+        renderer.CreateStreamingConstantBuffer(1024);
+
+    renderer.BindConstantBufferRange(handle, 512, 64);
+    EXPECT_EQ(512, mock_gl::g_boundRangeOffset);
+    EXPECT_EQ(64, mock_gl::g_boundRangeSize);
+}
+
+/**
+ * Create a program and a mesh of a triangle.
+ */
+static void CreateGLRendererTestObjects(ds_render::GLRenderer *renderer,
+                                        ds_render::ProgramHandle *program,
+                                        ds_render::VertexBufferHandle *vertices,
+                                        ds_render::IndexBufferHandle *indices)
+{
+    const char *source = "void main() {}";
+    std::vector<ds_render::ShaderHandle> shaders;
+    shaders.push_back(renderer->CreateShaderObject(
+        ds_render::ShaderType::VertexShader, strlen(source), source));
+    *program = renderer->CreateProgram(shaders);
+
+    ds_render::VertexBufferDescription::AttributeDescription position;
+    position.attributeType = ds_render::AttributeType::Position;
+    position.attributeDataType = ds_render::RenderDataType::Float;
+    position.numElementsPerAttribute = 3;
+    position.stride = 0;
+    position.offset = 0;
+    position.normalized = false;
+    ds_render::VertexBufferDescription description;
+    description.AddAttributeDescription(position);
+
+    std::vector<float> vertexData(9, 0.0f);
+    std::vector<unsigned int> indexData = {0, 1, 2};
+    *vertices = renderer->CreateVertexBuffer(
+        ds_render::BufferUsageType::Static, description,
+        vertexData.size() * sizeof(float), &vertexData[0]);
+    *indices = renderer->CreateIndexBuffer(
+        ds_render::BufferUsageType::Static,
+        indexData.size() * sizeof(unsigned int), &indexData[0]);
+}
+
+// Setting state that is already set should make no OpenGL calls
+TEST(GLRenderer, SkipRedundantState)
+{
+    mock_gl::Install();
+
+    ds_render::GLRenderer renderer;
+    ds_render::ProgramHandle program;
+    ds_render::VertexBufferHandle vertices;
+    ds_render::IndexBufferHandle indices;
+    CreateGLRendererTestObjects(&renderer, &program, &vertices, &indices);
+    ds_render::ConstantBufferHandle objectBuffer =
+        renderer.CreateStreamingConstantBuffer(1024);
+
+    mock_gl::ResetCounts();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        renderer.SetProgram(program);
+        renderer.BindConstantBuffer(program, "Object", objectBuffer);
+        renderer.BindConstantBufferRange(objectBuffer, 256, 64);
+        renderer.DrawVerticesIndexedInstanced(
+            vertices, indices, ds_render::PrimitiveType::Triangles, 0, 3, 1);
+    }
+
+    EXPECT_EQ(3u, mock_gl::g_numDraws);
+    EXPECT_EQ(1u, mock_gl::g_numUseProgram);
+    EXPECT_EQ(1u, mock_gl::g_numUniformBlockBinding);
+    EXPECT_EQ(1u, mock_gl::g_numBindBufferRange);
+    EXPECT_EQ(1u, mock_gl::g_numBindVertexArray);
+    EXPECT_EQ(1u, mock_gl::g_numBindElementArrayBuffer);
+
+    // Uniform blocks were found when the program was linked
+    EXPECT_EQ(0u, mock_gl::g_numGetUniformBlockIndex);
+}
+
+// Each vertex array keeps the index buffer bound to it, so switching back to
+// a vertex array shouldn't bind it's index buffer again
+TEST(GLRenderer, IndexBufferFollowsVertexArray)
+{
+    mock_gl::Install();
+
+    ds_render::GLRenderer renderer;
+    ds_render::ProgramHandle program;
+    ds_render::VertexBufferHandle vertices[2];
+    ds_render::IndexBufferHandle indices[2];
+    CreateGLRendererTestObjects(&renderer, &program, &vertices[0],
+                                &indices[0]);
+    CreateGLRendererTestObjects(&renderer, &program, &vertices[1],
+                                &indices[1]);
+
+    mock_gl::ResetCounts();
+    const unsigned int meshes[] = {0, 1, 0, 0, 1};
+    for (unsigned int mesh : meshes)
+    {
+        renderer.DrawVerticesIndexedInstanced(
+            vertices[mesh], indices[mesh], ds_render::PrimitiveType::Triangles,
+            0, 3, 1);
+    }
+
+    EXPECT_EQ(5u, mock_gl::g_numDraws);
+    EXPECT_EQ(4u, mock_gl::g_numBindVertexArray);
+    EXPECT_EQ(2u, mock_gl::g_numBindElementArrayBuffer);
+}
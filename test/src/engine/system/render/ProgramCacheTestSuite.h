@@ -0,0 +1,127 @@
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "engine/system/render/ProgramCache.h"
+#include "engine/system/render/RecordingRenderer.h"
+
+/**
+ * Shaders of a program, a vertex and a fragment shader with the given
+ * fragment shader source.
+ */
+static std::vector<ds_render::ProgramCache::ShaderSource>
+ProgramCacheTestSources(const std::string &fragmentSource)
+{
+    std::vector<ds_render::ProgramCache::ShaderSource> shaderSources(2);
+    shaderSources[0].type = ds_render::ShaderType::VertexShader;
+    shaderSources[0].source = "void main() { gl_Position = vec4(0.0); }";
+    shaderSources[1].type = ds_render::ShaderType::FragmentShader;
+    shaderSources[1].source = fragmentSource;
+
+    return shaderSources;
+}
+
+// Programs with the same shaders should be compiled once and shared
+TEST(ProgramCache, SharesIdenticalPrograms)
+{
+    mock_renderer::RecordingRenderer renderer;
+    ds_render::ProgramCache cache;
+
+    ds_render::ProgramHandle red =
+        cache.GetProgram(&renderer, ProgramCacheTestSources("red"));
+    ds_render::ProgramHandle blue =
+        cache.GetProgram(&renderer, ProgramCacheTestSources("blue"));
+    ds_render::ProgramHandle redAgain =
+        cache.GetProgram(&renderer, ProgramCacheTestSources("red"));
+
+    EXPECT_EQ(red, redAgain);
+    EXPECT_NE(red, blue);
+    EXPECT_EQ(2u, renderer.numCreateProgram);
+    EXPECT_EQ(4u, renderer.numCreateShaderObject);
+
+    EXPECT_EQ(3u, cache.GetStatistics().numRequests);
+    EXPECT_EQ(2u, cache.GetStatistics().numCompiled);
+    EXPECT_EQ(0u, cache.GetStatistics().numCreatedFromBinary);
+
+    // Shaders of a different type are a different program
+    std::vector<ds_render::ProgramCache::ShaderSource> swapped =
+        ProgramCacheTestSources("red");
+    std::swap(swapped[0].type, swapped[1].type);
+    EXPECT_NE(ds_render::ProgramCache::HashShaderSources(
+                  ProgramCacheTestSources("red")),
+              ds_render::ProgramCache::HashShaderSources(swapped));
+}
+
+// Programs whose binaries were saved should be created from them on the next
+// run, unless the binary no longer works
+TEST(ProgramCache, SaveAndLoadBinaries)
+{
+    const char *filePath = "ProgramCacheTest.bin";
+
+    mock_renderer::RecordingRenderer coldRenderer;
+    coldRenderer.supportsProgramBinaries = true;
+    ds_render::ProgramCache coldCache;
+    coldCache.GetProgram(&coldRenderer, ProgramCacheTestSources("red"));
+    coldCache.GetProgram(&coldRenderer, ProgramCacheTestSources("blue"));
+    ASSERT_TRUE(coldCache.SaveBinaries(filePath));
+
+    mock_renderer::RecordingRenderer warmRenderer;
+    warmRenderer.supportsProgramBinaries = true;
+    ds_render::ProgramCache warmCache;
+    ASSERT_TRUE(warmCache.LoadBinaries(filePath));
+    ds_render::ProgramHandle red =
+        warmCache.GetProgram(&warmRenderer, ProgramCacheTestSources("red"));
+    warmCache.GetProgram(&warmRenderer, ProgramCacheTestSources("blue"));
+    warmCache.GetProgram(&warmRenderer, ProgramCacheTestSources("green"));
+
+    EXPECT_NE(ds_render::ProgramHandle(), red);
+    EXPECT_EQ(2u, warmRenderer.numCreateProgramFromBinary);
+    EXPECT_EQ(1u, warmRenderer.numCreateProgram);
+    EXPECT_EQ(2u, warmCache.GetStatistics().numCreatedFromBinary);
+    EXPECT_EQ(1u, warmCache.GetStatistics().numCompiled);
+
+    // A driver that can't use the binaries compiles from source instead
+    mock_renderer::RecordingRenderer newDriverRenderer;
+    ds_render::ProgramCache newDriverCache;
+    ASSERT_TRUE(newDriverCache.LoadBinaries(filePath));
+    EXPECT_NE(ds_render::ProgramHandle(),
+              newDriverCache.GetProgram(&newDriverRenderer,
+                                        ProgramCacheTestSources("red")));
+    EXPECT_EQ(1u, newDriverRenderer.numCreateProgram);
+
+    std::remove(filePath);
+
+    ds_render::ProgramCache missingCache;
+    EXPECT_FALSE(missingCache.LoadBinaries(filePath));
+}
+
+// A file whose entry sizes run past it's end should be rejected rather than
+// allocated for
+TEST(ProgramCache, RejectsCorruptBinaries)
+{
+    const char *filePath = "ProgramCacheCorruptTest.bin";
+
+    mock_renderer::RecordingRenderer renderer;
+    renderer.supportsProgramBinaries = true;
+    ds_render::ProgramCache coldCache;
+    coldCache.GetProgram(&renderer, ProgramCacheTestSources("red"));
+    ASSERT_TRUE(coldCache.SaveBinaries(filePath));
+
+    // Overwrite the size of the only entry, after the header and it's key
+    {
+        std::fstream file(filePath,
+                          std::ios::in | std::ios::out | std::ios::binary);
+        uint64_t size = 0xffffffffffffull;
+        file.seekp(3 * sizeof(uint32_t) + sizeof(uint64_t));
+        file.write((const char *)&size, sizeof(size));
+    }
+
+    ds_render::ProgramCache cache;
+    EXPECT_FALSE(cache.LoadBinaries(filePath));
+    cache.GetProgram(&renderer, ProgramCacheTestSources("red"));
+    EXPECT_EQ(0u, cache.GetStatistics().numCreatedFromBinary);
+
+    std::remove(filePath);
+}
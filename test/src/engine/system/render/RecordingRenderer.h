@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "engine/system/render/IRenderer.h"
+
+namespace mock_renderer
+{
+/**
+ * Renderer that draws nothing and records the draw calls made to it and the
+ * constant buffer data each was made with, so what a frame would draw can be
+ * checked without a graphics context.
+ */
+class RecordingRenderer : public ds_render::IRenderer
+{
+public:
+    /**
+     * A draw call made to the renderer.
+     */
+    struct Draw
+    {
+        /** Program set when drawn */
+        ds_render::ProgramHandle program;
+        /** Vertex buffer drawn */
+        ds_render::VertexBufferHandle vertexBuffer;
+        /** Instances drawn, 1 for a draw that isn't instanced */
+        size_t numInstances;
+        /** Contents of the last constant buffer updated or range bound
+         * before the draw */
+        std::vector<char> constantBufferData;
+    };
+
+    RecordingRenderer()
+    {
+        numSetProgram = 0;
+        numBindTexture = 0;
+        numUpdateConstantBuffer = 0;
+        numBytesUpdated = 0;
+        numWriteStreamingConstantBuffer = 0;
+        numBindConstantBufferRange = 0;
+        numBytesStreamed = 0;
+        numCreateShaderObject = 0;
+        numCreateProgram = 0;
+        numCreateProgramFromBinary = 0;
+        supportsProgramBinaries = false;
+    }
+
+    virtual bool Init(unsigned int viewportWidth, unsigned int viewportHeight)
+    {
+        return true;
+    }
+    virtual void SetClearColour(float r, float g, float b, float a)
+    {
+    }
+    virtual void ClearBuffers(bool colour, bool depth, bool stencil)
+    {
+    }
+    virtual void ResizeViewport(unsigned int newViewportWidth,
+                                unsigned int newViewportHeight)
+    {
+    }
+    virtual ds_render::VertexBufferHandle
+    CreateVertexBuffer(ds_render::BufferUsageType usage,
+                       const ds_render::VertexBufferDescription &description,
+                       size_t numBytes,
+                       const void *data)
+    {
+        return ds_render::VertexBufferHandle();
+    }
+    virtual ds_render::IndexBufferHandle
+    CreateIndexBuffer(ds_render::BufferUsageType usage,
+                      size_t numBytes,
+                      const void *data)
+    {
+        return ds_render::IndexBufferHandle();
+    }
+    virtual ds_render::ShaderHandle
+    CreateShaderObject(ds_render::ShaderType shaderType,
+                       size_t shaderSourceSize,
+                       const char *shaderSource)
+    {
+        ++numCreateShaderObject;
+        return ds_render::ShaderHandle();
+    }
+    virtual ds_render::ProgramHandle
+    CreateProgram(const std::vector<ds_render::ShaderHandle> &shaders)
+    {
+        // Programs are numbered from 1 in the order created
+        ++numCreateProgram;
+        return ds_render::ProgramHandle(numCreateProgram +
+                                            numCreateProgramFromBinary,
+                                        0, 0);
+    }
+    virtual bool GetProgramBinary(ds_render::ProgramHandle programHandle,
+                                  std::vector<char> *binary) const
+    {
+        // The binary of a program is it's index
+        uint32_t index = programHandle.index;
+        binary->assign((const char *)&index, (const char *)&index + 4);
+        return supportsProgramBinaries;
+    }
+    virtual ds_render::ProgramHandle
+    CreateProgramFromBinary(size_t numBytes, const void *binary)
+    {
+        ds_render::ProgramHandle programHandle;
+        if (supportsProgramBinaries && numBytes == 4)
+        {
+            ++numCreateProgramFromBinary;
+            programHandle = ds_render::ProgramHandle(
+                numCreateProgram + numCreateProgramFromBinary, 0, 0);
+        }
+        return programHandle;
+    }
+    virtual void SetProgram(ds_render::ProgramHandle programHandle)
+    {
+        m_program = programHandle;
+        ++numSetProgram;
+    }
+    virtual ds_render::TextureHandle
+    Create2DTexture(ds_render::ImageFormat format,
+                    ds_render::RenderDataType imageDataType,
+                    ds_render::InternalImageFormat internalFormat,
+                    bool generateMipMaps,
+                    unsigned int width,
+                    unsigned int height,
+                    const void *data)
+    {
+        return ds_render::TextureHandle();
+    }
+    virtual void BindTextureToSampler(ds_render::ProgramHandle programHandle,
+                                      const std::string &samplerName,
+                                      ds_render::TextureHandle textureHandle)
+    {
+        ++numBindTexture;
+    }
+    virtual void
+    UnbindTextureFromSampler(ds_render::TextureHandle textureHandle)
+    {
+    }
+    virtual void GetConstantBufferDescription(
+        ds_render::ProgramHandle programHandle,
+        const std::string &constantBufferName,
+        ds_render::ConstantBufferDescription *constantBufferDescription)
+    {
+    }
+    virtual ds_render::ConstantBufferHandle CreateConstantBuffer(
+        const ds_render::ConstantBufferDescription &constantBufferDescription)
+    {
+        return ds_render::ConstantBufferHandle();
+    }
+    virtual void
+    BindConstantBuffer(ds_render::ProgramHandle programHandle,
+                       const std::string &constantBufferName,
+                       ds_render::ConstantBufferHandle constantBufferHandle)
+    {
+    }
+    virtual void UpdateConstantBufferData(
+        ds_render::ConstantBufferHandle constantBufferHandle,
+        const ds_render::ConstantBufferDescription &constantBufferDescription)
+    {
+        const char *data =
+            (const char *)constantBufferDescription.GetDataPtr();
+        m_constantBufferData.assign(
+            data, data + constantBufferDescription.GetBufferSize());
+        ++numUpdateConstantBuffer;
+        numBytesUpdated += constantBufferDescription.GetBufferSize();
+    }
+    virtual void UpdateConstantBufferSubData(
+        ds_render::ConstantBufferHandle constantBufferHandle,
+        const ds_render::ConstantBufferDescription &constantBufferDescription,
+        size_t offset,
+        size_t numBytes)
+    {
+        // Keep the rest of the buffer as it was, as a GPU buffer would
+        const char *data =
+            (const char *)constantBufferDescription.GetDataPtr();
+        m_constantBufferData.resize(constantBufferDescription.GetBufferSize());
+        std::copy(data + offset, data + offset + numBytes,
+                  m_constantBufferData.begin() + offset);
+        ++numUpdateConstantBuffer;
+        numBytesUpdated += numBytes;
+    }
+    virtual ds_render::ConstantBufferHandle
+    CreateStreamingConstantBuffer(size_t numBytes)
+    {
+        return ds_render::ConstantBufferHandle();
+    }
+    virtual size_t GetConstantBufferOffsetAlignment() const
+    {
+        return 256;
+    }
+    virtual bool
+    WriteStreamingConstantBuffer(ds_render::ConstantBufferHandle handle,
+                                 size_t numBytes,
+                                 const void *data,
+                                 size_t *offset)
+    {
+        // Never wraps, so every range written stays readable
+        *offset = (m_streamedData.size() + 255) / 256 * 256;
+        m_streamedData.resize(*offset);
+        m_streamedData.insert(m_streamedData.end(), (const char *)data,
+                              (const char *)data + numBytes);
+        ++numWriteStreamingConstantBuffer;
+        numBytesStreamed += numBytes;
+
+        return true;
+    }
+    virtual void BindConstantBufferRange(ds_render::ConstantBufferHandle handle,
+                                         size_t offset,
+                                         size_t numBytes)
+    {
+        m_constantBufferData.assign(m_streamedData.begin() + offset,
+                                    m_streamedData.begin() + offset + numBytes);
+        ++numBindConstantBufferRange;
+    }
+    virtual void DrawVertices(ds_render::VertexBufferHandle buffer,
+                              ds_render::PrimitiveType primitiveType,
+                              size_t startingVertex,
+                              size_t numVertices)
+    {
+        RecordDraw(buffer, 1);
+    }
+    virtual void DrawVerticesIndexed(ds_render::VertexBufferHandle buffer,
+                                     ds_render::IndexBufferHandle indexBuffer,
+                                     ds_render::PrimitiveType primitiveType,
+                                     size_t startingIndex,
+                                     size_t numIndices)
+    {
+        RecordDraw(buffer, 1);
+    }
+    virtual void
+    DrawVerticesIndexedInstanced(ds_render::VertexBufferHandle buffer,
+                                 ds_render::IndexBufferHandle indexBuffer,
+                                 ds_render::PrimitiveType primitiveType,
+                                 size_t startingIndex,
+                                 size_t numIndices,
+                                 size_t numInstances)
+    {
+        RecordDraw(buffer, numInstances);
+    }
+
+    /** Draw calls made, in order */
+    std::vector<Draw> draws;
+    unsigned int numSetProgram;
+    unsigned int numBindTexture;
+    unsigned int numUpdateConstantBuffer;
+    size_t numBytesUpdated;
+    unsigned int numWriteStreamingConstantBuffer;
+    unsigned int numBindConstantBufferRange;
+    size_t numBytesStreamed;
+    unsigned int numCreateShaderObject;
+    unsigned int numCreateProgram;
+    unsigned int numCreateProgramFromBinary;
+    /** Whether program binaries can be got and created from, the programs
+     * created from them are numbered along with the programs compiled */
+    bool supportsProgramBinaries;
+
+private:
+    void RecordDraw(ds_render::VertexBufferHandle buffer, size_t numInstances)
+    {
+        Draw draw;
+        draw.program = m_program;
+        draw.vertexBuffer = buffer;
+        draw.numInstances = numInstances;
+        draw.constantBufferData = m_constantBufferData;
+
+        draws.push_back(draw);
+    }
+
+    ds_render::ProgramHandle m_program;
+    std::vector<char> m_constantBufferData;
+    std::vector<char> m_streamedData;
+};
+}
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "engine/system/render/RecordingRenderer.h"
+#include "engine/system/render/RenderQueue.h"
+
+/**
+ * Make a material with the given program and one texture.
+ */
+static ds_render::Material RenderQueueTestMaterial(unsigned int program,
+                                                   unsigned int texture)
+{
+    ds_render::Material material;
+    material.SetProgram(ds_render::ProgramHandle(program, 0, 0));
+    material.AddTexture("diffuse", ds_render::Texture(ds_render::TextureHandle(
+                                       texture, 0, 0)));
+
+    return material;
+}
+
+/**
+ * Make a mesh with the given vertex and index buffer.
+ */
+static ds_render::Mesh RenderQueueTestMesh(unsigned int buffer)
+{
+    return ds_render::Mesh(ds_render::VertexBufferHandle(buffer, 0, 0),
+                           ds_render::IndexBufferHandle(buffer, 0, 0), 0, 3,
+                           ds_math::AABB());
+}
+
+// Program should matter more than textures, textures more than mesh and mesh
+// more than depth
+TEST(RenderQueue, MakeKey)
+{
+    ds_render::Material material = RenderQueueTestMaterial(1, 1);
+    ds_render::Mesh mesh = RenderQueueTestMesh(1);
+    uint64_t key = ds_render::RenderQueue::MakeKey(material, mesh, 0.5f);
+
+    // Nearer sorts first, out of range depths are clamped
+    EXPECT_LT(ds_render::RenderQueue::MakeKey(material, mesh, 0.25f), key);
+    EXPECT_EQ(ds_render::RenderQueue::MakeKey(material, mesh, 0.0f),
+              ds_render::RenderQueue::MakeKey(material, mesh, -1.0f));
+
+    // Only the depth field differs
+    uint64_t depthMask = (1ull << ds_render::RenderQueue::KeyFieldBits) - 1;
+    EXPECT_EQ(key & ~depthMask,
+              ds_render::RenderQueue::MakeKey(material, mesh, 1.0f) &
+                  ~depthMask);
+
+    // A different program outweighs anything below it
+    uint64_t otherProgram = ds_render::RenderQueue::MakeKey(
+        RenderQueueTestMaterial(2, 1), mesh, 0.0f);
+    EXPECT_NE(key >> (3 * ds_render::RenderQueue::KeyFieldBits),
+              otherProgram >> (3 * ds_render::RenderQueue::KeyFieldBits));
+}
+
+// Sorting should order the keys, keeping items with equal keys in the order
+// pushed
+TEST(RenderQueue, Sort)
+{
+    std::vector<ds_render::Material> materials;
+    for (unsigned int i = 0; i < 20; ++i)
+    {
+        materials.push_back(RenderQueueTestMaterial(i % 5, i));
+    }
+    std::vector<ds_render::Mesh> meshes;
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        meshes.push_back(RenderQueueTestMesh(i));
+    }
+
+    ds_render::RenderQueue queue;
+    std::vector<uint64_t> expected;
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        const ds_render::Material &material = materials[(i * 7) % 20];
+        const ds_render::Mesh &mesh = meshes[(i * 3) % 10];
+        float depth = (float)((i * 13) % 100) / 100.0f;
+
+        queue.Push(&material, &mesh, nullptr, depth);
+        expected.push_back(
+            ds_render::RenderQueue::MakeKey(material, mesh, depth));
+    }
+
+    queue.Sort();
+    std::sort(expected.begin(), expected.end());
+
+    ASSERT_EQ(expected.size(), queue.GetNumItems());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(expected[i], queue.GetKey(i)) << "Position " << i;
+    }
+
+    // Clearing empties the queue, sorting nothing is fine
+    queue.Clear();
+    queue.Sort();
+    EXPECT_EQ(0u, queue.GetNumItems());
+}
+
+// Each item should be drawn on it's own, only setting state that changed
+TEST(RenderQueue, Submit)
+{
+    ds_render::Material materials[] = {RenderQueueTestMaterial(1, 1),
+                                       RenderQueueTestMaterial(2, 2)};
+    ds_render::Mesh mesh = RenderQueueTestMesh(1);
+    std::vector<ds_math::Matrix4> transforms;
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        transforms.push_back(
+            ds_math::Matrix4::CreateTranslationMatrix((float)i, 0.0f, 0.0f));
+    }
+
+    ds_render::RenderQueue queue;
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        queue.Push(&materials[i % 2], &mesh, &transforms[i], i / 10.0f);
+    }
+    queue.Sort();
+
+    ds_render::ConstantBufferDescription objectBufferDescription(
+        sizeof(ds_math::Matrix4));
+    objectBufferDescription.AddMember("Object.modelMatrix");
+    objectBufferDescription.SetMemberOffset("Object.modelMatrix", 0);
+
+    queue.SetObjectBuffer(ds_render::ConstantBufferHandle(),
+                          &objectBufferDescription);
+
+    mock_renderer::RecordingRenderer renderer;
+    ds_render::RenderQueueStatistics statistics = queue.Submit(&renderer);
+
+    EXPECT_EQ(10u, statistics.numDraws);
+    EXPECT_EQ(10u, statistics.numInstances);
+    EXPECT_EQ(2u, statistics.numProgramChanges);
+    EXPECT_EQ(2u, renderer.numSetProgram);
+    EXPECT_EQ(2u, renderer.numBindTexture);
+
+    // Every transform is streamed with one write, each draw binding it's own
+    // aligned block
+    EXPECT_EQ(0u, renderer.numUpdateConstantBuffer);
+    EXPECT_EQ(1u, renderer.numWriteStreamingConstantBuffer);
+    EXPECT_EQ(10u, renderer.numBindConstantBufferRange);
+    EXPECT_EQ(9 * 256 + sizeof(ds_math::Matrix4), renderer.numBytesStreamed);
+
+    // Program 1 drew the even translations front to back
+    ASSERT_EQ(10u, renderer.draws.size());
+    for (unsigned int i = 0; i < 5; ++i)
+    {
+        const mock_renderer::RecordingRenderer::Draw &draw = renderer.draws[i];
+        EXPECT_EQ(ds_render::ProgramHandle(1, 0, 0), draw.program);
+        EXPECT_EQ(1u, draw.numInstances);
+
+        const ds_math::Matrix4 &modelMatrix =
+            *(const ds_math::Matrix4 *)&draw.constantBufferData[0];
+        EXPECT_EQ(transforms[2 * i], modelMatrix);
+    }
+}
+
+// Copies of a mesh with an instanced material should be drawn a few at a
+// time, with every copy's transform, while other items are drawn as before
+TEST(RenderQueue, SubmitInstanced)
+{
+    ds_render::Material instancedMaterial = RenderQueueTestMaterial(1, 1);
+    instancedMaterial.SetInstanced(true);
+    ds_render::Material material = RenderQueueTestMaterial(2, 2);
+    ds_render::Mesh meshes[] = {RenderQueueTestMesh(1),
+                                RenderQueueTestMesh(2)};
+
+    const unsigned int numCopies = 1000;
+    std::vector<ds_math::Matrix4> transforms;
+    for (unsigned int i = 0; i < numCopies; ++i)
+    {
+        transforms.push_back(
+            ds_math::Matrix4::CreateTranslationMatrix((float)i, 0.0f, 0.0f));
+    }
+
+    // Copies of two meshes with the instanced material, interleaved, and a
+    // few copies of the first mesh with the other material
+    ds_render::RenderQueue queue;
+    for (unsigned int i = 0; i < numCopies; ++i)
+    {
+        queue.Push(&instancedMaterial, &meshes[i % 2], &transforms[i],
+                   (float)(i % 7) / 7.0f);
+    }
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        queue.Push(&material, &meshes[0], &transforms[i], 0.0f);
+    }
+    queue.Sort();
+
+    ds_render::ConstantBufferDescription objectBufferDescription(
+        sizeof(ds_math::Matrix4));
+    objectBufferDescription.AddMember("Object.modelMatrix");
+    objectBufferDescription.SetMemberOffset("Object.modelMatrix", 0);
+
+    ds_render::ConstantBufferDescription instanceBufferDescription(
+        ds_render::RenderQueue::MaxInstancesPerDraw *
+        sizeof(ds_math::Matrix4));
+    instanceBufferDescription.AddMember("Instances.modelMatrices");
+    instanceBufferDescription.SetMemberOffset("Instances.modelMatrices", 0);
+
+    queue.SetObjectBuffer(ds_render::ConstantBufferHandle(),
+                          &objectBufferDescription);
+    queue.SetInstanceBuffer(ds_render::ConstantBufferHandle(),
+                            &instanceBufferDescription);
+
+    mock_renderer::RecordingRenderer renderer;
+    ds_render::RenderQueueStatistics statistics = queue.Submit(&renderer);
+
+    // 500 copies of each mesh take 2 draws of up to 256 each, plus 3 draws
+    // of the other material
+    EXPECT_EQ(7u, statistics.numDraws);
+    EXPECT_EQ(numCopies + 3, statistics.numInstances);
+    EXPECT_EQ(2u, renderer.numSetProgram);
+    ASSERT_EQ(7u, renderer.draws.size());
+
+    // One write to each of the object and instance buffers for the frame
+    EXPECT_EQ(0u, renderer.numUpdateConstantBuffer);
+    EXPECT_EQ(2u, renderer.numWriteStreamingConstantBuffer);
+    EXPECT_EQ(7u, renderer.numBindConstantBufferRange);
+
+    // Every copy is drawn once, with it's own transform
+    std::vector<float> translations;
+    for (const mock_renderer::RecordingRenderer::Draw &draw : renderer.draws)
+    {
+        if (draw.program == ds_render::ProgramHandle(1, 0, 0))
+        {
+            EXPECT_LE(draw.numInstances,
+                      ds_render::RenderQueue::MaxInstancesPerDraw);
+
+            const ds_math::Matrix4 *modelMatrices =
+                (const ds_math::Matrix4 *)&draw.constantBufferData[0];
+            for (size_t i = 0; i < draw.numInstances; ++i)
+            {
+                translations.push_back(modelMatrices[i].data[3].x);
+            }
+        }
+        else
+        {
+            EXPECT_EQ(1u, draw.numInstances);
+        }
+    }
+
+    ASSERT_EQ(numCopies, translations.size());
+    std::sort(translations.begin(), translations.end());
+    for (unsigned int i = 0; i < numCopies; ++i)
+    {
+        EXPECT_EQ((float)i, translations[i]);
+    }
+}
+
+// Items without a transform should be drawn with the object buffer
+// description's model matrix, the other members of the block kept
+TEST(RenderQueue, SubmitWithoutTransform)
+{
+    ds_render::Material material = RenderQueueTestMaterial(1, 1);
+    ds_render::Mesh mesh = RenderQueueTestMesh(1);
+    ds_math::Matrix4 transform =
+        ds_math::Matrix4::CreateTranslationMatrix(1.0f, 2.0f, 3.0f);
+
+    ds_render::RenderQueue queue;
+    queue.Push(&material, &mesh, nullptr, 0.0f);
+    queue.Push(&material, &mesh, &transform, 0.5f);
+    queue.Sort();
+
+    ds_render::ConstantBufferDescription objectBufferDescription(
+        2 * sizeof(ds_math::Matrix4));
+    objectBufferDescription.AddMember("Object.modelMatrix");
+    objectBufferDescription.SetMemberOffset("Object.modelMatrix", 0);
+    objectBufferDescription.AddMember("Object.colour");
+    objectBufferDescription.SetMemberOffset("Object.colour",
+                                            sizeof(ds_math::Matrix4));
+
+    ds_math::Matrix4 modelMatrix = ds_math::Matrix4(1.0f);
+    ds_math::Matrix4 colour = ds_math::Matrix4(2.0f);
+    objectBufferDescription.InsertMemberData(
+        "Object.modelMatrix", sizeof(ds_math::Matrix4), &modelMatrix);
+    objectBufferDescription.InsertMemberData(
+        "Object.colour", sizeof(ds_math::Matrix4), &colour);
+
+    queue.SetObjectBuffer(ds_render::ConstantBufferHandle(),
+                          &objectBufferDescription);
+
+    mock_renderer::RecordingRenderer renderer;
+    queue.Submit(&renderer);
+
+    ASSERT_EQ(2u, renderer.draws.size());
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        const ds_math::Matrix4 *block =
+            (const ds_math::Matrix4 *)&renderer.draws[i]
+                .constantBufferData[0];
+        EXPECT_EQ(i == 0 ? modelMatrix : transform, block[0]);
+        EXPECT_EQ(colour, block[1]);
+    }
+}
@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "engine/system/scene/BoundingVolumeHierarchy.h"
+#include "math/Matrix4.h"
+
+/**
+ * Make the entity with the given index.
+ */
+static ds::Entity BoundingVolumeHierarchyTestEntity(unsigned int index)
+{
+    ds::Entity entity;
+    entity.id = index;
+
+    return entity;
+}
+
+/**
+ * Make a box of random size at a random position in a 100 unit cube.
+ */
+static ds_math::AABB BoundingVolumeHierarchyTestBox()
+{
+    ds_math::Vector3 center(rand() % 1000 * 0.1f - 50.0f,
+                            rand() % 1000 * 0.1f - 50.0f,
+                            rand() % 1000 * 0.1f - 50.0f);
+    ds_math::Vector3 extents(rand() % 20 * 0.1f + 0.1f,
+                             rand() % 20 * 0.1f + 0.1f,
+                             rand() % 20 * 0.1f + 0.1f);
+
+    return ds_math::AABB(center, extents);
+}
+
+/**
+ * Get the indices of the given entities, sorted.
+ */
+static std::vector<unsigned int>
+BoundingVolumeHierarchyTestSorted(const std::vector<ds::Entity> &entities)
+{
+    std::vector<unsigned int> indices;
+    for (ds::Entity entity : entities)
+    {
+        indices.push_back(entity.GetIndex());
+    }
+    std::sort(indices.begin(), indices.end());
+
+    return indices;
+}
+
+/**
+ * Get the indices of the boxes intersecting a box, by testing every box.
+ */
+static std::vector<unsigned int>
+BoundingVolumeHierarchyTestBruteForce(const std::vector<ds_math::AABB> &boxes,
+                                      const ds_math::AABB &query)
+{
+    std::vector<unsigned int> indices;
+    for (unsigned int i = 0; i < boxes.size(); ++i)
+    {
+        if (ds_math::AABB::Intersects(boxes[i], query))
+        {
+            indices.push_back(i);
+        }
+    }
+
+    return indices;
+}
+
+// Queries should find exactly the entities a linear scan finds
+TEST(BoundingVolumeHierarchy, QueryAABB)
+{
+    srand(0);
+
+    ds::BoundingVolumeHierarchy tree;
+    std::vector<ds_math::AABB> boxes;
+
+    for (unsigned int i = 0; i < 500; ++i)
+    {
+        boxes.push_back(BoundingVolumeHierarchyTestBox());
+        tree.Insert(BoundingVolumeHierarchyTestEntity(i), boxes.back());
+    }
+
+    EXPECT_EQ(500u, tree.GetNumEntities());
+
+    for (unsigned int q = 0; q < 20; ++q)
+    {
+        ds_math::AABB query(BoundingVolumeHierarchyTestBox().center,
+                            ds_math::Vector3(10.0f, 10.0f, 10.0f));
+
+        std::vector<ds::Entity> found;
+        tree.QueryAABB(query, &found);
+
+        EXPECT_EQ(BoundingVolumeHierarchyTestBruteForce(boxes, query),
+                  BoundingVolumeHierarchyTestSorted(found));
+    }
+}
+
+// Moved entities should be found at their new position after a refit or a
+// rebuild
+TEST(BoundingVolumeHierarchy, UpdateRefitRebuild)
+{
+    srand(1);
+
+    ds::BoundingVolumeHierarchy tree;
+    std::vector<ds_math::AABB> boxes;
+
+    for (unsigned int i = 0; i < 200; ++i)
+    {
+        boxes.push_back(BoundingVolumeHierarchyTestBox());
+        tree.Insert(BoundingVolumeHierarchyTestEntity(i), boxes.back());
+    }
+
+    for (unsigned int i = 0; i < 200; i += 3)
+    {
+        boxes[i] = BoundingVolumeHierarchyTestBox();
+        tree.Update(BoundingVolumeHierarchyTestEntity(i), boxes[i]);
+    }
+    EXPECT_EQ(67u, tree.GetNumUpdatesSinceRebuild());
+
+    ds_math::AABB query(ds_math::Vector3(), ds_math::Vector3(25.0f, 25.0f,
+                                                             25.0f));
+    std::vector<ds::Entity> found;
+
+    tree.Refit();
+    tree.QueryAABB(query, &found);
+    EXPECT_EQ(BoundingVolumeHierarchyTestBruteForce(boxes, query),
+              BoundingVolumeHierarchyTestSorted(found));
+
+    tree.Rebuild();
+    EXPECT_EQ(0u, tree.GetNumUpdatesSinceRebuild());
+    EXPECT_EQ(200u, tree.GetNumEntities());
+
+    found.clear();
+    tree.QueryAABB(query, &found);
+    EXPECT_EQ(BoundingVolumeHierarchyTestBruteForce(boxes, query),
+              BoundingVolumeHierarchyTestSorted(found));
+
+    // Root contains everything
+    ds_math::AABB bounds = tree.GetBounds();
+    for (const ds_math::AABB &box : boxes)
+    {
+        EXPECT_TRUE(ds_math::AABB::Merge(bounds, box).GetSurfaceArea() <=
+                    bounds.GetSurfaceArea());
+    }
+}
+
+// Removed entities should no longer be found, and their nodes reused
+TEST(BoundingVolumeHierarchy, Remove)
+{
+    ds::BoundingVolumeHierarchy tree;
+
+    ds_math::AABB box(ds_math::Vector3(), ds_math::Vector3(1.0f, 1.0f, 1.0f));
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        tree.Insert(BoundingVolumeHierarchyTestEntity(i), box);
+    }
+
+    EXPECT_TRUE(tree.Remove(BoundingVolumeHierarchyTestEntity(1)));
+    EXPECT_FALSE(tree.Remove(BoundingVolumeHierarchyTestEntity(1)));
+    EXPECT_FALSE(tree.Contains(BoundingVolumeHierarchyTestEntity(1)));
+    EXPECT_TRUE(tree.Contains(BoundingVolumeHierarchyTestEntity(2)));
+
+    // Same index, different generation is a different entity
+    ds::Entity newer = BoundingVolumeHierarchyTestEntity(
+        2 | (1 << ds::Entity::ENTITY_INDEX_BITS));
+    EXPECT_FALSE(tree.Contains(newer));
+
+    std::vector<ds::Entity> found;
+    tree.QueryAABB(box, &found);
+    EXPECT_EQ(std::vector<unsigned int>({0, 2, 3}),
+              BoundingVolumeHierarchyTestSorted(found));
+
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        tree.Remove(BoundingVolumeHierarchyTestEntity(i));
+    }
+    EXPECT_EQ(0u, tree.GetNumEntities());
+
+    found.clear();
+    tree.QueryAABB(box, &found);
+    EXPECT_TRUE(found.empty());
+}
+
+TEST(BoundingVolumeHierarchy, QueryFrustum)
+{
+    ds::BoundingVolumeHierarchy tree;
+
+    // Row of boxes along the z axis, the camera at the origin looks down -z
+    // and sees 1 to 100 units away
+    for (unsigned int i = 0; i < 20; ++i)
+    {
+        tree.Insert(BoundingVolumeHierarchyTestEntity(i),
+                    ds_math::AABB(ds_math::Vector3(0.0f, 0.0f,
+                                                   100.0f - i * 10.0f),
+                                  ds_math::Vector3(0.5f, 0.5f, 0.5f)));
+    }
+    tree.Rebuild();
+
+    ds_math::Frustum frustum(
+        ds_math::Matrix4::CreatePerspectiveFieldOfView(1.0f, 1.0f, 1.0f,
+                                                       100.0f));
+
+    std::vector<ds::Entity> found;
+    tree.QueryFrustum(frustum, &found);
+
+    // Boxes at z = -10 to -90, the rest are behind the camera
+    EXPECT_EQ(std::vector<unsigned int>({11, 12, 13, 14, 15, 16, 17, 18, 19}),
+              BoundingVolumeHierarchyTestSorted(found));
+}
+
+TEST(BoundingVolumeHierarchy, QueryRayAndRadius)
+{
+    ds::BoundingVolumeHierarchy tree;
+
+    // Boxes at x = 0, 10, 20, 30
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        tree.Insert(BoundingVolumeHierarchyTestEntity(i),
+                    ds_math::AABB(ds_math::Vector3(i * 10.0f, 0.0f, 0.0f),
+                                  ds_math::Vector3(1.0f, 1.0f, 1.0f)));
+    }
+
+    // Ray along x from 5 for 20 units hits the boxes at 10 and 20
+    std::vector<ds::Entity> found;
+    tree.QueryRay(ds_math::Vector3(5.0f, 0.0f, 0.0f),
+                  ds_math::Vector3(1.0f, 0.0f, 0.0f), 20.0f, &found);
+    EXPECT_EQ(std::vector<unsigned int>({1, 2}),
+              BoundingVolumeHierarchyTestSorted(found));
+
+    // Ray pointing away hits nothing
+    found.clear();
+    tree.QueryRay(ds_math::Vector3(5.0f, 2.0f, 0.0f),
+                  ds_math::Vector3(0.0f, 1.0f, 0.0f), 100.0f, &found);
+    EXPECT_TRUE(found.empty());
+
+    // Within 9.5 units of x = 15 are the boxes at 10 and 20 (nearest edges 4
+    // units away), not 0 or 30 (nearest edges 14 units away)
+    found.clear();
+    tree.QueryRadius(ds_math::Vector3(15.0f, 0.0f, 0.0f), 9.5f, &found);
+    EXPECT_EQ(std::vector<unsigned int>({1, 2}),
+              BoundingVolumeHierarchyTestSorted(found));
+}
@@ -0,0 +1,370 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "engine/system/scene/TransformComponentManager.h"
+#include "math/MathHelper.h"
+
+/**
+ * Create a transform component for an entity with the given index.
+ */
+static ds::Instance
+TransformComponentManagerTestCreate(ds::TransformComponentManager *manager,
+                                    unsigned int entityIndex)
+{
+    ds::Entity entity;
+    entity.id = entityIndex;
+
+    return manager->CreateComponentForEntity(entity);
+}
+
+/**
+ * Get the transform component of the entity with the given index.
+ */
+static ds::Instance
+TransformComponentManagerTestGet(const ds::TransformComponentManager &manager,
+                                 unsigned int entityIndex)
+{
+    ds::Entity entity;
+    entity.id = entityIndex;
+
+    return manager.GetInstanceForEntity(entity);
+}
+
+// Children should be linked in both directions
+TEST(TransformComponentManager, SetParent)
+{
+    ds::TransformComponentManager manager;
+
+    ds::Instance parent = TransformComponentManagerTestCreate(&manager, 0);
+    ds::Instance a = TransformComponentManagerTestCreate(&manager, 1);
+    ds::Instance b = TransformComponentManagerTestCreate(&manager, 2);
+
+    manager.SetParent(a, parent);
+    manager.SetParent(b, parent);
+
+    EXPECT_EQ(a, manager.GetFirstChild(parent));
+    EXPECT_EQ(b, manager.GetNextSibling(a));
+    EXPECT_EQ(a, manager.GetPrevSibling(b));
+    EXPECT_EQ(parent, manager.GetParent(b));
+
+    // Removing parent should unlink child
+    manager.SetParent(a, ds::Instance::MakeInvalidInstance());
+
+    EXPECT_EQ(b, manager.GetFirstChild(parent));
+    EXPECT_FALSE(manager.GetPrevSibling(b).IsValid());
+    EXPECT_FALSE(manager.GetParent(a).IsValid());
+}
+
+// Removing a child should only relink it's parent and siblings, and moving
+// the last component into it's place should keep the moved component's links
+TEST(TransformComponentManager, RemoveChild)
+{
+    ds::TransformComponentManager manager;
+
+    ds::Instance parent = TransformComponentManagerTestCreate(&manager, 0);
+    ds::Instance a = TransformComponentManagerTestCreate(&manager, 1);
+    ds::Instance b = TransformComponentManagerTestCreate(&manager, 2);
+    ds::Instance c = TransformComponentManagerTestCreate(&manager, 3);
+
+    manager.SetParent(a, parent);
+    manager.SetParent(b, parent);
+    manager.SetParent(c, parent);
+
+    // c is last, so it is moved into b's place
+    EXPECT_TRUE(manager.RemoveInstance(b));
+
+    a = TransformComponentManagerTestGet(manager, 1);
+    c = TransformComponentManagerTestGet(manager, 3);
+
+    EXPECT_EQ(a, manager.GetFirstChild(parent));
+    EXPECT_EQ(c, manager.GetNextSibling(a));
+    EXPECT_EQ(a, manager.GetPrevSibling(c));
+    EXPECT_FALSE(manager.GetNextSibling(c).IsValid());
+    EXPECT_EQ(parent, manager.GetParent(c));
+}
+
+// Removing a parent should leave it's children as roots, and moving a parent
+// should update it's children
+TEST(TransformComponentManager, RemoveParent)
+{
+    ds::TransformComponentManager manager;
+
+    ds::Instance root = TransformComponentManagerTestCreate(&manager, 0);
+    ds::Instance parent = TransformComponentManagerTestCreate(&manager, 1);
+    ds::Instance child = TransformComponentManagerTestCreate(&manager, 2);
+    ds::Instance grandchild = TransformComponentManagerTestCreate(&manager, 3);
+
+    manager.SetParent(child, root);
+    manager.SetParent(grandchild, child);
+
+    // Removing parent (no relations) moves grandchild into it's place
+    EXPECT_TRUE(manager.RemoveInstance(parent));
+    grandchild = TransformComponentManagerTestGet(manager, 3);
+    EXPECT_EQ(grandchild, manager.GetFirstChild(child));
+    EXPECT_EQ(child, manager.GetParent(grandchild));
+
+    // Removing root leaves child without a parent
+    EXPECT_TRUE(manager.RemoveInstance(root));
+    child = TransformComponentManagerTestGet(manager, 2);
+    grandchild = TransformComponentManagerTestGet(manager, 3);
+    EXPECT_FALSE(manager.GetParent(child).IsValid());
+    EXPECT_EQ(grandchild, manager.GetFirstChild(child));
+    EXPECT_EQ(child, manager.GetParent(grandchild));
+}
+
+// Local transforms should come back as they were set, however they're stored
+TEST(TransformComponentManager, LocalTransformStorage)
+{
+#ifndef DS_NO_COMPACT_TRANSFORMS
+    EXPECT_EQ(12 * sizeof(ds_math::scalar), sizeof(ds::LocalTransform));
+#endif
+
+    ds::TransformComponentManager manager;
+
+    ds::Instance object = TransformComponentManagerTestCreate(&manager, 0);
+    EXPECT_EQ(ds_math::Matrix4(), manager.GetLocalTransform(object));
+
+    const ds_math::Matrix4 local =
+        ds_math::Matrix4::CreateTranslationMatrix(1.0f, 2.0f, 3.0f) *
+        ds_math::Matrix4::CreateFromQuaternion(
+            ds_math::Quaternion(0.0f, 0.6f, 0.0f, 0.8f)) *
+        ds_math::Matrix4::CreateScaleMatrix(2.0f, 3.0f, 4.0f);
+    manager.SetLocalTransform(object, local);
+
+    EXPECT_EQ(local, manager.GetLocalTransform(object));
+}
+
+// World transforms should only change when UpdateWorldTransforms is called,
+// and changes should reach every descendant
+TEST(TransformComponentManager, UpdateWorldTransforms)
+{
+    ds::TransformComponentManager manager;
+
+    ds::Instance root = TransformComponentManagerTestCreate(&manager, 0);
+    ds::Instance child = TransformComponentManagerTestCreate(&manager, 1);
+    ds::Instance grandchild = TransformComponentManagerTestCreate(&manager, 2);
+
+    manager.SetParent(child, root);
+    manager.SetParent(grandchild, child);
+
+    manager.SetLocalTransform(
+        root, ds_math::Matrix4::CreateTranslationMatrix(1.0f, 0.0f, 0.0f));
+    manager.SetLocalTransform(
+        grandchild,
+        ds_math::Matrix4::CreateTranslationMatrix(0.0f, 2.0f, 0.0f));
+
+    // Not updated yet
+    EXPECT_EQ(ds_math::Matrix4(), manager.GetWorldTransform(root));
+    EXPECT_EQ(ds_math::Matrix4(), manager.GetWorldTransform(grandchild));
+
+    manager.UpdateWorldTransforms();
+
+    EXPECT_EQ(ds_math::Matrix4::CreateTranslationMatrix(1.0f, 0.0f, 0.0f),
+              manager.GetWorldTransform(child));
+    EXPECT_EQ(ds_math::Matrix4::CreateTranslationMatrix(1.0f, 2.0f, 0.0f),
+              manager.GetWorldTransform(grandchild));
+
+    // Moving the root should move it's descendants too
+    manager.SetLocalTransform(
+        root, ds_math::Matrix4::CreateTranslationMatrix(0.0f, 0.0f, 3.0f));
+    manager.UpdateWorldTransforms();
+
+    EXPECT_EQ(ds_math::Matrix4::CreateTranslationMatrix(0.0f, 2.0f, 3.0f),
+              manager.GetWorldTransform(grandchild));
+}
+
+// Changing parent should keep an object where it is in the world
+TEST(TransformComponentManager, SetParentKeepsWorldTransform)
+{
+    ds::TransformComponentManager manager;
+
+    ds::Instance parent = TransformComponentManagerTestCreate(&manager, 0);
+    ds::Instance child = TransformComponentManagerTestCreate(&manager, 1);
+
+    manager.SetLocalTransform(
+        parent, ds_math::Matrix4::CreateTranslationMatrix(1.0f, 2.0f, 3.0f));
+    manager.SetLocalTransform(
+        child, ds_math::Matrix4::CreateTranslationMatrix(4.0f, 4.0f, 4.0f));
+
+    // Parent's world transform hasn't been updated yet
+    manager.SetParent(child, parent);
+    manager.UpdateWorldTransforms();
+
+    const ds_math::Vector4 &translation = manager.GetWorldTransform(child)[3];
+    EXPECT_FLOAT_EQ(4.0f, translation.x);
+    EXPECT_FLOAT_EQ(4.0f, translation.y);
+    EXPECT_FLOAT_EQ(4.0f, translation.z);
+
+    // Removing the parent leaves child where it is too
+    EXPECT_TRUE(manager.RemoveInstance(parent));
+    child = TransformComponentManagerTestGet(manager, 1);
+    manager.UpdateWorldTransforms();
+
+    const ds_math::Vector4 &newTranslation =
+        manager.GetWorldTransform(child)[3];
+    EXPECT_FLOAT_EQ(4.0f, newTranslation.x);
+    EXPECT_FLOAT_EQ(4.0f, newTranslation.y);
+    EXPECT_FLOAT_EQ(4.0f, newTranslation.z);
+}
+
+// Removing an object in the middle of a hierarchy should leave it's children
+// where they are in the world, under every ancestor's transform
+TEST(TransformComponentManager, RemoveMiddleKeepsWorldTransform)
+{
+    ds::TransformComponentManager manager;
+
+    ds::Instance root = TransformComponentManagerTestCreate(&manager, 0);
+    ds::Instance middle = TransformComponentManagerTestCreate(&manager, 1);
+    ds::Instance leaf = TransformComponentManagerTestCreate(&manager, 2);
+
+    manager.SetParent(middle, root);
+    manager.SetParent(leaf, middle);
+
+    manager.SetLocalTransform(
+        root, ds_math::Matrix4::CreateTranslationMatrix(10.0f, 0.0f, 0.0f));
+    manager.SetLocalTransform(
+        middle, ds_math::Matrix4::CreateTranslationMatrix(0.0f, 1.0f, 0.0f));
+    manager.SetLocalTransform(
+        leaf, ds_math::Matrix4::CreateTranslationMatrix(0.0f, 0.0f, 2.0f));
+    manager.UpdateWorldTransforms();
+
+    EXPECT_TRUE(manager.RemoveInstance(middle));
+    leaf = TransformComponentManagerTestGet(manager, 2);
+    manager.UpdateWorldTransforms();
+
+    EXPECT_FALSE(manager.GetParent(leaf).IsValid());
+    const ds_math::Vector4 &translation = manager.GetWorldTransform(leaf)[3];
+    EXPECT_FLOAT_EQ(10.0f, translation.x);
+    EXPECT_FLOAT_EQ(1.0f, translation.y);
+    EXPECT_FLOAT_EQ(2.0f, translation.z);
+}
+
+// Objects should be drawn between their last two world transforms, new and
+// stopped objects where they are
+TEST(TransformComponentManager, InterpolatedWorldTransform)
+{
+    ds::TransformComponentManager manager;
+
+    ds::Instance object = TransformComponentManagerTestCreate(&manager, 0);
+    manager.SetLocalTransform(
+        object, ds_math::Matrix4::CreateTranslationMatrix(4.0f, 0.0f, 0.0f));
+    manager.UpdateWorldTransforms();
+
+    EXPECT_EQ(manager.GetWorldTransform(object),
+              manager.GetInterpolatedWorldTransform(object, 0.5f));
+
+    // Moved 2 along x from the origin and turned 90 degrees about z
+    const float halfAngle = ds_math::MathHelper::PI / 4.0f;
+    manager.SetLocalTransform(
+        object, ds_math::Matrix4::CreateTranslationMatrix(2.0f, 0.0f, 0.0f) *
+                    ds_math::Matrix4::CreateFromQuaternion(ds_math::Quaternion(
+                        0.0f, 0.0f, std::sin(halfAngle), std::cos(halfAngle))));
+    manager.UpdateWorldTransforms();
+
+    // Half way is 3 along x and turned 45 degrees
+    const ds_math::Matrix4 expected =
+        ds_math::Matrix4::CreateTranslationMatrix(3.0f, 0.0f, 0.0f) *
+        ds_math::Matrix4::CreateFromQuaternion(
+            ds_math::Quaternion(0.0f, 0.0f, std::sin(halfAngle / 2.0f),
+                                std::cos(halfAngle / 2.0f)));
+    const ds_math::Matrix4 interpolated =
+        manager.GetInterpolatedWorldTransform(object, 0.5f);
+    for (int col = 0; col < 4; ++col)
+    {
+        for (int row = 0; row < 4; ++row)
+        {
+            EXPECT_NEAR(expected[col][row], interpolated[col][row], 1e-5f);
+        }
+    }
+
+    // Stopped after the move
+    manager.UpdateWorldTransforms();
+    EXPECT_EQ(manager.GetWorldTransform(object),
+              manager.GetInterpolatedWorldTransform(object, 0.5f));
+}
+
+// Updating world transforms on a thread pool should give exactly the same
+// results as updating them serially
+TEST(TransformComponentManager, UpdateWorldTransformsParallel)
+{
+    const int numComponents = 20000;
+
+    ds::TransformComponentManager serial;
+    ds::TransformComponentManager parallel;
+
+    ds_com::ThreadPool threadPool(3);
+    parallel.SetThreadPool(&threadPool);
+
+    for (int i = 0; i < numComponents; ++i)
+    {
+        TransformComponentManagerTestCreate(&serial, i);
+        TransformComponentManagerTestCreate(&parallel, i);
+    }
+
+    // Tree with four children per node, so the deeper levels are split
+    // across the threads
+    for (int i = 1; i < numComponents; ++i)
+    {
+        ds::Instance parent = ds::Instance::MakeInstance((i - 1) / 4);
+
+        serial.SetParent(ds::Instance::MakeInstance(i), parent);
+        parallel.SetParent(ds::Instance::MakeInstance(i), parent);
+    }
+
+    for (int i = 0; i < numComponents; ++i)
+    {
+        const ds_math::Matrix4 local =
+            ds_math::Matrix4::CreateTranslationMatrix(0.1f * i, 1.0f, 0.0f) *
+            ds_math::Matrix4::CreateScaleMatrix(1.001f, 0.999f, 1.0f);
+
+        serial.SetLocalTransform(ds::Instance::MakeInstance(i), local);
+        parallel.SetLocalTransform(ds::Instance::MakeInstance(i), local);
+    }
+
+    serial.UpdateWorldTransforms();
+    parallel.UpdateWorldTransforms();
+
+    for (int i = 0; i < numComponents; ++i)
+    {
+        const ds_math::Matrix4 &expected =
+            serial.GetWorldTransform(ds::Instance::MakeInstance(i));
+        const ds_math::Matrix4 &actual =
+            parallel.GetWorldTransform(ds::Instance::MakeInstance(i));
+
+        EXPECT_EQ(0, memcmp(&expected, &actual, sizeof(expected)))
+            << "Instance " << i;
+    }
+}
+
+// Only instances whose world transforms changed should be reported as
+// updated, including the children of moved instances
+TEST(TransformComponentManager, GetUpdatedInstances)
+{
+    ds::TransformComponentManager manager;
+
+    ds::Instance parent = TransformComponentManagerTestCreate(&manager, 0);
+    ds::Instance child = TransformComponentManagerTestCreate(&manager, 1);
+    ds::Instance other = TransformComponentManagerTestCreate(&manager, 2);
+    manager.SetParent(child, parent);
+
+    // New instances are all updated
+    manager.UpdateWorldTransforms();
+    EXPECT_EQ(3u, manager.GetUpdatedInstances().size());
+
+    manager.SetLocalTransform(
+        parent, ds_math::Matrix4::CreateTranslationMatrix(1.0f, 0.0f, 0.0f));
+    manager.UpdateWorldTransforms();
+
+    const std::vector<ds::Instance> &updated = manager.GetUpdatedInstances();
+    ASSERT_EQ(2u, updated.size());
+    EXPECT_NE(updated.end(), std::find(updated.begin(), updated.end(), parent));
+    EXPECT_NE(updated.end(), std::find(updated.begin(), updated.end(), child));
+    EXPECT_EQ(updated.end(), std::find(updated.begin(), updated.end(), other));
+
+    // Nothing moved
+    manager.UpdateWorldTransforms();
+    EXPECT_TRUE(manager.GetUpdatedInstances().empty());
+}
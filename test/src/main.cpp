@@ -1,8 +1,26 @@
 #include "gtest/gtest.h"
 
 #include "engine/ConfigTestSuite.h"
+#include "engine/FrameStatisticsTestSuite.h"
+#include "engine/SystemSchedulerTestSuite.h"
 #include "engine/common/CommonTestSuite.h"
+#include "engine/common/HandleManagerTestSuite.h"
 #include "engine/common/StreamBufferTestSuite.h"
+#include "engine/common/StringHashTestSuite.h"
+#include "engine/common/StringInternTestSuite.h"
+#include "engine/common/ThreadPoolTestSuite.h"
+#include "engine/entity/ComponentManagerTestSuite.h"
+#include "engine/message/MessageBusTestSuite.h"
+#include "engine/system/render/CommandBufferTestSuite.h"
+#include "engine/system/render/ConstantBufferDescriptionTestSuite.h"
+#include "engine/system/render/GLRendererTestSuite.h"
+#include "engine/system/render/ProgramCacheTestSuite.h"
+#include "engine/system/render/RenderQueueTestSuite.h"
+#include "engine/system/scene/BoundingVolumeHierarchyTestSuite.h"
+#include "engine/system/scene/TransformComponentManagerTestSuite.h"
+#include "math/AABBTestSuite.h"
+#include "math/BatchTestSuite.h"
+#include "math/FrustumTestSuite.h"
 #include "math/Matrix4TestSuite.h"
 #include "math/QuaternionTestSuite.h"
 #include "math/Vector3TestSuite.h"
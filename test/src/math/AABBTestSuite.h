@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+
+#include "math/AABB.h"
+#include "math/MathHelper.h"
+#include "math/Quaternion.h"
+
+TEST(AABB, TestFromMinMax)
+{
+    ds_math::AABB box =
+        ds_math::AABB::FromMinMax(ds_math::Vector3(-1.0f, 2.0f, 0.0f),
+                                  ds_math::Vector3(3.0f, 4.0f, 1.0f));
+
+    EXPECT_EQ(ds_math::Vector3(1.0f, 3.0f, 0.5f), box.center);
+    EXPECT_EQ(ds_math::Vector3(2.0f, 1.0f, 0.5f), box.extents);
+    EXPECT_EQ(ds_math::Vector3(-1.0f, 2.0f, 0.0f), box.GetMin());
+    EXPECT_EQ(ds_math::Vector3(3.0f, 4.0f, 1.0f), box.GetMax());
+}
+
+TEST(AABB, TestFromPoints)
+{
+    ds_math::Vector3 points[] = {ds_math::Vector3(1.0f, -2.0f, 0.5f),
+                                 ds_math::Vector3(-3.0f, 0.0f, 0.0f),
+                                 ds_math::Vector3(0.0f, 5.0f, -1.0f)};
+
+    ds_math::AABB box = ds_math::AABB::FromPoints(points, 3);
+
+    EXPECT_EQ(ds_math::Vector3(-3.0f, -2.0f, -1.0f), box.GetMin());
+    EXPECT_EQ(ds_math::Vector3(1.0f, 5.0f, 0.5f), box.GetMax());
+
+    // No points gives an empty box
+    box = ds_math::AABB::FromPoints(points, 0);
+
+    EXPECT_EQ(ds_math::Vector3(), box.center);
+    EXPECT_EQ(ds_math::Vector3(), box.extents);
+}
+
+TEST(AABB, TestTransform)
+{
+    ds_math::AABB box =
+        ds_math::AABB::FromMinMax(ds_math::Vector3(-1.0f, -2.0f, -3.0f),
+                                  ds_math::Vector3(1.0f, 2.0f, 3.0f));
+
+    // Translation and scale map corners to corners
+    ds_math::AABB transformed = ds_math::AABB::Transform(
+        box, ds_math::Matrix4::CreateTranslationMatrix(10.0f, 0.0f, -5.0f) *
+                 ds_math::Matrix4::CreateScaleMatrix(2.0f, 1.0f, 0.5f));
+
+    EXPECT_EQ(ds_math::Vector3(8.0f, -2.0f, -6.5f), transformed.GetMin());
+    EXPECT_EQ(ds_math::Vector3(12.0f, 2.0f, -3.5f), transformed.GetMax());
+
+    // A quarter turn around z swaps the x and y extents
+    float angle = ds_math::MathHelper::PI / 2.0f;
+    transformed = ds_math::AABB::Transform(
+        box, ds_math::Matrix4::CreateFromQuaternion(ds_math::Quaternion(
+                 0.0f, 0.0f, sin(angle / 2.0f), cos(angle / 2.0f))));
+
+    EXPECT_EQ(ds_math::Vector3(), transformed.center);
+    EXPECT_EQ(ds_math::Vector3(2.0f, 1.0f, 3.0f), transformed.extents);
+}
+
+TEST(AABB, TestMerge)
+{
+    ds_math::AABB a =
+        ds_math::AABB::FromMinMax(ds_math::Vector3(-1.0f, 0.0f, 0.0f),
+                                  ds_math::Vector3(1.0f, 1.0f, 1.0f));
+    ds_math::AABB b =
+        ds_math::AABB::FromMinMax(ds_math::Vector3(0.0f, -2.0f, 0.5f),
+                                  ds_math::Vector3(3.0f, 0.5f, 2.0f));
+
+    ds_math::AABB merged = ds_math::AABB::Merge(a, b);
+
+    EXPECT_EQ(ds_math::Vector3(-1.0f, -2.0f, 0.0f), merged.GetMin());
+    EXPECT_EQ(ds_math::Vector3(3.0f, 1.0f, 2.0f), merged.GetMax());
+}
+
+TEST(AABB, TestIntersects)
+{
+    ds_math::AABB a =
+        ds_math::AABB::FromMinMax(ds_math::Vector3(0.0f, 0.0f, 0.0f),
+                                  ds_math::Vector3(1.0f, 1.0f, 1.0f));
+
+    // Overlapping, touching and separated on a single axis
+    EXPECT_TRUE(ds_math::AABB::Intersects(
+        a, ds_math::AABB::FromMinMax(ds_math::Vector3(0.5f, 0.5f, 0.5f),
+                                     ds_math::Vector3(2.0f, 2.0f, 2.0f))));
+    EXPECT_TRUE(ds_math::AABB::Intersects(
+        a, ds_math::AABB::FromMinMax(ds_math::Vector3(1.0f, 0.0f, 0.0f),
+                                     ds_math::Vector3(2.0f, 1.0f, 1.0f))));
+    EXPECT_FALSE(ds_math::AABB::Intersects(
+        a, ds_math::AABB::FromMinMax(ds_math::Vector3(0.0f, 0.0f, 1.5f),
+                                     ds_math::Vector3(1.0f, 1.0f, 2.0f))));
+}
+
+TEST(AABB, TestGetSurfaceArea)
+{
+    ds_math::AABB box =
+        ds_math::AABB::FromMinMax(ds_math::Vector3(0.0f, 0.0f, 0.0f),
+                                  ds_math::Vector3(1.0f, 2.0f, 3.0f));
+
+    EXPECT_FLOAT_EQ(22.0f, box.GetSurfaceArea());
+}
@@ -0,0 +1,175 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "math/Batch.h"
+
+// Not a multiple of the SIMD width, so the remainder paths are tested too
+static const size_t BatchTestCount = 11;
+
+/**
+ * Create an affine matrix that differs for each index.
+ */
+static ds_math::Matrix4 BatchTestMatrix(size_t i)
+{
+    ds_math::Quaternion rotation = ds_math::Quaternion::Normalize(
+        ds_math::Quaternion(0.1f * i, 0.5f, -0.3f, 0.8f));
+
+    return ds_math::Matrix4::CreateTranslationMatrix(i * 0.5f, -2.0f,
+                                                     i * 3.0f) *
+           ds_math::Matrix4::CreateFromQuaternion(rotation) *
+           ds_math::Matrix4::CreateScaleMatrix(2.0f, 0.5f + i, 1.5f);
+}
+
+TEST(Batch, Multiply)
+{
+    std::vector<ds_math::Matrix4> m1, m2, result(BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        m1.push_back(BatchTestMatrix(i));
+        m2.push_back(BatchTestMatrix(i + 7));
+    }
+
+    ds_math::Batch::Multiply(m1.data(), m2.data(), result.data(),
+                             BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        EXPECT_EQ(m1[i] * m2[i], result[i]);
+    }
+
+    ds_math::Batch::AffineMultiply(m1.data(), m2.data(), result.data(),
+                                   BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        EXPECT_EQ(ds_math::Matrix4::AffineMultiply(m1[i], m2[i]), result[i]);
+    }
+
+    // Output may be the same as an input
+    std::vector<ds_math::Matrix4> expected = result;
+    ds_math::Batch::AffineMultiply(m1.data(), m2.data(), m1.data(),
+                                   BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        EXPECT_EQ(expected[i], m1[i]);
+    }
+}
+
+TEST(Batch, TransformPoints)
+{
+    ds_math::Matrix4 mat = BatchTestMatrix(3);
+
+    std::vector<ds_math::Vector3> points, result(BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        points.push_back(ds_math::Vector3(i * 1.0f, i * -2.0f, 0.5f));
+    }
+
+    ds_math::Batch::TransformPoints(mat, points.data(), result.data(),
+                                    BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        ds_math::Vector4 expected = mat * ds_math::Vector4(points[i], 1.0f);
+
+        EXPECT_FLOAT_EQ(expected.x, result[i].x);
+        EXPECT_FLOAT_EQ(expected.y, result[i].y);
+        EXPECT_FLOAT_EQ(expected.z, result[i].z);
+    }
+}
+
+TEST(Batch, TransformVectors)
+{
+    ds_math::Matrix4 mat = BatchTestMatrix(5);
+
+    std::vector<ds_math::Vector4> vectors, result(BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        vectors.push_back(ds_math::Vector4(i * 1.0f, 3.0f, i * -0.5f, 0.0f));
+    }
+
+    ds_math::Batch::TransformVectors(mat, vectors.data(), result.data(),
+                                     BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        EXPECT_EQ(mat * vectors[i], result[i]);
+    }
+}
+
+TEST(Batch, CreateFromQuaternions)
+{
+    std::vector<ds_math::Quaternion> quaternions;
+    std::vector<ds_math::Matrix4> result(BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        quaternions.push_back(ds_math::Quaternion::Normalize(
+            ds_math::Quaternion(0.3f, -0.1f * i, 0.7f, 0.2f * i)));
+    }
+
+    ds_math::Batch::CreateFromQuaternions(quaternions.data(), result.data(),
+                                          BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        EXPECT_EQ(ds_math::Matrix4::CreateFromQuaternion(quaternions[i]),
+                  result[i]);
+    }
+}
+
+TEST(Batch, NormalizeQuaternions)
+{
+    std::vector<ds_math::Quaternion> quaternions;
+    std::vector<ds_math::Quaternion> result(BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        quaternions.push_back(
+            ds_math::Quaternion(0.3f * i, -2.0f, 0.7f, 10.0f * i));
+    }
+
+    ds_math::NormalizePrecision precisions[] = {
+        ds_math::NormalizePrecision::Exact, ds_math::NormalizePrecision::Fast};
+    for (ds_math::NormalizePrecision precision : precisions)
+    {
+        ds_math::Batch::Normalize(quaternions.data(), result.data(),
+                                  BatchTestCount, precision);
+        for (size_t i = 0; i < BatchTestCount; ++i)
+        {
+            EXPECT_EQ(ds_math::Quaternion::Normalize(quaternions[i]),
+                      result[i]);
+        }
+    }
+}
+
+TEST(Batch, InterpolateQuaternions)
+{
+    std::vector<ds_math::Quaternion> q1, q2;
+    std::vector<ds_math::Quaternion> result(BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        q1.push_back(ds_math::Quaternion::Normalize(
+            ds_math::Quaternion(0.3f, -0.1f * i, 0.7f, 0.2f * i)));
+        // Every other pair in opposite hemispheres
+        q2.push_back(ds_math::Quaternion::Normalize(ds_math::Quaternion(
+            -0.5f * i, 0.4f, (i % 2 == 0) ? -0.9f : 0.9f, 0.1f)));
+    }
+
+    const float t = 0.3f;
+
+    ds_math::Batch::Nlerp(q1.data(), q2.data(), t, result.data(),
+                          BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        EXPECT_EQ(ds_math::Quaternion::Nlerp(q1[i], q2[i], t), result[i]);
+    }
+
+    ds_math::Batch::Nlerp(q1.data(), q2.data(), t, result.data(),
+                          BatchTestCount, ds_math::NormalizePrecision::Fast);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        EXPECT_EQ(ds_math::Quaternion::Nlerp(q1[i], q2[i], t), result[i]);
+    }
+
+    ds_math::Batch::Slerp(q1.data(), q2.data(), t, result.data(),
+                          BatchTestCount);
+    for (size_t i = 0; i < BatchTestCount; ++i)
+    {
+        EXPECT_EQ(ds_math::Quaternion::Slerp(q1[i], q2[i], t), result[i]);
+    }
+}
@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+
+#include "math/Frustum.h"
+#include "math/MathHelper.h"
+
+/**
+ * Create the frustum of a camera at the given position looking down -z, with
+ * a 90 degree field of view and planes at 1 and 100.
+ */
+static ds_math::Frustum FrustumTestFrustum(const ds_math::Vector3 &position)
+{
+    ds_math::Matrix4 view =
+        ds_math::Matrix4::CreateTranslationMatrix(-position);
+    ds_math::Matrix4 projection =
+        ds_math::Matrix4::CreatePerspectiveFieldOfView(
+            ds_math::MathHelper::PI / 2.0f, 1.0f, 1.0f, 100.0f);
+
+    return ds_math::Frustum(projection * view);
+}
+
+TEST(Frustum, TestPlanes)
+{
+    ds_math::Frustum frustum = FrustumTestFrustum(ds_math::Vector3());
+
+    // Normals point into the frustum
+    EXPECT_EQ(ds_math::Vector4(0.0f, 0.0f, -1.0f, -1.0f),
+              frustum.GetPlane(ds_math::Frustum::Near));
+    ds_math::Vector4 farPlane = frustum.GetPlane(ds_math::Frustum::Far);
+    EXPECT_EQ(ds_math::Vector3(0.0f, 0.0f, 1.0f),
+              ds_math::Vector3(farPlane.x, farPlane.y, farPlane.z));
+    EXPECT_NEAR(100.0f, farPlane.w, 1e-3f);
+
+    float halfSqrt2 = sqrt(2.0f) / 2.0f;
+    EXPECT_EQ(ds_math::Vector4(halfSqrt2, 0.0f, -halfSqrt2, 0.0f),
+              frustum.GetPlane(ds_math::Frustum::Left));
+    EXPECT_EQ(ds_math::Vector4(0.0f, -halfSqrt2, -halfSqrt2, 0.0f),
+              frustum.GetPlane(ds_math::Frustum::Top));
+}
+
+TEST(Frustum, TestIntersectsAABB)
+{
+    ds_math::Frustum frustum =
+        FrustumTestFrustum(ds_math::Vector3(5.0f, 0.0f, 0.0f));
+    ds_math::Vector3 unitExtents(1.0f, 1.0f, 1.0f);
+
+    // Inside
+    EXPECT_TRUE(frustum.Intersects(
+        ds_math::AABB(ds_math::Vector3(5.0f, 0.0f, -10.0f), unitExtents)));
+    // Behind the camera, past the far plane and to each side
+    EXPECT_FALSE(frustum.Intersects(
+        ds_math::AABB(ds_math::Vector3(5.0f, 0.0f, 10.0f), unitExtents)));
+    EXPECT_FALSE(frustum.Intersects(
+        ds_math::AABB(ds_math::Vector3(5.0f, 0.0f, -110.0f), unitExtents)));
+    EXPECT_FALSE(frustum.Intersects(
+        ds_math::AABB(ds_math::Vector3(-10.0f, 0.0f, -10.0f), unitExtents)));
+    EXPECT_FALSE(frustum.Intersects(
+        ds_math::AABB(ds_math::Vector3(5.0f, 20.0f, -10.0f), unitExtents)));
+    // Straddling a plane
+    EXPECT_TRUE(frustum.Intersects(
+        ds_math::AABB(ds_math::Vector3(5.0f, 0.0f, -100.5f), unitExtents)));
+    EXPECT_TRUE(frustum.Intersects(ds_math::AABB(
+        ds_math::Vector3(-5.5f, 0.0f, -10.0f), unitExtents)));
+    // Larger than the frustum
+    EXPECT_TRUE(frustum.Intersects(ds_math::AABB(
+        ds_math::Vector3(), ds_math::Vector3(1000.0f, 1000.0f, 1000.0f))));
+}
+
+TEST(Frustum, TestContainsAABB)
+{
+    ds_math::Frustum frustum = FrustumTestFrustum(ds_math::Vector3());
+    ds_math::Vector3 unitExtents(1.0f, 1.0f, 1.0f);
+
+    EXPECT_TRUE(frustum.Contains(
+        ds_math::AABB(ds_math::Vector3(0.0f, 0.0f, -10.0f), unitExtents)));
+    // Straddling the near and left planes
+    EXPECT_FALSE(frustum.Contains(
+        ds_math::AABB(ds_math::Vector3(0.0f, 0.0f, -1.5f), unitExtents)));
+    EXPECT_FALSE(frustum.Contains(
+        ds_math::AABB(ds_math::Vector3(-10.0f, 0.0f, -10.0f), unitExtents)));
+    // Outside
+    EXPECT_FALSE(frustum.Contains(
+        ds_math::AABB(ds_math::Vector3(0.0f, 0.0f, 10.0f), unitExtents)));
+}
+
+TEST(Frustum, TestIntersectsSphere)
+{
+    ds_math::Frustum frustum = FrustumTestFrustum(ds_math::Vector3());
+
+    EXPECT_TRUE(frustum.Intersects(ds_math::Vector3(0.0f, 0.0f, -10.0f), 1.0f));
+    EXPECT_FALSE(frustum.Intersects(ds_math::Vector3(0.0f, 0.0f, 3.0f), 1.0f));
+    EXPECT_TRUE(frustum.Intersects(ds_math::Vector3(0.0f, 0.0f, 3.0f), 5.0f));
+}
+
+TEST(Frustum, TestIntersectsTransformedAABB)
+{
+    ds_math::Frustum frustum = FrustumTestFrustum(ds_math::Vector3());
+    ds_math::AABB box(ds_math::Vector3(0.0f, 0.0f, 1.0f),
+                      ds_math::Vector3(1.0f, 2.0f, 0.5f));
+
+    // Same result as testing the transformed box, over a sweep of positions
+    // in and out of the frustum
+    for (float x = -50.0f; x <= 50.0f; x += 2.5f)
+    {
+        ds_math::Quaternion rotation = ds_math::Quaternion::Normalize(
+            ds_math::Quaternion(0.3f, x * 0.1f, 0.2f, 0.9f));
+        ds_math::Matrix4 transform =
+            ds_math::Matrix4::CreateTranslationMatrix(x, x * 0.5f, -20.0f) *
+            ds_math::Matrix4::CreateFromQuaternion(rotation) *
+            ds_math::Matrix4::CreateScaleMatrix(2.0f, 1.0f, 3.0f);
+
+        EXPECT_EQ(frustum.Intersects(ds_math::AABB::Transform(box, transform)),
+                  frustum.Intersects(box, transform));
+    }
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include "gtest/gtest.h"
@@ -216,6 +218,49 @@ TEST(Matrix4, TestInverse)
     EXPECT_EQ(result, inv);
 }
 
+TEST(Matrix4, TestIsAffine)
+{
+    EXPECT_TRUE(ds_math::Matrix4::IsAffine(ds_math::Matrix4()));
+    EXPECT_TRUE(ds_math::Matrix4::IsAffine(
+        ds_math::Matrix4::CreateTranslationMatrix(1.0f, 2.0f, 3.0f)));
+    EXPECT_FALSE(ds_math::Matrix4::IsAffine(
+        ds_math::Matrix4::CreatePerspectiveFieldOfView(1.0f, 1.0f, 0.1f,
+                                                       100.0f)));
+}
+
+TEST(Matrix4, TestAffineInverse)
+{
+    ds_math::Matrix4 identity = ds_math::Matrix4();
+
+    EXPECT_EQ(identity, ds_math::Matrix4::AffineInverse(identity));
+
+    ds_math::Matrix4 mat =
+        ds_math::Matrix4::CreateTranslationMatrix(4.0f, -2.0f, 0.5f) *
+        ds_math::Matrix4::CreateFromQuaternion(ds_math::Quaternion::Normalize(
+            ds_math::Quaternion(0.2f, 0.5f, -0.3f, 0.8f))) *
+        ds_math::Matrix4::CreateScaleMatrix(2.0f, 0.5f, 4.0f);
+
+    EXPECT_EQ(ds_math::Matrix4::Inverse(mat),
+              ds_math::Matrix4::AffineInverse(mat));
+    EXPECT_EQ(identity, mat * ds_math::Matrix4::AffineInverse(mat));
+}
+
+TEST(Matrix4, TestAffineMultiply)
+{
+    ds_math::Matrix4 mat1 =
+        ds_math::Matrix4::CreateTranslationMatrix(1.0f, 2.0f, 3.0f) *
+        ds_math::Matrix4::CreateScaleMatrix(3.0f, 1.0f, 0.5f);
+    ds_math::Matrix4 mat2 =
+        ds_math::Matrix4::CreateFromQuaternion(ds_math::Quaternion::Normalize(
+            ds_math::Quaternion(-0.4f, 0.1f, 0.7f, 0.5f))) *
+        ds_math::Matrix4::CreateTranslationMatrix(-6.0f, 0.25f, 9.0f);
+
+    EXPECT_EQ(mat1 * mat2, ds_math::Matrix4::AffineMultiply(mat1, mat2));
+    EXPECT_EQ(mat2 * mat1, ds_math::Matrix4::AffineMultiply(mat2, mat1));
+    EXPECT_TRUE(ds_math::Matrix4::IsAffine(
+        ds_math::Matrix4::AffineMultiply(mat1, mat2)));
+}
+
 TEST(Matrix4, TestCreateTranslationMatrix)
 {
     ds_math::Vector3 translation(1.0f, -2.3f, 0.3f);
@@ -375,3 +420,149 @@ TEST(Matrix4, TestOutputStreamOperator)
 
     EXPECT_EQ(resultStream.str(), stream.str());
 }
+
+// The tests below check the kernels selected at build time (SIMD or scalar)
+// against straightforward reference implementations.
+
+/**
+ * Create a matrix with pseudo-random elements in the range [-10, 10].
+ */
+static ds_math::Matrix4 Matrix4TestRandomMatrix(unsigned int *seed)
+{
+    ds_math::Matrix4 mat;
+
+    for (unsigned int col = 0; col < 4; ++col)
+    {
+        for (unsigned int row = 0; row < 4; ++row)
+        {
+            *seed = *seed * 1664525u + 1013904223u;
+            mat[col][row] = ((*seed >> 8) / (float)(1u << 24)) * 20.0f - 10.0f;
+        }
+    }
+
+    return mat;
+}
+
+// Products of elements up to 10 sum to at most 400, so allow for a few units
+// of rounding error at that magnitude (i.e. if the compiler fuses the
+// reference's multiplies and adds).
+TEST(Matrix4, TestMatrixMultiplicationMatchesReference)
+{
+    const float tolerance = 1e-3f;
+
+    unsigned int seed = 1;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ds_math::Matrix4 m1 = Matrix4TestRandomMatrix(&seed);
+        ds_math::Matrix4 m2 = Matrix4TestRandomMatrix(&seed);
+        ds_math::Vector4 vec = Matrix4TestRandomMatrix(&seed)[0];
+
+        ds_math::Matrix4 product = m1 * m2;
+        ds_math::Vector4 columnProduct = m1 * vec;
+        ds_math::Vector4 rowProduct = vec * m1;
+
+        for (unsigned int col = 0; col < 4; ++col)
+        {
+            for (unsigned int row = 0; row < 4; ++row)
+            {
+                float expected = m1[0][row] * m2[col][0];
+                expected += m1[1][row] * m2[col][1];
+                expected += m1[2][row] * m2[col][2];
+                expected += m1[3][row] * m2[col][3];
+
+                EXPECT_NEAR(expected, product[col][row], tolerance);
+            }
+
+            float expectedColumn = m1[0][col] * vec.x;
+            expectedColumn += m1[1][col] * vec.y;
+            expectedColumn += m1[2][col] * vec.z;
+            expectedColumn += m1[3][col] * vec.w;
+
+            float expectedRow = vec.x * m1[col].x;
+            expectedRow += vec.y * m1[col].y;
+            expectedRow += vec.z * m1[col].z;
+            expectedRow += vec.w * m1[col].w;
+
+            EXPECT_NEAR(expectedColumn, columnProduct[col], tolerance);
+            EXPECT_NEAR(expectedRow, rowProduct[col], tolerance);
+        }
+    }
+}
+
+TEST(Matrix4, TestTransposeMatchesReference)
+{
+    unsigned int seed = 2;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ds_math::Matrix4 mat = Matrix4TestRandomMatrix(&seed);
+        ds_math::Matrix4 transposed = ds_math::Matrix4::Transpose(mat);
+
+        for (unsigned int col = 0; col < 4; ++col)
+        {
+            for (unsigned int row = 0; row < 4; ++row)
+            {
+                EXPECT_EQ(mat[col][row], transposed[row][col]);
+            }
+        }
+    }
+}
+
+TEST(Matrix4, TestInverseMatchesReference)
+{
+    unsigned int seed = 3;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ds_math::Matrix4 mat = Matrix4TestRandomMatrix(&seed);
+        ds_math::Matrix4 inv = ds_math::Matrix4::Inverse(mat);
+
+        // Reference inverse by Gauss-Jordan elimination in double precision
+        double a[4][8];
+        for (unsigned int row = 0; row < 4; ++row)
+        {
+            for (unsigned int col = 0; col < 4; ++col)
+            {
+                a[row][col] = mat[col][row];
+                a[row][col + 4] = (row == col) ? 1.0 : 0.0;
+            }
+        }
+        for (unsigned int pivot = 0; pivot < 4; ++pivot)
+        {
+            unsigned int best = pivot;
+            for (unsigned int row = pivot + 1; row < 4; ++row)
+            {
+                if (fabs(a[row][pivot]) > fabs(a[best][pivot]))
+                {
+                    best = row;
+                }
+            }
+            for (unsigned int col = 0; col < 8; ++col)
+            {
+                std::swap(a[pivot][col], a[best][col]);
+            }
+            for (unsigned int row = 0; row < 4; ++row)
+            {
+                if (row != pivot)
+                {
+                    double factor = a[row][pivot] / a[pivot][pivot];
+                    for (unsigned int col = 0; col < 8; ++col)
+                    {
+                        a[row][col] -= factor * a[pivot][col];
+                    }
+                }
+            }
+        }
+
+        for (unsigned int col = 0; col < 4; ++col)
+        {
+            for (unsigned int row = 0; row < 4; ++row)
+            {
+                double expected = a[row][col + 4] / a[row][row];
+                EXPECT_NEAR(expected, inv[col][row],
+                            1e-3 * std::max(1.0, fabs(expected)));
+            }
+        }
+    }
+}
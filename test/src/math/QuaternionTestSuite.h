@@ -180,6 +180,27 @@ TEST(Quaternion, TestNormalize)
     EXPECT_EQ(q, normalized);
 }
 
+TEST(Quaternion, TestNormalizeFast)
+{
+    // Magnitudes over several orders of magnitude
+    float magnitudes[] = {1e-3f, 0.5f, 1.0f, 7.3f, 993.0f, 1e5f};
+
+    for (float magnitude : magnitudes)
+    {
+        ds_math::Quaternion q =
+            ds_math::Quaternion(0.3f, -0.1f, 0.9f, 0.2f) * magnitude;
+        ds_math::Quaternion exact = ds_math::Quaternion::Normalize(q);
+        ds_math::Quaternion fast = ds_math::Quaternion::Normalize(
+            q, ds_math::NormalizePrecision::Fast);
+
+        EXPECT_EQ(exact, fast);
+        EXPECT_NEAR(1.0f, fast.Magnitude(), 1e-6f);
+
+        q.Normalize(ds_math::NormalizePrecision::Fast);
+        EXPECT_EQ(fast, q);
+    }
+}
+
 TEST(Quaternion, TestInvert)
 {
     float x = -13.0f;
@@ -222,6 +243,65 @@ TEST(Quaternion, TestQuaternionMultiplication)
     EXPECT_EQ(expectedResult, q1 * q2);
 }
 
+/**
+ * Create a unit quaternion rotating by the given angle around the z axis.
+ */
+static ds_math::Quaternion QuaternionTestRotationZ(float angle)
+{
+    return ds_math::Quaternion(0.0f, 0.0f, sin(angle / 2.0f),
+                               cos(angle / 2.0f));
+}
+
+TEST(Quaternion, TestNlerp)
+{
+    ds_math::Quaternion q1 = QuaternionTestRotationZ(0.0f);
+    ds_math::Quaternion q2 = QuaternionTestRotationZ(1.5f);
+
+    EXPECT_EQ(q1, ds_math::Quaternion::Nlerp(q1, q2, 0.0f));
+    EXPECT_EQ(q2, ds_math::Quaternion::Nlerp(q1, q2, 1.0f));
+
+    // Halfway is exact, as the interpolation is symmetric
+    EXPECT_EQ(QuaternionTestRotationZ(0.75f),
+              ds_math::Quaternion::Nlerp(q1, q2, 0.5f));
+    EXPECT_EQ(QuaternionTestRotationZ(0.75f),
+              ds_math::Quaternion::Nlerp(q1, q2, 0.5f,
+                                         ds_math::NormalizePrecision::Fast));
+
+    // Takes the shortest path when the quaternions are in opposite
+    // hemispheres
+    EXPECT_EQ(QuaternionTestRotationZ(0.75f),
+              ds_math::Quaternion::Nlerp(q1, -q2, 0.5f));
+
+    ds_math::Quaternion quarter = ds_math::Quaternion::Nlerp(q1, q2, 0.25f);
+    EXPECT_NEAR(1.0f, quarter.Magnitude(), 1e-6f);
+}
+
+TEST(Quaternion, TestSlerp)
+{
+    ds_math::Quaternion q1 = QuaternionTestRotationZ(0.0f);
+    ds_math::Quaternion q2 = QuaternionTestRotationZ(2.0f);
+
+    EXPECT_EQ(q1, ds_math::Quaternion::Slerp(q1, q2, 0.0f));
+    EXPECT_EQ(q2, ds_math::Quaternion::Slerp(q1, q2, 1.0f));
+
+    // Constant angular velocity
+    for (float t = 0.0f; t <= 1.0f; t += 0.125f)
+    {
+        EXPECT_EQ(QuaternionTestRotationZ(2.0f * t),
+                  ds_math::Quaternion::Slerp(q1, q2, t));
+    }
+
+    // Takes the shortest path when the quaternions are in opposite
+    // hemispheres
+    EXPECT_EQ(QuaternionTestRotationZ(0.5f),
+              ds_math::Quaternion::Slerp(q1, -q2, 0.25f));
+
+    // Almost equal orientations
+    ds_math::Quaternion q3 = QuaternionTestRotationZ(1e-4f);
+    EXPECT_EQ(QuaternionTestRotationZ(0.5e-4f),
+              ds_math::Quaternion::Slerp(q1, q3, 0.5f));
+}
+
 TEST(Quaternion, TestOutputOperator)
 {
     float x = 1.0f;
@@ -349,3 +349,31 @@ TEST(Vector4, TestUnitW)
     EXPECT_EQ(ds_math::Vector4(0.0f, 0.0f, 0.0f, 1.0f),
               ds_math::Vector4::UnitW);
 }
+
+// Checks the kernels selected at build time (SIMD or scalar) against the
+// component-wise definitions
+TEST(Vector4, TestOperationsMatchReference)
+{
+    ds_math::Vector4 v1(1.5f, -2.25f, 3.0f, 0.5f);
+    ds_math::Vector4 v2(-4.0f, 0.125f, 7.5f, -1.0f);
+
+    ds_math::Vector4 sum = v1 + v2;
+    ds_math::Vector4 difference = v1 - v2;
+    ds_math::Vector4 scaled = v1 * 3.0f;
+
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        EXPECT_FLOAT_EQ(v1[i] + v2[i], sum[i]);
+        EXPECT_FLOAT_EQ(v1[i] - v2[i], difference[i]);
+        EXPECT_FLOAT_EQ(v1[i] * 3.0f, scaled[i]);
+    }
+
+    EXPECT_FLOAT_EQ(v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w,
+                    ds_math::Vector4::Dot(v1, v2));
+}
+
+TEST(Vector4, TestAlignment)
+{
+    EXPECT_EQ(16u, alignof(ds_math::Vector4));
+    EXPECT_EQ(4 * sizeof(ds_math::scalar), sizeof(ds_math::Vector4));
+}